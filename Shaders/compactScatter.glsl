@@ -0,0 +1,45 @@
+#version 450
+#pragma shader_stage(compute)
+
+// Second half of stream compaction: every flagged value moves to its slot from the exclusive scan of the flags
+
+layout(local_size_x = 256) in;
+
+layout(std430, binding = 0) readonly buffer ValueBuffer {
+    uint values[];
+};
+
+// 0 or 1 per value
+layout(std430, binding = 1) readonly buffer FlagBuffer {
+    uint flags[];
+};
+
+layout(std430, binding = 2) readonly buffer OffsetBuffer {
+    uint offsets[];
+};
+
+layout(std430, binding = 3) writeonly buffer OutputBuffer {
+    uint outputs[];
+};
+
+layout(std430, binding = 4) writeonly buffer CountBuffer {
+    uint compactedCount;
+};
+
+// Must match CompactConstants
+layout(push_constant) uniform CompactConstants {
+    uint count;
+} compaction;
+
+void main() {
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= compaction.count)
+        return;
+
+    uint offset = offsets[index];
+    if (flags[index] != 0u)
+        outputs[offset] = values[index];
+
+    if (index == compaction.count - 1)
+        compactedCount = offset + flags[index];
+}
@@ -0,0 +1,30 @@
+#version 450
+#pragma shader_stage(compute)
+
+// Builds one level of the depth pyramid. With reverse-Z the smallest value is the farthest surface, so every texel
+// keeps the minimum of its footprint and an object behind that depth is hidden everywhere inside the texel.
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 0) uniform sampler2D source;
+layout(binding = 1, r32f) uniform writeonly image2D destination;
+
+void main() {
+    ivec2 position = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 destinationSize = imageSize(destination);
+    if (any(greaterThanEqual(position, destinationSize)))
+        return;
+
+    // Level 0 is a power of two below the depth buffer, so a footprint can span up to 3 source texels per axis
+    ivec2 sourceSize = textureSize(source, 0);
+    ivec2 first = position * sourceSize / destinationSize;
+    ivec2 last = min(((position + 1) * sourceSize + destinationSize - 1) / destinationSize, sourceSize) - 1;
+
+    float depth = 1.0;
+    for (int y = first.y; y <= last.y; y++) {
+        for (int x = first.x; x <= last.x; x++) {
+            depth = min(depth, texelFetch(source, ivec2(x, y), 0).r);
+        }
+    }
+    imageStore(destination, position, vec4(depth));
+}
@@ -0,0 +1,25 @@
+#version 450
+#pragma shader_stage(vertex)
+
+#include "Objects.glslh"
+#include "PushConstants.glslh"
+
+// Depth only variant of vertexShader.glsl for meshes with a split position stream, consumes binding 0 alone
+layout(location = 0) in vec3 inPosition;
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+layout(std430, binding = 1) readonly buffer ObjectBuffer {
+    GpuObject objects[];
+};
+
+// Has to match vertexShader.glsl exactly, the shading pass tests against this depth with equal-or-greater
+invariant gl_Position;
+
+void main() {
+    mat4 model = draw.objectIndex == INDIRECT_OBJECT_INDEX ? objects[gl_InstanceIndex].model : draw.model;
+    gl_Position = ubo.proj * ubo.view * model * vec4(inPosition, 1.0);
+}
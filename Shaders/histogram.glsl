@@ -0,0 +1,59 @@
+#version 450
+#pragma shader_stage(compute)
+
+// Counts values per bin. Workgroups count into shared memory first and add their totals to the bins once, so
+// the global atomics scale with the bins rather than the values.
+
+#define GROUP_SIZE 256
+#define ITEMS_PER_THREAD 8
+#define MAX_SHARED_BINS 1024
+
+layout(local_size_x = GROUP_SIZE) in;
+
+layout(std430, binding = 0) readonly buffer ValueBuffer {
+    uint values[];
+};
+
+layout(std430, binding = 1) buffer BinBuffer {
+    uint bins[];
+};
+
+// Must match HistogramConstants
+layout(push_constant) uniform HistogramConstants {
+    uint count;
+    uint binCount;
+    uint shift; // A value's bin is value >> shift, clamped to the last bin
+} histogram;
+
+shared uint localBins[MAX_SHARED_BINS];
+
+void main() {
+    uint local = gl_LocalInvocationIndex;
+    bool privatized = histogram.binCount <= MAX_SHARED_BINS;
+    if (privatized) {
+        for (uint bin = local; bin < histogram.binCount; bin += GROUP_SIZE)
+            localBins[bin] = 0;
+    }
+    barrier();
+
+    uint first = gl_WorkGroupID.x * GROUP_SIZE * ITEMS_PER_THREAD + local;
+    for (uint i = 0; i < ITEMS_PER_THREAD; i++) {
+        uint index = first + i * GROUP_SIZE;
+        if (index >= histogram.count)
+            break;
+
+        uint bin = min(values[index] >> histogram.shift, histogram.binCount - 1);
+        if (privatized)
+            atomicAdd(localBins[bin], 1u);
+        else
+            atomicAdd(bins[bin], 1u);
+    }
+    barrier();
+
+    if (privatized) {
+        for (uint bin = local; bin < histogram.binCount; bin += GROUP_SIZE) {
+            if (localBins[bin] != 0u)
+                atomicAdd(bins[bin], localBins[bin]);
+        }
+    }
+}
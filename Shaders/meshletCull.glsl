@@ -0,0 +1,118 @@
+#version 450
+#pragma shader_stage(compute)
+
+#include "Objects.glslh"
+
+// One workgroup per task, one invocation per meshlet. Every meshlet that passes the frustum and normal cone tests
+// becomes an indexed indirect draw of its index range, with the object's slot as firstInstance.
+
+layout(local_size_x = 64) in;
+
+struct DrawCommand {
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
+
+// Must match GpuMeshlet
+struct Meshlet {
+    vec4 boundingSphere; // Model space center and radius
+    vec4 cone; // Front facing axis and cutoff, a cutoff of 1 disables the test
+    uint firstIndex;
+    uint indexCount;
+    uint padding0;
+    uint padding1;
+};
+
+// Must match MeshletDrawBatch, drawCount is the count buffer of vkCmdDrawIndexedIndirectCount
+struct DrawBatch {
+    uint drawCount;
+    uint firstDraw;
+};
+
+layout(std430, binding = 0) readonly buffer ObjectBuffer {
+    GpuObject objects[];
+};
+
+layout(std430, binding = 1) readonly buffer MeshletBuffer {
+    Meshlet meshlets[];
+};
+
+// x: object slot, y: first meshlet of the task relative to the object
+layout(std430, binding = 2) readonly buffer TaskBuffer {
+    uvec2 tasks[];
+};
+
+layout(std430, binding = 3) buffer BatchBuffer {
+    DrawBatch batches[];
+};
+
+layout(std430, binding = 4) writeonly buffer CommandBuffer {
+    DrawCommand commands[];
+};
+
+// Must match MeshletCullConstants
+layout(push_constant) uniform MeshletCullConstants {
+    mat4 view;
+    vec4 frustum; // xy: normalized x plane, zw: normalized y plane, both as (slope, z)
+    float nearPlane;
+    uint taskCount;
+    uint compact;
+    uint padding;
+} cull;
+
+// Center in view space with z pointing forward
+bool isInFrustum(vec3 center, float radius) {
+    bool visible = center.z * cull.frustum.y - abs(center.x) * cull.frustum.x > -radius;
+    visible = visible && center.z * cull.frustum.w - abs(center.y) * cull.frustum.z > -radius;
+    return visible && center.z + radius > cull.nearPlane;
+}
+
+// All triangles face away when the direction from the eye lies inside the cone widened by the sphere
+bool isBackFacing(vec3 center, float radius, vec3 axis, float cutoff) {
+    return dot(center, axis) >= cutoff * length(center) + radius;
+}
+
+void main() {
+    if (gl_WorkGroupID.x >= cull.taskCount)
+        return;
+
+    uvec2 task = tasks[gl_WorkGroupID.x];
+    GpuObject object = objects[task.x];
+    uint local = task.y + gl_LocalInvocationID.x;
+    if (local >= object.meshletCount)
+        return;
+
+    Meshlet meshlet = meshlets[object.firstMeshlet + local];
+    mat4 modelView = cull.view * object.model;
+
+    vec3 scales = vec3(length(object.model[0].xyz), length(object.model[1].xyz), length(object.model[2].xyz));
+    float scale = max(scales.x, max(scales.y, scales.z));
+
+    vec3 center = (modelView * vec4(meshlet.boundingSphere.xyz, 1.0)).xyz;
+    center.z = -center.z;
+    float radius = meshlet.boundingSphere.w * scale;
+
+    bool visible = isInFrustum(center, radius);
+
+    // Non uniform scale skews the normals, the cone no longer bounds them
+    bool uniformScale = scale - min(scales.x, min(scales.y, scales.z)) < 1e-3 * scale;
+    if (visible && meshlet.cone.w < 1.0 && uniformScale) {
+        vec3 axis = normalize(mat3(modelView) * meshlet.cone.xyz);
+        axis.z = -axis.z;
+        visible = !isBackFacing(center, radius, axis, meshlet.cone.w);
+    }
+
+    DrawCommand command = DrawCommand(meshlet.indexCount, 1u, meshlet.firstIndex, object.vertexOffset, task.x);
+    if (cull.compact != 0) {
+        if (visible) {
+            uint slot = atomicAdd(batches[object.batch].drawCount, 1u);
+            commands[batches[object.batch].firstDraw + slot] = command;
+        }
+    } else {
+        command.instanceCount = visible ? 1u : 0u;
+        commands[object.firstDraw + local] = command;
+    }
+}
@@ -0,0 +1,45 @@
+#version 450
+#pragma shader_stage(compute)
+
+// Builds one mip level of a texture whose format vkCmdBlitImage can not filter. Every texel is the average of its
+// footprint in the level above, which spans 3 texels per axis where an odd size rounds down.
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 0) uniform sampler2D source;
+layout(binding = 1, rgba8) uniform writeonly image2D destination;
+
+// Must match MipDownsampleConstants
+layout(push_constant) uniform MipDownsampleConstants {
+    uint encodeSrgb; // The destination is the UNORM alias of an sRGB image
+} downsample;
+
+vec3 linearToSrgb(vec3 color) {
+    vec3 low = color * 12.92;
+    vec3 high = 1.055 * pow(color, vec3(1.0 / 2.4)) - 0.055;
+    return mix(high, low, lessThanEqual(color, vec3(0.0031308)));
+}
+
+void main() {
+    ivec2 position = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 destinationSize = imageSize(destination);
+    if (any(greaterThanEqual(position, destinationSize)))
+        return;
+
+    ivec2 sourceSize = textureSize(source, 0);
+    ivec2 first = position * sourceSize / destinationSize;
+    ivec2 last = min(((position + 1) * sourceSize + destinationSize - 1) / destinationSize, sourceSize) - 1;
+
+    // sRGB sources are decoded by the fetch, so the average is taken in linear space
+    vec4 sum = vec4(0.0);
+    for (int y = first.y; y <= last.y; y++) {
+        for (int x = first.x; x <= last.x; x++) {
+            sum += texelFetch(source, ivec2(x, y), 0);
+        }
+    }
+    vec4 color = sum / float((last.x - first.x + 1) * (last.y - first.y + 1));
+
+    if (downsample.encodeSrgb != 0u)
+        color.rgb = linearToSrgb(color.rgb);
+    imageStore(destination, position, color);
+}
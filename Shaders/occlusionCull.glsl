@@ -0,0 +1,107 @@
+#version 450
+#pragma shader_stage(compute)
+
+#include "Objects.glslh"
+
+// Writes one indirect draw per object. The first phase redraws what was visible last frame, the second tests every
+// object against the depth pyramid built from the first phase and only draws the ones that just became visible.
+
+layout(local_size_x = 64) in;
+
+struct DrawCommand {
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
+
+layout(std430, binding = 0) readonly buffer ObjectBuffer {
+    GpuObject objects[];
+};
+
+layout(std430, binding = 1) writeonly buffer CommandBuffer {
+    DrawCommand commands[];
+};
+
+// Indexed by objectIndex, persists across frames
+layout(std430, binding = 2) buffer VisibilityBuffer {
+    uint visibility[];
+};
+
+layout(binding = 3) uniform sampler2D depthPyramid;
+
+// Must match OcclusionCullConstants
+layout(push_constant) uniform OcclusionCullConstants {
+    mat4 view;
+    vec4 projection; // x: P00, y: P11, z: near plane
+    vec2 pyramidSize;
+    uint objectCount;
+    uint phase;
+} cull;
+
+// Screen rectangle in uv of a view space sphere (z pointing forward) from its tangent lines through the eye.
+// Fails when the sphere touches the near plane, such objects are always treated as visible.
+bool projectSphere(vec3 center, float radius, out vec4 bounds) {
+    float nearPlane = cull.projection.z;
+    if (center.z < radius + nearPlane)
+        return false;
+
+    float denominator = center.z * center.z - radius * radius;
+    float offsetX = radius * sqrt(center.x * center.x + denominator);
+    float offsetY = radius * sqrt(center.y * center.y + denominator);
+    vec2 slopesX = (center.x * center.z + vec2(-offsetX, offsetX)) / denominator;
+    vec2 slopesY = (center.y * center.z + vec2(-offsetY, offsetY)) / denominator;
+
+    // P11 is negative because Vulkan's y points down, min/max keeps the rectangle ordered either way
+    vec2 ndcX = slopesX * cull.projection.x;
+    vec2 ndcY = slopesY * cull.projection.y;
+    vec2 minimum = vec2(min(ndcX.x, ndcX.y), min(ndcY.x, ndcY.y));
+    vec2 maximum = vec2(max(ndcX.x, ndcX.y), max(ndcY.x, ndcY.y));
+    bounds = vec4(minimum, maximum) * 0.5 + 0.5;
+    return true;
+}
+
+bool isOccluded(vec3 center, float radius) {
+    vec4 bounds;
+    if (!projectSphere(center, radius, bounds))
+        return false;
+
+    // Pick the level where the rectangle covers at most 2x2 texels and take their farthest depth
+    vec2 size = (bounds.zw - bounds.xy) * cull.pyramidSize;
+    int level = clamp(int(ceil(log2(max(max(size.x, size.y), 1.0)))), 0, textureQueryLevels(depthPyramid) - 1);
+
+    ivec2 levelSize = textureSize(depthPyramid, level);
+    ivec2 first = clamp(ivec2(bounds.xy * levelSize), ivec2(0), levelSize - 1);
+    ivec2 last = clamp(ivec2(bounds.zw * levelSize), ivec2(0), levelSize - 1);
+
+    float occluderDepth = min(min(texelFetch(depthPyramid, first, level).r,
+                                  texelFetch(depthPyramid, ivec2(last.x, first.y), level).r),
+                              min(texelFetch(depthPyramid, ivec2(first.x, last.y), level).r,
+                                  texelFetch(depthPyramid, last, level).r));
+
+    // Reverse-Z infinite projection, depth = near / distance. The sphere's closest point has to be behind everything.
+    float sphereDepth = cull.projection.z / (center.z - radius);
+    return sphereDepth < occluderDepth;
+}
+
+void main() {
+    uint slot = gl_GlobalInvocationID.x;
+    if (slot >= cull.objectCount)
+        return;
+
+    GpuObject object = objects[slot];
+    bool wasVisible = visibility[object.objectIndex] != 0;
+
+    bool draw = wasVisible;
+    if (cull.phase == 1) {
+        vec3 center = (cull.view * vec4(object.boundingSphere.xyz, 1.0)).xyz;
+        center.z = -center.z;
+
+        bool visible = !isOccluded(center, object.boundingSphere.w);
+        visibility[object.objectIndex] = visible ? 1u : 0u;
+        draw = visible && !wasVisible;
+    }
+
+    commands[slot] = DrawCommand(object.indexCount, draw ? 1u : 0u, object.firstIndex, object.vertexOffset, slot);
+}
@@ -0,0 +1,37 @@
+#version 450
+#pragma shader_stage(compute)
+
+#include "Particles.glslh"
+
+// Single invocation bookkeeping around the simulation, so the counts never have to come back to the CPU.
+// Begin takes this frame's spawns from the dead list and sizes the simulation, end sizes the draw.
+
+layout(local_size_x = 1) in;
+
+const uint MODE_BEGIN = 0;
+const uint MODE_END = 1;
+
+// Must match ParticleCounterConstants
+layout(push_constant) uniform ParticleCounterConstants {
+    uint mode;
+    uint requestedSpawns;
+    uint parity;
+} step;
+
+void main() {
+    uint current = step.parity;
+    uint next = 1u - step.parity;
+
+    if (step.mode == MODE_BEGIN) {
+        // Spawns beyond the free particles are dropped, the dead list is popped from its end
+        uint spawns = min(step.requestedSpawns, counters.deadCount);
+        counters.deadCount -= spawns;
+        counters.spawnCount = spawns;
+        counters.aliveCounts[current] += spawns;
+        counters.aliveCounts[next] = 0;
+        counters.simulateGroups = uvec3((counters.aliveCounts[current] + PARTICLE_GROUP_SIZE - 1) /
+                                        PARTICLE_GROUP_SIZE, 1, 1);
+    } else {
+        counters.drawCommand = uvec4(6, counters.aliveCounts[next], 0, 0);
+    }
+}
@@ -0,0 +1,71 @@
+#version 450
+#pragma shader_stage(compute)
+
+#include "Particles.glslh"
+
+// Turns dead particles into fresh ones and appends them to the alive list the simulation reads next
+
+layout(local_size_x = 64) in;
+
+layout(std430, binding = 1) readonly buffer EmitterBuffer {
+    GpuParticleEmitter emitters[];
+};
+
+layout(std430, binding = 2) writeonly buffer ParticleBuffer {
+    GpuParticle particles[];
+};
+
+layout(std430, binding = 3) readonly buffer DeadListBuffer {
+    uint deadList[];
+};
+
+layout(std430, binding = 4) writeonly buffer AliveListBuffer {
+    uint aliveList[];
+};
+
+// Must match ParticleEmitConstants
+layout(push_constant) uniform ParticleEmitConstants {
+    uint emitterCount;
+    uint parity;
+} emit;
+
+void main() {
+    uint spawn = gl_GlobalInvocationID.x;
+    if (spawn >= counters.spawnCount)
+        return;
+
+    // Last emitter starting at or before this spawn
+    uint low = 0;
+    uint high = emit.emitterCount - 1;
+    while (low < high) {
+        uint middle = (low + high + 1) / 2;
+        if (emitters[middle].firstSpawn <= spawn)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+    GpuParticleEmitter emitter = emitters[low];
+    uint seed = emitter.seed ^ hashRandom(spawn);
+
+    // Uniform direction and cube root radius give a uniform point in the sphere
+    float z = randomFloat(seed) * 2.0 - 1.0;
+    float angle = randomFloat(seed) * 6.28318530718;
+    vec3 direction = vec3(sqrt(1.0 - z * z) * vec2(cos(angle), sin(angle)), z);
+    vec3 offset = direction * emitter.positionRadius.w * pow(randomFloat(seed), 1.0 / 3.0);
+    vec3 deviation = vec3(randomFloat(seed), randomFloat(seed), randomFloat(seed)) * 2.0 - 1.0;
+
+    GpuParticle particle;
+    particle.position = emitter.positionRadius.xyz + offset;
+    particle.age = 0.0;
+    particle.velocity = emitter.velocitySpread.xyz + deviation * emitter.velocitySpread.w;
+    particle.lifetime = mix(emitter.lifetime.x, emitter.lifetime.y, randomFloat(seed));
+    particle.startColor = packUnorm4x8(emitter.startColor);
+    particle.endColor = packUnorm4x8(emitter.endColor);
+    particle.startSize = emitter.size.x;
+    particle.endSize = emitter.size.y;
+
+    // The begin step already reserved both ranges, so no atomics are needed here
+    uint index = deadList[counters.deadCount + spawn];
+    particles[index] = particle;
+    aliveList[counters.aliveCounts[emit.parity] - counters.spawnCount + spawn] = index;
+}
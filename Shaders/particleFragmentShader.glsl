@@ -0,0 +1,13 @@
+#version 450
+#pragma shader_stage(fragment)
+
+layout(location = 0) in vec4 fragColor;
+layout(location = 1) in vec2 fragCorner;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    // Soft round sprite, fading out towards the quad's inscribed circle
+    float falloff = clamp(1.0 - dot(fragCorner, fragCorner), 0.0, 1.0);
+    outColor = vec4(fragColor.rgb, fragColor.a * falloff);
+}
@@ -0,0 +1,36 @@
+#version 450
+#pragma shader_stage(compute)
+
+#include "Particles.glslh"
+
+// Writes the billboards of the live particles in drawing order, the draw then reads them by instance index
+
+layout(local_size_x = PARTICLE_GROUP_SIZE) in;
+
+layout(std430, binding = 1) readonly buffer ParticleBuffer {
+    GpuParticle particles[];
+};
+
+layout(std430, binding = 2) readonly buffer AliveListBuffer {
+    uint aliveList[];
+};
+
+layout(std430, binding = 3) writeonly buffer DrawDataBuffer {
+    ParticleDrawData drawData[];
+};
+
+// Must match ParticleGatherConstants
+layout(push_constant) uniform ParticleGatherConstants {
+    uint parity; // Of the list the simulation read, the gathered one is the other
+} gather;
+
+void main() {
+    uint slot = gl_GlobalInvocationID.x;
+    if (slot >= counters.aliveCounts[1u - gather.parity])
+        return;
+
+    GpuParticle particle = particles[aliveList[slot]];
+    float progress = clamp(particle.age / particle.lifetime, 0.0, 1.0);
+    drawData[slot].positionSize = vec4(particle.position, mix(particle.startSize, particle.endSize, progress));
+    drawData[slot].color = mix(unpackUnorm4x8(particle.startColor), unpackUnorm4x8(particle.endColor), progress);
+}
@@ -0,0 +1,121 @@
+#version 450
+#pragma shader_stage(compute)
+
+#include "Particles.glslh"
+
+// Ages, moves and collides every live particle. Survivors are appended to the next alive list, together with
+// their sort key, and expired particles go back to the dead list.
+
+layout(local_size_x = PARTICLE_GROUP_SIZE) in;
+
+layout(std430, binding = 1) buffer ParticleBuffer {
+    GpuParticle particles[];
+};
+
+layout(std430, binding = 2) buffer DeadListBuffer {
+    uint deadList[];
+};
+
+layout(std430, binding = 3) readonly buffer CurrentAliveListBuffer {
+    uint currentAlive[];
+};
+
+layout(std430, binding = 4) writeonly buffer NextAliveListBuffer {
+    uint nextAlive[];
+};
+
+layout(std430, binding = 5) writeonly buffer SortKeyBuffer {
+    uint sortKeys[];
+};
+
+layout(binding = 6) uniform sampler2D depthBuffer;
+
+// Must match ParticleSimulateConstants
+layout(push_constant) uniform ParticleSimulateConstants {
+    mat4 view;
+    vec4 projection; // P00, P11, near plane
+    vec4 gravityDrag; // Acceleration and velocity lost per second
+    vec2 viewportSize;
+    float deltaTime;
+    float collisionThickness; // Particles this far behind the depth buffer's surface still collide with it
+    float restitution;
+    uint parity;
+    uint collide;
+    uint sort;
+} simulation;
+
+// View space point on the depth buffer's surface at a pixel, reverse-Z infinite projection
+vec3 reconstructViewPosition(ivec2 pixel, out bool valid) {
+    float depth = texelFetch(depthBuffer, pixel, 0).r;
+    valid = depth > 0.0; // Cleared to 0, nothing was drawn there
+    float forward = simulation.projection.z / max(depth, 1e-6);
+    vec2 ndc = (vec2(pixel) + 0.5) / simulation.viewportSize * 2.0 - 1.0;
+    return vec3(ndc * forward / simulation.projection.xy, -forward);
+}
+
+void collide(inout vec3 position, inout vec3 velocity, vec3 previousPosition) {
+    vec3 viewPosition = (simulation.view * vec4(position, 1.0)).xyz;
+    float forward = -viewPosition.z;
+    if (forward <= simulation.projection.z)
+        return;
+
+    vec2 ndc = simulation.projection.xy * viewPosition.xy / forward;
+    if (any(greaterThanEqual(abs(ndc), vec2(1.0))))
+        return;
+
+    ivec2 size = ivec2(simulation.viewportSize);
+    ivec2 pixel = clamp(ivec2((ndc * 0.5 + 0.5) * simulation.viewportSize), ivec2(0), size - 2);
+    bool valid;
+    vec3 surface = reconstructViewPosition(pixel, valid);
+    float surfaceForward = -surface.z;
+    if (!valid || forward < surfaceForward || forward > surfaceForward + simulation.collisionThickness)
+        return;
+
+    // Normal from the neighbouring texels, turned towards the camera
+    bool validX;
+    bool validY;
+    vec3 surfaceX = reconstructViewPosition(pixel + ivec2(1, 0), validX);
+    vec3 surfaceY = reconstructViewPosition(pixel + ivec2(0, 1), validY);
+    if (!validX || !validY)
+        return;
+    vec3 normal = normalize(cross(surfaceX - surface, surfaceY - surface));
+    if (dot(normal, surface) > 0.0)
+        normal = -normal;
+    normal = transpose(mat3(simulation.view)) * normal;
+
+    position = previousPosition;
+    if (dot(velocity, normal) < 0.0)
+        velocity = reflect(velocity, normal) * simulation.restitution;
+}
+
+void main() {
+    uint slot = gl_GlobalInvocationID.x;
+    if (slot >= counters.aliveCounts[simulation.parity])
+        return;
+
+    uint index = currentAlive[slot];
+    GpuParticle particle = particles[index];
+    particle.age += simulation.deltaTime;
+    if (particle.age >= particle.lifetime) {
+        deadList[atomicAdd(counters.deadCount, 1u)] = index;
+        return;
+    }
+
+    vec3 previousPosition = particle.position;
+    particle.velocity += simulation.gravityDrag.xyz * simulation.deltaTime;
+    particle.velocity *= max(1.0 - simulation.gravityDrag.w * simulation.deltaTime, 0.0);
+    particle.position += particle.velocity * simulation.deltaTime;
+    if (simulation.collide != 0u)
+        collide(particle.position, particle.velocity, previousPosition);
+    particles[index] = particle;
+
+    uint next = atomicAdd(counters.aliveCounts[1u - simulation.parity], 1u);
+    nextAlive[next] = index;
+
+    // Back to front: the farthest particle gets the smallest key. Half floats keep the order of positive
+    // distances in 15 bits, the unused keys were cleared to the maximum so they sort behind all live ones.
+    if (simulation.sort != 0u) {
+        float distance = max(-(simulation.view * vec4(particle.position, 1.0)).z, 0.0);
+        sortKeys[next] = 0x7FFFu - min(packHalf2x16(vec2(distance, 0.0)) & 0xFFFFu, 0x7FFFu);
+    }
+}
@@ -0,0 +1,39 @@
+#version 450
+#pragma shader_stage(vertex)
+
+// Camera facing quad per instance, built from gl_VertexIndex without any vertex buffer
+
+struct ParticleDrawData {
+    vec4 positionSize;
+    vec4 color;
+};
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragCorner;
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+layout(std430, binding = 1) readonly buffer DrawDataBuffer {
+    ParticleDrawData particles[];
+};
+
+// Two clockwise triangles, matching the pipelines' front face
+const vec2 CORNERS[6] = vec2[](
+    vec2(-1.0, -1.0), vec2(-1.0, 1.0), vec2(1.0, -1.0),
+    vec2(1.0, -1.0), vec2(-1.0, 1.0), vec2(1.0, 1.0)
+);
+
+void main() {
+    ParticleDrawData particle = particles[gl_InstanceIndex];
+    vec2 corner = CORNERS[gl_VertexIndex];
+
+    vec4 viewPosition = ubo.view * vec4(particle.positionSize.xyz, 1.0);
+    viewPosition.xy += corner * particle.positionSize.w * 0.5;
+    gl_Position = ubo.proj * viewPosition;
+
+    fragColor = particle.color;
+    fragCorner = corner;
+}
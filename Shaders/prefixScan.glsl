@@ -0,0 +1,101 @@
+#version 450
+#pragma shader_stage(compute)
+
+// Single pass exclusive prefix sum with decoupled look-back. Every tile publishes its own sum right away, then
+// walks back over its predecessors until one has published its inclusive prefix. Tiles take their index from an
+// atomic counter, so every tile that is waited on has already started running.
+
+#define GROUP_SIZE 256
+#define ITEMS_PER_THREAD 4
+#define TILE_SIZE (GROUP_SIZE * ITEMS_PER_THREAD)
+
+layout(local_size_x = GROUP_SIZE) in;
+
+layout(std430, binding = 0) readonly buffer InputBuffer {
+    uint inputs[];
+};
+
+layout(std430, binding = 1) writeonly buffer OutputBuffer {
+    uint outputs[];
+};
+
+// [0] hands out tile indices, [1 + tile] is the tile's state: a flag in the top two bits and a 30 bit sum below.
+// Has to be zeroed before every scan.
+layout(std430, binding = 2) coherent buffer TileStateBuffer {
+    uint tileStates[];
+};
+
+// Must match ScanConstants
+layout(push_constant) uniform ScanConstants {
+    uint count;
+} scan;
+
+const uint FLAG_AGGREGATE = 1u << 30; // Sum of the tile alone
+const uint FLAG_PREFIX = 2u << 30; // Sum of the tile and everything before it
+const uint FLAG_MASK = 3u << 30;
+const uint VALUE_MASK = ~FLAG_MASK;
+
+shared uint tileIndex;
+shared uint threadSums[GROUP_SIZE];
+shared uint tilePrefix;
+
+void main() {
+    uint local = gl_LocalInvocationIndex;
+    if (local == 0)
+        tileIndex = atomicAdd(tileStates[0], 1u);
+    barrier();
+    uint tile = tileIndex;
+
+    // Every thread owns consecutive items, their sum goes into the tile wide scan
+    uint first = tile * TILE_SIZE + local * ITEMS_PER_THREAD;
+    uint items[ITEMS_PER_THREAD];
+    uint threadSum = 0;
+    for (uint i = 0; i < ITEMS_PER_THREAD; i++) {
+        uint index = first + i;
+        items[i] = index < scan.count ? inputs[index] : 0u;
+        threadSum += items[i];
+    }
+
+    threadSums[local] = threadSum;
+    barrier();
+    for (uint offset = 1; offset < GROUP_SIZE; offset <<= 1) {
+        uint value = local >= offset ? threadSums[local - offset] : 0u;
+        barrier();
+        threadSums[local] += value;
+        barrier();
+    }
+    uint tileSum = threadSums[GROUP_SIZE - 1];
+
+    // States are only touched through atomics, which keeps the flag and the sum of a tile consistent
+    if (local == 0) {
+        uint prefix = 0;
+        if (tile == 0) {
+            atomicExchange(tileStates[1], FLAG_PREFIX | tileSum);
+        } else {
+            atomicExchange(tileStates[1 + tile], FLAG_AGGREGATE | tileSum);
+            int previous = int(tile) - 1;
+            while (previous >= 0) {
+                uint state = atomicOr(tileStates[1 + previous], 0u);
+                uint flag = state & FLAG_MASK;
+                if (flag == 0u)
+                    continue; // Not published yet
+
+                prefix += state & VALUE_MASK;
+                if (flag == FLAG_PREFIX)
+                    break;
+                previous--;
+            }
+            atomicExchange(tileStates[1 + tile], FLAG_PREFIX | (prefix + tileSum));
+        }
+        tilePrefix = prefix;
+    }
+    barrier();
+
+    uint running = tilePrefix + threadSums[local] - threadSum;
+    for (uint i = 0; i < ITEMS_PER_THREAD; i++) {
+        uint index = first + i;
+        if (index < scan.count)
+            outputs[index] = running;
+        running += items[i];
+    }
+}
@@ -0,0 +1,34 @@
+#version 450
+#pragma shader_stage(compute)
+
+#include "RadixSort.glslh"
+
+// Counts the digits of every tile. The table is digit major, so its exclusive scan yields where each tile's
+// elements of each digit start in the sorted output.
+
+layout(local_size_x = RADIX_GROUP_SIZE) in;
+
+layout(std430, binding = 0) readonly buffer KeyBuffer {
+    uint keys[];
+};
+
+layout(std430, binding = 1) writeonly buffer DigitCountBuffer {
+    uint digitCounts[];
+};
+
+shared uint counts[RADIX_DIGITS];
+
+void main() {
+    uint local = gl_LocalInvocationIndex;
+    if (local < RADIX_DIGITS)
+        counts[local] = 0;
+    barrier();
+
+    uint index = gl_GlobalInvocationID.x;
+    if (index < sort.count)
+        atomicAdd(counts[extractDigit(keys[index * sort.keyWords + (sort.shift >> 5)])], 1u);
+    barrier();
+
+    if (local < RADIX_DIGITS)
+        digitCounts[local * sort.tileCount + gl_WorkGroupID.x] = counts[local];
+}
@@ -0,0 +1,95 @@
+#version 450
+#pragma shader_stage(compute)
+
+#include "RadixSort.glslh"
+
+// Sorts a tile by the pass's digit with stable one bit splits in shared memory, then moves every element to the
+// start of its digit for this tile plus its rank among the tile's elements with that digit. Stable, so the
+// earlier passes' order survives within equal digits.
+
+layout(local_size_x = RADIX_GROUP_SIZE) in;
+
+layout(std430, binding = 0) readonly buffer KeyInputBuffer {
+    uint keysIn[];
+};
+
+layout(std430, binding = 1) readonly buffer ValueInputBuffer {
+    uint valuesIn[];
+};
+
+// Exclusive scan of the digit counts
+layout(std430, binding = 2) readonly buffer DigitOffsetBuffer {
+    uint digitOffsets[];
+};
+
+layout(std430, binding = 3) writeonly buffer KeyOutputBuffer {
+    uint keysOut[];
+};
+
+layout(std430, binding = 4) writeonly buffer ValueOutputBuffer {
+    uint valuesOut[];
+};
+
+shared uint order[RADIX_GROUP_SIZE]; // Tile elements in the order sorted so far
+shared uint digits[RADIX_GROUP_SIZE];
+shared uint scanned[RADIX_GROUP_SIZE];
+shared uint counts[RADIX_DIGITS];
+shared uint starts[RADIX_DIGITS];
+
+void main() {
+    uint local = gl_LocalInvocationIndex;
+    uint tileStart = gl_WorkGroupID.x * RADIX_GROUP_SIZE;
+    uint index = tileStart + local;
+
+    // Elements past the end only exist in the last tile and sort behind all valid elements of the last digit
+    bool valid = index < sort.count;
+    uint digit = valid ? extractDigit(keysIn[index * sort.keyWords + (sort.shift >> 5)]) : RADIX_DIGITS - 1u;
+    digits[local] = digit;
+    order[local] = local;
+    if (local < RADIX_DIGITS)
+        counts[local] = 0;
+    barrier();
+    if (valid)
+        atomicAdd(counts[digit], 1u);
+
+    for (uint bit = 0; bit < RADIX_BITS; bit++) {
+        uint element = order[local];
+        uint isSet = (digits[element] >> bit) & 1u;
+        scanned[local] = 1u - isSet;
+        barrier();
+        for (uint offset = 1; offset < RADIX_GROUP_SIZE; offset <<= 1) {
+            uint value = local >= offset ? scanned[local - offset] : 0u;
+            barrier();
+            scanned[local] += value;
+            barrier();
+        }
+
+        uint zerosBefore = scanned[local] - (1u - isSet);
+        uint zeros = scanned[RADIX_GROUP_SIZE - 1];
+        uint position = isSet == 0u ? zerosBefore : zeros + local - zerosBefore;
+        barrier();
+        order[position] = element;
+        barrier();
+    }
+
+    if (local == 0) {
+        uint start = 0;
+        for (uint i = 0; i < RADIX_DIGITS; i++) {
+            starts[i] = start;
+            start += counts[i];
+        }
+    }
+    barrier();
+
+    uint element = order[local];
+    uint source = tileStart + element;
+    if (source >= sort.count)
+        return;
+
+    uint elementDigit = digits[element];
+    uint destination = digitOffsets[elementDigit * sort.tileCount + gl_WorkGroupID.x] + local - starts[elementDigit];
+    for (uint word = 0; word < sort.keyWords; word++)
+        keysOut[destination * sort.keyWords + word] = keysIn[source * sort.keyWords + word];
+    if (sort.hasValues != 0u)
+        valuesOut[destination] = valuesIn[source];
+}
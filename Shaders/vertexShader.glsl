@@ -1,18 +1,28 @@
 #version 450
 #pragma shader_stage(vertex)
 
-layout(location = 0) in vec2 inPosition;
+#include "Objects.glslh"
+#include "PushConstants.glslh"
+
+layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
 
 layout(location = 0) out vec3 fragColor;
 
 layout(binding = 0) uniform UniformBufferObject {
-    mat4 model;
     mat4 view;
     mat4 proj;
 } ubo;
 
+layout(std430, binding = 1) readonly buffer ObjectBuffer {
+    GpuObject objects[];
+};
+
+// The shading pass has to reproduce the depth pre-pass depth exactly, otherwise visible fragments fail the test
+invariant gl_Position;
+
 void main() {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 0.0, 1.0);
+    mat4 model = draw.objectIndex == INDIRECT_OBJECT_INDEX ? objects[gl_InstanceIndex].model : draw.model;
+    gl_Position = ubo.proj * ubo.view * model * vec4(inPosition, 1.0);
     fragColor = inColor;
 }
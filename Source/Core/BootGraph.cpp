@@ -0,0 +1,185 @@
+#include "BootGraph.h"
+
+#include <algorithm>
+#include <deque>
+#include <fstream>
+
+#include "Utility/Corvus.h"
+#include "Utility/Log.h"
+
+namespace Corvus
+{
+    BootGraph::BootGraph(ThreadPool& threadPool)
+        : m_ThreadPool(threadPool), m_Start(std::chrono::steady_clock::now())
+    {
+    }
+
+    void BootGraph::addPhase(const std::string& name, const std::vector<std::string>& dependencies, Affinity affinity,
+                             std::function<void()> work)
+    {
+        size_t index = m_Phases.size();
+        m_Phases.push_back({
+            .name = name,
+            .affinity = affinity,
+            .work = std::move(work)
+        });
+
+        for (const auto& dependency: dependencies)
+            m_UnresolvedDependencies.emplace_back(index, dependency);
+    }
+
+    void BootGraph::resolveDependencies()
+    {
+        for (const auto& [index, dependency]: m_UnresolvedDependencies)
+        {
+            auto it = std::ranges::find(m_Phases, dependency, &Phase::name);
+            CORVUS_ASSERT(it != m_Phases.end(), "Boot phase [{}] depends on unknown phase [{}]!", m_Phases[index].name,
+                          dependency)
+
+            it->dependents.push_back(index);
+            m_Phases[index].pendingDependencies++;
+        }
+        m_UnresolvedDependencies.clear();
+    }
+
+    void BootGraph::run()
+    {
+        resolveDependencies();
+        {
+            std::lock_guard lock(m_Mutex);
+            threadIndex(std::this_thread::get_id()); // The calling thread is always thread 0
+        }
+
+        std::deque<size_t> mainThreadReady;
+        size_t runningWorkers = 0;
+        size_t finished = 0;
+
+        auto schedule = [&](size_t index)
+        {
+            if (m_Phases[index].affinity == Affinity::MainThread)
+            {
+                mainThreadReady.push_back(index);
+                return;
+            }
+            runningWorkers++;
+            m_ThreadPool.submit([this, index] { execute(index); });
+        };
+
+        for (size_t i = 0; i < m_Phases.size(); i++)
+        {
+            if (m_Phases[i].pendingDependencies == 0)
+                schedule(i);
+        }
+
+        while (finished < m_Phases.size())
+        {
+            if (not mainThreadReady.empty())
+            {
+                size_t index = mainThreadReady.front();
+                mainThreadReady.pop_front();
+                execute(index);
+            }
+            else
+            {
+                CORVUS_ASSERT(runningWorkers > 0, "Boot graph contains a dependency cycle!")
+                std::unique_lock lock(m_Mutex);
+                m_Completed.wait(lock, [this] { return not m_CompletedPhases.empty(); });
+            }
+
+            std::vector<size_t> completed;
+            {
+                std::lock_guard lock(m_Mutex);
+                completed.swap(m_CompletedPhases);
+            }
+
+            for (size_t index: completed)
+            {
+                finished++;
+                if (m_Phases[index].affinity == Affinity::Worker)
+                    runningWorkers--;
+
+                for (size_t dependent: m_Phases[index].dependents)
+                {
+                    if (--m_Phases[dependent].pendingDependencies == 0)
+                        schedule(dependent);
+                }
+            }
+        }
+
+        CORVUS_LOG(info, "Boot graph finished {} phases in {} us", m_Phases.size(), now().count());
+    }
+
+    void BootGraph::execute(size_t phaseIndex)
+    {
+        const auto& phase = m_Phases[phaseIndex];
+
+        auto start = now();
+        phase.work();
+        auto end = now();
+
+        std::lock_guard lock(m_Mutex);
+        m_Timeline.push_back({
+            .name = phase.name,
+            .affinity = phase.affinity,
+            .thread = threadIndex(std::this_thread::get_id()),
+            .start = start,
+            .end = end
+        });
+        m_CompletedPhases.push_back(phaseIndex);
+        m_Completed.notify_one();
+    }
+
+    void BootGraph::markFirstFrame()
+    {
+        if (m_FirstFrame.has_value())
+            return;
+
+        m_FirstFrame = now();
+        CORVUS_LOG(info, "Time to first frame: {} us", m_FirstFrame->count());
+    }
+
+    void BootGraph::exportTimeline(const std::string& path) const
+    {
+        // Chrome trace event format, can be opened in chrome://tracing or Perfetto
+        std::ofstream file(path, std::ios::trunc);
+        if (not file.is_open())
+        {
+            CORVUS_LOG(error, "Failed to open boot timeline file: {}", path);
+            return;
+        }
+
+        file << "{\"traceEvents\":[\n";
+        for (size_t i = 0; i < m_Timeline.size(); i++)
+        {
+            const auto& record = m_Timeline[i];
+            file << "{\"name\":\"" << record.name << "\",\"cat\":\"boot\",\"ph\":\"X\",\"pid\":0"
+                 << ",\"tid\":" << record.thread
+                 << ",\"ts\":" << record.start.count()
+                 << ",\"dur\":" << (record.end - record.start).count() << "}";
+            file << (i + 1 < m_Timeline.size() or m_FirstFrame.has_value() ? ",\n" : "\n");
+        }
+        if (m_FirstFrame.has_value())
+        {
+            file << "{\"name\":\"FirstFrame\",\"cat\":\"boot\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0"
+                 << ",\"ts\":" << m_FirstFrame->count() << "}\n";
+        }
+        file << "]}\n";
+
+        CORVUS_LOG(info, "Boot timeline exported to {}", path);
+    }
+
+    std::chrono::microseconds BootGraph::now() const
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_Start);
+    }
+
+    uint32_t BootGraph::threadIndex(std::thread::id id)
+    {
+        auto it = std::ranges::find(m_Threads, id);
+        if (it != m_Threads.end())
+            return static_cast<uint32_t>(it - m_Threads.begin());
+
+        m_Threads.push_back(id);
+        return static_cast<uint32_t>(m_Threads.size() - 1);
+    }
+} // Corvus
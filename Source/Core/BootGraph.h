@@ -0,0 +1,77 @@
+#ifndef ENGINE_BOOTGRAPH_H
+#define ENGINE_BOOTGRAPH_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Utility/ThreadPool.h"
+
+namespace Corvus
+{
+    // Startup expressed as a dependency graph of named phases. Worker phases are handed to the
+    // thread pool as soon as their dependencies are done, main thread phases (GLFW, swapchain)
+    // run on the thread calling run(). Every phase is recorded so the boot timeline can be exported.
+    class BootGraph
+    {
+    public:
+        enum class Affinity { MainThread, Worker };
+
+        struct PhaseRecord
+        {
+            std::string name;
+            Affinity affinity;
+            uint32_t thread;
+            std::chrono::microseconds start;
+            std::chrono::microseconds end;
+        };
+
+        explicit BootGraph(ThreadPool& threadPool = ThreadPool::getInstance());
+
+        void addPhase(const std::string& name, const std::vector<std::string>& dependencies, Affinity affinity,
+                      std::function<void()> work);
+        void run();
+
+        void markFirstFrame();
+        void exportTimeline(const std::string& path) const;
+
+        [[nodiscard]] const std::vector<PhaseRecord>& getTimeline() const { return m_Timeline; }
+        [[nodiscard]] std::optional<std::chrono::microseconds> getTimeToFirstFrame() const { return m_FirstFrame; }
+
+    private:
+        struct Phase
+        {
+            std::string name;
+            Affinity affinity;
+            std::function<void()> work;
+            std::vector<size_t> dependents;
+            size_t pendingDependencies = 0;
+        };
+
+        ThreadPool& m_ThreadPool;
+        std::vector<Phase> m_Phases;
+        std::vector<std::pair<size_t, std::string>> m_UnresolvedDependencies;
+
+        std::chrono::steady_clock::time_point m_Start;
+        std::vector<PhaseRecord> m_Timeline;
+        std::optional<std::chrono::microseconds> m_FirstFrame;
+        std::vector<std::thread::id> m_Threads;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_Completed;
+        std::vector<size_t> m_CompletedPhases;
+
+    private:
+        void resolveDependencies();
+        void execute(size_t phaseIndex);
+        [[nodiscard]] std::chrono::microseconds now() const;
+        uint32_t threadIndex(std::thread::id id);
+    };
+} // Corvus
+
+#endif //ENGINE_BOOTGRAPH_H
@@ -8,29 +8,156 @@ namespace Corvus
     Engine::Engine()
     {
         CORVUS_LOG(info, "Initializing engine");
-        m_Window = std::make_shared<Window>("Corvus Engine", false, 800, 600,"Resources/icon.png");
+
+        using enum BootGraph::Affinity;
+        WindowIcon icon;
+        std::vector<char> vertexCode;
+        std::vector<char> fragmentCode;
 
         auto renderSpec = RendererSpecification{
             RendererSpecification::API::Vulkan,
-            m_Window,
+            nullptr,
             "Shaders/vertexShader.glsl.spv",
             "Shaders/fragmentShader.glsl.spv"
         };
 
-        m_Renderer = std::make_unique<Renderer>(renderSpec);
+        // GLFW and the swapchain have to stay on the main thread, file IO and pipeline compilation do not
+        m_Boot.addPhase("Window", {}, MainThread, [this]
+        {
+            m_Window = std::make_shared<Window>("Corvus Engine", false, 800, 600);
+        });
+        m_Boot.addPhase("IconDecode", {}, Worker, [&icon]
+        {
+            icon = Window::loadIcon("Resources/icon.png");
+        });
+        m_Boot.addPhase("WindowIcon", {"Window", "IconDecode"}, MainThread, [this, &icon]
+        {
+            m_Window->setIcon(icon);
+        });
+        m_Boot.addPhase("ShaderLoad", {}, Worker, [&]
+        {
+            vertexCode = Pipeline::readFile(renderSpec.vertexShader);
+            fragmentCode = Pipeline::readFile(renderSpec.fragmentShader);
+        });
+        m_Boot.addPhase("Device", {"Window"}, MainThread, [this, &renderSpec]
+        {
+            renderSpec.window = m_Window;
+            m_Renderer = std::make_unique<Renderer>(renderSpec);
+            m_Renderer->createDevice();
+        });
+        m_Boot.addPhase("Pipeline", {"Device", "ShaderLoad"}, Worker, [&]
+        {
+            m_Renderer->createPipeline(vertexCode, fragmentCode);
+        });
+        m_Boot.addPhase("Geometry", {"Device"}, Worker, [this, &renderSpec]
+        {
+            m_Quad = addObject(m_Renderer->createMesh(renderSpec.vertices, renderSpec.indices), glm::mat4(1.0f));
+        });
+        m_Boot.addPhase("FrameResources", {"Pipeline", "Geometry"}, MainThread, [this]
+        {
+            m_Renderer->createFrameResources();
+        });
+
+        m_Boot.run();
     }
 
-    void Engine::run() const
+    void Engine::run()
     {
         CORVUS_LOG(info, "Starting engine loop");
 
+        m_StartTime = std::chrono::steady_clock::now();
         while (not m_Window->shouldClose() and glfwGetKey(m_Window->getHandle(), GLFW_KEY_ESCAPE) != GLFW_PRESS)
         {
+            submitScene();
             m_Renderer->draw();
+            if (not m_Boot.getTimeToFirstFrame().has_value())
+            {
+                m_Boot.markFirstFrame();
+                m_Boot.exportTimeline("boot_timeline.json");
+            }
             m_Window->update();
         }
         m_Renderer->waitIdle();
     }
 
+    CullHandle Engine::addObject(MeshHandle mesh, const glm::mat4& model)
+    {
+        AABB bounds = m_Renderer->getMesh(mesh).getBounds().transform(model);
+        CullHandle handle = m_Culler.add(bounds);
+        if (handle >= m_Objects.size())
+            m_Objects.resize(handle + 1);
+
+        m_Objects[handle] = {mesh, model, m_SceneTree.insert(bounds, handle), bounds};
+        return handle;
+    }
+
+    void Engine::setTransform(CullHandle object, const glm::mat4& model)
+    {
+        auto& sceneObject = m_Objects[object];
+        sceneObject.model = model;
+        sceneObject.bounds = m_Renderer->getMesh(sceneObject.mesh).getBounds().transform(model);
+
+        m_Culler.update(object, sceneObject.bounds);
+        m_SceneTree.update(sceneObject.proxy, sceneObject.bounds);
+    }
+
+    OccluderHandle Engine::addOccluder(std::vector<glm::vec3> positions, std::vector<uint32_t> indices,
+                                       const glm::mat4& model)
+    {
+        return m_OcclusionCuller.addOccluder(std::move(positions), std::move(indices), model);
+    }
+
+    std::optional<CullHandle> Engine::pick(const Ray& ray) const
+    {
+        auto hit = m_SceneTree.raycast(ray);
+        return hit.has_value() ? std::optional(hit->userData) : std::nullopt;
+    }
+
+    void Engine::queryObjects(const BoundingSphere& sphere, std::vector<CullHandle>& objects) const
+    {
+        m_SceneTree.querySphere(sphere, objects);
+    }
+
+    void Engine::queryObjects(const AABB& box, std::vector<CullHandle>& objects) const
+    {
+        m_SceneTree.queryBox(box, objects);
+    }
+
+    void Engine::submitScene()
+    {
+        float time = std::chrono::duration<float>(std::chrono::steady_clock::now() - m_StartTime).count();
+        setTransform(m_Quad, rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
+
+        m_SceneTree.rebuildIfDegraded();
+
+        // Only what survives culling reaches the render queue
+        glm::mat4 viewProjection = m_Renderer->getViewProjection();
+        m_Culler.cull(Frustum::fromMatrix(viewProjection), m_VisibleObjects);
+
+        if (m_OcclusionCuller.getOccluderCount() > 0)
+        {
+            m_OcclusionCuller.render(viewProjection);
+
+            m_VisibleBounds.clear();
+            for (CullHandle handle: m_VisibleObjects)
+                m_VisibleBounds.push_back(m_Objects[handle].bounds);
+            m_OcclusionCuller.cull(m_VisibleObjects, m_VisibleBounds);
+        }
+
+        const auto& camera = m_Renderer->getCamera();
+        for (CullHandle handle: m_VisibleObjects)
+        {
+            auto& object = m_Objects[handle];
+            object.lod = m_Renderer->selectLod(object.mesh, object.model, object.lod);
+            m_Renderer->getRenderQueue().submit({
+                .mesh = object.mesh,
+                .depth = camera.getViewDepth(glm::vec3(object.model[3])),
+                .model = object.model,
+                .objectIndex = handle,
+                .lod = object.lod,
+            });
+        }
+    }
+
     Engine::~Engine() = default;
-}
\ No newline at end of file
+}
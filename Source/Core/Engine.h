@@ -1,24 +1,65 @@
 #ifndef ENGINE_ENGINE_H
 #define ENGINE_ENGINE_H
 
+#include <chrono>
 #include <memory>
 #include "Window.h"
+#include "BootGraph.h"
 #include "Graphic/Vulkan/Device.h"
 #include "Graphic/Vulkan/Pipeline.h"
 #include "Renderer/Renderer.h"
+#include "Culling/DynamicBVH.h"
+#include "Culling/FrustumCuller.h"
+#include "Culling/SoftwareOcclusionCuller.h"
 
 namespace Corvus
 {
+    struct SceneObject
+    {
+        MeshHandle mesh = 0;
+        glm::mat4 model = glm::mat4(1.0f);
+        ProxyHandle proxy = 0;
+        AABB bounds; // World space
+        uint32_t lod = 0; // Level of detail drawn last frame
+    };
+
     class Engine
     {
     public:
         Engine();
         ~Engine();
 
-        void run() const;
+        void run();
+
+        // Spatial queries over the scene's world space bounds, objects are identified by their cull handle
+        [[nodiscard]] std::optional<CullHandle> pick(const Ray& ray) const;
+        void queryObjects(const BoundingSphere& sphere, std::vector<CullHandle>& objects) const;
+        void queryObjects(const AABB& box, std::vector<CullHandle>& objects) const;
+
+        // Simplified stand-ins for large static geometry. While any exist, objects behind them are culled on the
+        // CPU before submission, the alternative to RendererSpecification::occlusionCulling for weak GPUs.
+        OccluderHandle addOccluder(std::vector<glm::vec3> positions, std::vector<uint32_t> indices,
+                                   const glm::mat4& model);
+
     private:
+        BootGraph m_Boot;
         std::shared_ptr<Window> m_Window;
         std::unique_ptr<Renderer> m_Renderer;
+
+        // Indexed by cull handle
+        std::vector<SceneObject> m_Objects;
+        FrustumCuller m_Culler;
+        DynamicBVH m_SceneTree;
+        SoftwareOcclusionCuller m_OcclusionCuller;
+        std::vector<CullHandle> m_VisibleObjects;
+        std::vector<AABB> m_VisibleBounds;
+        CullHandle m_Quad = 0;
+        std::chrono::steady_clock::time_point m_StartTime;
+
+    private:
+        CullHandle addObject(MeshHandle mesh, const glm::mat4& model);
+        void setTransform(CullHandle object, const glm::mat4& model);
+        void submitScene();
     };
 } // Corvus
 
@@ -46,7 +46,8 @@ namespace Corvus
             glfwSetFramebufferSizeCallback(m_Window, resizeCallback);
             glfwSetErrorCallback(glfwErrorCallback);
 
-            setIcon(iconPath);
+            if (not iconPath.empty())
+                setIcon(loadIcon(iconPath));
 
             CORVUS_ASSERT(m_Window, "Failed to create window!");
         }
@@ -83,17 +84,28 @@ namespace Corvus
         userWindow->m_Height = static_cast<uint32_t>(height);
     }
 
-    void Window::setIcon(const std::string& iconPath) const
+    WindowIcon Window::loadIcon(const std::string& iconPath)
     {
-        if (iconPath.empty())
-            return;
-
-        GLFWimage icon;
+        WindowIcon icon;
         int channels;
 
-        icon.pixels = stbi_load(iconPath.c_str(), &icon.width, &icon.height, &channels, 4);
-        glfwSetWindowIcon(m_Window, 1, &icon);
-        stbi_image_free(icon.pixels);
+        icon.pixels = {stbi_load(iconPath.c_str(), &icon.width, &icon.height, &channels, 4), stbi_image_free};
+        if (not icon.pixels)
+            CORVUS_LOG(error, "Failed to load window icon: {}", iconPath);
+        return icon;
+    }
+
+    void Window::setIcon(const WindowIcon& icon) const
+    {
+        if (not icon.pixels)
+            return;
+
+        GLFWimage image = {
+            .width = icon.width,
+            .height = icon.height,
+            .pixels = icon.pixels.get()
+        };
+        glfwSetWindowIcon(m_Window, 1, &image);
     }
 
 } // Corvus
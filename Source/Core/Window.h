@@ -3,11 +3,19 @@
 
 #define GLFW_INCLUDE_VULKAN
 
+#include <memory>
 #include <string>
 #include "GLFW/glfw3.h"
 
 namespace Corvus
 {
+    // Decoded icon pixels, can be loaded on any thread and applied to the window later
+    struct WindowIcon
+    {
+        int width = 0;
+        int height = 0;
+        std::unique_ptr<unsigned char, void (*)(void*)> pixels = {nullptr, nullptr};
+    };
 
     class Window
     {
@@ -16,6 +24,8 @@ namespace Corvus
         ~Window();
 
         static void update();
+        static WindowIcon loadIcon(const std::string& iconPath);
+        void setIcon(const WindowIcon& icon) const;
         void resetResized() { m_WasResized = false; }
 
         [[nodiscard]] bool shouldClose() const;
@@ -38,7 +48,6 @@ namespace Corvus
 
     private:
         static void resizeCallback(GLFWwindow* window, int width, int height);
-        void setIcon(const std::string& iconPath) const;
     };
 
 
@@ -0,0 +1,94 @@
+#ifndef ENGINE_BOUNDS_H
+#define ENGINE_BOUNDS_H
+
+#include <limits>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace Corvus
+{
+    struct BoundingSphere;
+
+    struct AABB
+    {
+        glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+        glm::vec3 max = glm::vec3(std::numeric_limits<float>::lowest());
+
+        [[nodiscard]] glm::vec3 getCenter() const { return (min + max) * 0.5f; }
+        [[nodiscard]] glm::vec3 getExtent() const { return (max - min) * 0.5f; }
+        [[nodiscard]] bool isValid() const { return min.x <= max.x and min.y <= max.y and min.z <= max.z; }
+
+        [[nodiscard]] float getSurfaceArea() const
+        {
+            glm::vec3 size = max - min;
+            return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+
+        [[nodiscard]] bool contains(const AABB& other) const
+        {
+            return glm::all(glm::lessThanEqual(min, other.min)) and glm::all(glm::greaterThanEqual(max, other.max));
+        }
+
+        [[nodiscard]] bool intersects(const AABB& other) const
+        {
+            return glm::all(glm::lessThanEqual(min, other.max)) and glm::all(glm::greaterThanEqual(max, other.min));
+        }
+
+        [[nodiscard]] bool intersects(const BoundingSphere& sphere) const;
+
+        [[nodiscard]] static AABB merge(const AABB& a, const AABB& b)
+        {
+            return {glm::min(a.min, b.min), glm::max(a.max, b.max)};
+        }
+
+        void expand(const glm::vec3& point)
+        {
+            min = glm::min(min, point);
+            max = glm::max(max, point);
+        }
+
+        void expand(const AABB& other)
+        {
+            min = glm::min(min, other.min);
+            max = glm::max(max, other.max);
+        }
+
+        // Box around the transformed box, projects the extent onto each world axis instead of transforming 8 corners
+        [[nodiscard]] AABB transform(const glm::mat4& matrix) const
+        {
+            glm::vec3 center = glm::vec3(matrix * glm::vec4(getCenter(), 1.0f));
+            glm::mat3 absolute = glm::mat3(glm::abs(glm::vec3(matrix[0])), glm::abs(glm::vec3(matrix[1])),
+                                           glm::abs(glm::vec3(matrix[2])));
+            glm::vec3 extent = absolute * getExtent();
+            return {center - extent, center + extent};
+        }
+    };
+
+    struct BoundingSphere
+    {
+        glm::vec3 center = glm::vec3(0.0f);
+        float radius = 0.0f;
+
+        [[nodiscard]] static BoundingSphere fromAABB(const AABB& bounds)
+        {
+            return {bounds.getCenter(), glm::length(bounds.getExtent())};
+        }
+
+        [[nodiscard]] BoundingSphere transform(const glm::mat4& matrix) const
+        {
+            float scale = glm::max(glm::length(glm::vec3(matrix[0])),
+                                   glm::max(glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))));
+            return {glm::vec3(matrix * glm::vec4(center, 1.0f)), radius * scale};
+        }
+    };
+
+    inline bool AABB::intersects(const BoundingSphere& sphere) const
+    {
+        glm::vec3 closest = glm::clamp(sphere.center, min, max);
+        glm::vec3 offset = closest - sphere.center;
+        return glm::dot(offset, offset) <= sphere.radius * sphere.radius;
+    }
+} // Corvus
+
+#endif //ENGINE_BOUNDS_H
@@ -0,0 +1,581 @@
+#include "DynamicBVH.h"
+
+#include <algorithm>
+#include <array>
+
+#include "Utility/Corvus.h"
+
+namespace Corvus
+{
+    namespace
+    {
+        enum class Containment { Outside, Intersecting, Inside };
+
+        Containment classify(const Frustum& frustum, const AABB& bounds)
+        {
+            glm::vec3 center = bounds.getCenter();
+            glm::vec3 extent = bounds.getExtent();
+
+            auto result = Containment::Inside;
+            for (const auto& plane: frustum.planes)
+            {
+                glm::vec3 normal = glm::vec3(plane);
+                float distance = glm::dot(normal, center) + plane.w;
+                float radius = glm::dot(glm::abs(normal), extent);
+                if (distance < -radius)
+                    return Containment::Outside;
+                if (distance < radius)
+                    result = Containment::Intersecting;
+            }
+            return result;
+        }
+
+        // Slab test, returns the entry distance or nothing when the ray misses within maxDistance
+        std::optional<float> intersectRay(const AABB& bounds, const glm::vec3& origin, const glm::vec3& inverseDirection,
+                                          float maxDistance)
+        {
+            glm::vec3 t0 = (bounds.min - origin) * inverseDirection;
+            glm::vec3 t1 = (bounds.max - origin) * inverseDirection;
+            glm::vec3 entries = glm::min(t0, t1);
+            glm::vec3 exits = glm::max(t0, t1);
+
+            float entry = std::max(std::max(entries.x, entries.y), std::max(entries.z, 0.0f));
+            float exit = std::min(std::min(exits.x, exits.y), std::min(exits.z, maxDistance));
+            if (entry > exit)
+                return std::nullopt;
+            return entry;
+        }
+    }
+
+    DynamicBVH::DynamicBVH(float margin)
+        : m_Margin(margin)
+    {
+    }
+
+    ProxyHandle DynamicBVH::insert(const AABB& bounds, uint32_t userData)
+    {
+        ProxyHandle proxy;
+        if (not m_FreeProxies.empty())
+        {
+            proxy = m_FreeProxies.back();
+            m_FreeProxies.pop_back();
+        }
+        else
+        {
+            proxy = static_cast<ProxyHandle>(m_Proxies.size());
+            m_Proxies.emplace_back();
+        }
+
+        uint32_t leaf = allocateNode();
+        m_Nodes[leaf].bounds = fatten(bounds);
+        m_Nodes[leaf].proxy = proxy;
+        m_Proxies[proxy] = {bounds, userData, leaf};
+
+        insertLeaf(leaf);
+        m_ProxyCount++;
+        m_ChangesSinceCheck++;
+        return proxy;
+    }
+
+    void DynamicBVH::remove(ProxyHandle proxy)
+    {
+        CORVUS_ASSERT(proxy < m_Proxies.size() and m_Proxies[proxy].node != NULL_NODE, "Invalid BVH proxy {}!", proxy)
+
+        uint32_t leaf = m_Proxies[proxy].node;
+        removeLeaf(leaf);
+        freeNode(leaf);
+
+        m_Proxies[proxy].node = NULL_NODE;
+        m_FreeProxies.push_back(proxy);
+        m_ProxyCount--;
+        m_ChangesSinceCheck++;
+    }
+
+    bool DynamicBVH::update(ProxyHandle proxy, const AABB& bounds)
+    {
+        CORVUS_ASSERT(proxy < m_Proxies.size() and m_Proxies[proxy].node != NULL_NODE, "Invalid BVH proxy {}!", proxy)
+
+        auto& entry = m_Proxies[proxy];
+        entry.bounds = bounds;
+        if (m_Nodes[entry.node].bounds.contains(bounds))
+            return false;
+
+        removeLeaf(entry.node);
+        m_Nodes[entry.node].bounds = fatten(bounds);
+        insertLeaf(entry.node);
+        m_ChangesSinceCheck++;
+        return true;
+    }
+
+    void DynamicBVH::rebuild()
+    {
+        std::vector<uint32_t> proxies;
+        proxies.reserve(m_ProxyCount);
+        for (uint32_t i = 0; i < m_Proxies.size(); i++)
+        {
+            if (m_Proxies[i].node != NULL_NODE)
+                proxies.push_back(i);
+        }
+
+        std::vector<Node> nodes;
+        nodes.reserve(proxies.empty() ? 0 : proxies.size() * 2 - 1);
+        m_Root = proxies.empty() ? NULL_NODE : buildRecursive(proxies, nodes, NULL_NODE);
+        m_Nodes = std::move(nodes);
+        m_FreeNodes.clear();
+
+        m_RebuiltCost = getCost();
+        m_ChangesSinceCheck = 0;
+    }
+
+    bool DynamicBVH::rebuildIfDegraded(float factor)
+    {
+        // Measuring the cost walks every node, only do it once enough of the tree may have changed
+        if (m_ChangesSinceCheck < std::max(64u, m_ProxyCount / 4))
+            return false;
+
+        m_ChangesSinceCheck = 0;
+        if (m_RebuiltCost > 0.0f and getCost() <= m_RebuiltCost * factor)
+            return false;
+
+        rebuild();
+        return true;
+    }
+
+    void DynamicBVH::queryFrustum(const Frustum& frustum, std::vector<uint32_t>& results) const
+    {
+        if (m_Root == NULL_NODE)
+            return;
+
+        std::vector<uint32_t> stack = {m_Root};
+        while (not stack.empty())
+        {
+            const auto& node = m_Nodes[stack.back()];
+            uint32_t index = stack.back();
+            stack.pop_back();
+
+            switch (classify(frustum, node.bounds))
+            {
+            case Containment::Outside:
+                break;
+            case Containment::Inside:
+                // Nothing below can be outside either, skip the plane tests for the whole subtree
+                collectLeaves(index, results);
+                break;
+            case Containment::Intersecting:
+                if (not node.isLeaf())
+                {
+                    stack.push_back(node.children[1]);
+                    stack.push_back(node.children[0]);
+                }
+                else if (frustum.intersects(m_Proxies[node.proxy].bounds))
+                {
+                    results.push_back(m_Proxies[node.proxy].userData);
+                }
+                break;
+            }
+        }
+    }
+
+    void DynamicBVH::queryBox(const AABB& box, std::vector<uint32_t>& results) const
+    {
+        queryOverlaps([&box](const AABB& bounds) { return bounds.intersects(box); }, results);
+    }
+
+    void DynamicBVH::querySphere(const BoundingSphere& sphere, std::vector<uint32_t>& results) const
+    {
+        queryOverlaps([&sphere](const AABB& bounds) { return bounds.intersects(sphere); }, results);
+    }
+
+    std::optional<RayHit> DynamicBVH::raycast(const Ray& ray) const
+    {
+        if (m_Root == NULL_NODE)
+            return std::nullopt;
+
+        glm::vec3 inverseDirection = 1.0f / ray.direction;
+        std::optional<RayHit> closest;
+        float maxDistance = ray.maxDistance;
+
+        std::vector<std::pair<uint32_t, float>> stack = {{m_Root, 0.0f}};
+        while (not stack.empty())
+        {
+            auto [index, entry] = stack.back();
+            stack.pop_back();
+            if (entry > maxDistance)
+                continue; // A closer hit was found after this node was pushed
+
+            const auto& node = m_Nodes[index];
+            if (node.isLeaf())
+            {
+                const auto& proxy = m_Proxies[node.proxy];
+                auto distance = intersectRay(proxy.bounds, ray.origin, inverseDirection, maxDistance);
+                if (distance.has_value())
+                {
+                    closest = RayHit{proxy.userData, *distance};
+                    maxDistance = *distance;
+                }
+                continue;
+            }
+
+            // Visit the nearer child first so the hit distance shrinks early and prunes the farther one
+            auto first = intersectRay(m_Nodes[node.children[0]].bounds, ray.origin, inverseDirection, maxDistance);
+            auto second = intersectRay(m_Nodes[node.children[1]].bounds, ray.origin, inverseDirection, maxDistance);
+            std::pair nearer = {node.children[0], first};
+            std::pair farther = {node.children[1], second};
+            if (second.has_value() and (not first.has_value() or *second < *first))
+                std::swap(nearer, farther);
+
+            if (farther.second.has_value())
+                stack.emplace_back(farther.first, *farther.second);
+            if (nearer.second.has_value())
+                stack.emplace_back(nearer.first, *nearer.second);
+        }
+        return closest;
+    }
+
+    void DynamicBVH::queryFrustums(std::span<const Frustum> frustums, std::vector<std::vector<uint32_t>>& results,
+                                   ThreadPool& threadPool) const
+    {
+        results.resize(frustums.size());
+        threadPool.parallelFor(frustums.size(), MIN_QUERIES_PER_TASK, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                results[i].clear();
+                queryFrustum(frustums[i], results[i]);
+            }
+        });
+    }
+
+    void DynamicBVH::queryBoxes(std::span<const AABB> boxes, std::vector<std::vector<uint32_t>>& results,
+                                ThreadPool& threadPool) const
+    {
+        results.resize(boxes.size());
+        threadPool.parallelFor(boxes.size(), MIN_QUERIES_PER_TASK, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                results[i].clear();
+                queryBox(boxes[i], results[i]);
+            }
+        });
+    }
+
+    void DynamicBVH::querySpheres(std::span<const BoundingSphere> spheres, std::vector<std::vector<uint32_t>>& results,
+                                  ThreadPool& threadPool) const
+    {
+        results.resize(spheres.size());
+        threadPool.parallelFor(spheres.size(), MIN_QUERIES_PER_TASK, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                results[i].clear();
+                querySphere(spheres[i], results[i]);
+            }
+        });
+    }
+
+    void DynamicBVH::raycast(std::span<const Ray> rays, std::span<std::optional<RayHit>> hits,
+                             ThreadPool& threadPool) const
+    {
+        CORVUS_ASSERT(hits.size() >= rays.size(), "Not enough space for {} ray hits!", rays.size())
+        threadPool.parallelFor(rays.size(), MIN_QUERIES_PER_TASK, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+                hits[i] = raycast(rays[i]);
+        });
+    }
+
+    uint32_t DynamicBVH::getHeight() const
+    {
+        return m_Root == NULL_NODE ? 0 : m_Nodes[m_Root].height;
+    }
+
+    float DynamicBVH::getCost() const
+    {
+        if (m_Root == NULL_NODE)
+            return 0.0f;
+
+        float rootArea = m_Nodes[m_Root].bounds.getSurfaceArea();
+        if (rootArea <= 0.0f)
+            return 0.0f;
+
+        float total = 0.0f;
+        std::vector<uint32_t> stack = {m_Root};
+        while (not stack.empty())
+        {
+            const auto& node = m_Nodes[stack.back()];
+            stack.pop_back();
+            if (node.isLeaf())
+                continue;
+
+            total += node.bounds.getSurfaceArea();
+            stack.push_back(node.children[0]);
+            stack.push_back(node.children[1]);
+        }
+        return total / rootArea;
+    }
+
+    uint32_t DynamicBVH::allocateNode()
+    {
+        if (not m_FreeNodes.empty())
+        {
+            uint32_t node = m_FreeNodes.back();
+            m_FreeNodes.pop_back();
+            m_Nodes[node] = {};
+            return node;
+        }
+
+        m_Nodes.emplace_back();
+        return static_cast<uint32_t>(m_Nodes.size() - 1);
+    }
+
+    void DynamicBVH::freeNode(uint32_t node)
+    {
+        m_Nodes[node].height = UINT32_MAX;
+        m_FreeNodes.push_back(node);
+    }
+
+    void DynamicBVH::insertLeaf(uint32_t leaf)
+    {
+        if (m_Root == NULL_NODE)
+        {
+            m_Root = leaf;
+            m_Nodes[leaf].parent = NULL_NODE;
+            return;
+        }
+
+        // Descend towards the sibling that increases the summed surface area the least
+        AABB leafBounds = m_Nodes[leaf].bounds;
+        uint32_t index = m_Root;
+        while (not m_Nodes[index].isLeaf())
+        {
+            const auto& node = m_Nodes[index];
+            float area = node.bounds.getSurfaceArea();
+            float combinedArea = AABB::merge(node.bounds, leafBounds).getSurfaceArea();
+
+            // Cost of pairing with this node, and the growth every node below has to pay for
+            float cost = 2.0f * combinedArea;
+            float inheritance = 2.0f * (combinedArea - area);
+
+            auto descentCost = [&](uint32_t child)
+            {
+                const auto& bounds = m_Nodes[child].bounds;
+                float merged = AABB::merge(bounds, leafBounds).getSurfaceArea();
+                return (m_Nodes[child].isLeaf() ? merged : merged - bounds.getSurfaceArea()) + inheritance;
+            };
+
+            float cost0 = descentCost(node.children[0]);
+            float cost1 = descentCost(node.children[1]);
+            if (cost < cost0 and cost < cost1)
+                break;
+
+            index = cost0 < cost1 ? node.children[0] : node.children[1];
+        }
+
+        uint32_t sibling = index;
+        uint32_t oldParent = m_Nodes[sibling].parent;
+        uint32_t newParent = allocateNode();
+
+        m_Nodes[newParent].parent = oldParent;
+        m_Nodes[newParent].bounds = AABB::merge(leafBounds, m_Nodes[sibling].bounds);
+        m_Nodes[newParent].height = m_Nodes[sibling].height + 1;
+        m_Nodes[newParent].children[0] = sibling;
+        m_Nodes[newParent].children[1] = leaf;
+        m_Nodes[sibling].parent = newParent;
+        m_Nodes[leaf].parent = newParent;
+
+        if (oldParent == NULL_NODE)
+        {
+            m_Root = newParent;
+        }
+        else
+        {
+            auto& children = m_Nodes[oldParent].children;
+            children[children[0] == sibling ? 0 : 1] = newParent;
+        }
+
+        refitAncestors(m_Nodes[leaf].parent);
+    }
+
+    void DynamicBVH::removeLeaf(uint32_t leaf)
+    {
+        if (leaf == m_Root)
+        {
+            m_Root = NULL_NODE;
+            return;
+        }
+
+        uint32_t parent = m_Nodes[leaf].parent;
+        uint32_t grandParent = m_Nodes[parent].parent;
+        uint32_t sibling = m_Nodes[parent].children[0] == leaf ? m_Nodes[parent].children[1]
+                                                               : m_Nodes[parent].children[0];
+
+        // The parent only existed to pair the leaf with its sibling, the sibling takes its place
+        m_Nodes[sibling].parent = grandParent;
+        if (grandParent == NULL_NODE)
+        {
+            m_Root = sibling;
+        }
+        else
+        {
+            auto& children = m_Nodes[grandParent].children;
+            children[children[0] == parent ? 0 : 1] = sibling;
+            refitAncestors(grandParent);
+        }
+        freeNode(parent);
+        m_Nodes[leaf].parent = NULL_NODE;
+    }
+
+    void DynamicBVH::refitAncestors(uint32_t node)
+    {
+        while (node != NULL_NODE)
+        {
+            auto& current = m_Nodes[node];
+            const auto& left = m_Nodes[current.children[0]];
+            const auto& right = m_Nodes[current.children[1]];
+
+            current.bounds = AABB::merge(left.bounds, right.bounds);
+            current.height = 1 + std::max(left.height, right.height);
+            node = current.parent;
+        }
+    }
+
+    AABB DynamicBVH::fatten(const AABB& bounds) const
+    {
+        return {bounds.min - glm::vec3(m_Margin), bounds.max + glm::vec3(m_Margin)};
+    }
+
+    uint32_t DynamicBVH::buildRecursive(std::span<uint32_t> proxies, std::vector<Node>& nodes, uint32_t parent)
+    {
+        auto index = static_cast<uint32_t>(nodes.size());
+        nodes.emplace_back();
+        nodes[index].parent = parent;
+
+        if (proxies.size() == 1)
+        {
+            nodes[index].bounds = fatten(m_Proxies[proxies[0]].bounds);
+            nodes[index].proxy = proxies[0];
+            m_Proxies[proxies[0]].node = index;
+            return index;
+        }
+
+        AABB centroidBounds;
+        for (uint32_t proxy: proxies)
+            centroidBounds.expand(m_Proxies[proxy].bounds.getCenter());
+
+        glm::vec3 size = centroidBounds.max - centroidBounds.min;
+        int axis = size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+
+        auto middle = proxies.begin() + static_cast<ptrdiff_t>(proxies.size() / 2);
+        if (size[axis] > 0.0f)
+        {
+            // Bin the centroids along the widest axis and split where the SAH cost is lowest
+            struct Bin
+            {
+                AABB bounds;
+                uint32_t count = 0;
+            };
+            std::array<Bin, SAH_BINS> bins;
+
+            float scale = static_cast<float>(SAH_BINS) / size[axis];
+            auto binIndex = [&](uint32_t proxy)
+            {
+                float offset = m_Proxies[proxy].bounds.getCenter()[axis] - centroidBounds.min[axis];
+                return std::min(SAH_BINS - 1, static_cast<uint32_t>(offset * scale));
+            };
+
+            for (uint32_t proxy: proxies)
+            {
+                auto& bin = bins[binIndex(proxy)];
+                bin.bounds.expand(m_Proxies[proxy].bounds);
+                bin.count++;
+            }
+
+            std::array<float, SAH_BINS - 1> leftCost;
+            AABB leftBounds;
+            uint32_t leftCount = 0;
+            for (uint32_t i = 0; i < SAH_BINS - 1; i++)
+            {
+                leftBounds.expand(bins[i].bounds);
+                leftCount += bins[i].count;
+                leftCost[i] = leftCount == 0 ? 0.0f : leftBounds.getSurfaceArea() * static_cast<float>(leftCount);
+            }
+
+            AABB rightBounds;
+            uint32_t rightCount = 0;
+            uint32_t bestSplit = 0;
+            float bestCost = std::numeric_limits<float>::max();
+            for (uint32_t i = SAH_BINS - 1; i > 0; i--)
+            {
+                rightBounds.expand(bins[i].bounds);
+                rightCount += bins[i].count;
+                float rightCost = rightCount == 0 ? 0.0f : rightBounds.getSurfaceArea() * static_cast<float>(rightCount);
+                float cost = leftCost[i - 1] + rightCost;
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestSplit = i;
+                }
+            }
+
+            auto partition = std::partition(proxies.begin(), proxies.end(),
+                                            [&](uint32_t proxy) { return binIndex(proxy) < bestSplit; });
+            if (partition != proxies.begin() and partition != proxies.end())
+                middle = partition;
+        }
+
+        // Left child directly follows its parent, so the common descent path reads forward through memory
+        uint32_t left = buildRecursive({proxies.begin(), middle}, nodes, index);
+        uint32_t right = buildRecursive({middle, proxies.end()}, nodes, index);
+
+        auto& node = nodes[index];
+        node.children[0] = left;
+        node.children[1] = right;
+        node.bounds = AABB::merge(nodes[left].bounds, nodes[right].bounds);
+        node.height = 1 + std::max(nodes[left].height, nodes[right].height);
+        return index;
+    }
+
+    template<typename Overlaps>
+    void DynamicBVH::queryOverlaps(Overlaps&& overlaps, std::vector<uint32_t>& results) const
+    {
+        if (m_Root == NULL_NODE)
+            return;
+
+        std::vector<uint32_t> stack = {m_Root};
+        while (not stack.empty())
+        {
+            const auto& node = m_Nodes[stack.back()];
+            stack.pop_back();
+            if (not overlaps(node.bounds))
+                continue;
+
+            if (not node.isLeaf())
+            {
+                stack.push_back(node.children[1]);
+                stack.push_back(node.children[0]);
+            }
+            else if (overlaps(m_Proxies[node.proxy].bounds))
+            {
+                results.push_back(m_Proxies[node.proxy].userData);
+            }
+        }
+    }
+
+    void DynamicBVH::collectLeaves(uint32_t node, std::vector<uint32_t>& results) const
+    {
+        std::vector<uint32_t> stack = {node};
+        while (not stack.empty())
+        {
+            const auto& current = m_Nodes[stack.back()];
+            stack.pop_back();
+            if (current.isLeaf())
+            {
+                results.push_back(m_Proxies[current.proxy].userData);
+                continue;
+            }
+            stack.push_back(current.children[1]);
+            stack.push_back(current.children[0]);
+        }
+    }
+} // Corvus
@@ -0,0 +1,118 @@
+#ifndef ENGINE_DYNAMICBVH_H
+#define ENGINE_DYNAMICBVH_H
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Bounds.h"
+#include "Frustum.h"
+#include "Utility/ThreadPool.h"
+
+namespace Corvus
+{
+    using ProxyHandle = uint32_t;
+
+    struct Ray
+    {
+        glm::vec3 origin;
+        glm::vec3 direction;
+        float maxDistance = std::numeric_limits<float>::max();
+    };
+
+    struct RayHit
+    {
+        uint32_t userData;
+        float distance; // Along the ray to the object's bounds
+    };
+
+    // Dynamic AABB tree. Leaves hold a fattened box so small movements do not touch the tree, an object that leaves
+    // its fat box is reinserted with a surface area heuristic descent. Incremental inserts degrade the tree over time,
+    // rebuild() recreates it top-down with binned SAH and lays the nodes out depth-first so traversal walks forward
+    // through memory. Queries are read only and can run concurrently, the batch overloads spread over the pool.
+    class DynamicBVH
+    {
+    public:
+        explicit DynamicBVH(float margin = 0.1f);
+
+        ProxyHandle insert(const AABB& bounds, uint32_t userData);
+        void remove(ProxyHandle proxy);
+        // Returns true when the object left its fat box and was reinserted
+        bool update(ProxyHandle proxy, const AABB& bounds);
+
+        void rebuild();
+        // Rebuilds when the SAH cost grew by more than the factor since the last rebuild, checked every few changes
+        bool rebuildIfDegraded(float factor = 1.5f);
+
+        void queryFrustum(const Frustum& frustum, std::vector<uint32_t>& results) const;
+        void queryBox(const AABB& box, std::vector<uint32_t>& results) const;
+        void querySphere(const BoundingSphere& sphere, std::vector<uint32_t>& results) const;
+        [[nodiscard]] std::optional<RayHit> raycast(const Ray& ray) const;
+
+        void queryFrustums(std::span<const Frustum> frustums, std::vector<std::vector<uint32_t>>& results,
+                           ThreadPool& threadPool = ThreadPool::getInstance()) const;
+        void queryBoxes(std::span<const AABB> boxes, std::vector<std::vector<uint32_t>>& results,
+                        ThreadPool& threadPool = ThreadPool::getInstance()) const;
+        void querySpheres(std::span<const BoundingSphere> spheres, std::vector<std::vector<uint32_t>>& results,
+                          ThreadPool& threadPool = ThreadPool::getInstance()) const;
+        void raycast(std::span<const Ray> rays, std::span<std::optional<RayHit>> hits,
+                     ThreadPool& threadPool = ThreadPool::getInstance()) const;
+
+        [[nodiscard]] uint32_t getProxyCount() const { return m_ProxyCount; }
+        [[nodiscard]] uint32_t getHeight() const;
+        [[nodiscard]] float getCost() const; // Summed surface area of internal nodes relative to the root
+        [[nodiscard]] const AABB& getBounds(ProxyHandle proxy) const { return m_Proxies[proxy].bounds; }
+        [[nodiscard]] uint32_t getUserData(ProxyHandle proxy) const { return m_Proxies[proxy].userData; }
+
+    private:
+        static constexpr uint32_t NULL_NODE = UINT32_MAX;
+        static constexpr uint32_t SAH_BINS = 12;
+        static constexpr size_t MIN_QUERIES_PER_TASK = 16;
+
+        struct Node
+        {
+            AABB bounds;
+            uint32_t parent = NULL_NODE;
+            uint32_t children[2] = {NULL_NODE, NULL_NODE};
+            uint32_t proxy = NULL_NODE; // Set for leaves only
+            uint32_t height = 0;
+
+            [[nodiscard]] bool isLeaf() const { return children[0] == NULL_NODE; }
+        };
+
+        struct Proxy
+        {
+            AABB bounds; // Tight bounds, leaf queries test against these
+            uint32_t userData = 0;
+            uint32_t node = NULL_NODE;
+        };
+
+        float m_Margin;
+        uint32_t m_Root = NULL_NODE;
+        std::vector<Node> m_Nodes;
+        std::vector<uint32_t> m_FreeNodes;
+        std::vector<Proxy> m_Proxies;
+        std::vector<ProxyHandle> m_FreeProxies;
+        uint32_t m_ProxyCount = 0;
+
+        uint32_t m_ChangesSinceCheck = 0;
+        float m_RebuiltCost = 0.0f;
+
+    private:
+        uint32_t allocateNode();
+        void freeNode(uint32_t node);
+        void insertLeaf(uint32_t leaf);
+        void removeLeaf(uint32_t leaf);
+        void refitAncestors(uint32_t node);
+        [[nodiscard]] AABB fatten(const AABB& bounds) const;
+
+        uint32_t buildRecursive(std::span<uint32_t> proxies, std::vector<Node>& nodes, uint32_t parent);
+
+        template<typename Overlaps>
+        void queryOverlaps(Overlaps&& overlaps, std::vector<uint32_t>& results) const;
+        void collectLeaves(uint32_t node, std::vector<uint32_t>& results) const;
+    };
+} // Corvus
+
+#endif //ENGINE_DYNAMICBVH_H
@@ -0,0 +1,47 @@
+#include "Frustum.h"
+
+namespace Corvus
+{
+    Frustum Frustum::fromMatrix(const glm::mat4& viewProjection)
+    {
+        glm::mat4 rows = glm::transpose(viewProjection);
+
+        Frustum frustum = {};
+        frustum.planes[Left] = rows[3] + rows[0];
+        frustum.planes[Right] = rows[3] - rows[0];
+        frustum.planes[Bottom] = rows[3] + rows[1];
+        frustum.planes[Top] = rows[3] - rows[1];
+        frustum.planes[Near] = rows[2];           // z >= 0, the far plane with reverse-Z
+        frustum.planes[Far] = rows[3] - rows[2];  // z <= w, the near plane with reverse-Z
+
+        for (auto& plane: frustum.planes)
+        {
+            float length = glm::length(glm::vec3(plane));
+            plane = length > 1e-6f ? plane / length : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        }
+        return frustum;
+    }
+
+    bool Frustum::intersects(const AABB& bounds) const
+    {
+        glm::vec3 center = bounds.getCenter();
+        glm::vec3 extent = bounds.getExtent();
+        for (const auto& plane: planes)
+        {
+            glm::vec3 normal = glm::vec3(plane);
+            if (glm::dot(normal, center) + plane.w < -glm::dot(glm::abs(normal), extent))
+                return false;
+        }
+        return true;
+    }
+
+    bool Frustum::intersects(const BoundingSphere& sphere) const
+    {
+        for (const auto& plane: planes)
+        {
+            if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius)
+                return false;
+        }
+        return true;
+    }
+} // Corvus
@@ -0,0 +1,26 @@
+#ifndef ENGINE_FRUSTUM_H
+#define ENGINE_FRUSTUM_H
+
+#include <array>
+
+#include "Bounds.h"
+
+namespace Corvus
+{
+    // Six inward facing planes (xyz normal, w distance), a point p is inside when dot(n, p) + w >= 0 for all of them
+    struct Frustum
+    {
+        enum Plane { Left, Right, Bottom, Top, Near, Far, Count };
+
+        std::array<glm::vec4, Count> planes;
+
+        // Extracts the planes from a view projection with Vulkan's [0, 1] depth range. Works for reverse-Z and
+        // infinite projections, a plane at infinity degenerates to one that accepts everything.
+        [[nodiscard]] static Frustum fromMatrix(const glm::mat4& viewProjection);
+
+        [[nodiscard]] bool intersects(const AABB& bounds) const;
+        [[nodiscard]] bool intersects(const BoundingSphere& sphere) const;
+    };
+} // Corvus
+
+#endif //ENGINE_FRUSTUM_H
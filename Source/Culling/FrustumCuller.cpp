@@ -0,0 +1,336 @@
+#include "FrustumCuller.h"
+
+#include <algorithm>
+#include <bit>
+#include <mutex>
+
+#include "Utility/Corvus.h"
+
+namespace Corvus
+{
+    namespace
+    {
+        constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+        struct CullData
+        {
+            const float* centerX;
+            const float* centerY;
+            const float* centerZ;
+            const float* extentX;
+            const float* extentY;
+            const float* extentZ;
+            const float* radius;
+            size_t count;
+        };
+
+        // Lanes of the block starting at base that hold an object, the padding at the end is never visible
+        uint32_t validLanes(size_t base, size_t count)
+        {
+            size_t remaining = count - base;
+            return remaining >= FrustumCuller::LANES ? 0xFF : (1u << remaining) - 1;
+        }
+
+        uint32_t writeVisible(uint32_t mask, size_t base, uint32_t* output)
+        {
+            uint32_t written = 0;
+            while (mask != 0)
+            {
+                output[written++] = static_cast<uint32_t>(base) + std::countr_zero(mask);
+                mask &= mask - 1;
+            }
+            return written;
+        }
+
+        uint32_t cullScalar(const CullData& data, const Frustum& frustum, size_t firstBlock, size_t lastBlock,
+                            uint32_t* output)
+        {
+            uint32_t written = 0;
+            size_t end = std::min(lastBlock * FrustumCuller::LANES, data.count);
+            for (size_t i = firstBlock * FrustumCuller::LANES; i < end; i++)
+            {
+                bool inside = true;
+                for (const auto& plane: frustum.planes)
+                {
+                    float distance = plane.x * data.centerX[i] + plane.y * data.centerY[i] +
+                                     plane.z * data.centerZ[i] + plane.w;
+                    float boxRadius = std::abs(plane.x) * data.extentX[i] + std::abs(plane.y) * data.extentY[i] +
+                                      std::abs(plane.z) * data.extentZ[i];
+                    if (distance + std::min(boxRadius, data.radius[i]) < 0.0f)
+                    {
+                        inside = false;
+                        break;
+                    }
+                }
+                if (inside)
+                    output[written++] = static_cast<uint32_t>(i);
+            }
+            return written;
+        }
+
+#if CORVUS_SIMD_X86
+        // Baseline on x86-64, one block is processed as two halves of 4
+        uint32_t cullSSE2(const CullData& data, const Frustum& frustum, size_t firstBlock, size_t lastBlock,
+                          uint32_t* output)
+        {
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+            __m128 normalX[Frustum::Count], normalY[Frustum::Count], normalZ[Frustum::Count];
+            __m128 distance[Frustum::Count];
+            __m128 absX[Frustum::Count], absY[Frustum::Count], absZ[Frustum::Count];
+            for (int p = 0; p < Frustum::Count; p++)
+            {
+                normalX[p] = _mm_set1_ps(frustum.planes[p].x);
+                normalY[p] = _mm_set1_ps(frustum.planes[p].y);
+                normalZ[p] = _mm_set1_ps(frustum.planes[p].z);
+                distance[p] = _mm_set1_ps(frustum.planes[p].w);
+                absX[p] = _mm_and_ps(normalX[p], absMask);
+                absY[p] = _mm_and_ps(normalY[p], absMask);
+                absZ[p] = _mm_and_ps(normalZ[p], absMask);
+            }
+
+            uint32_t written = 0;
+            for (size_t block = firstBlock; block < lastBlock; block++)
+            {
+                size_t base = block * FrustumCuller::LANES;
+                uint32_t outsideMask = 0;
+                for (size_t half = 0; half < FrustumCuller::LANES; half += 4)
+                {
+                    size_t i = base + half;
+                    __m128 centerX = _mm_loadu_ps(data.centerX + i);
+                    __m128 centerY = _mm_loadu_ps(data.centerY + i);
+                    __m128 centerZ = _mm_loadu_ps(data.centerZ + i);
+                    __m128 extentX = _mm_loadu_ps(data.extentX + i);
+                    __m128 extentY = _mm_loadu_ps(data.extentY + i);
+                    __m128 extentZ = _mm_loadu_ps(data.extentZ + i);
+                    __m128 radius = _mm_loadu_ps(data.radius + i);
+
+                    __m128 outside = _mm_setzero_ps();
+                    for (int p = 0; p < Frustum::Count; p++)
+                    {
+                        __m128 signedDistance = _mm_add_ps(
+                            _mm_add_ps(_mm_mul_ps(normalX[p], centerX), _mm_mul_ps(normalY[p], centerY)),
+                            _mm_add_ps(_mm_mul_ps(normalZ[p], centerZ), distance[p]));
+                        __m128 boxRadius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absX[p], extentX),
+                                                                 _mm_mul_ps(absY[p], extentY)),
+                                                      _mm_mul_ps(absZ[p], extentZ));
+                        __m128 limit = _mm_add_ps(signedDistance, _mm_min_ps(boxRadius, radius));
+                        outside = _mm_or_ps(outside, _mm_cmplt_ps(limit, _mm_setzero_ps()));
+                    }
+                    outsideMask |= static_cast<uint32_t>(_mm_movemask_ps(outside)) << half;
+                }
+
+                uint32_t visibleMask = ~outsideMask bitand validLanes(base, data.count);
+                written += writeVisible(visibleMask, base, output + written);
+            }
+            return written;
+        }
+
+        CORVUS_TARGET_AVX2
+        uint32_t cullAVX2(const CullData& data, const Frustum& frustum, size_t firstBlock, size_t lastBlock,
+                          uint32_t* output)
+        {
+            const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+            __m256 normalX[Frustum::Count], normalY[Frustum::Count], normalZ[Frustum::Count];
+            __m256 distance[Frustum::Count];
+            __m256 absX[Frustum::Count], absY[Frustum::Count], absZ[Frustum::Count];
+            for (int p = 0; p < Frustum::Count; p++)
+            {
+                normalX[p] = _mm256_set1_ps(frustum.planes[p].x);
+                normalY[p] = _mm256_set1_ps(frustum.planes[p].y);
+                normalZ[p] = _mm256_set1_ps(frustum.planes[p].z);
+                distance[p] = _mm256_set1_ps(frustum.planes[p].w);
+                absX[p] = _mm256_and_ps(normalX[p], absMask);
+                absY[p] = _mm256_and_ps(normalY[p], absMask);
+                absZ[p] = _mm256_and_ps(normalZ[p], absMask);
+            }
+
+            uint32_t written = 0;
+            for (size_t block = firstBlock; block < lastBlock; block++)
+            {
+                size_t i = block * FrustumCuller::LANES;
+                __m256 centerX = _mm256_loadu_ps(data.centerX + i);
+                __m256 centerY = _mm256_loadu_ps(data.centerY + i);
+                __m256 centerZ = _mm256_loadu_ps(data.centerZ + i);
+                __m256 extentX = _mm256_loadu_ps(data.extentX + i);
+                __m256 extentY = _mm256_loadu_ps(data.extentY + i);
+                __m256 extentZ = _mm256_loadu_ps(data.extentZ + i);
+                __m256 radius = _mm256_loadu_ps(data.radius + i);
+
+                __m256 outside = _mm256_setzero_ps();
+                for (int p = 0; p < Frustum::Count; p++)
+                {
+                    __m256 signedDistance = _mm256_fmadd_ps(normalX[p], centerX,
+                                                            _mm256_fmadd_ps(normalY[p], centerY,
+                                                                            _mm256_fmadd_ps(normalZ[p], centerZ,
+                                                                                            distance[p])));
+                    __m256 boxRadius = _mm256_fmadd_ps(absX[p], extentX,
+                                                       _mm256_fmadd_ps(absY[p], extentY,
+                                                                       _mm256_mul_ps(absZ[p], extentZ)));
+                    __m256 limit = _mm256_add_ps(signedDistance, _mm256_min_ps(boxRadius, radius));
+                    outside = _mm256_or_ps(outside, _mm256_cmp_ps(limit, _mm256_setzero_ps(), _CMP_LT_OQ));
+                }
+
+                uint32_t outsideMask = static_cast<uint32_t>(_mm256_movemask_ps(outside));
+                uint32_t visibleMask = ~outsideMask bitand validLanes(i, data.count);
+                written += writeVisible(visibleMask, i, output + written);
+            }
+            return written;
+        }
+#endif
+    }
+
+    CullHandle FrustumCuller::add(const AABB& bounds, const BoundingSphere& sphere)
+    {
+        CullHandle handle;
+        if (not m_FreeHandles.empty())
+        {
+            handle = m_FreeHandles.back();
+            m_FreeHandles.pop_back();
+        }
+        else
+        {
+            handle = static_cast<CullHandle>(m_Indices.size());
+            m_Indices.push_back(INVALID_INDEX);
+        }
+
+        auto index = static_cast<uint32_t>(m_Handles.size());
+        m_Handles.push_back(handle);
+        m_Indices[handle] = index;
+
+        resizeStorage(m_Handles.size());
+        store(index, bounds, sphere);
+        return handle;
+    }
+
+    void FrustumCuller::update(CullHandle handle, const AABB& bounds, const BoundingSphere& sphere)
+    {
+        CORVUS_ASSERT(handle < m_Indices.size() and m_Indices[handle] != INVALID_INDEX, "Invalid cull handle {}!",
+                      handle)
+        store(m_Indices[handle], bounds, sphere);
+    }
+
+    void FrustumCuller::remove(CullHandle handle)
+    {
+        CORVUS_ASSERT(handle < m_Indices.size() and m_Indices[handle] != INVALID_INDEX, "Invalid cull handle {}!",
+                      handle)
+
+        // Keep the arrays dense by moving the last object into the hole
+        uint32_t index = m_Indices[handle];
+        auto last = static_cast<uint32_t>(m_Handles.size() - 1);
+        if (index != last)
+        {
+            for (auto* array: {&m_CenterX, &m_CenterY, &m_CenterZ, &m_ExtentX, &m_ExtentY, &m_ExtentZ, &m_Radius})
+                (*array)[index] = (*array)[last];
+
+            m_Handles[index] = m_Handles[last];
+            m_Indices[m_Handles[index]] = index;
+        }
+
+        m_Handles.pop_back();
+        m_Indices[handle] = INVALID_INDEX;
+        m_FreeHandles.push_back(handle);
+        resizeStorage(m_Handles.size());
+    }
+
+    void FrustumCuller::cull(const Frustum& frustum, std::vector<CullHandle>& visible, ThreadPool& threadPool)
+    {
+        cull(frustum, visible, getSimdLevel(), threadPool);
+    }
+
+    void FrustumCuller::cull(const Frustum& frustum, std::vector<CullHandle>& visible, SimdLevel level,
+                             ThreadPool& threadPool)
+    {
+        level = std::min(level, getSimdLevel());
+        visible.clear();
+        size_t blockCount = (m_Handles.size() + LANES - 1) / LANES;
+        if (blockCount == 0)
+            return;
+
+        visible.resize(blockCount * LANES);
+        if (blockCount <= MIN_BLOCKS_PER_TASK)
+        {
+            visible.resize(cullBlocks(frustum, level, 0, blockCount, visible.data()));
+            return;
+        }
+
+        // Every task compacts into its own slice of the scratch buffer, the slices are joined in order afterwards
+        m_Scratch.resize(blockCount * LANES);
+        std::vector<std::pair<size_t, uint32_t>> slices;
+        std::mutex slicesMutex;
+
+        threadPool.parallelFor(blockCount, MIN_BLOCKS_PER_TASK, [&](size_t begin, size_t end)
+        {
+            uint32_t written = cullBlocks(frustum, level, begin, end, m_Scratch.data() + begin * LANES);
+            std::lock_guard lock(slicesMutex);
+            slices.emplace_back(begin, written);
+        });
+
+        std::ranges::sort(slices);
+        size_t size = 0;
+        for (auto [begin, written]: slices)
+        {
+            std::copy_n(m_Scratch.data() + begin * LANES, written, visible.data() + size);
+            size += written;
+        }
+        visible.resize(size);
+    }
+
+    void FrustumCuller::store(uint32_t index, const AABB& bounds, const BoundingSphere& sphere)
+    {
+        glm::vec3 center = bounds.getCenter();
+        glm::vec3 extent = bounds.getExtent();
+
+        m_CenterX[index] = center.x;
+        m_CenterY[index] = center.y;
+        m_CenterZ[index] = center.z;
+        m_ExtentX[index] = extent.x;
+        m_ExtentY[index] = extent.y;
+        m_ExtentZ[index] = extent.z;
+
+        // The sphere is tested against the box center, grow it so it still encloses the object
+        m_Radius[index] = sphere.radius + glm::length(sphere.center - center);
+    }
+
+    void FrustumCuller::resizeStorage(size_t count)
+    {
+        size_t padded = (count + LANES - 1) / LANES * LANES;
+        for (auto* array: {&m_CenterX, &m_CenterY, &m_CenterZ, &m_ExtentX, &m_ExtentY, &m_ExtentZ, &m_Radius})
+            array->resize(padded, 0.0f);
+    }
+
+    uint32_t FrustumCuller::cullBlocks(const Frustum& frustum, SimdLevel level, size_t firstBlock, size_t lastBlock,
+                                       CullHandle* output) const
+    {
+        CullData data = {
+            .centerX = m_CenterX.data(),
+            .centerY = m_CenterY.data(),
+            .centerZ = m_CenterZ.data(),
+            .extentX = m_ExtentX.data(),
+            .extentY = m_ExtentY.data(),
+            .extentZ = m_ExtentZ.data(),
+            .radius = m_Radius.data(),
+            .count = m_Handles.size(),
+        };
+
+        uint32_t written;
+        switch (level)
+        {
+#if CORVUS_SIMD_X86
+        case SimdLevel::AVX2:
+            written = cullAVX2(data, frustum, firstBlock, lastBlock, output);
+            break;
+        case SimdLevel::SSE2:
+            written = cullSSE2(data, frustum, firstBlock, lastBlock, output);
+            break;
+#endif
+        default:
+            written = cullScalar(data, frustum, firstBlock, lastBlock, output);
+            break;
+        }
+
+        // The kernels produce dense indices, callers only know handles
+        for (uint32_t i = 0; i < written; i++)
+            output[i] = m_Handles[output[i]];
+        return written;
+    }
+} // Corvus
@@ -0,0 +1,60 @@
+#ifndef ENGINE_FRUSTUMCULLER_H
+#define ENGINE_FRUSTUMCULLER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Bounds.h"
+#include "Frustum.h"
+#include "Utility/Simd.h"
+#include "Utility/ThreadPool.h"
+
+namespace Corvus
+{
+    using CullHandle = uint32_t;
+
+    // World space bounds of every cullable object in structure of arrays layout, so one iteration loads the same
+    // component of 8 objects. Objects are rejected when their sphere or their box is outside any frustum plane.
+    class FrustumCuller
+    {
+    public:
+        static constexpr uint32_t LANES = 8;
+
+        CullHandle add(const AABB& bounds, const BoundingSphere& sphere);
+        CullHandle add(const AABB& bounds) { return add(bounds, BoundingSphere::fromAABB(bounds)); }
+        void update(CullHandle handle, const AABB& bounds, const BoundingSphere& sphere);
+        void update(CullHandle handle, const AABB& bounds) { update(handle, bounds, BoundingSphere::fromAABB(bounds)); }
+        void remove(CullHandle handle);
+
+        // Writes the handles of all objects intersecting the frustum, in storage order
+        void cull(const Frustum& frustum, std::vector<CullHandle>& visible,
+                  ThreadPool& threadPool = ThreadPool::getInstance());
+        // Levels above what the CPU supports fall back to the best supported one
+        void cull(const Frustum& frustum, std::vector<CullHandle>& visible, SimdLevel level, ThreadPool& threadPool);
+
+        [[nodiscard]] uint32_t getSize() const { return static_cast<uint32_t>(m_Handles.size()); }
+
+    private:
+        // Blocks of LANES objects per work item below which the cull stays on the calling thread
+        static constexpr size_t MIN_BLOCKS_PER_TASK = 128;
+
+        // Padded to a multiple of LANES so every block can be loaded whole
+        std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+        std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+        std::vector<float> m_Radius;
+
+        std::vector<CullHandle> m_Handles;  // Dense index -> handle
+        std::vector<uint32_t> m_Indices;    // Handle -> dense index
+        std::vector<CullHandle> m_FreeHandles;
+
+        std::vector<CullHandle> m_Scratch;
+
+    private:
+        void store(uint32_t index, const AABB& bounds, const BoundingSphere& sphere);
+        void resizeStorage(size_t count);
+        uint32_t cullBlocks(const Frustum& frustum, SimdLevel level, size_t firstBlock, size_t lastBlock,
+                            CullHandle* output) const;
+    };
+} // Corvus
+
+#endif //ENGINE_FRUSTUMCULLER_H
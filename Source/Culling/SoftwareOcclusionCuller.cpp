@@ -0,0 +1,401 @@
+#include "SoftwareOcclusionCuller.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Utility/Corvus.h"
+
+namespace Corvus
+{
+    namespace
+    {
+        // Geometry closer than this in clip w is cut away, occluders only ever lose area to it
+        constexpr float MIN_CLIP_W = 1e-4f;
+
+        // Edge functions E(x, y) = a * x + b * y + c are positive inside, depth is the plane z = dx * x + dy * y + c
+        struct TriangleSetup
+        {
+            std::array<float, 3> edgeA, edgeB, edgeC;
+            float depthX, depthY, depthC;
+            int minX, maxX, minY, maxY;
+        };
+
+        bool setupTriangle(const std::array<glm::vec3, 3>& triangle, uint32_t width, uint32_t height,
+                           TriangleSetup& setup)
+        {
+            glm::vec3 a = triangle[0], b = triangle[1], c = triangle[2];
+            float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+            if (std::abs(area) < 1e-8f)
+                return false;
+
+            // Occluders are rasterized from both sides, flip clockwise triangles so the inside is positive
+            if (area < 0.0f)
+            {
+                std::swap(b, c);
+                area = -area;
+            }
+
+            float minX = std::min({a.x, b.x, c.x}), maxX = std::max({a.x, b.x, c.x});
+            float minY = std::min({a.y, b.y, c.y}), maxY = std::max({a.y, b.y, c.y});
+            setup.minX = std::max(0, static_cast<int>(std::floor(minX)));
+            setup.maxX = std::min(static_cast<int>(width) - 1, static_cast<int>(std::floor(maxX)));
+            setup.minY = std::max(0, static_cast<int>(std::floor(minY)));
+            setup.maxY = std::min(static_cast<int>(height) - 1, static_cast<int>(std::floor(maxY)));
+            if (setup.minX > setup.maxX or setup.minY > setup.maxY)
+                return false;
+
+            const std::array<glm::vec3, 3> vertices = {a, b, c};
+            for (int i = 0; i < 3; i++)
+            {
+                const auto& from = vertices[i];
+                const auto& to = vertices[(i + 1) % 3];
+                setup.edgeA[i] = from.y - to.y;
+                setup.edgeB[i] = to.x - from.x;
+                setup.edgeC[i] = (to.y - from.y) * from.x - (to.x - from.x) * from.y;
+            }
+
+            setup.depthX = ((b.z - a.z) * (c.y - a.y) - (c.z - a.z) * (b.y - a.y)) / area;
+            setup.depthY = ((c.z - a.z) * (b.x - a.x) - (b.z - a.z) * (c.x - a.x)) / area;
+            setup.depthC = a.z - setup.depthX * a.x - setup.depthY * a.y;
+            return true;
+        }
+
+        // Pixel centers sit at +0.5, shared edges are covered by both triangles which max() does not mind
+        void rasterizeScalar(const TriangleSetup& setup, float* depth, uint32_t width, int firstRow, int lastRow)
+        {
+            for (int y = firstRow; y <= lastRow; y++)
+            {
+                float py = static_cast<float>(y) + 0.5f;
+                float* row = depth + static_cast<size_t>(y) * width;
+                for (int x = setup.minX; x <= setup.maxX; x++)
+                {
+                    float px = static_cast<float>(x) + 0.5f;
+                    bool inside = true;
+                    for (int i = 0; i < 3; i++)
+                        inside = inside and setup.edgeA[i] * px + (setup.edgeB[i] * py + setup.edgeC[i]) >= 0.0f;
+
+                    if (inside)
+                        row[x] = std::max(row[x], setup.depthX * px + (setup.depthY * py + setup.depthC));
+                }
+            }
+        }
+
+        bool testScalar(const float* depth, uint32_t width, uint32_t minX, uint32_t minY, uint32_t maxX,
+                        uint32_t maxY, float objectDepth)
+        {
+            for (uint32_t y = minY; y <= maxY; y++)
+            {
+                const float* row = depth + static_cast<size_t>(y) * width;
+                for (uint32_t x = minX; x <= maxX; x++)
+                {
+                    if (row[x] <= objectDepth)
+                        return true;
+                }
+            }
+            return false;
+        }
+
+#if CORVUS_SIMD_X86
+        // Eight pixels of a row per step, the coverage mask decides which lanes take the new depth. Rows start on
+        // a multiple of LANES, so the stepping never leaves the row even though it ignores the bounding box.
+        CORVUS_TARGET_AVX2
+        void rasterizeAVX2(const TriangleSetup& setup, float* depth, uint32_t width, int firstRow, int lastRow)
+        {
+            const __m256 laneOffsets = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+            const __m256 zero = _mm256_setzero_ps();
+            __m256 edgeA[3];
+            for (int i = 0; i < 3; i++)
+                edgeA[i] = _mm256_set1_ps(setup.edgeA[i]);
+            __m256 depthX = _mm256_set1_ps(setup.depthX);
+
+            int firstX = setup.minX bitand ~static_cast<int>(SoftwareOcclusionCuller::LANES - 1);
+            for (int y = firstRow; y <= lastRow; y++)
+            {
+                float py = static_cast<float>(y) + 0.5f;
+                float* row = depth + static_cast<size_t>(y) * width;
+
+                __m256 edgeRow[3];
+                for (int i = 0; i < 3; i++)
+                    edgeRow[i] = _mm256_set1_ps(setup.edgeB[i] * py + setup.edgeC[i]);
+                __m256 depthRow = _mm256_set1_ps(setup.depthY * py + setup.depthC);
+
+                for (int x = firstX; x <= setup.maxX; x += SoftwareOcclusionCuller::LANES)
+                {
+                    __m256 px = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), laneOffsets);
+                    __m256 covered = _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(edgeA[0], px), edgeRow[0]), zero,
+                                                   _CMP_GE_OQ);
+                    for (int i = 1; i < 3; i++)
+                    {
+                        __m256 edge = _mm256_add_ps(_mm256_mul_ps(edgeA[i], px), edgeRow[i]);
+                        covered = _mm256_and_ps(covered, _mm256_cmp_ps(edge, zero, _CMP_GE_OQ));
+                    }
+                    if (_mm256_movemask_ps(covered) == 0)
+                        continue;
+
+                    __m256 triangleDepth = _mm256_add_ps(_mm256_mul_ps(depthX, px), depthRow);
+                    __m256 current = _mm256_loadu_ps(row + x);
+                    __m256 updated = _mm256_blendv_ps(current, _mm256_max_ps(current, triangleDepth), covered);
+                    _mm256_storeu_ps(row + x, updated);
+                }
+            }
+        }
+
+        CORVUS_TARGET_AVX2
+        bool testAVX2(const float* depth, uint32_t width, uint32_t minX, uint32_t minY, uint32_t maxX,
+                      uint32_t maxY, float objectDepth)
+        {
+            const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            __m256i first = _mm256_set1_epi32(static_cast<int>(minX) - 1);
+            __m256i last = _mm256_set1_epi32(static_cast<int>(maxX) + 1);
+            __m256 objectDepths = _mm256_set1_ps(objectDepth);
+
+            uint32_t firstX = minX bitand ~(SoftwareOcclusionCuller::LANES - 1);
+            for (uint32_t y = minY; y <= maxY; y++)
+            {
+                const float* row = depth + static_cast<size_t>(y) * width;
+                for (uint32_t x = firstX; x <= maxX; x += SoftwareOcclusionCuller::LANES)
+                {
+                    __m256i laneX = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(x)), lanes);
+                    __m256i inRect = _mm256_and_si256(_mm256_cmpgt_epi32(laneX, first),
+                                                      _mm256_cmpgt_epi32(last, laneX));
+                    __m256 uncovered = _mm256_cmp_ps(_mm256_loadu_ps(row + x), objectDepths, _CMP_LE_OQ);
+                    if (_mm256_movemask_ps(_mm256_and_ps(uncovered, _mm256_castsi256_ps(inRect))) != 0)
+                        return true;
+                }
+            }
+            return false;
+        }
+#endif
+
+        glm::vec3 toScreen(const glm::vec4& clip, uint32_t width, uint32_t height)
+        {
+            float inverseW = 1.0f / clip.w;
+            return {
+                (clip.x * inverseW * 0.5f + 0.5f) * static_cast<float>(width),
+                (clip.y * inverseW * 0.5f + 0.5f) * static_cast<float>(height),
+                inverseW
+            };
+        }
+    }
+
+    SoftwareOcclusionCuller::SoftwareOcclusionCuller(uint32_t width, uint32_t height)
+        : m_Width((std::max(width, LANES) + LANES - 1) / LANES * LANES),
+          m_Height(std::max(height, 1u)),
+          m_Depth(static_cast<size_t>(m_Width) * m_Height, 0.0f)
+    {
+    }
+
+    OccluderHandle SoftwareOcclusionCuller::addOccluder(std::vector<glm::vec3> positions,
+                                                        std::vector<uint32_t> indices, const glm::mat4& model)
+    {
+        CORVUS_ASSERT(indices.size() % 3 == 0, "Occluder indices have to form triangles!")
+
+        OccluderHandle handle;
+        if (not m_FreeHandles.empty())
+        {
+            handle = m_FreeHandles.back();
+            m_FreeHandles.pop_back();
+        }
+        else
+        {
+            handle = static_cast<OccluderHandle>(m_Occluders.size());
+            m_Occluders.emplace_back();
+        }
+
+        m_Occluders[handle] = {
+            .positions = std::move(positions),
+            .indices = std::move(indices),
+            .model = model,
+            .active = true,
+        };
+        m_OccluderCount++;
+        return handle;
+    }
+
+    void SoftwareOcclusionCuller::setTransform(OccluderHandle handle, const glm::mat4& model)
+    {
+        CORVUS_ASSERT(handle < m_Occluders.size() and m_Occluders[handle].active, "Invalid occluder handle {}!",
+                      handle)
+        m_Occluders[handle].model = model;
+    }
+
+    void SoftwareOcclusionCuller::removeOccluder(OccluderHandle handle)
+    {
+        CORVUS_ASSERT(handle < m_Occluders.size() and m_Occluders[handle].active, "Invalid occluder handle {}!",
+                      handle)
+        m_Occluders[handle] = {};
+        m_FreeHandles.push_back(handle);
+        m_OccluderCount--;
+    }
+
+    void SoftwareOcclusionCuller::render(const glm::mat4& viewProjection, ThreadPool& threadPool)
+    {
+        render(viewProjection, getSimdLevel(), threadPool);
+    }
+
+    void SoftwareOcclusionCuller::render(const glm::mat4& viewProjection, SimdLevel level, ThreadPool& threadPool)
+    {
+        m_ViewProjection = viewProjection;
+        m_Level = std::min(level, getSimdLevel());
+
+        threadPool.parallelFor(m_Occluders.size(), 1, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+                transformOccluder(m_Occluders[i]);
+        });
+
+        uint32_t bandCount = (m_Height + BAND_HEIGHT - 1) / BAND_HEIGHT;
+        threadPool.parallelFor(bandCount, 1, [&](size_t begin, size_t end)
+        {
+            for (size_t band = begin; band < end; band++)
+            {
+                auto firstRow = static_cast<uint32_t>(band) * BAND_HEIGHT;
+                rasterizeBand(firstRow, std::min(firstRow + BAND_HEIGHT, m_Height));
+            }
+        });
+    }
+
+    bool SoftwareOcclusionCuller::isVisible(const AABB& bounds) const
+    {
+        glm::vec2 screenMin(std::numeric_limits<float>::max());
+        glm::vec2 screenMax(std::numeric_limits<float>::lowest());
+        float nearestDepth = 0.0f;
+
+        for (int corner = 0; corner < 8; corner++)
+        {
+            glm::vec3 position = {
+                corner bitand 1 ? bounds.max.x : bounds.min.x,
+                corner bitand 2 ? bounds.max.y : bounds.min.y,
+                corner bitand 4 ? bounds.max.z : bounds.min.z
+            };
+            glm::vec4 clip = m_ViewProjection * glm::vec4(position, 1.0f);
+            if (clip.w < MIN_CLIP_W)
+                return true;
+
+            glm::vec3 screen = toScreen(clip, m_Width, m_Height);
+            screenMin = glm::min(screenMin, glm::vec2(screen));
+            screenMax = glm::max(screenMax, glm::vec2(screen));
+            nearestDepth = std::max(nearestDepth, screen.z);
+        }
+
+        // Off screen boxes are the frustum culler's business
+        if (screenMax.x < 0.0f or screenMax.y < 0.0f or screenMin.x >= static_cast<float>(m_Width) or
+            screenMin.y >= static_cast<float>(m_Height))
+            return true;
+
+        auto minX = static_cast<uint32_t>(std::max(0.0f, std::floor(screenMin.x)));
+        auto minY = static_cast<uint32_t>(std::max(0.0f, std::floor(screenMin.y)));
+        auto maxX = static_cast<uint32_t>(std::min(static_cast<float>(m_Width - 1), std::floor(screenMax.x)));
+        auto maxY = static_cast<uint32_t>(std::min(static_cast<float>(m_Height - 1), std::floor(screenMax.y)));
+        return testRect(minX, minY, maxX, maxY, nearestDepth);
+    }
+
+    void SoftwareOcclusionCuller::cull(std::vector<CullHandle>& handles, const std::vector<AABB>& bounds,
+                                       ThreadPool& threadPool) const
+    {
+        CORVUS_ASSERT(handles.size() == bounds.size(), "Every handle needs its bounds!")
+
+        std::vector<uint8_t> visible(handles.size());
+        threadPool.parallelFor(handles.size(), MIN_OBJECTS_PER_TASK, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+                visible[i] = isVisible(bounds[i]);
+        });
+
+        size_t size = 0;
+        for (size_t i = 0; i < handles.size(); i++)
+        {
+            if (visible[i])
+                handles[size++] = handles[i];
+        }
+        handles.resize(size);
+    }
+
+    void SoftwareOcclusionCuller::transformOccluder(Occluder& occluder) const
+    {
+        occluder.triangles.clear();
+        if (not occluder.active)
+            return;
+
+        glm::mat4 transform = m_ViewProjection * occluder.model;
+        std::vector<glm::vec4> clip(occluder.positions.size());
+        for (size_t i = 0; i < clip.size(); i++)
+            clip[i] = transform * glm::vec4(occluder.positions[i], 1.0f);
+
+        for (size_t i = 0; i < occluder.indices.size(); i += 3)
+        {
+            std::array triangle = {clip[occluder.indices[i]], clip[occluder.indices[i + 1]],
+                                   clip[occluder.indices[i + 2]]};
+
+            // Clip against w = MIN_CLIP_W, a triangle turns into at most a quad. The sides of the screen are
+            // handled by the bounding box clamp while rasterizing.
+            std::array<glm::vec4, 4> polygon;
+            uint32_t vertexCount = 0;
+            for (int v = 0; v < 3; v++)
+            {
+                const auto& current = triangle[v];
+                const auto& next = triangle[(v + 1) % 3];
+                bool currentInside = current.w >= MIN_CLIP_W;
+                bool nextInside = next.w >= MIN_CLIP_W;
+
+                if (currentInside)
+                    polygon[vertexCount++] = current;
+                if (currentInside != nextInside)
+                {
+                    float t = (MIN_CLIP_W - current.w) / (next.w - current.w);
+                    polygon[vertexCount++] = glm::mix(current, next, t);
+                }
+            }
+
+            for (uint32_t v = 2; v < vertexCount; v++)
+            {
+                occluder.triangles.push_back({
+                    toScreen(polygon[0], m_Width, m_Height),
+                    toScreen(polygon[v - 1], m_Width, m_Height),
+                    toScreen(polygon[v], m_Width, m_Height)
+                });
+            }
+        }
+    }
+
+    void SoftwareOcclusionCuller::rasterizeBand(uint32_t firstRow, uint32_t lastRow)
+    {
+        std::fill(m_Depth.begin() + static_cast<ptrdiff_t>(firstRow) * m_Width,
+                  m_Depth.begin() + static_cast<ptrdiff_t>(lastRow) * m_Width, 0.0f);
+
+        TriangleSetup setup;
+        for (const auto& occluder: m_Occluders)
+        {
+            for (const auto& triangle: occluder.triangles)
+            {
+                if (not setupTriangle(triangle, m_Width, m_Height, setup))
+                    continue;
+
+                int first = std::max(setup.minY, static_cast<int>(firstRow));
+                int last = std::min(setup.maxY, static_cast<int>(lastRow) - 1);
+                if (first > last)
+                    continue;
+
+#if CORVUS_SIMD_X86
+                if (m_Level == SimdLevel::AVX2)
+                {
+                    rasterizeAVX2(setup, m_Depth.data(), m_Width, first, last);
+                    continue;
+                }
+#endif
+                rasterizeScalar(setup, m_Depth.data(), m_Width, first, last);
+            }
+        }
+    }
+
+    bool SoftwareOcclusionCuller::testRect(uint32_t minX, uint32_t minY, uint32_t maxX, uint32_t maxY,
+                                           float depth) const
+    {
+#if CORVUS_SIMD_X86
+        if (m_Level == SimdLevel::AVX2)
+            return testAVX2(m_Depth.data(), m_Width, minX, minY, maxX, maxY, depth);
+#endif
+        return testScalar(m_Depth.data(), m_Width, minX, minY, maxX, maxY, depth);
+    }
+} // Corvus
@@ -0,0 +1,87 @@
+#ifndef ENGINE_SOFTWAREOCCLUSIONCULLER_H
+#define ENGINE_SOFTWAREOCCLUSIONCULLER_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Bounds.h"
+#include "FrustumCuller.h"
+#include "Utility/Simd.h"
+#include "Utility/ThreadPool.h"
+
+namespace Corvus
+{
+    using OccluderHandle = uint32_t;
+
+    // Occlusion culling without any GPU work for devices where the compute culler costs more than it saves.
+    // A few simplified occluder meshes are rasterized into a small depth buffer on the CPU, 8 pixels per step with
+    // coverage masks, and object boxes are then tested against it. Depth is stored as 1/w, larger is closer.
+    class SoftwareOcclusionCuller
+    {
+    public:
+        static constexpr uint32_t LANES = 8;
+
+        // The width is rounded up to a multiple of LANES so every row starts aligned
+        explicit SoftwareOcclusionCuller(uint32_t width = 256, uint32_t height = 128);
+
+        // Occluders have to lie inside the geometry they stand for, anything they cover is treated as hidden
+        OccluderHandle addOccluder(std::vector<glm::vec3> positions, std::vector<uint32_t> indices,
+                                   const glm::mat4& model);
+        void setTransform(OccluderHandle handle, const glm::mat4& model);
+        void removeOccluder(OccluderHandle handle);
+
+        // Clears the depth buffer and rasterizes every occluder, horizontal bands run on the workers
+        void render(const glm::mat4& viewProjection, ThreadPool& threadPool = ThreadPool::getInstance());
+        // Levels above what the CPU supports fall back to the best supported one
+        void render(const glm::mat4& viewProjection, SimdLevel level, ThreadPool& threadPool);
+
+        // Tests against the last render(). Boxes crossing the near plane are always visible.
+        [[nodiscard]] bool isVisible(const AABB& bounds) const;
+
+        // Drops every handle whose bounds[i] is hidden, the remaining handles keep their order
+        void cull(std::vector<CullHandle>& handles, const std::vector<AABB>& bounds,
+                  ThreadPool& threadPool = ThreadPool::getInstance()) const;
+
+        [[nodiscard]] uint32_t getOccluderCount() const { return m_OccluderCount; }
+        [[nodiscard]] uint32_t getWidth() const { return m_Width; }
+        [[nodiscard]] uint32_t getHeight() const { return m_Height; }
+        [[nodiscard]] const std::vector<float>& getDepth() const { return m_Depth; }
+
+    private:
+        // Screen space vertex, x and y in pixels with y pointing down and z = 1/w
+        using ScreenTriangle = std::array<glm::vec3, 3>;
+
+        struct Occluder
+        {
+            std::vector<glm::vec3> positions;
+            std::vector<uint32_t> indices;
+            glm::mat4 model = glm::mat4(1.0f);
+            bool active = false;
+
+            std::vector<ScreenTriangle> triangles; // Near plane clipped, rebuilt every render()
+        };
+
+        // Rows rasterized per work item, every band only touches its own part of the depth buffer
+        static constexpr uint32_t BAND_HEIGHT = 16;
+        static constexpr size_t MIN_OBJECTS_PER_TASK = 64;
+
+        uint32_t m_Width;
+        uint32_t m_Height;
+        std::vector<float> m_Depth;
+
+        std::vector<Occluder> m_Occluders;
+        std::vector<OccluderHandle> m_FreeHandles;
+        uint32_t m_OccluderCount = 0;
+
+        glm::mat4 m_ViewProjection = glm::mat4(1.0f);
+        SimdLevel m_Level = SimdLevel::Scalar;
+
+    private:
+        void transformOccluder(Occluder& occluder) const;
+        void rasterizeBand(uint32_t firstRow, uint32_t lastRow);
+        [[nodiscard]] bool testRect(uint32_t minX, uint32_t minY, uint32_t maxX, uint32_t maxY, float depth) const;
+    };
+} // Corvus
+
+#endif //ENGINE_SOFTWAREOCCLUSIONCULLER_H
@@ -0,0 +1,176 @@
+#include "BindlessDescriptors.h"
+
+#include <algorithm>
+
+#include "Utility/Corvus.h"
+
+namespace Corvus
+{
+    BindlessDescriptors::BindlessDescriptors(const DeviceDispatch& dispatch, VkDevice device,
+                                             DescriptorLayoutCache& layoutCache,
+                                             const DeviceCapabilities& capabilities)
+        : m_Dispatch(dispatch), m_Device(device)
+    {
+        const auto& limits = capabilities.vulkan12Properties;
+        getSlots(Binding::StorageBuffers).capacity = std::min({
+            MAX_STORAGE_BUFFERS, limits.maxDescriptorSetUpdateAfterBindStorageBuffers,
+            limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers
+        });
+        getSlots(Binding::SampledImages).capacity = std::min({
+            MAX_SAMPLED_IMAGES, limits.maxDescriptorSetUpdateAfterBindSampledImages,
+            limits.maxPerStageDescriptorUpdateAfterBindSampledImages
+        });
+        getSlots(Binding::Samplers).capacity = std::min({
+            MAX_SAMPLERS, limits.maxDescriptorSetUpdateAfterBindSamplers,
+            limits.maxPerStageDescriptorUpdateAfterBindSamplers
+        });
+
+        constexpr VkShaderStageFlags stages = VK_SHADER_STAGE_ALL_GRAPHICS bitor VK_SHADER_STAGE_COMPUTE_BIT;
+        std::vector<VkDescriptorSetLayoutBinding> bindings = {
+            {
+                .binding = static_cast<uint32_t>(Binding::StorageBuffers),
+                .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                .descriptorCount = getCapacity(Binding::StorageBuffers),
+                .stageFlags = stages,
+            },
+            {
+                .binding = static_cast<uint32_t>(Binding::SampledImages),
+                .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+                .descriptorCount = getCapacity(Binding::SampledImages),
+                .stageFlags = stages,
+            },
+            {
+                .binding = static_cast<uint32_t>(Binding::Samplers),
+                .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+                .descriptorCount = getCapacity(Binding::Samplers),
+                .stageFlags = stages,
+            },
+        };
+
+        // Unused slots may stay empty and slots not read by in-flight work may be written while the set is bound
+        constexpr VkDescriptorBindingFlags bindingFlags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT bitor
+                                                          VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT bitor
+                                                          VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+        m_Layout = layoutCache.getLayout(bindings, std::vector(bindings.size(), bindingFlags),
+                                         VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT);
+
+        std::array<VkDescriptorPoolSize, 3> poolSizes = {{
+            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, getCapacity(Binding::StorageBuffers)},
+            {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, getCapacity(Binding::SampledImages)},
+            {VK_DESCRIPTOR_TYPE_SAMPLER, getCapacity(Binding::Samplers)},
+        }};
+
+        VkDescriptorPoolCreateInfo poolInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+            .maxSets = 1,
+            .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+            .pPoolSizes = poolSizes.data(),
+        };
+
+        auto success = m_Dispatch.vkCreateDescriptorPool(m_Device, &poolInfo, nullptr, &m_Pool);
+        CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create bindless descriptor pool!")
+
+        VkDescriptorSetAllocateInfo allocInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .descriptorPool = m_Pool,
+            .descriptorSetCount = 1,
+            .pSetLayouts = &m_Layout,
+        };
+
+        success = m_Dispatch.vkAllocateDescriptorSets(m_Device, &allocInfo, &m_Set);
+        CORVUS_ASSERT(success == VK_SUCCESS, "Failed to allocate bindless descriptor set!")
+        CORVUS_LOG(info, "Bindless descriptors created: {} storage buffers, {} sampled images, {} samplers",
+                   getCapacity(Binding::StorageBuffers), getCapacity(Binding::SampledImages),
+                   getCapacity(Binding::Samplers));
+    }
+
+    BindlessDescriptors::~BindlessDescriptors()
+    {
+        m_Dispatch.vkDestroyDescriptorPool(m_Device, m_Pool, nullptr);
+    }
+
+    BindlessHandle BindlessDescriptors::registerStorageBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+    {
+        VkDescriptorBufferInfo bufferInfo = {.buffer = buffer, .offset = offset, .range = range};
+
+        std::lock_guard lock(m_Mutex);
+        auto handle = allocate(Binding::StorageBuffers);
+        write(Binding::StorageBuffers, handle, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, &bufferInfo, nullptr);
+        return handle;
+    }
+
+    BindlessHandle BindlessDescriptors::registerSampledImage(VkImageView imageView, VkImageLayout layout)
+    {
+        VkDescriptorImageInfo imageInfo = {.imageView = imageView, .imageLayout = layout};
+
+        std::lock_guard lock(m_Mutex);
+        auto handle = allocate(Binding::SampledImages);
+        write(Binding::SampledImages, handle, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, nullptr, &imageInfo);
+        return handle;
+    }
+
+    BindlessHandle BindlessDescriptors::registerSampler(VkSampler sampler)
+    {
+        VkDescriptorImageInfo imageInfo = {.sampler = sampler};
+
+        std::lock_guard lock(m_Mutex);
+        auto handle = allocate(Binding::Samplers);
+        write(Binding::Samplers, handle, VK_DESCRIPTOR_TYPE_SAMPLER, nullptr, &imageInfo);
+        return handle;
+    }
+
+    void BindlessDescriptors::release(Binding binding, BindlessHandle handle)
+    {
+        if (handle == INVALID_BINDLESS_HANDLE)
+            return;
+
+        std::lock_guard lock(m_Mutex);
+        getSlots(binding).retired.emplace_back(m_FrameNumber, handle);
+    }
+
+    void BindlessDescriptors::beginFrame(uint32_t framesInFlight)
+    {
+        std::lock_guard lock(m_Mutex);
+        m_FrameNumber++;
+        for (auto& slots: m_Slots)
+        {
+            while (not slots.retired.empty() and slots.retired.front().first + framesInFlight <= m_FrameNumber)
+            {
+                slots.free.push_back(slots.retired.front().second);
+                slots.retired.pop_front();
+            }
+        }
+    }
+
+    BindlessHandle BindlessDescriptors::allocate(Binding binding)
+    {
+        auto& slots = getSlots(binding);
+        if (not slots.free.empty())
+        {
+            auto handle = slots.free.back();
+            slots.free.pop_back();
+            return handle;
+        }
+
+        CORVUS_ASSERT(slots.next < slots.capacity, "Bindless descriptor array {} is full!",
+                      static_cast<uint32_t>(binding))
+        return slots.next++;
+    }
+
+    void BindlessDescriptors::write(Binding binding, BindlessHandle handle, VkDescriptorType type,
+                                    const VkDescriptorBufferInfo* bufferInfo, const VkDescriptorImageInfo* imageInfo)
+    {
+        VkWriteDescriptorSet descriptorWrite = {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = m_Set,
+            .dstBinding = static_cast<uint32_t>(binding),
+            .dstArrayElement = handle,
+            .descriptorCount = 1,
+            .descriptorType = type,
+            .pImageInfo = imageInfo,
+            .pBufferInfo = bufferInfo,
+        };
+        m_Dispatch.vkUpdateDescriptorSets(m_Device, 1, &descriptorWrite, 0, nullptr);
+    }
+} // Corvus
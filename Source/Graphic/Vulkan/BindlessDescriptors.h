@@ -0,0 +1,84 @@
+#ifndef ENGINE_BINDLESSDESCRIPTORS_H
+#define ENGINE_BINDLESSDESCRIPTORS_H
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "DescriptorLayoutCache.h"
+#include "DeviceCapabilities.h"
+#include "Dispatch.h"
+
+namespace Corvus
+{
+    // Index into one of the bindless arrays, small enough for push constants and per-instance data
+    using BindlessHandle = uint32_t;
+    constexpr BindlessHandle INVALID_BINDLESS_HANDLE = UINT32_MAX;
+
+    // One global descriptor set of large UPDATE_AFTER_BIND arrays. Resources are registered once and then
+    // addressed by handle from shaders (Shaders/Include/Bindless.glslh), so draws using different buffers or
+    // textures need no descriptor rebinding. The set is bound at SET_INDEX by every pipeline of the device.
+    class BindlessDescriptors
+    {
+    public:
+        enum class Binding : uint32_t { StorageBuffers, SampledImages, Samplers, Count };
+        static constexpr uint32_t SET_INDEX = 1;
+
+        BindlessDescriptors(const DeviceDispatch& dispatch, VkDevice device, DescriptorLayoutCache& layoutCache,
+                            const DeviceCapabilities& capabilities);
+        ~BindlessDescriptors();
+
+        BindlessDescriptors(const BindlessDescriptors&) = delete;
+        BindlessDescriptors& operator=(const BindlessDescriptors&) = delete;
+
+        [[nodiscard]] BindlessHandle registerStorageBuffer(VkBuffer buffer, VkDeviceSize offset = 0,
+                                                           VkDeviceSize range = VK_WHOLE_SIZE);
+        [[nodiscard]] BindlessHandle registerSampledImage(VkImageView imageView,
+                                                          VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        [[nodiscard]] BindlessHandle registerSampler(VkSampler sampler);
+
+        // The slot is only reused once frames that may still read it are done, see beginFrame
+        void release(Binding binding, BindlessHandle handle);
+        // Called once per frame, recycles handles released at least framesInFlight frames ago
+        void beginFrame(uint32_t framesInFlight);
+
+        [[nodiscard]] VkDescriptorSetLayout getLayout() const { return m_Layout; }
+        [[nodiscard]] VkDescriptorSet getSet() const { return m_Set; }
+        [[nodiscard]] uint32_t getCapacity(Binding binding) const { return getSlots(binding).capacity; }
+
+    private:
+        struct Slots
+        {
+            uint32_t capacity = 0;
+            uint32_t next = 0;
+            std::vector<BindlessHandle> free;
+            std::deque<std::pair<uint64_t, BindlessHandle>> retired; // Frame of release, handle
+        };
+
+        const DeviceDispatch& m_Dispatch;
+        VkDevice m_Device;
+
+        VkDescriptorSetLayout m_Layout = VK_NULL_HANDLE; // Owned by the layout cache
+        VkDescriptorPool m_Pool = VK_NULL_HANDLE;
+        VkDescriptorSet m_Set = VK_NULL_HANDLE;
+
+        std::mutex m_Mutex;
+        std::array<Slots, static_cast<size_t>(Binding::Count)> m_Slots;
+        uint64_t m_FrameNumber = 0;
+
+        static constexpr uint32_t MAX_STORAGE_BUFFERS = 1u << 16;
+        static constexpr uint32_t MAX_SAMPLED_IMAGES = 1u << 16;
+        static constexpr uint32_t MAX_SAMPLERS = 1u << 10;
+
+    private:
+        Slots& getSlots(Binding binding) { return m_Slots[static_cast<size_t>(binding)]; }
+        [[nodiscard]] const Slots& getSlots(Binding binding) const { return m_Slots[static_cast<size_t>(binding)]; }
+
+        BindlessHandle allocate(Binding binding);
+        void write(Binding binding, BindlessHandle handle, VkDescriptorType type,
+                   const VkDescriptorBufferInfo* bufferInfo, const VkDescriptorImageInfo* imageInfo);
+    };
+} // Corvus
+
+#endif //ENGINE_BINDLESSDESCRIPTORS_H
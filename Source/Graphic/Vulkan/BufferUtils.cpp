@@ -4,48 +4,50 @@
 
 #include "BufferUtils.h"
 
+#include "Device.h"
 #include "Utility/Corvus.h"
 
-void BufferUtils::createBuffer(VkDevice device, VkPhysicalDevice physicalDevice, VkDeviceSize size,
-                               VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer,
-                               VkDeviceMemory& bufferMemory)
+void BufferUtils::createBuffer(const Corvus::Device& device, VkDeviceSize size, VkBufferUsageFlags usage,
+                               VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory,
+                               const std::vector<uint32_t>& queueFamilies)
 
 {
+    const auto& vk = device.getDispatch();
+
     VkBufferCreateInfo bufferInfo = {
         .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
         .size = size,
         .usage = usage,
-        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .sharingMode = queueFamilies.size() > 1 ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = queueFamilies.size() > 1 ? static_cast<uint32_t>(queueFamilies.size()) : 0,
+        .pQueueFamilyIndices = queueFamilies.size() > 1 ? queueFamilies.data() : nullptr,
     };
 
-    auto result = vkCreateBuffer(device, &bufferInfo, nullptr, &buffer);
+    auto result = vk.vkCreateBuffer(device.getDevice(), &bufferInfo, nullptr, &buffer);
     CORVUS_ASSERT(result == VK_SUCCESS, "Failed to create buffer!")
 
     VkMemoryRequirements memRequirements;
-    vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
+    vk.vkGetBufferMemoryRequirements(device.getDevice(), buffer, &memRequirements);
 
     VkMemoryAllocateInfo allocInfo = {
         .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
         .allocationSize = memRequirements.size,
-        .memoryTypeIndex = findMemoryType(physicalDevice, memRequirements.memoryTypeBits, properties),
+        .memoryTypeIndex = findMemoryType(device.getCapabilities().memoryProperties, memRequirements.memoryTypeBits, properties),
     };
 
-    result = vkAllocateMemory(device, &allocInfo, nullptr, &bufferMemory);
+    result = vk.vkAllocateMemory(device.getDevice(), &allocInfo, nullptr, &bufferMemory);
     CORVUS_ASSERT(result == VK_SUCCESS, "Failed to allocate buffer memory!")
 
-    vkBindBufferMemory(device, buffer, bufferMemory, 0);
+    vk.vkBindBufferMemory(device.getDevice(), buffer, bufferMemory, 0);
 }
 
 
-uint32_t BufferUtils::findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter,
+uint32_t BufferUtils::findMemoryType(const VkPhysicalDeviceMemoryProperties& memoryProperties, uint32_t typeFilter,
                                      const VkMemoryPropertyFlags properties)
 {
-    VkPhysicalDeviceMemoryProperties memProperties;
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
-
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
     {
-        if ((typeFilter bitand (1 << i)) and (memProperties.memoryTypes[i].propertyFlags bitand properties) ==
+        if ((typeFilter bitand (1 << i)) and (memoryProperties.memoryTypes[i].propertyFlags bitand properties) ==
             properties)
         {
             return i;
@@ -54,33 +56,34 @@ uint32_t BufferUtils::findMemoryType(VkPhysicalDevice physicalDevice, uint32_t t
     CORVUS_ASSERT(false, "Failed to find suitable memory type!")
 }
 
-void BufferUtils::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize deviceSize, VkCommandPool commandPool,
-                             VkDevice device, VkQueue graphicsQueue)
+void BufferUtils::copyBuffer(const Corvus::Device& device, VkBuffer srcBuffer, VkBuffer dstBuffer,
+                             VkDeviceSize deviceSize)
 {
+    const auto& vk = device.getDispatch();
     VkCommandBufferAllocateInfo allocInfo = {
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-        .commandPool = commandPool,
+        .commandPool = device.getCommandPool(),
         .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
         .commandBufferCount = 1,
     };
 
     VkCommandBuffer commandBuffer;
-    vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer);
+    vk.vkAllocateCommandBuffers(device.getDevice(), &allocInfo, &commandBuffer);
 
     VkCommandBufferBeginInfo beginInfo = {
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
         .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
     };
 
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    vk.vkBeginCommandBuffer(commandBuffer, &beginInfo);
     VkBufferCopy copyRegion = {
         .srcOffset = 0,
         .dstOffset = 0,
         .size = deviceSize,
     };
 
-    vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-    vkEndCommandBuffer(commandBuffer);
+    vk.vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+    vk.vkEndCommandBuffer(commandBuffer);
 
     VkSubmitInfo submitInfo = {
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
@@ -88,7 +91,8 @@ void BufferUtils::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSiz
         .pCommandBuffers = &commandBuffer,
     };
 
-    vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(graphicsQueue);
-    vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+    auto& queue = device.getQueue(Corvus::QueueRole::Graphics);
+    queue.submit(submitInfo, VK_NULL_HANDLE);
+    queue.waitIdle();
+    vk.vkFreeCommandBuffers(device.getDevice(), device.getCommandPool(), 1, &commandBuffer);
 }
@@ -5,21 +5,29 @@
 #ifndef BUFFER_H
 #define BUFFER_H
 
+#include <vector>
 #include <vulkan/vulkan_core.h>
 
+namespace Corvus
+{
+    class Device;
+}
+
 class BufferUtils
 {
 public:
-    static void createBuffer(VkDevice device, VkPhysicalDevice physicalDevice, VkDeviceSize size,
+    // More than one queue family makes the buffer concurrently shared between them, see
+    // Device::getSharedQueueFamilies
+    static void createBuffer(const Corvus::Device& device, VkDeviceSize size,
                              VkBufferUsageFlags usage,
                              VkMemoryPropertyFlags properties,
-                             VkBuffer& buffer, VkDeviceMemory& bufferMemory);
+                             VkBuffer& buffer, VkDeviceMemory& bufferMemory,
+                             const std::vector<uint32_t>& queueFamilies = {});
 
-    static uint32_t findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter,
+    static uint32_t findMemoryType(const VkPhysicalDeviceMemoryProperties& memoryProperties, uint32_t typeFilter,
                                    VkMemoryPropertyFlags properties);
 
-    static void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, uint64_t deviceSize, VkCommandPool commandPool,
-                           VkDevice device, VkQueue graphicsQueue);
+    static void copyBuffer(const Corvus::Device& device, VkBuffer srcBuffer, VkBuffer dstBuffer, uint64_t deviceSize);
 };
 
 
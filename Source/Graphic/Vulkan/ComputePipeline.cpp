@@ -0,0 +1,129 @@
+#include "ComputePipeline.h"
+
+#include "Pipeline.h"
+#include "Utility/Log.h"
+
+namespace Corvus
+{
+    ComputePipeline::ComputePipeline(std::shared_ptr<Device> device, const std::string& shader,
+                                     const std::vector<VkDescriptorType>& bindings, uint32_t pushConstantSize,
+                                     const char* identifier)
+        : ComputePipeline(std::move(device), Pipeline::readFile(shader), bindings, pushConstantSize, identifier)
+    {
+    }
+
+    ComputePipeline::ComputePipeline(std::shared_ptr<Device> device, const std::vector<char>& code,
+                                     const std::vector<VkDescriptorType>& bindings, uint32_t pushConstantSize,
+                                     const char* identifier)
+        : m_Device(std::move(device)),
+          m_Shader(identifier, code, m_Device),
+          m_PushConstantSize(pushConstantSize)
+    {
+        CORVUS_ASSERT(pushConstantSize % 4 == 0 and pushConstantSize <= MIN_PUSH_CONSTANT_SIZE,
+                      "{} push constants must be a multiple of 4 and at most {} bytes!", identifier,
+                      MIN_PUSH_CONSTANT_SIZE)
+        createPipelineLayout(bindings);
+        createComputePipeline();
+    }
+
+    ComputePipeline::~ComputePipeline()
+    {
+        const auto& vk = m_Device->getDispatch();
+        vk.vkDestroyPipeline(m_Device->getDevice(), m_Pipeline, nullptr);
+        vk.vkDestroyPipelineLayout(m_Device->getDevice(), m_PipelineLayout, nullptr);
+    }
+
+    void ComputePipeline::bind(VkCommandBuffer commandBuffer, VkDescriptorSet descriptorSet) const
+    {
+        const auto& vk = m_Device->getDispatch();
+        vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline);
+        vk.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1,
+                                   &descriptorSet, 0, nullptr);
+    }
+
+    void ComputePipeline::dispatch(VkCommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY,
+                                   uint32_t groupCountZ) const
+    {
+        if (groupCountX == 0 or groupCountY == 0 or groupCountZ == 0)
+            return;
+        m_Device->getDispatch().vkCmdDispatch(commandBuffer, groupCountX, groupCountY, groupCountZ);
+    }
+
+    void ComputePipeline::dispatchIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset) const
+    {
+        m_Device->getDispatch().vkCmdDispatchIndirect(commandBuffer, buffer, offset);
+    }
+
+    void ComputePipeline::pushConstants(VkCommandBuffer commandBuffer, const void* data, uint32_t size) const
+    {
+        CORVUS_ASSERT(size <= m_PushConstantSize, "Push constants exceed the {} pipeline's range!",
+                      m_Shader.getIdentifier())
+        m_Device->getDispatch().vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                                                   size, data);
+    }
+
+    void ComputePipeline::createPipelineLayout(const std::vector<VkDescriptorType>& bindings)
+    {
+        std::vector<VkDescriptorSetLayoutBinding> layoutBindings;
+        layoutBindings.reserve(bindings.size());
+        for (uint32_t binding = 0; binding < bindings.size(); binding++)
+        {
+            layoutBindings.push_back({
+                .binding = binding,
+                .descriptorType = bindings[binding],
+                .descriptorCount = 1,
+                .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+                .pImmutableSamplers = nullptr,
+            });
+        }
+        m_DescriptorSetLayout = m_Device->getDescriptorLayoutCache().getLayout(layoutBindings);
+
+        VkPushConstantRange pushConstantRange = {
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+            .offset = 0,
+            .size = m_PushConstantSize,
+        };
+
+        VkPipelineLayoutCreateInfo layoutInfo = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            .setLayoutCount = 1,
+            .pSetLayouts = &m_DescriptorSetLayout,
+            .pushConstantRangeCount = m_PushConstantSize > 0 ? 1u : 0u,
+            .pPushConstantRanges = &pushConstantRange,
+        };
+        auto success = m_Device->getDispatch().vkCreatePipelineLayout(m_Device->getDevice(), &layoutInfo, nullptr,
+                                                                      &m_PipelineLayout);
+        CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create {} pipeline layout!", m_Shader.getIdentifier())
+    }
+
+    void ComputePipeline::createComputePipeline()
+    {
+        VkComputePipelineCreateInfo pipelineInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+            .stage = {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+                .module = m_Shader.getModule(),
+                .pName = "main",
+            },
+            .layout = m_PipelineLayout,
+        };
+        auto success = m_Device->getDispatch().vkCreateComputePipelines(m_Device->getDevice(), VK_NULL_HANDLE, 1,
+                                                                        &pipelineInfo, nullptr, &m_Pipeline);
+        CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create {} pipeline!", m_Shader.getIdentifier())
+    }
+
+    void memoryBarrier(const Device& device, VkCommandBuffer commandBuffer, VkPipelineStageFlags sourceStage,
+                       VkAccessFlags sourceAccess, VkPipelineStageFlags destinationStage,
+                       VkAccessFlags destinationAccess)
+    {
+        VkMemoryBarrier barrier = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = sourceAccess,
+            .dstAccessMask = destinationAccess,
+        };
+
+        device.getDispatch().vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 1, &barrier, 0,
+                                                  nullptr, 0, nullptr);
+    }
+} // Corvus
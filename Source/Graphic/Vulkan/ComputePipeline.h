@@ -0,0 +1,74 @@
+#ifndef ENGINE_COMPUTEPIPELINE_H
+#define ENGINE_COMPUTEPIPELINE_H
+
+#include <string>
+#include <vector>
+
+#include "Device.h"
+#include "PushConstants.h"
+#include "Shader.h"
+
+#include "Utility/Corvus.h"
+
+namespace Corvus
+{
+    // Compute shader with a single descriptor set and an optional push constant range. Binding i of the set has
+    // the i-th descriptor type, storage buffers and storage images are written with DescriptorWrite.
+    class ComputePipeline
+    {
+    public:
+        ComputePipeline(std::shared_ptr<Device> device, const std::string& shader,
+                        const std::vector<VkDescriptorType>& bindings, uint32_t pushConstantSize = 0,
+                        const char* identifier = "Compute");
+        ComputePipeline(std::shared_ptr<Device> device, const std::vector<char>& code,
+                        const std::vector<VkDescriptorType>& bindings, uint32_t pushConstantSize = 0,
+                        const char* identifier = "Compute");
+        ~ComputePipeline();
+
+        ComputePipeline(const ComputePipeline&) = delete;
+        ComputePipeline& operator=(const ComputePipeline&) = delete;
+
+        [[nodiscard]] VkPipeline getPipeline() const { return m_Pipeline; }
+        [[nodiscard]] VkPipelineLayout getPipelineLayout() const { return m_PipelineLayout; }
+        [[nodiscard]] VkDescriptorSetLayout getDescriptorSetLayout() const { return m_DescriptorSetLayout; }
+        [[nodiscard]] uint32_t getPushConstantSize() const { return m_PushConstantSize; }
+
+        void bind(VkCommandBuffer commandBuffer, VkDescriptorSet descriptorSet) const;
+        void dispatch(VkCommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY = 1,
+                      uint32_t groupCountZ = 1) const;
+        // Group counts read from a VkDispatchIndirectCommand the GPU wrote
+        void dispatchIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset = 0) const;
+
+        template<PushConstantData T>
+        void pushConstants(VkCommandBuffer commandBuffer, const T& data) const
+        {
+            pushConstants(commandBuffer, &data, sizeof(T));
+        }
+        void pushConstants(VkCommandBuffer commandBuffer, const void* data, uint32_t size) const;
+
+        // Workgroups needed to cover count invocations
+        [[nodiscard]] static uint32_t getGroupCount(uint32_t count, uint32_t groupSize)
+        {
+            return (count + groupSize - 1) / groupSize;
+        }
+
+    private:
+        std::shared_ptr<Device> m_Device;
+        Shader m_Shader;
+        uint32_t m_PushConstantSize;
+
+        VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+        VkPipeline m_Pipeline = VK_NULL_HANDLE;
+        VkDescriptorSetLayout m_DescriptorSetLayout = VK_NULL_HANDLE; // Owned by the device's layout cache
+
+        void createPipelineLayout(const std::vector<VkDescriptorType>& bindings);
+        void createComputePipeline();
+    };
+
+    // Global memory dependency between two passes recorded into the same command buffer
+    void memoryBarrier(const Device& device, VkCommandBuffer commandBuffer, VkPipelineStageFlags sourceStage,
+                       VkAccessFlags sourceAccess, VkPipelineStageFlags destinationStage,
+                       VkAccessFlags destinationAccess);
+} // Corvus
+
+#endif //ENGINE_COMPUTEPIPELINE_H
@@ -0,0 +1,120 @@
+#include "DescriptorAllocator.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace Corvus
+{
+    DescriptorAllocator::DescriptorAllocator(std::shared_ptr<Device> device, uint32_t setsPerPool,
+                                             std::vector<PoolSizeRatio> ratios)
+        : m_Device(std::move(device)), m_Ratios(std::move(ratios)), m_SetsPerPool(setsPerPool)
+    {
+    }
+
+    DescriptorAllocator::~DescriptorAllocator()
+    {
+        const auto& vk = m_Device->getDispatch();
+        for (auto pool: m_UsedPools)
+            vk.vkDestroyDescriptorPool(m_Device->getDevice(), pool, nullptr);
+        for (auto pool: m_FreePools)
+            vk.vkDestroyDescriptorPool(m_Device->getDevice(), pool, nullptr);
+    }
+
+    std::vector<DescriptorAllocator::PoolSizeRatio> DescriptorAllocator::getDefaultRatios()
+    {
+        return {
+            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.0f},
+            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f},
+            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2.0f},
+            {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2.0f},
+            {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1.0f},
+            {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f},
+            {VK_DESCRIPTOR_TYPE_SAMPLER, 0.5f},
+        };
+    }
+
+    VkDescriptorSet DescriptorAllocator::allocate(VkDescriptorSetLayout layout)
+    {
+        if (m_CurrentPool == VK_NULL_HANDLE)
+            m_CurrentPool = grabPool();
+
+        VkDescriptorSetAllocateInfo allocInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .descriptorPool = m_CurrentPool,
+            .descriptorSetCount = 1,
+            .pSetLayouts = &layout,
+        };
+
+        const auto& vk = m_Device->getDispatch();
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        auto result = vk.vkAllocateDescriptorSets(m_Device->getDevice(), &allocInfo, &set);
+
+        // The current pool is exhausted, retire it and retry once with a fresh one
+        if (result == VK_ERROR_OUT_OF_POOL_MEMORY or result == VK_ERROR_FRAGMENTED_POOL)
+        {
+            m_CurrentPool = grabPool();
+            allocInfo.descriptorPool = m_CurrentPool;
+            result = vk.vkAllocateDescriptorSets(m_Device->getDevice(), &allocInfo, &set);
+        }
+
+        CORVUS_ASSERT(result == VK_SUCCESS, "Failed to allocate descriptor set!")
+        return set;
+    }
+
+    void DescriptorAllocator::reset()
+    {
+        const auto& vk = m_Device->getDispatch();
+        for (auto pool: m_UsedPools)
+        {
+            vk.vkResetDescriptorPool(m_Device->getDevice(), pool, 0);
+            m_FreePools.push_back(pool);
+        }
+        m_UsedPools.clear();
+        m_CurrentPool = VK_NULL_HANDLE;
+    }
+
+    VkDescriptorPool DescriptorAllocator::grabPool()
+    {
+        VkDescriptorPool pool;
+        if (not m_FreePools.empty())
+        {
+            pool = m_FreePools.back();
+            m_FreePools.pop_back();
+        }
+        else
+        {
+            pool = createPool(m_SetsPerPool);
+            m_SetsPerPool = std::min(m_SetsPerPool + m_SetsPerPool / 2, MAX_SETS_PER_POOL); // Grow the next one
+        }
+
+        m_UsedPools.push_back(pool);
+        return pool;
+    }
+
+    VkDescriptorPool DescriptorAllocator::createPool(uint32_t setCount)
+    {
+        std::vector<VkDescriptorPoolSize> poolSizes;
+        poolSizes.reserve(m_Ratios.size());
+        for (const auto& ratio: m_Ratios)
+        {
+            poolSizes.push_back({
+                .type = ratio.type,
+                .descriptorCount = std::max(1u, static_cast<uint32_t>(ratio.ratio * static_cast<float>(setCount))),
+            });
+        }
+
+        VkDescriptorPoolCreateInfo poolInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .flags = 0,
+            .maxSets = setCount,
+            .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+            .pPoolSizes = poolSizes.data(),
+        };
+
+        VkDescriptorPool pool;
+        auto success = m_Device->getDispatch().vkCreateDescriptorPool(m_Device->getDevice(), &poolInfo, nullptr, &pool);
+        CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create descriptor pool!")
+        CORVUS_LOG(trace, "Descriptor pool created for {} sets", setCount);
+        return pool;
+    }
+} // Corvus
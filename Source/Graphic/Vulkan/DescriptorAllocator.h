@@ -0,0 +1,52 @@
+#ifndef ENGINE_DESCRIPTORALLOCATOR_H
+#define ENGINE_DESCRIPTORALLOCATOR_H
+
+#include <memory>
+#include <vector>
+
+#include "Device.h"
+
+namespace Corvus
+{
+    // Linear descriptor set allocator. Pools are created on demand when the current one runs out and are
+    // all recycled by a single reset(), so the owner resets it once the sets can no longer be in use
+    // (e.g. once per frame in flight after waiting on its fence). Not thread safe, use one per thread.
+    class DescriptorAllocator
+    {
+    public:
+        struct PoolSizeRatio
+        {
+            VkDescriptorType type;
+            float ratio; // Descriptors of this type per set
+        };
+
+        explicit DescriptorAllocator(std::shared_ptr<Device> device, uint32_t setsPerPool = 64,
+                                     std::vector<PoolSizeRatio> ratios = getDefaultRatios());
+        ~DescriptorAllocator();
+
+        DescriptorAllocator(const DescriptorAllocator&) = delete;
+        DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+        [[nodiscard]] VkDescriptorSet allocate(VkDescriptorSetLayout layout);
+        void reset();
+
+        static std::vector<PoolSizeRatio> getDefaultRatios();
+
+    private:
+        std::shared_ptr<Device> m_Device;
+        std::vector<PoolSizeRatio> m_Ratios;
+        uint32_t m_SetsPerPool;
+
+        VkDescriptorPool m_CurrentPool = VK_NULL_HANDLE;
+        std::vector<VkDescriptorPool> m_UsedPools;
+        std::vector<VkDescriptorPool> m_FreePools;
+
+        static constexpr uint32_t MAX_SETS_PER_POOL = 4096;
+
+    private:
+        VkDescriptorPool grabPool();
+        VkDescriptorPool createPool(uint32_t setCount);
+    };
+} // Corvus
+
+#endif //ENGINE_DESCRIPTORALLOCATOR_H
@@ -0,0 +1,93 @@
+#include "DescriptorLayoutCache.h"
+
+#include <algorithm>
+
+#include "Utility/Corvus.h"
+#include "Utility/Hash.h"
+
+namespace Corvus
+{
+    bool DescriptorLayoutKey::operator==(const DescriptorLayoutKey& other) const
+    {
+        return flags == other.flags and bindingFlags == other.bindingFlags and std::ranges::equal(bindings, other.bindings, [](const auto& a, const auto& b)
+        {
+            return a.binding == b.binding and a.descriptorType == b.descriptorType and
+                   a.descriptorCount == b.descriptorCount and a.stageFlags == b.stageFlags and
+                   a.pImmutableSamplers == b.pImmutableSamplers;
+        });
+    }
+
+    size_t DescriptorLayoutKeyHash::operator()(const DescriptorLayoutKey& key) const
+    {
+        size_t seed = key.bindings.size();
+        hashCombine(seed, key.flags);
+        for (auto flags: key.bindingFlags)
+            hashCombine(seed, flags);
+        for (const auto& binding: key.bindings)
+        {
+            hashCombine(seed, binding.binding);
+            hashCombine(seed, static_cast<uint32_t>(binding.descriptorType));
+            hashCombine(seed, binding.descriptorCount);
+            hashCombine(seed, binding.stageFlags);
+        }
+        return seed;
+    }
+
+    DescriptorLayoutCache::DescriptorLayoutCache(const DeviceDispatch& dispatch, VkDevice device)
+        : m_Dispatch(dispatch), m_Device(device)
+    {
+    }
+
+    DescriptorLayoutCache::~DescriptorLayoutCache()
+    {
+        for (const auto& [key, layout]: m_Layouts)
+            m_Dispatch.vkDestroyDescriptorSetLayout(m_Device, layout, nullptr);
+    }
+
+    VkDescriptorSetLayout DescriptorLayoutCache::getLayout(std::vector<VkDescriptorSetLayoutBinding> bindings,
+                                                           std::vector<VkDescriptorBindingFlags> bindingFlags,
+                                                           VkDescriptorSetLayoutCreateFlags flags)
+    {
+        CORVUS_ASSERT(bindingFlags.empty() or bindingFlags.size() == bindings.size(),
+                      "Descriptor binding flags must be given for every binding!")
+
+        // Canonical order so the same bindings declared in a different order hit the same entry
+        std::vector<size_t> order(bindings.size());
+        for (size_t i = 0; i < order.size(); i++)
+            order[i] = i;
+        std::ranges::sort(order, {}, [&bindings](size_t i) { return bindings[i].binding; });
+
+        DescriptorLayoutKey key{.flags = flags};
+        for (size_t i: order)
+        {
+            key.bindings.push_back(bindings[i]);
+            if (not bindingFlags.empty())
+                key.bindingFlags.push_back(bindingFlags[i]);
+        }
+
+        std::lock_guard lock(m_Mutex);
+        if (auto it = m_Layouts.find(key); it != m_Layouts.end())
+            return it->second;
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+            .bindingCount = static_cast<uint32_t>(key.bindingFlags.size()),
+            .pBindingFlags = key.bindingFlags.data(),
+        };
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .pNext = key.bindingFlags.empty() ? nullptr : &bindingFlagsInfo,
+            .flags = key.flags,
+            .bindingCount = static_cast<uint32_t>(key.bindings.size()),
+            .pBindings = key.bindings.data()
+        };
+
+        VkDescriptorSetLayout layout;
+        auto success = m_Dispatch.vkCreateDescriptorSetLayout(m_Device, &layoutInfo, nullptr, &layout);
+        CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create descriptor set layout!")
+
+        m_Layouts.emplace(std::move(key), layout);
+        return layout;
+    }
+} // Corvus
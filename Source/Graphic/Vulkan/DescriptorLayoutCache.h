@@ -0,0 +1,51 @@
+#ifndef ENGINE_DESCRIPTORLAYOUTCACHE_H
+#define ENGINE_DESCRIPTORLAYOUTCACHE_H
+
+#include <vulkan/vulkan_core.h>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Dispatch.h"
+
+namespace Corvus
+{
+    struct DescriptorLayoutKey
+    {
+        std::vector<VkDescriptorSetLayoutBinding> bindings; // Sorted by binding number
+        std::vector<VkDescriptorBindingFlags> bindingFlags; // Empty or one per binding
+        VkDescriptorSetLayoutCreateFlags flags = 0;
+
+        bool operator==(const DescriptorLayoutKey& other) const;
+    };
+
+    struct DescriptorLayoutKeyHash
+    {
+        size_t operator()(const DescriptorLayoutKey& key) const;
+    };
+
+    // Deduplicates descriptor set layouts, pipelines declaring the same bindings share one VkDescriptorSetLayout.
+    // Owned by the Device and thread safe, since pipelines are created from worker threads during boot.
+    class DescriptorLayoutCache
+    {
+    public:
+        DescriptorLayoutCache(const DeviceDispatch& dispatch, VkDevice device);
+        ~DescriptorLayoutCache();
+
+        DescriptorLayoutCache(const DescriptorLayoutCache&) = delete;
+        DescriptorLayoutCache& operator=(const DescriptorLayoutCache&) = delete;
+
+        [[nodiscard]] VkDescriptorSetLayout getLayout(std::vector<VkDescriptorSetLayoutBinding> bindings,
+                                                      std::vector<VkDescriptorBindingFlags> bindingFlags = {},
+                                                      VkDescriptorSetLayoutCreateFlags flags = 0);
+
+    private:
+        const DeviceDispatch& m_Dispatch;
+        VkDevice m_Device;
+
+        std::mutex m_Mutex;
+        std::unordered_map<DescriptorLayoutKey, VkDescriptorSetLayout, DescriptorLayoutKeyHash> m_Layouts;
+    };
+} // Corvus
+
+#endif //ENGINE_DESCRIPTORLAYOUTCACHE_H
@@ -0,0 +1,132 @@
+#include "DescriptorSetCache.h"
+
+#include <utility>
+
+#include "Utility/Hash.h"
+
+namespace Corvus
+{
+    DescriptorWrite DescriptorWrite::buffer(uint32_t binding, VkDescriptorType type, VkBuffer buffer,
+                                            VkDeviceSize offset, VkDeviceSize range)
+    {
+        return {
+            .binding = binding,
+            .type = type,
+            .bufferInfo = {.buffer = buffer, .offset = offset, .range = range},
+        };
+    }
+
+    DescriptorWrite DescriptorWrite::image(uint32_t binding, VkDescriptorType type, VkImageView imageView,
+                                           VkSampler sampler, VkImageLayout layout)
+    {
+        return {
+            .binding = binding,
+            .type = type,
+            .imageInfo = {.sampler = sampler, .imageView = imageView, .imageLayout = layout},
+        };
+    }
+
+    DescriptorWrite DescriptorWrite::storageBuffer(uint32_t binding, VkBuffer buffer, VkDeviceSize offset,
+                                                   VkDeviceSize range)
+    {
+        return DescriptorWrite::buffer(binding, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, buffer, offset, range);
+    }
+
+    DescriptorWrite DescriptorWrite::storageImage(uint32_t binding, VkImageView imageView)
+    {
+        return DescriptorWrite::image(binding, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, imageView, VK_NULL_HANDLE,
+                                      VK_IMAGE_LAYOUT_GENERAL);
+    }
+
+    bool DescriptorWrite::isImage() const
+    {
+        switch (type)
+        {
+        case VK_DESCRIPTOR_TYPE_SAMPLER:
+        case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+        case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+        case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+        case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool DescriptorWrite::operator==(const DescriptorWrite& other) const
+    {
+        return binding == other.binding and type == other.type and
+               bufferInfo.buffer == other.bufferInfo.buffer and bufferInfo.offset == other.bufferInfo.offset and
+               bufferInfo.range == other.bufferInfo.range and
+               imageInfo.sampler == other.imageInfo.sampler and imageInfo.imageView == other.imageInfo.imageView and
+               imageInfo.imageLayout == other.imageInfo.imageLayout;
+    }
+
+    size_t DescriptorSetKeyHash::operator()(const DescriptorSetKey& key) const
+    {
+        size_t seed = std::hash<VkDescriptorSetLayout>{}(key.layout);
+        for (const auto& write: key.writes)
+        {
+            hashCombine(seed, write.binding);
+            hashCombine(seed, static_cast<uint32_t>(write.type));
+            if (write.isImage())
+            {
+                hashCombine(seed, write.imageInfo.imageView);
+                hashCombine(seed, write.imageInfo.sampler);
+                hashCombine(seed, static_cast<uint32_t>(write.imageInfo.imageLayout));
+            }
+            else
+            {
+                hashCombine(seed, write.bufferInfo.buffer);
+                hashCombine(seed, write.bufferInfo.offset);
+                hashCombine(seed, write.bufferInfo.range);
+            }
+        }
+        return seed;
+    }
+
+    DescriptorSetCache::DescriptorSetCache(std::shared_ptr<Device> device, DescriptorAllocator& allocator)
+        : m_Device(std::move(device)), m_Allocator(allocator)
+    {
+    }
+
+    VkDescriptorSet DescriptorSetCache::get(VkDescriptorSetLayout layout, const std::vector<DescriptorWrite>& writes)
+    {
+        DescriptorSetKey key{layout, writes};
+        if (auto it = m_Sets.find(key); it != m_Sets.end())
+            return it->second;
+
+        VkDescriptorSet set = m_Allocator.allocate(layout);
+        write(set, writes);
+        m_Sets.emplace(std::move(key), set);
+        return set;
+    }
+
+    void DescriptorSetCache::clear()
+    {
+        m_Sets.clear();
+    }
+
+    void DescriptorSetCache::write(VkDescriptorSet set, const std::vector<DescriptorWrite>& writes) const
+    {
+        std::vector<VkWriteDescriptorSet> descriptorWrites;
+        descriptorWrites.reserve(writes.size());
+        for (const auto& write: writes)
+        {
+            descriptorWrites.push_back({
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = set,
+                .dstBinding = write.binding,
+                .dstArrayElement = 0,
+                .descriptorCount = 1,
+                .descriptorType = write.type,
+                .pImageInfo = write.isImage() ? &write.imageInfo : nullptr,
+                .pBufferInfo = write.isImage() ? nullptr : &write.bufferInfo,
+            });
+        }
+
+        m_Device->getDispatch().vkUpdateDescriptorSets(m_Device->getDevice(),
+                                                       static_cast<uint32_t>(descriptorWrites.size()),
+                                                       descriptorWrites.data(), 0, nullptr);
+    }
+} // Corvus
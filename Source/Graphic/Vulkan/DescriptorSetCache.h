@@ -0,0 +1,73 @@
+#ifndef ENGINE_DESCRIPTORSETCACHE_H
+#define ENGINE_DESCRIPTORSETCACHE_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "DescriptorAllocator.h"
+#include "Device.h"
+
+namespace Corvus
+{
+    // Contents of a single descriptor binding, either a buffer range or an image / sampler
+    struct DescriptorWrite
+    {
+        uint32_t binding = 0;
+        VkDescriptorType type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        VkDescriptorBufferInfo bufferInfo{};
+        VkDescriptorImageInfo imageInfo{};
+
+        static DescriptorWrite buffer(uint32_t binding, VkDescriptorType type, VkBuffer buffer,
+                                      VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+        static DescriptorWrite image(uint32_t binding, VkDescriptorType type, VkImageView imageView,
+                                     VkSampler sampler = VK_NULL_HANDLE,
+                                     VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+        // Shorthands for compute bindings, storage images are read and written in the general layout
+        static DescriptorWrite storageBuffer(uint32_t binding, VkBuffer buffer, VkDeviceSize offset = 0,
+                                             VkDeviceSize range = VK_WHOLE_SIZE);
+        static DescriptorWrite storageImage(uint32_t binding, VkImageView imageView);
+
+        [[nodiscard]] bool isImage() const;
+        bool operator==(const DescriptorWrite& other) const;
+    };
+
+    struct DescriptorSetKey
+    {
+        VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+        std::vector<DescriptorWrite> writes;
+
+        bool operator==(const DescriptorSetKey& other) const = default;
+    };
+
+    struct DescriptorSetKeyHash
+    {
+        size_t operator()(const DescriptorSetKey& key) const;
+    };
+
+    // Hands out descriptor sets keyed by their binding contents. The first request for a combination allocates
+    // and writes the set, every later one is a hash lookup. Sets come from the given allocator, so clear() has
+    // to be called whenever that allocator is reset.
+    class DescriptorSetCache
+    {
+    public:
+        DescriptorSetCache(std::shared_ptr<Device> device, DescriptorAllocator& allocator);
+
+        [[nodiscard]] VkDescriptorSet get(VkDescriptorSetLayout layout, const std::vector<DescriptorWrite>& writes);
+        void clear();
+
+        [[nodiscard]] size_t getSize() const { return m_Sets.size(); }
+
+    private:
+        std::shared_ptr<Device> m_Device;
+        DescriptorAllocator& m_Allocator;
+
+        std::unordered_map<DescriptorSetKey, VkDescriptorSet, DescriptorSetKeyHash> m_Sets;
+
+    private:
+        void write(VkDescriptorSet set, const std::vector<DescriptorWrite>& writes) const;
+    };
+} // Corvus
+
+#endif //ENGINE_DESCRIPTORSETCACHE_H
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <map>
 #include <utility>
 #include <set>
 
@@ -8,30 +10,48 @@
 
 namespace Corvus
 {
-    Device::Device(std::shared_ptr<Window> window)
+    Device::Device(std::shared_ptr<Window> window, const DeviceSelection &selection, const DeviceFeatures &features)
             : m_Window(std::move(window)),
-              m_Instance(),
+              m_Instance(m_Window != nullptr),
               m_DebugMessenger(&m_Instance)
     {
-        createWindowSurface();
-        pickPhysicalDevice();
+        if (not isHeadless())
+        {
+            m_DeviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+            createWindowSurface();
+        }
+        pickPhysicalDevice(selection);
+        enableFeatures(features);
         createLogicalDevice();
 
-        m_SwapChain = SwapChain(m_Device, m_PhysicalDevice, m_Surface, m_Window->getHandle());
-        createImageViews();
-        createRenderPass();
-        createFramebuffers();
+        if (not isHeadless())
+        {
+            m_SwapChain = SwapChain(*this);
+            createImageViews();
+            createDepthResources();
+            if (not m_EnabledFeatures.dynamicRendering)
+            {
+                createRenderPass();
+                createFramebuffers();
+            }
+        }
         createCommandPool();
     }
 
     Device::~Device()
     {
-        vkDestroyCommandPool(m_Device, m_CommandPool, nullptr);
-
-        vkDestroyRenderPass(m_Device, m_RenderPass, nullptr);
-        m_SwapChain.destroy(m_Device);
-        vkDestroyDevice(m_Device, nullptr);
-        vkDestroySurfaceKHR(m_Instance.getInstance(), m_Surface, nullptr);
+        m_Dispatch.vkDestroyCommandPool(m_Device, m_ComputeCommandPool, nullptr);
+        m_Dispatch.vkDestroyCommandPool(m_Device, m_CommandPool, nullptr);
+
+        m_Dispatch.vkDestroyRenderPass(m_Device, m_RenderPass, nullptr);
+        if (not isHeadless())
+            m_SwapChain.destroy(*this);
+        m_BindlessDescriptors.reset();
+        m_DescriptorLayoutCache.reset();
+        m_SamplerCache.reset();
+        m_Dispatch.vkDestroyDevice(m_Device, nullptr);
+        if (m_Surface != VK_NULL_HANDLE) // The surface extension is not even loaded without a window
+            m_Instance.getDispatch().vkDestroySurfaceKHR(m_Instance.getInstance(), m_Surface, nullptr);
     }
 
     void Device::createWindowSurface()
@@ -41,83 +61,167 @@ namespace Corvus
         CORVUS_LOG(info, "Window surface created successfully!");
     }
 
-    void Device::pickPhysicalDevice()
+    void Device::pickPhysicalDevice(const DeviceSelection &selection)
     {
+        const auto &vk = m_Instance.getDispatch();
+
         uint32_t deviceCount = 0;
-        vkEnumeratePhysicalDevices(m_Instance.getInstance(), &deviceCount, nullptr);
+        vk.vkEnumeratePhysicalDevices(m_Instance.getInstance(), &deviceCount, nullptr);
         CORVUS_ASSERT(deviceCount != 0, "Failed to find GPUs with Vulkan support!")
 
         std::vector<VkPhysicalDevice> physicalDevices(deviceCount);
-        vkEnumeratePhysicalDevices(m_Instance.getInstance(), &deviceCount, physicalDevices.data());
+        vk.vkEnumeratePhysicalDevices(m_Instance.getInstance(), &deviceCount, physicalDevices.data());
+
+        std::optional<DeviceCapabilities> best;
+        std::optional<DeviceCapabilities> requested;
 
-        for (const auto &pd: physicalDevices)
+        for (uint32_t i = 0; i < deviceCount; i++)
         {
-            if (isDeviceSuitable(pd))
-            {
-                CORVUS_LOG(info, "Found suitable GPU");
-                m_PhysicalDevice = pd;
-                break;
-            }
+            auto capabilities = DeviceCapabilities::query(vk, m_Instance.getApiVersion(), physicalDevices[i], i,
+                                                          m_Surface);
+            bool suitable = isDeviceSuitable(capabilities);
+            CORVUS_LOG(info, "GPU [{}] {}: suitable={}, score={}", i, capabilities.properties.deviceName, suitable,
+                       capabilities.score());
+
+            if (not suitable)
+                continue;
+
+            if (not requested.has_value() and capabilities.matches(selection))
+                requested = capabilities;
+
+            if (not best.has_value() or capabilities.score() > best->score())
+                best = std::move(capabilities);
         }
-        CORVUS_ASSERT(m_PhysicalDevice != VK_NULL_HANDLE, "Failed to find a suitable GPU!")
+
+        CORVUS_ASSERT(best.has_value(), "Failed to find a suitable GPU!")
+        if ((selection.index.has_value() or not selection.name.empty()) and not requested.has_value())
+            CORVUS_LOG(warn, "Requested GPU is not available or not suitable, falling back to scoring");
+
+        m_Capabilities = requested.has_value() ? std::move(*requested) : std::move(*best);
+        m_PhysicalDevice = m_Capabilities.physicalDevice;
+        CORVUS_LOG(info, "Selected GPU [{}] {}", m_Capabilities.enumerationIndex, m_Capabilities.properties.deviceName);
     }
 
-    bool Device::isDeviceSuitable(VkPhysicalDevice const &physicalDevice) const
+    bool Device::isDeviceSuitable(const DeviceCapabilities &capabilities) const
     {
-        QueueFamilyIndices indices = QueueFamilyIndices::findQueueFamilies(physicalDevice, m_Surface);
-        bool deviceExtensionsSupported = checkDeviceExtensionSupport(physicalDevice);
+        bool deviceExtensionsSupported = checkDeviceExtensionSupport(capabilities);
+        if (isHeadless())
+            return capabilities.queueFamilyIndices.graphicsFamily.has_value() and deviceExtensionsSupported;
 
         bool swapChainAdequate = false;
         if (deviceExtensionsSupported)
         {
-            SwapChainSupportDetails swapChainSupport = SwapChain::querySwapChainSupport(physicalDevice, m_Surface);
+            SwapChainSupportDetails swapChainSupport = SwapChain::querySwapChainSupport(
+                    m_Instance.getDispatch(), capabilities.physicalDevice, m_Surface);
             swapChainAdequate = not swapChainSupport.formats.empty();
         }
 
-        return indices.isComplete() and deviceExtensionsSupported and swapChainAdequate;
+        return capabilities.queueFamilyIndices.isComplete() and deviceExtensionsSupported and swapChainAdequate;
     }
 
-    bool Device::checkDeviceExtensionSupport(VkPhysicalDevice const &physicalDevice) const
+    bool Device::checkDeviceExtensionSupport(const DeviceCapabilities &capabilities) const
     {
-        uint32_t extensionCount;
-        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
-
-        std::vector<VkExtensionProperties> availableExtensions(extensionCount);
-
-        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, availableExtensions.data());
-        std::set<std::string> requiredExtensions(m_DeviceExtensions.begin(), m_DeviceExtensions.end());
-
-        for (const auto &extension: availableExtensions)
-            requiredExtensions.erase(extension.extensionName); // Remove supported extensions from requiredExtensions
+        return std::ranges::all_of(m_DeviceExtensions, [&capabilities](const char *extension)
+        {
+            return capabilities.supportsExtension(extension);
+        });
+    }
 
-        return requiredExtensions.empty(); // If empty, all required extensions are supported
+    void Device::enableFeatures(const DeviceFeatures &requested)
+    {
+        m_EnabledFeatures.dynamicRendering = requested.dynamicRendering and m_Capabilities.supportsDynamicRendering();
+
+        m_EnabledFeatures.descriptorIndexing = requested.descriptorIndexing and
+                                               m_Capabilities.supportsDescriptorIndexing();
+
+        m_EnabledFeatures.multiDrawIndirect = requested.multiDrawIndirect and m_Capabilities.features.multiDrawIndirect;
+
+        m_EnabledFeatures.drawIndirectCount = requested.drawIndirectCount and
+                                              m_Capabilities.vulkan12Features.drawIndirectCount == VK_TRUE;
+
+        m_EnabledFeatures.samplerAnisotropy = requested.samplerAnisotropy and m_Capabilities.features.samplerAnisotropy;
+
+        const auto &features = m_Capabilities.features;
+        m_EnabledFeatures.textureCompressionBC = requested.textureCompressionBC and features.textureCompressionBC;
+        m_EnabledFeatures.textureCompressionETC2 = requested.textureCompressionETC2 and
+                                                   features.textureCompressionETC2;
+        m_EnabledFeatures.textureCompressionASTC = requested.textureCompressionASTC and
+                                                   features.textureCompressionASTC_LDR;
+
+        m_EnabledFeatures.asyncCompute = requested.asyncCompute and m_Capabilities.supportsAsyncCompute();
+        const auto &indices = m_Capabilities.queueFamilyIndices;
+        if (m_EnabledFeatures.asyncCompute and indices.computeFamily.value() != indices.graphicsFamily.value())
+            m_SharedQueueFamilies = {indices.graphicsFamily.value(), indices.computeFamily.value()};
+
+        if (requested.dynamicRendering and not m_EnabledFeatures.dynamicRendering)
+            CORVUS_LOG(warn, "Dynamic rendering is not supported, falling back to render passes");
+        if (requested.descriptorIndexing and not m_EnabledFeatures.descriptorIndexing)
+            CORVUS_LOG(warn, "Descriptor indexing is not supported, bindless descriptors are disabled");
+        if (requested.asyncCompute and not m_EnabledFeatures.asyncCompute)
+            CORVUS_LOG(warn, "No compute queue besides the graphics one, compute runs on the graphics queue");
+        CORVUS_LOG(info, "Dynamic rendering: {}, descriptor indexing: {}, multi draw indirect: {}, "
+                         "draw indirect count: {}, sampler anisotropy: {}, async compute: {}",
+                   m_EnabledFeatures.dynamicRendering, m_EnabledFeatures.descriptorIndexing,
+                   m_EnabledFeatures.multiDrawIndirect, m_EnabledFeatures.drawIndirectCount,
+                   m_EnabledFeatures.samplerAnisotropy, m_EnabledFeatures.asyncCompute);
+        CORVUS_LOG(info, "Texture compression BC: {}, ETC2: {}, ASTC: {}", m_EnabledFeatures.textureCompressionBC,
+                   m_EnabledFeatures.textureCompressionETC2, m_EnabledFeatures.textureCompressionASTC);
     }
 
     void Device::createLogicalDevice()
     {
-        QueueFamilyIndices indices = QueueFamilyIndices::findQueueFamilies(m_PhysicalDevice, m_Surface);
+        const QueueFamilyIndices &indices = m_Capabilities.queueFamilyIndices;
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
 
         std::set<uint32_t> uniqueQueueFamilies = {
                 indices.graphicsFamily.value(),
-                indices.presentFamily.value()
+                indices.presentFamily.value_or(indices.graphicsFamily.value()),
+                indices.computeFamily.value_or(indices.graphicsFamily.value()),
+                indices.transferFamily.value_or(indices.graphicsFamily.value())
         };
 
-        float queuePriority = 1.0f;
+        std::vector<float> queuePriorities(MAX_QUEUES_PER_FAMILY, 1.0f);
         for (uint32_t queueFamily: uniqueQueueFamilies)
         {
             VkDeviceQueueCreateInfo createInfo = {
                     .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
                     .queueFamilyIndex = queueFamily,
-                    .queueCount = 1,
-                    .pQueuePriorities = &queuePriority
+                    .queueCount = std::min(m_Capabilities.queueFamilies[queueFamily].queueCount, MAX_QUEUES_PER_FAMILY),
+                    .pQueuePriorities = queuePriorities.data()
             };
             queueCreateInfos.push_back(createInfo);
         }
 
-        VkPhysicalDeviceFeatures deviceFeatures{};
+        VkPhysicalDeviceVulkan13Features vulkan13Features = {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
+                .dynamicRendering = m_EnabledFeatures.dynamicRendering,
+        };
+
+        bool descriptorIndexing = m_EnabledFeatures.descriptorIndexing;
+        VkPhysicalDeviceVulkan12Features vulkan12Features = {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+                .pNext = m_Capabilities.apiVersion >= VK_API_VERSION_1_3 ? &vulkan13Features : nullptr,
+                .drawIndirectCount = m_EnabledFeatures.drawIndirectCount,
+                .descriptorIndexing = descriptorIndexing,
+                .shaderSampledImageArrayNonUniformIndexing = descriptorIndexing,
+                .shaderStorageBufferArrayNonUniformIndexing = descriptorIndexing,
+                .descriptorBindingSampledImageUpdateAfterBind = descriptorIndexing,
+                .descriptorBindingStorageBufferUpdateAfterBind = descriptorIndexing,
+                .descriptorBindingUpdateUnusedWhilePending = descriptorIndexing,
+                .descriptorBindingPartiallyBound = descriptorIndexing,
+                .runtimeDescriptorArray = descriptorIndexing,
+        };
+
+        VkPhysicalDeviceFeatures deviceFeatures = {
+                .multiDrawIndirect = m_EnabledFeatures.multiDrawIndirect,
+                .samplerAnisotropy = m_EnabledFeatures.samplerAnisotropy,
+                .textureCompressionETC2 = m_EnabledFeatures.textureCompressionETC2,
+                .textureCompressionASTC_LDR = m_EnabledFeatures.textureCompressionASTC,
+                .textureCompressionBC = m_EnabledFeatures.textureCompressionBC,
+        };
         VkDeviceCreateInfo createInfo = {
                 .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+                .pNext = m_Capabilities.apiVersion >= VK_API_VERSION_1_2 ? &vulkan12Features : nullptr,
                 .queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size()),
                 .pQueueCreateInfos = queueCreateInfos.data(),
                 .enabledExtensionCount = static_cast<uint32_t>(m_DeviceExtensions.size()),
@@ -125,17 +229,92 @@ namespace Corvus
                 .pEnabledFeatures = &deviceFeatures,
         };
 
-        auto success = vkCreateDevice(m_PhysicalDevice, &createInfo, nullptr, &m_Device);
+        const auto &vk = m_Instance.getDispatch();
+        auto success = vk.vkCreateDevice(m_PhysicalDevice, &createInfo, nullptr, &m_Device);
         CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create logical device!")
         CORVUS_LOG(info, "Logical device created successfully!");
 
-        vkGetDeviceQueue(m_Device, indices.graphicsFamily.value(), 0, &m_Queues["graphics"]);
-        vkGetDeviceQueue(m_Device, indices.presentFamily.value(), 0, &m_Queues["present"]);
+        m_Dispatch.load(m_Device, vk.vkGetDeviceProcAddr);
+        m_DescriptorLayoutCache = std::make_unique<DescriptorLayoutCache>(m_Dispatch, m_Device);
+        float maxAnisotropy = m_EnabledFeatures.samplerAnisotropy
+                                  ? m_Capabilities.getLimits().maxSamplerAnisotropy
+                                  : 0.0f;
+        m_SamplerCache = std::make_unique<SamplerCache>(m_Dispatch, m_Device, maxAnisotropy);
+        if (m_EnabledFeatures.descriptorIndexing)
+        {
+            m_BindlessDescriptors = std::make_unique<BindlessDescriptors>(m_Dispatch, m_Device, *m_DescriptorLayoutCache,
+                                                                          m_Capabilities);
+        }
+
+        createQueues(queueCreateInfos);
+    }
+
+    void Device::createQueues(const std::vector<VkDeviceQueueCreateInfo> &queueCreateInfos)
+    {
+        std::map<uint32_t, std::vector<Queue *>> familyQueues;
+        for (const auto &createInfo: queueCreateInfos)
+        {
+            for (uint32_t queueIndex = 0; queueIndex < createInfo.queueCount; queueIndex++)
+            {
+                VkQueue handle;
+                m_Dispatch.vkGetDeviceQueue(m_Device, createInfo.queueFamilyIndex, queueIndex, &handle);
+                m_QueueStorage.push_back(
+                        std::make_unique<Queue>(m_Dispatch, handle, createInfo.queueFamilyIndex, queueIndex));
+                familyQueues[createInfo.queueFamilyIndex].push_back(m_QueueStorage.back().get());
+            }
+        }
+
+        // Every role sees all queues of its family, rotated so roles sharing a family start on different queues
+        auto assign = [&](QueueRole role, uint32_t family, uint32_t firstQueue)
+        {
+            const auto &queues = familyQueues.at(family);
+            auto &roleQueues = m_Queues[static_cast<size_t>(role)];
+            for (size_t i = 0; i < queues.size(); i++)
+                roleQueues.push_back(queues[(firstQueue + i) % queues.size()]);
+        };
+
+        const QueueFamilyIndices &indices = m_Capabilities.queueFamilyIndices;
+        uint32_t graphicsFamily = indices.graphicsFamily.value();
+        uint32_t computeFamily = indices.computeFamily.value_or(graphicsFamily);
+        uint32_t transferFamily = indices.transferFamily.value_or(graphicsFamily);
+
+        assign(QueueRole::Graphics, graphicsFamily, 0);
+        if (indices.presentFamily.has_value()) // Shares graphics queue 0 when possible
+            assign(QueueRole::Present, indices.presentFamily.value(), 0);
+        assign(QueueRole::Compute, computeFamily, computeFamily == graphicsFamily ? 1 : 0);
+        assign(QueueRole::Transfer, transferFamily,
+               transferFamily == graphicsFamily ? 2 : transferFamily == computeFamily ? 1 : 0);
+
+        CORVUS_LOG(info, "Queues created: graphics={}, compute={}, transfer={}, present={}",
+                   getQueueCount(QueueRole::Graphics), getQueueCount(QueueRole::Compute),
+                   getQueueCount(QueueRole::Transfer), getQueueCount(QueueRole::Present));
+    }
+
+    Queue &Device::getQueue(QueueRole role, uint32_t index) const
+    {
+        const auto &queues = m_Queues[static_cast<size_t>(role)];
+        return *queues[index % queues.size()];
+    }
+
+    Queue &Device::acquireQueue(QueueRole role)
+    {
+        uint32_t index = m_NextQueue[static_cast<size_t>(role)].fetch_add(1, std::memory_order_relaxed);
+        return getQueue(role, index);
+    }
+
+    uint32_t Device::getQueueCount(QueueRole role) const
+    {
+        return static_cast<uint32_t>(m_Queues[static_cast<size_t>(role)].size());
     }
 
     void Device::createImageViews()
     {
-        m_SwapChain.createImageViews(m_Device);
+        m_SwapChain.createImageViews(*this);
+    }
+
+    void Device::createDepthResources()
+    {
+        m_SwapChain.createDepthResources(*this);
     }
 
     void Device::createRenderPass()
@@ -151,59 +330,92 @@ namespace Corvus
                 .finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
         };
 
+        // Cleared to 0 for reverse-Z and never read after the pass, so it does not have to be stored
+        VkAttachmentDescription depthAttachment = {
+                .format = m_SwapChain.getDepthFormat(),
+                .samples = VK_SAMPLE_COUNT_1_BIT,
+                .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+                .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                .finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+        };
+
         VkAttachmentReference colorAttachmentRef = {
                 .attachment = 0,
                 .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
         };
 
+        VkAttachmentReference depthAttachmentRef = {
+                .attachment = 1,
+                .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+        };
+
         VkSubpassDescription subpass = {
                 .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
                 .colorAttachmentCount = 1,
-                .pColorAttachments = &colorAttachmentRef
+                .pColorAttachments = &colorAttachmentRef,
+                .pDepthStencilAttachment = &depthAttachmentRef
         };
 
+        // The depth image is shared between frames, the clear has to wait for the previous frame's depth tests
         VkSubpassDependency dependency = {
                 .srcSubpass = VK_SUBPASS_EXTERNAL,
                 .dstSubpass = 0,
-                .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                .srcAccessMask = 0,
-                .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+                .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT bitor
+                                VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT bitor
+                                VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+                .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT bitor
+                                 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
         };
 
+        std::array attachments = {colorAttachment, depthAttachment};
         VkRenderPassCreateInfo renderPassInfo = {
                 .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
-                .attachmentCount = 1,
-                .pAttachments = &colorAttachment,
+                .attachmentCount = static_cast<uint32_t>(attachments.size()),
+                .pAttachments = attachments.data(),
                 .subpassCount = 1,
                 .pSubpasses = &subpass,
                 .dependencyCount = 1,
                 .pDependencies = &dependency
         };
 
-        auto success = vkCreateRenderPass(m_Device, &renderPassInfo, nullptr, &m_RenderPass);
+        auto success = m_Dispatch.vkCreateRenderPass(m_Device, &renderPassInfo, nullptr, &m_RenderPass);
         CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create render pass!")
         CORVUS_LOG(info, "Render pass created successfully!");
     }
 
+    void Device::recreateSwapChain()
+    {
+        m_SwapChain.recreate(*this, m_RenderPass);
+    }
+
     void Device::createFramebuffers()
     {
-        m_SwapChain.createFramebuffers(m_Device, m_RenderPass);
+        m_SwapChain.createFramebuffers(*this, m_RenderPass);
     }
 
     void Device::createCommandPool()
     {
-        QueueFamilyIndices queueFamilyIndices = QueueFamilyIndices::findQueueFamilies(m_PhysicalDevice, m_Surface);
-
         VkCommandPoolCreateInfo poolInfo = {
                 .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
                 .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
-                .queueFamilyIndex = queueFamilyIndices.graphicsFamily.value(),
+                .queueFamilyIndex = m_Capabilities.queueFamilyIndices.graphicsFamily.value(),
         };
 
-        auto success = vkCreateCommandPool(m_Device, &poolInfo, nullptr, &m_CommandPool);
+        auto success = m_Dispatch.vkCreateCommandPool(m_Device, &poolInfo, nullptr, &m_CommandPool);
         CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create command pool!")
         CORVUS_LOG(info, "Command pool created successfully!");
+
+        if (m_EnabledFeatures.asyncCompute)
+        {
+            poolInfo.queueFamilyIndex = getQueue(QueueRole::Compute).getFamilyIndex();
+            success = m_Dispatch.vkCreateCommandPool(m_Device, &poolInfo, nullptr, &m_ComputeCommandPool);
+            CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create compute command pool!")
+        }
     }
 
 } // Corvus
\ No newline at end of file
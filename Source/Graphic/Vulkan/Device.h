@@ -10,12 +10,19 @@
 #include "SwapChain.h"
 #include "Instance.h"
 #include "DebugMessenger.h"
+#include "DeviceCapabilities.h"
+#include "Queue.h"
+#include "Dispatch.h"
+#include "DescriptorLayoutCache.h"
+#include "BindlessDescriptors.h"
+#include "SamplerCache.h"
 
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
+#include <array>
+#include <atomic>
 #include <vector>
 #include <memory>
-#include <map>
 
 namespace Corvus
 {
@@ -23,18 +30,39 @@ namespace Corvus
     class Device
     {
     public:
-        explicit Device(std::shared_ptr<Window> window);
+        // A null window creates a headless device for compute and transfer work. It has no surface, swapchain,
+        // render pass or present queue, e.g. for running compute kernels on a software implementation in tests.
+        explicit Device(std::shared_ptr<Window> window, const DeviceSelection &selection = {},
+                        const DeviceFeatures &features = {});
         ~Device();
 
         [[nodiscard]] Instance &getInstance() { return m_Instance; }
         [[nodiscard]] DebugMessenger &getDebugMessenger() { return m_DebugMessenger; }
+        [[nodiscard]] const InstanceDispatch &getInstanceDispatch() const { return m_Instance.getDispatch(); }
+        [[nodiscard]] const DeviceDispatch &getDispatch() const { return m_Dispatch; }
+        [[nodiscard]] GLFWwindow *getWindowHandle() const { return m_Window->getHandle(); }
+        [[nodiscard]] bool isHeadless() const { return m_Window == nullptr; }
         [[nodiscard]] VkDevice getDevice() const { return m_Device; }
         [[nodiscard]] VkPhysicalDevice getPhysicalDevice() const { return m_PhysicalDevice; }
+        [[nodiscard]] const DeviceCapabilities &getCapabilities() const { return m_Capabilities; }
+        [[nodiscard]] const DeviceFeatures &getEnabledFeatures() const { return m_EnabledFeatures; }
         [[nodiscard]] VkSurfaceKHR getSurface() const { return m_Surface; }
-        [[nodiscard]] VkQueue getQueue(const std::string &queueName) const { return m_Queues.at(queueName); }
+        [[nodiscard]] Queue &getQueue(QueueRole role, uint32_t index = 0) const;
+        [[nodiscard]] Queue &acquireQueue(QueueRole role); // Round-robin over the role's hardware queues
+        [[nodiscard]] uint32_t getQueueCount(QueueRole role) const;
         [[nodiscard]] SwapChain &getSwapChain() { return m_SwapChain; }
-        [[nodiscard]] VkRenderPass getRenderPass() const { return m_RenderPass; }
+        [[nodiscard]] VkRenderPass getRenderPass() const { return m_RenderPass; } // Null with dynamic rendering
         [[nodiscard]] VkCommandPool getCommandPool() const { return m_CommandPool; }
+        // Pool for the compute queue's family, null unless the asyncCompute feature is enabled
+        [[nodiscard]] VkCommandPool getComputeCommandPool() const { return m_ComputeCommandPool; }
+        // Families resources have to be shared across, empty when a single family uses them all
+        [[nodiscard]] const std::vector<uint32_t> &getSharedQueueFamilies() const { return m_SharedQueueFamilies; }
+        [[nodiscard]] DescriptorLayoutCache &getDescriptorLayoutCache() const { return *m_DescriptorLayoutCache; }
+        [[nodiscard]] SamplerCache &getSamplerCache() const { return *m_SamplerCache; }
+        // Null unless the descriptorIndexing feature is enabled
+        [[nodiscard]] BindlessDescriptors *getBindlessDescriptors() const { return m_BindlessDescriptors.get(); }
+
+        void recreateSwapChain();
 
     private:
         std::shared_ptr<Window> m_Window;
@@ -42,24 +70,40 @@ namespace Corvus
         DebugMessenger m_DebugMessenger;
         SwapChain m_SwapChain;
 
-        const std::vector<const char *> m_DeviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+        std::vector<const char *> m_DeviceExtensions; // Only the swapchain, which headless devices go without
 
         VkSurfaceKHR m_Surface = VK_NULL_HANDLE;
         VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
+        DeviceCapabilities m_Capabilities;
+        DeviceFeatures m_EnabledFeatures;
         VkDevice m_Device = VK_NULL_HANDLE;
+        DeviceDispatch m_Dispatch;
+        std::unique_ptr<DescriptorLayoutCache> m_DescriptorLayoutCache;
+        std::unique_ptr<SamplerCache> m_SamplerCache;
+        std::unique_ptr<BindlessDescriptors> m_BindlessDescriptors;
         VkRenderPass m_RenderPass = VK_NULL_HANDLE;
         VkCommandPool m_CommandPool = VK_NULL_HANDLE;
-        std::map<std::string, VkQueue> m_Queues;
+        VkCommandPool m_ComputeCommandPool = VK_NULL_HANDLE;
+        std::vector<uint32_t> m_SharedQueueFamilies;
+
+        static constexpr uint32_t MAX_QUEUES_PER_FAMILY = 4;
+        static constexpr size_t QUEUE_ROLE_COUNT = static_cast<size_t>(QueueRole::Count);
+        std::vector<std::unique_ptr<Queue>> m_QueueStorage;
+        std::array<std::vector<Queue *>, QUEUE_ROLE_COUNT> m_Queues;
+        std::array<std::atomic<uint32_t>, QUEUE_ROLE_COUNT> m_NextQueue{};
 
     private:
         void createWindowSurface();
 
-        void pickPhysicalDevice();
-        [[nodiscard]] bool isDeviceSuitable(VkPhysicalDevice const &physicalDevice) const;
-        [[nodiscard]] bool checkDeviceExtensionSupport(VkPhysicalDevice const &physicalDevice) const;
+        void pickPhysicalDevice(const DeviceSelection &selection);
+        [[nodiscard]] bool isDeviceSuitable(const DeviceCapabilities &capabilities) const;
+        [[nodiscard]] bool checkDeviceExtensionSupport(const DeviceCapabilities &capabilities) const;
 
+        void enableFeatures(const DeviceFeatures &requested);
         void createLogicalDevice();
+        void createQueues(const std::vector<VkDeviceQueueCreateInfo> &queueCreateInfos);
         void createImageViews();
+        void createDepthResources();
 
         void createRenderPass();
         void createFramebuffers();
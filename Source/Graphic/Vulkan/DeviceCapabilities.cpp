@@ -0,0 +1,171 @@
+#include "DeviceCapabilities.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
+
+namespace Corvus
+{
+    DeviceSelection DeviceSelection::fromEnvironment()
+    {
+        DeviceSelection selection;
+
+        const char *value = std::getenv("CORVUS_DEVICE");
+        if (value == nullptr or *value == '\0')
+            return selection;
+
+        // Anything that is not entirely a uint32, including out of range numbers, is matched as a name and falls
+        // back to scoring if no device has it
+        std::string request(value);
+        uint32_t index;
+        auto [end, error] = std::from_chars(request.data(), request.data() + request.size(), index);
+        if (error == std::errc() and end == request.data() + request.size())
+            selection.index = index;
+        else
+            selection.name = request;
+
+        return selection;
+    }
+
+    DeviceCapabilities DeviceCapabilities::query(const InstanceDispatch &vk, uint32_t instanceApiVersion,
+                                                 VkPhysicalDevice physicalDevice, uint32_t enumerationIndex,
+                                                 VkSurfaceKHR surface)
+    {
+        DeviceCapabilities capabilities;
+        capabilities.physicalDevice = physicalDevice;
+        capabilities.enumerationIndex = enumerationIndex;
+
+        vk.vkGetPhysicalDeviceProperties(physicalDevice, &capabilities.properties);
+        capabilities.apiVersion = std::min(instanceApiVersion, capabilities.properties.apiVersion);
+
+        if (capabilities.apiVersion >= VK_API_VERSION_1_2 and vk.vkGetPhysicalDeviceFeatures2 != nullptr and
+            vk.vkGetPhysicalDeviceProperties2 != nullptr)
+        {
+            capabilities.vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+            capabilities.vulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+            if (capabilities.apiVersion >= VK_API_VERSION_1_3)
+                capabilities.vulkan12Features.pNext = &capabilities.vulkan13Features;
+
+            VkPhysicalDeviceFeatures2 features2 = {
+                    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+                    .pNext = &capabilities.vulkan12Features,
+            };
+            vk.vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+            capabilities.features = features2.features;
+            capabilities.vulkan12Features.pNext = nullptr;
+            capabilities.vulkan13Features.pNext = nullptr;
+
+            capabilities.vulkan12Properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+            VkPhysicalDeviceProperties2 properties2 = {
+                    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+                    .pNext = &capabilities.vulkan12Properties,
+            };
+            vk.vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+            capabilities.vulkan12Properties.pNext = nullptr;
+        }
+        else
+        {
+            vk.vkGetPhysicalDeviceFeatures(physicalDevice, &capabilities.features);
+        }
+        vk.vkGetPhysicalDeviceMemoryProperties(physicalDevice, &capabilities.memoryProperties);
+
+        uint32_t queueFamilyCount = 0;
+        vk.vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+        capabilities.queueFamilies.resize(queueFamilyCount);
+        vk.vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount,
+                                                    capabilities.queueFamilies.data());
+
+        // Headless devices have no surface, and then no family presents
+        capabilities.presentSupport.resize(queueFamilyCount, VK_FALSE);
+        for (uint32_t i = 0; i < queueFamilyCount and surface != VK_NULL_HANDLE; i++)
+            vk.vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &capabilities.presentSupport[i]);
+
+        capabilities.queueFamilyIndices = QueueFamilyIndices::findQueueFamilies(capabilities.queueFamilies,
+                                                                                capabilities.presentSupport);
+
+        uint32_t extensionCount = 0;
+        vk.vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+        std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+        vk.vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, availableExtensions.data());
+
+        for (const auto &extension: availableExtensions)
+            capabilities.extensions.insert(extension.extensionName);
+
+        return capabilities;
+    }
+
+    VkDeviceSize DeviceCapabilities::getDeviceLocalMemorySize() const
+    {
+        VkDeviceSize size = 0;
+        for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+        {
+            if (memoryProperties.memoryHeaps[i].flags bitand VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+                size += memoryProperties.memoryHeaps[i].size;
+        }
+        return size;
+    }
+
+    bool DeviceCapabilities::supportsDescriptorIndexing() const
+    {
+        const auto &features = vulkan12Features;
+        return features.descriptorIndexing and features.runtimeDescriptorArray and
+               features.descriptorBindingPartiallyBound and features.descriptorBindingUpdateUnusedWhilePending and
+               features.descriptorBindingStorageBufferUpdateAfterBind and
+               features.descriptorBindingSampledImageUpdateAfterBind and
+               features.shaderStorageBufferArrayNonUniformIndexing and
+               features.shaderSampledImageArrayNonUniformIndexing;
+    }
+
+    bool DeviceCapabilities::supportsAsyncCompute() const
+    {
+        if (not queueFamilyIndices.computeFamily.has_value())
+            return false;
+
+        uint32_t graphicsFamily = queueFamilyIndices.graphicsFamily.value();
+        return queueFamilyIndices.computeFamily.value() != graphicsFamily or
+               queueFamilies[graphicsFamily].queueCount > 1;
+    }
+
+    uint64_t DeviceCapabilities::score() const
+    {
+        uint64_t typeScore = 0;
+        switch (properties.deviceType)
+        {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+            typeScore = 4;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+            typeScore = 3;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+            typeScore = 2;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_CPU:
+            typeScore = 1;
+            break;
+        default:
+            break;
+        }
+
+        // Device type dominates, VRAM in MiB breaks ties between devices of the same type
+        constexpr uint64_t typeWeight = 1ull << 40;
+        return typeScore * typeWeight + getDeviceLocalMemorySize() / (1024 * 1024);
+    }
+
+    bool DeviceCapabilities::matches(const DeviceSelection &selection) const
+    {
+        if (selection.index.has_value())
+            return *selection.index == enumerationIndex;
+
+        if (selection.name.empty())
+            return false;
+
+        auto toLower = [](std::string text)
+        {
+            std::ranges::transform(text, text.begin(), [](unsigned char c) { return std::tolower(c); });
+            return text;
+        };
+        return toLower(properties.deviceName).find(toLower(selection.name)) != std::string::npos;
+    }
+} // Corvus
@@ -0,0 +1,81 @@
+#ifndef ENGINE_DEVICECAPABILITIES_H
+#define ENGINE_DEVICECAPABILITIES_H
+
+#include <vulkan/vulkan_core.h>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "QueueFamilyIndices.h"
+#include "Dispatch.h"
+
+namespace Corvus
+{
+    // Explicit GPU choice, overrides the scoring policy when the requested device is suitable
+    struct DeviceSelection
+    {
+        std::optional<uint32_t> index;
+        std::string name; // Case-insensitive substring of VkPhysicalDeviceProperties::deviceName
+
+        // Reads CORVUS_DEVICE, a number selects by enumeration index, anything else by name
+        static DeviceSelection fromEnvironment();
+    };
+
+    // Optional features the engine would like to use, each one is only enabled when the selected device supports it
+    struct DeviceFeatures
+    {
+        bool dynamicRendering = true; // Render straight into image views instead of render pass + framebuffers
+        bool descriptorIndexing = true; // Bindless arrays of buffers, images and samplers, see BindlessDescriptors
+        bool multiDrawIndirect = true; // Many indirect draws per call, otherwise GPU culled draws are issued one by one
+        bool drawIndirectCount = true; // Draw count read from a buffer, lets GPU culling compact its draws (1.2)
+        bool samplerAnisotropy = true; // Otherwise every sampler from the SamplerCache filters isotropically
+        // Block compressed texture families, KTX2 files in a family the device lacks can not be loaded
+        bool textureCompressionBC = true;
+        bool textureCompressionETC2 = true;
+        bool textureCompressionASTC = true; // LDR profile only
+        // Compute submitted on its own queue to overlap with graphics. Storage buffers are then shared concurrently
+        // between the graphics and compute families, which can cost some bandwidth on a few GPUs.
+        bool asyncCompute = false;
+    };
+
+    // Everything the engine needs to know about a physical device, queried from the driver exactly once
+    struct DeviceCapabilities
+    {
+        VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+        uint32_t enumerationIndex = 0;
+        uint32_t apiVersion = VK_API_VERSION_1_0; // Usable version, limited by both the instance and the device
+
+        VkPhysicalDeviceProperties properties{};
+        VkPhysicalDeviceFeatures features{};
+        VkPhysicalDeviceVulkan12Features vulkan12Features{}; // Only filled in when apiVersion >= 1.2
+        VkPhysicalDeviceVulkan13Features vulkan13Features{}; // Only filled in when apiVersion >= 1.3
+        VkPhysicalDeviceVulkan12Properties vulkan12Properties{}; // Only filled in when apiVersion >= 1.2
+        VkPhysicalDeviceMemoryProperties memoryProperties{};
+
+        std::vector<VkQueueFamilyProperties> queueFamilies;
+        std::vector<VkBool32> presentSupport;
+        QueueFamilyIndices queueFamilyIndices;
+
+        std::unordered_set<std::string> extensions;
+
+        static DeviceCapabilities query(const InstanceDispatch &vk, uint32_t instanceApiVersion,
+                                        VkPhysicalDevice physicalDevice, uint32_t enumerationIndex,
+                                        VkSurfaceKHR surface);
+
+        [[nodiscard]] const VkPhysicalDeviceLimits &getLimits() const { return properties.limits; }
+        [[nodiscard]] bool supportsExtension(const std::string &extension) const { return extensions.contains(extension); }
+        [[nodiscard]] VkDeviceSize getDeviceLocalMemorySize() const;
+        [[nodiscard]] bool supportsDynamicRendering() const { return vulkan13Features.dynamicRendering == VK_TRUE; }
+        [[nodiscard]] bool supportsDescriptorIndexing() const;
+        // A compute queue other than the graphics one, either a dedicated family or a second graphics queue
+        [[nodiscard]] bool supportsAsyncCompute() const;
+
+        // Higher is better, the scoring policy prefers discrete GPUs and then the one with the most VRAM
+        [[nodiscard]] uint64_t score() const;
+        [[nodiscard]] bool matches(const DeviceSelection &selection) const;
+    };
+
+} // Corvus
+
+#endif //ENGINE_DEVICECAPABILITIES_H
@@ -0,0 +1,38 @@
+#include "Dispatch.h"
+
+#include "Utility/Corvus.h"
+
+namespace Corvus
+{
+    void InstanceDispatch::load(VkInstance instance)
+    {
+#define CORVUS_LOAD_FUNCTION(name)                                                                \
+        name = reinterpret_cast<PFN_##name>(vkGetInstanceProcAddr(instance, #name));             \
+        CORVUS_ASSERT(name, "Failed to load instance function {}!", #name)
+
+        CORVUS_INSTANCE_FUNCTIONS(CORVUS_LOAD_FUNCTION)
+#undef CORVUS_LOAD_FUNCTION
+
+#define CORVUS_LOAD_OPTIONAL_FUNCTION(name)                                                       \
+        name = reinterpret_cast<PFN_##name>(vkGetInstanceProcAddr(instance, #name));
+
+        CORVUS_INSTANCE_OPTIONAL_FUNCTIONS(CORVUS_LOAD_OPTIONAL_FUNCTION)
+#undef CORVUS_LOAD_OPTIONAL_FUNCTION
+    }
+
+    void DeviceDispatch::load(VkDevice device, PFN_vkGetDeviceProcAddr getDeviceProcAddr)
+    {
+#define CORVUS_LOAD_FUNCTION(name)                                                                \
+        name = reinterpret_cast<PFN_##name>(getDeviceProcAddr(device, #name));                   \
+        CORVUS_ASSERT(name, "Failed to load device function {}!", #name)
+
+        CORVUS_DEVICE_FUNCTIONS(CORVUS_LOAD_FUNCTION)
+#undef CORVUS_LOAD_FUNCTION
+
+#define CORVUS_LOAD_OPTIONAL_FUNCTION(name)                                                       \
+        name = reinterpret_cast<PFN_##name>(getDeviceProcAddr(device, #name));
+
+        CORVUS_DEVICE_OPTIONAL_FUNCTIONS(CORVUS_LOAD_OPTIONAL_FUNCTION)
+#undef CORVUS_LOAD_OPTIONAL_FUNCTION
+    }
+} // Corvus
@@ -0,0 +1,136 @@
+#ifndef ENGINE_DISPATCH_H
+#define ENGINE_DISPATCH_H
+
+#include <vulkan/vulkan_core.h>
+
+// Function pointers fetched straight from the driver. Calling the exported vk* symbols goes through the
+// loader trampoline (and for device functions an additional dispatch on the handle), calling through
+// these tables jumps into the ICD directly. Add a function to the matching list to make it available.
+
+#define CORVUS_INSTANCE_FUNCTIONS(X)                  \
+    X(vkDestroyInstance)                              \
+    X(vkEnumeratePhysicalDevices)                     \
+    X(vkEnumerateDeviceExtensionProperties)           \
+    X(vkGetPhysicalDeviceProperties)                  \
+    X(vkGetPhysicalDeviceFeatures)                    \
+    X(vkGetPhysicalDeviceFormatProperties)            \
+    X(vkGetPhysicalDeviceMemoryProperties)            \
+    X(vkGetPhysicalDeviceQueueFamilyProperties)       \
+    X(vkGetPhysicalDeviceSurfaceSupportKHR)           \
+    X(vkGetPhysicalDeviceSurfaceCapabilitiesKHR)      \
+    X(vkGetPhysicalDeviceSurfaceFormatsKHR)           \
+    X(vkDestroySurfaceKHR)                            \
+    X(vkCreateDevice)                                 \
+    X(vkGetDeviceProcAddr)
+
+#define CORVUS_DEVICE_FUNCTIONS(X)                    \
+    X(vkDestroyDevice)                                \
+    X(vkGetDeviceQueue)                               \
+    X(vkDeviceWaitIdle)                               \
+    X(vkQueueSubmit)                                  \
+    X(vkQueueWaitIdle)                                \
+    X(vkQueuePresentKHR)                              \
+    X(vkCreateSwapchainKHR)                           \
+    X(vkDestroySwapchainKHR)                          \
+    X(vkGetSwapchainImagesKHR)                        \
+    X(vkAcquireNextImageKHR)                          \
+    X(vkCreateImageView)                              \
+    X(vkDestroyImageView)                             \
+    X(vkCreateFramebuffer)                            \
+    X(vkDestroyFramebuffer)                           \
+    X(vkCreateRenderPass)                             \
+    X(vkDestroyRenderPass)                            \
+    X(vkCreateCommandPool)                            \
+    X(vkDestroyCommandPool)                           \
+    X(vkAllocateCommandBuffers)                       \
+    X(vkFreeCommandBuffers)                           \
+    X(vkResetCommandBuffer)                           \
+    X(vkBeginCommandBuffer)                           \
+    X(vkEndCommandBuffer)                             \
+    X(vkCreateSemaphore)                              \
+    X(vkDestroySemaphore)                             \
+    X(vkCreateFence)                                  \
+    X(vkDestroyFence)                                 \
+    X(vkWaitForFences)                                \
+    X(vkResetFences)                                  \
+    X(vkCreateBuffer)                                 \
+    X(vkDestroyBuffer)                                \
+    X(vkGetBufferMemoryRequirements)                  \
+    X(vkBindBufferMemory)                             \
+    X(vkAllocateMemory)                               \
+    X(vkFreeMemory)                                   \
+    X(vkMapMemory)                                    \
+    X(vkCreateImage)                                  \
+    X(vkDestroyImage)                                 \
+    X(vkGetImageMemoryRequirements)                   \
+    X(vkBindImageMemory)                              \
+    X(vkUnmapMemory)                                  \
+    X(vkCreateShaderModule)                           \
+    X(vkDestroyShaderModule)                          \
+    X(vkCreateDescriptorSetLayout)                    \
+    X(vkDestroyDescriptorSetLayout)                   \
+    X(vkCreateDescriptorPool)                         \
+    X(vkDestroyDescriptorPool)                        \
+    X(vkResetDescriptorPool)                          \
+    X(vkAllocateDescriptorSets)                       \
+    X(vkUpdateDescriptorSets)                         \
+    X(vkCreatePipelineLayout)                         \
+    X(vkDestroyPipelineLayout)                        \
+    X(vkCreateGraphicsPipelines)                      \
+    X(vkCreateComputePipelines)                       \
+    X(vkDestroyPipeline)                              \
+    X(vkCreateSampler)                                \
+    X(vkDestroySampler)                               \
+    X(vkCmdBeginRenderPass)                           \
+    X(vkCmdEndRenderPass)                             \
+    X(vkCmdBindPipeline)                              \
+    X(vkCmdSetViewport)                               \
+    X(vkCmdSetScissor)                                \
+    X(vkCmdBindVertexBuffers)                         \
+    X(vkCmdBindIndexBuffer)                           \
+    X(vkCmdBindDescriptorSets)                        \
+    X(vkCmdPushConstants)                             \
+    X(vkCmdPipelineBarrier)                           \
+    X(vkCmdCopyBuffer)                                \
+    X(vkCmdCopyBufferToImage)                         \
+    X(vkCmdBlitImage)                                 \
+    X(vkCmdFillBuffer)                                \
+    X(vkCmdDispatch)                                  \
+    X(vkCmdDispatchIndirect)                          \
+    X(vkCmdDraw)                                      \
+    X(vkCmdDrawIndirect)                              \
+    X(vkCmdDrawIndexed)                               \
+    X(vkCmdDrawIndexedIndirect)
+
+// Core functions of newer API versions, left null when the instance or device does not reach that version
+#define CORVUS_INSTANCE_OPTIONAL_FUNCTIONS(X)         \
+    X(vkGetPhysicalDeviceFeatures2)                   \
+    X(vkGetPhysicalDeviceProperties2)
+
+#define CORVUS_DEVICE_OPTIONAL_FUNCTIONS(X)           \
+    X(vkCmdBeginRendering)                            \
+    X(vkCmdEndRendering)                              \
+    X(vkCmdDrawIndexedIndirectCount)
+
+#define CORVUS_DECLARE_FUNCTION(name) PFN_##name name = nullptr;
+
+namespace Corvus
+{
+    struct InstanceDispatch
+    {
+        CORVUS_INSTANCE_FUNCTIONS(CORVUS_DECLARE_FUNCTION)
+        CORVUS_INSTANCE_OPTIONAL_FUNCTIONS(CORVUS_DECLARE_FUNCTION)
+
+        void load(VkInstance instance);
+    };
+
+    struct DeviceDispatch
+    {
+        CORVUS_DEVICE_FUNCTIONS(CORVUS_DECLARE_FUNCTION)
+        CORVUS_DEVICE_OPTIONAL_FUNCTIONS(CORVUS_DECLARE_FUNCTION)
+
+        void load(VkDevice device, PFN_vkGetDeviceProcAddr getDeviceProcAddr);
+    };
+} // Corvus
+
+#endif //ENGINE_DISPATCH_H
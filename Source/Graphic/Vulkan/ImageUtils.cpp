@@ -0,0 +1,170 @@
+#include "ImageUtils.h"
+
+#include "BufferUtils.h"
+#include "Device.h"
+
+void ImageUtils::createImage(const Corvus::Device& device, VkExtent2D extent, VkFormat format,
+                             VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image,
+                             VkDeviceMemory& imageMemory, uint32_t mipLevels,
+                             const std::vector<uint32_t>& queueFamilies, VkImageCreateFlags flags)
+{
+    const auto& vk = device.getDispatch();
+    VkImageCreateInfo imageInfo = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .flags = flags,
+        .imageType = VK_IMAGE_TYPE_2D,
+        .format = format,
+        .extent = {extent.width, extent.height, 1},
+        .mipLevels = mipLevels,
+        .arrayLayers = 1,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = usage,
+        .sharingMode = queueFamilies.size() > 1 ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = queueFamilies.size() > 1 ? static_cast<uint32_t>(queueFamilies.size()) : 0,
+        .pQueueFamilyIndices = queueFamilies.size() > 1 ? queueFamilies.data() : nullptr,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+    };
+
+    auto result = vk.vkCreateImage(device.getDevice(), &imageInfo, nullptr, &image);
+    CORVUS_ASSERT(result == VK_SUCCESS, "Failed to create image!")
+
+    VkMemoryRequirements memRequirements;
+    vk.vkGetImageMemoryRequirements(device.getDevice(), image, &memRequirements);
+
+    VkMemoryAllocateInfo allocInfo = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize = memRequirements.size,
+        .memoryTypeIndex = BufferUtils::findMemoryType(device.getCapabilities().memoryProperties,
+                                                       memRequirements.memoryTypeBits, properties),
+    };
+
+    result = vk.vkAllocateMemory(device.getDevice(), &allocInfo, nullptr, &imageMemory);
+    CORVUS_ASSERT(result == VK_SUCCESS, "Failed to allocate image memory!")
+
+    vk.vkBindImageMemory(device.getDevice(), image, imageMemory, 0);
+}
+
+VkImageView ImageUtils::createImageView(const Corvus::Device& device, VkImage image, VkFormat format,
+                                        VkImageAspectFlags aspectMask, uint32_t mipLevels)
+{
+    VkImageViewCreateInfo createInfo = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image = image,
+        .viewType = VK_IMAGE_VIEW_TYPE_2D,
+        .format = format,
+        .subresourceRange = {
+            .aspectMask = aspectMask,
+            .baseMipLevel = 0,
+            .levelCount = mipLevels,
+            .baseArrayLayer = 0,
+            .layerCount = 1
+        }
+    };
+
+    VkImageView imageView;
+    auto result = device.getDispatch().vkCreateImageView(device.getDevice(), &createInfo, nullptr, &imageView);
+    CORVUS_ASSERT(result == VK_SUCCESS, "Failed to create image view!")
+    return imageView;
+}
+
+VkFormat ImageUtils::findSupportedFormat(const Corvus::Device& device, const std::vector<VkFormat>& candidates,
+                                         VkFormatFeatureFlags features)
+{
+    for (auto format: candidates)
+    {
+        VkFormatProperties properties;
+        device.getInstanceDispatch().vkGetPhysicalDeviceFormatProperties(device.getPhysicalDevice(), format,
+                                                                         &properties);
+        if ((properties.optimalTilingFeatures bitand features) == features)
+            return format;
+    }
+    return VK_FORMAT_UNDEFINED;
+}
+
+bool ImageUtils::hasStencilComponent(VkFormat format)
+{
+    return format == VK_FORMAT_D32_SFLOAT_S8_UINT or format == VK_FORMAT_D24_UNORM_S8_UINT;
+}
+
+void ImageUtils::transitionImageLayout(const Corvus::Device& device, VkCommandBuffer commandBuffer, VkImage image,
+                                       VkImageLayout oldLayout, VkImageLayout newLayout,
+                                       VkImageAspectFlags aspectMask, uint32_t baseMipLevel, uint32_t levelCount)
+{
+    recordLayoutBarrier(device, commandBuffer, image, oldLayout, newLayout, getLayoutUsage(oldLayout), aspectMask,
+                        baseMipLevel, levelCount);
+}
+
+void ImageUtils::transitionImageLayoutAfter(const Corvus::Device& device, VkCommandBuffer commandBuffer,
+                                            VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout,
+                                            VkPipelineStageFlags sourceStage, VkAccessFlags sourceAccess,
+                                            VkImageAspectFlags aspectMask)
+{
+    recordLayoutBarrier(device, commandBuffer, image, oldLayout, newLayout, {sourceStage, sourceAccess}, aspectMask,
+                        0, VK_REMAINING_MIP_LEVELS);
+}
+
+void ImageUtils::recordLayoutBarrier(const Corvus::Device& device, VkCommandBuffer commandBuffer, VkImage image,
+                                     VkImageLayout oldLayout, VkImageLayout newLayout, LayoutUsage source,
+                                     VkImageAspectFlags aspectMask, uint32_t baseMipLevel, uint32_t levelCount)
+{
+    auto destination = getLayoutUsage(newLayout);
+
+    VkImageMemoryBarrier barrier = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = source.access,
+        .dstAccessMask = destination.access,
+        .oldLayout = oldLayout,
+        .newLayout = newLayout,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = image,
+        .subresourceRange = {
+            .aspectMask = aspectMask,
+            .baseMipLevel = baseMipLevel,
+            .levelCount = levelCount,
+            .baseArrayLayer = 0,
+            .layerCount = VK_REMAINING_ARRAY_LAYERS,
+        },
+    };
+
+    device.getDispatch().vkCmdPipelineBarrier(commandBuffer, source.stage, destination.stage, 0, 0, nullptr, 0, nullptr,
+                                              1, &barrier);
+}
+
+ImageUtils::LayoutUsage ImageUtils::getLayoutUsage(VkImageLayout layout)
+{
+    switch (layout)
+    {
+    case VK_IMAGE_LAYOUT_UNDEFINED:
+        // Contents are discarded, but the transition must still wait for whatever used the image last.
+        // For swapchain images this also chains onto the acquire semaphore wait.
+        return {VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0};
+    case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+        return {
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            VK_ACCESS_COLOR_ATTACHMENT_READ_BIT bitor VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+        };
+    case VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL:
+    case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+        return {
+            VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT bitor VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT bitor VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+        };
+    case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+        return {
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT bitor VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_ACCESS_SHADER_READ_BIT
+        };
+    case VK_IMAGE_LAYOUT_GENERAL:
+        return {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT bitor VK_ACCESS_SHADER_WRITE_BIT};
+    case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+        return {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT};
+    case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+        return {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT};
+    case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+        return {VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0};
+    default:
+        return {VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_MEMORY_READ_BIT bitor VK_ACCESS_MEMORY_WRITE_BIT};
+    }
+}
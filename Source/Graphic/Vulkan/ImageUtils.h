@@ -0,0 +1,58 @@
+#ifndef ENGINE_IMAGEUTILS_H
+#define ENGINE_IMAGEUTILS_H
+
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+namespace Corvus
+{
+    class Device;
+}
+
+class ImageUtils
+{
+public:
+    // More than one queue family makes the image concurrently shared between them, storage images written by
+    // async compute need Device::getSharedQueueFamilies
+    static void createImage(const Corvus::Device& device, VkExtent2D extent, VkFormat format, VkImageUsageFlags usage,
+                            VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory,
+                            uint32_t mipLevels = 1, const std::vector<uint32_t>& queueFamilies = {},
+                            VkImageCreateFlags flags = 0);
+
+    static VkImageView createImageView(const Corvus::Device& device, VkImage image, VkFormat format,
+                                       VkImageAspectFlags aspectMask, uint32_t mipLevels = 1);
+
+    // Returns the first candidate whose optimal tiling supports the features, VK_FORMAT_UNDEFINED if none does
+    static VkFormat findSupportedFormat(const Corvus::Device& device, const std::vector<VkFormat>& candidates,
+                                        VkFormatFeatureFlags features);
+
+    [[nodiscard]] static bool hasStencilComponent(VkFormat format);
+
+    // Records a barrier moving the image between layouts, stages and access masks are derived from the layouts
+    static void transitionImageLayout(const Corvus::Device& device, VkCommandBuffer commandBuffer, VkImage image,
+                                      VkImageLayout oldLayout, VkImageLayout newLayout,
+                                      VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                      uint32_t baseMipLevel = 0, uint32_t levelCount = VK_REMAINING_MIP_LEVELS);
+    // Same, but waits for the given stages and makes their writes available. Transitions from UNDEFINED need this
+    // when the image's previous writes are not covered by a semaphore or fence wait, e.g. a depth image shared by
+    // frames in flight.
+    static void transitionImageLayoutAfter(const Corvus::Device& device, VkCommandBuffer commandBuffer,
+                                           VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout,
+                                           VkPipelineStageFlags sourceStage, VkAccessFlags sourceAccess,
+                                           VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT);
+
+private:
+    struct LayoutUsage
+    {
+        VkPipelineStageFlags stage;
+        VkAccessFlags access;
+    };
+
+    static LayoutUsage getLayoutUsage(VkImageLayout layout);
+    static void recordLayoutBarrier(const Corvus::Device& device, VkCommandBuffer commandBuffer, VkImage image,
+                                    VkImageLayout oldLayout, VkImageLayout newLayout, LayoutUsage source,
+                                    VkImageAspectFlags aspectMask, uint32_t baseMipLevel, uint32_t levelCount);
+};
+
+
+#endif //ENGINE_IMAGEUTILS_H
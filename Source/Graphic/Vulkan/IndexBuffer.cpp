@@ -4,21 +4,42 @@
 
 #include "IndexBuffer.h"
 
+#include <algorithm>
 #include <iso646.h>
 
 #include "BufferUtils.h"
 
 namespace Corvus
 {
+    namespace
+    {
+        // 0xFFFF stays unused so the meshes keep working should primitive restart ever be enabled
+        bool fitsUint16(const std::vector<uint32_t>& indices)
+        {
+            return std::ranges::all_of(indices, [](uint32_t index) { return index < 0xFFFF; });
+        }
+    }
+
     IndexBuffer::IndexBuffer(const std::vector<uint32_t>& indices, std::shared_ptr<Device> device)
-        : m_Device(std::move(device)), m_BufferSize(sizeof(indices[0]) * indices.size())
+        : m_Device(std::move(device)),
+          m_IndexType(fitsUint16(indices) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32)
     {
+        std::vector<uint16_t> narrowIndices;
+        const void* source = indices.data();
+        m_BufferSize = sizeof(uint32_t) * indices.size();
+        if (m_IndexType == VK_INDEX_TYPE_UINT16)
+        {
+            narrowIndices.assign(indices.begin(), indices.end());
+            source = narrowIndices.data();
+            m_BufferSize = sizeof(uint16_t) * indices.size();
+        }
+
+        const auto& vk = m_Device->getDispatch();
         VkBuffer stagingBuffer;
         VkDeviceMemory stagingBufferMemory;
 
         BufferUtils::createBuffer(
-            m_Device->getDevice(),
-            m_Device->getPhysicalDevice(),
+            *m_Device,
             m_BufferSize,
             VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT bitor
@@ -27,40 +48,33 @@ namespace Corvus
         );
 
         void* data;
-        vkMapMemory(m_Device->getDevice(), stagingBufferMemory, 0, m_BufferSize, 0, &data);
-        memcpy(data, indices.data(), m_BufferSize);
-        vkUnmapMemory(m_Device->getDevice(), stagingBufferMemory);
+        vk.vkMapMemory(m_Device->getDevice(), stagingBufferMemory, 0, m_BufferSize, 0, &data);
+        memcpy(data, source, m_BufferSize);
+        vk.vkUnmapMemory(m_Device->getDevice(), stagingBufferMemory);
 
         BufferUtils::createBuffer(
-            m_Device->getDevice(),
-            m_Device->getPhysicalDevice(),
+            *m_Device,
             m_BufferSize,
             VK_BUFFER_USAGE_TRANSFER_DST_BIT bitor VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
             m_IndexBuffer, m_IndexBufferMemory
         );
 
-        BufferUtils::copyBuffer(
-            stagingBuffer,
-            m_IndexBuffer,
-            m_BufferSize,
-            m_Device->getCommandPool(),
-            m_Device->getDevice(),
-            m_Device->getQueue("graphics")
-        );
+        BufferUtils::copyBuffer(*m_Device, stagingBuffer, m_IndexBuffer, m_BufferSize);
 
-        vkDestroyBuffer(m_Device->getDevice(), stagingBuffer, nullptr);
-        vkFreeMemory(m_Device->getDevice(), stagingBufferMemory, nullptr);
+        vk.vkDestroyBuffer(m_Device->getDevice(), stagingBuffer, nullptr);
+        vk.vkFreeMemory(m_Device->getDevice(), stagingBufferMemory, nullptr);
     }
 
     IndexBuffer::~IndexBuffer()
     {
-        vkDestroyBuffer(m_Device->getDevice(), m_IndexBuffer, nullptr);
-        vkFreeMemory(m_Device->getDevice(), m_IndexBufferMemory, nullptr);
+        const auto& vk = m_Device->getDispatch();
+        vk.vkDestroyBuffer(m_Device->getDevice(), m_IndexBuffer, nullptr);
+        vk.vkFreeMemory(m_Device->getDevice(), m_IndexBufferMemory, nullptr);
     }
 
     void IndexBuffer::bind(VkCommandBuffer commandBuffer) const
     {
-        vkCmdBindIndexBuffer(commandBuffer, m_IndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+        m_Device->getDispatch().vkCmdBindIndexBuffer(commandBuffer, m_IndexBuffer, 0, m_IndexType);
     }
 }
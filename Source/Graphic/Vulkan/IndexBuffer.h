@@ -12,6 +12,7 @@
 
 namespace Corvus
 {
+    // Indices are stored with 16 bits whenever every value fits, halving the buffer and the index fetch
     class IndexBuffer
     {
     public:
@@ -20,11 +21,14 @@ namespace Corvus
 
         void bind(VkCommandBuffer commandBuffer) const;
 
+        [[nodiscard]] VkIndexType getIndexType() const { return m_IndexType; }
+
     private:
         std::shared_ptr<Device> m_Device;
         std::vector<Vertex> m_Vertices;
 
         VkDeviceSize m_BufferSize;
+        VkIndexType m_IndexType;
 
         VkBuffer m_IndexBuffer = VK_NULL_HANDLE;
         VkDeviceMemory m_IndexBufferMemory = VK_NULL_HANDLE;
@@ -6,25 +6,31 @@
 #include "Utility/Corvus.h"
 #include "GLFW/glfw3.h"
 
+#include <algorithm>
+
 namespace Corvus
 {
-    Instance::Instance()
+    Instance::Instance(bool windowSystem)
     {
-        uint32_t glfwExtensionCount = 0;
-        const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-        m_Extensions = std::vector<const char*>(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        if (windowSystem)
+        {
+            uint32_t glfwExtensionCount = 0;
+            const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+            m_Extensions = std::vector<const char*>(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        }
 
 #ifndef NDEBUG
         m_Extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
 #endif
 
+        m_ApiVersion = queryApiVersion();
         m_AppInfo = {
                 .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
                 .pApplicationName = ENGINE_NAME,
                 .applicationVersion = VK_MAKE_VERSION(1, 0, 0),
                 .pEngineName = ENGINE_NAME,
                 .engineVersion = VK_MAKE_VERSION(1, 0, 0),
-                .apiVersion = VK_API_VERSION_1_0
+                .apiVersion = m_ApiVersion
         };
 
         m_CreateInfo = {
@@ -37,15 +43,31 @@ namespace Corvus
 
         auto success = vkCreateInstance(&m_CreateInfo, nullptr, &m_Instance);
         CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create instance!")
-        CORVUS_LOG(info, "Vulkan instance created!");
+        CORVUS_LOG(info, "Vulkan instance created! (API {}.{})", VK_API_VERSION_MAJOR(m_ApiVersion),
+                   VK_API_VERSION_MINOR(m_ApiVersion));
+
+        m_Dispatch.load(m_Instance);
     }
 
     Instance::~Instance()
     {
-        vkDestroyInstance(m_Instance, nullptr);
+        m_Dispatch.vkDestroyInstance(m_Instance, nullptr);
         CORVUS_LOG(info, "Vulkan instance destroyed!");
     }
 
+    uint32_t Instance::queryApiVersion()
+    {
+        // vkEnumerateInstanceVersion does not exist on 1.0 loaders, which can only create 1.0 instances
+        auto enumerateInstanceVersion = reinterpret_cast<PFN_vkEnumerateInstanceVersion>(
+                vkGetInstanceProcAddr(VK_NULL_HANDLE, "vkEnumerateInstanceVersion"));
+        if (enumerateInstanceVersion == nullptr)
+            return VK_API_VERSION_1_0;
+
+        uint32_t loaderVersion = VK_API_VERSION_1_0;
+        enumerateInstanceVersion(&loaderVersion);
+        return std::min(loaderVersion, VK_API_VERSION_1_3);
+    }
+
     VkInstance Instance::getInstance() const
     {
         return m_Instance;
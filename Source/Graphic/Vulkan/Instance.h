@@ -8,6 +8,8 @@
 #include <vulkan/vulkan_core.h>
 #include <vector>
 
+#include "Dispatch.h"
+
 namespace Corvus
 {
     class Instance
@@ -15,15 +17,23 @@ namespace Corvus
         VkInstance m_Instance = VK_NULL_HANDLE;
         VkInstanceCreateInfo m_CreateInfo = {};
         VkApplicationInfo m_AppInfo = {};
+        uint32_t m_ApiVersion = VK_API_VERSION_1_0;
         std::vector<const char*> m_Extensions;
+        InstanceDispatch m_Dispatch;
 
     public:
-        Instance();
+        // Without window system support the instance needs no initialized GLFW, but can not create surfaces
+        explicit Instance(bool windowSystem = true);
         ~Instance();
 
         [[nodiscard]] VkInstance getInstance() const;
+        [[nodiscard]] const InstanceDispatch& getDispatch() const { return m_Dispatch; }
+        [[nodiscard]] uint32_t getApiVersion() const { return m_ApiVersion; }
         [[nodiscard]] VkInstanceCreateInfo* getCreateInfo() { return &m_CreateInfo; }
         [[nodiscard]] VkApplicationInfo* getAppInfo() { return &m_AppInfo; }
+
+    private:
+        static uint32_t queryApiVersion();
     };
 
 } // Corvus
@@ -0,0 +1,299 @@
+#include "Ktx2.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+#include "Utility/Corvus.h"
+
+namespace Corvus
+{
+    namespace
+    {
+        static_assert(std::endian::native == std::endian::little, "KTX2 files are read and written in place");
+
+        constexpr std::array<uint8_t, 12> KTX2_IDENTIFIER = {
+            0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+        };
+
+        struct Ktx2Header
+        {
+            std::array<uint8_t, 12> identifier;
+            uint32_t vkFormat;
+            uint32_t typeSize;
+            uint32_t pixelWidth;
+            uint32_t pixelHeight;
+            uint32_t pixelDepth;
+            uint32_t layerCount;
+            uint32_t faceCount;
+            uint32_t levelCount;
+            uint32_t supercompressionScheme;
+            uint32_t dfdByteOffset;
+            uint32_t dfdByteLength;
+            uint32_t kvdByteOffset;
+            uint32_t kvdByteLength;
+            uint64_t sgdByteOffset;
+            uint64_t sgdByteLength;
+        };
+        static_assert(sizeof(Ktx2Header) == 80, "Ktx2Header must match the file layout");
+
+        struct Ktx2Level
+        {
+            uint64_t byteOffset;
+            uint64_t byteLength;
+            uint64_t uncompressedByteLength;
+        };
+        static_assert(sizeof(Ktx2Level) == 24, "Ktx2Level must match the file layout");
+
+        // Khronos Data Format enumerants of the BCn descriptors
+        constexpr uint8_t KHR_DF_MODEL_BC1A = 128;
+        constexpr uint8_t KHR_DF_MODEL_BC2 = 129;
+        constexpr uint8_t KHR_DF_MODEL_BC3 = 130;
+        constexpr uint8_t KHR_DF_MODEL_BC4 = 131;
+        constexpr uint8_t KHR_DF_MODEL_BC5 = 132;
+        constexpr uint8_t KHR_DF_MODEL_BC7 = 134;
+        constexpr uint8_t KHR_DF_PRIMARIES_BT709 = 1;
+        constexpr uint8_t KHR_DF_TRANSFER_LINEAR = 1;
+        constexpr uint8_t KHR_DF_TRANSFER_SRGB = 2;
+        constexpr uint8_t KHR_DF_CHANNEL_COLOR = 0;
+        constexpr uint8_t KHR_DF_CHANNEL_GREEN = 1;
+        constexpr uint8_t KHR_DF_CHANNEL_ALPHA_PRESENT = 1;
+        constexpr uint8_t KHR_DF_CHANNEL_ALPHA = 15;
+
+        struct DescriptorSample
+        {
+            uint8_t channel;
+            uint16_t bitOffset;
+        };
+
+        // Basic descriptor block with one sample per 64 or 128 bit part of the block
+        std::vector<uint32_t> createDataFormatDescriptor(VkFormat format)
+        {
+            uint8_t model;
+            std::vector<DescriptorSample> samples;
+            switch (format)
+            {
+            case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+                model = KHR_DF_MODEL_BC1A;
+                samples = {{KHR_DF_CHANNEL_COLOR, 0}};
+                break;
+            case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+                model = KHR_DF_MODEL_BC1A;
+                samples = {{KHR_DF_CHANNEL_ALPHA_PRESENT, 0}};
+                break;
+            case VK_FORMAT_BC2_UNORM_BLOCK:
+            case VK_FORMAT_BC2_SRGB_BLOCK:
+                model = KHR_DF_MODEL_BC2;
+                samples = {{KHR_DF_CHANNEL_ALPHA, 0}, {KHR_DF_CHANNEL_COLOR, 64}};
+                break;
+            case VK_FORMAT_BC3_UNORM_BLOCK:
+            case VK_FORMAT_BC3_SRGB_BLOCK:
+                model = KHR_DF_MODEL_BC3;
+                samples = {{KHR_DF_CHANNEL_ALPHA, 0}, {KHR_DF_CHANNEL_COLOR, 64}};
+                break;
+            case VK_FORMAT_BC4_UNORM_BLOCK:
+                model = KHR_DF_MODEL_BC4;
+                samples = {{KHR_DF_CHANNEL_COLOR, 0}};
+                break;
+            case VK_FORMAT_BC5_UNORM_BLOCK:
+                model = KHR_DF_MODEL_BC5;
+                samples = {{KHR_DF_CHANNEL_COLOR, 0}, {KHR_DF_CHANNEL_GREEN, 64}};
+                break;
+            case VK_FORMAT_BC7_UNORM_BLOCK:
+            case VK_FORMAT_BC7_SRGB_BLOCK:
+                model = KHR_DF_MODEL_BC7;
+                samples = {{KHR_DF_CHANNEL_COLOR, 0}};
+                break;
+            default:
+                return {};
+            }
+
+            auto block = getFormatBlock(format);
+            uint32_t bitLength = block.size * 8 / static_cast<uint32_t>(samples.size()) - 1;
+            uint32_t blockSize = 24 + 16 * static_cast<uint32_t>(samples.size());
+            uint8_t transfer = isSrgbFormat(format) ? KHR_DF_TRANSFER_SRGB : KHR_DF_TRANSFER_LINEAR;
+
+            std::vector<uint32_t> words = {
+                4 + blockSize, // Total size
+                0, // Khronos vendor, basic descriptor type
+                2u bitor blockSize << 16, // Version
+                model bitor KHR_DF_PRIMARIES_BT709 << 8 bitor static_cast<uint32_t>(transfer) << 16,
+                (block.width - 1) bitor (block.height - 1) << 8,
+                block.size,
+                0,
+            };
+            for (auto sample: samples)
+            {
+                uint32_t channel = sample.channel;
+                words.push_back(sample.bitOffset bitor bitLength << 16 bitor channel << 24);
+                words.push_back(0); // Sample position
+                words.push_back(0); // Lower
+                words.push_back(UINT32_MAX); // Upper
+            }
+            return words;
+        }
+
+        VkDeviceSize alignOffset(VkDeviceSize offset, VkDeviceSize alignment)
+        {
+            return (offset + alignment - 1) / alignment * alignment;
+        }
+
+        struct Ktx2Layout
+        {
+            Ktx2Info info;
+            std::vector<Ktx2Level> levels;
+        };
+
+        // Opens the file and checks its header and level index against what textures support
+        Ktx2Layout openFile(const std::string& path, std::ifstream& file)
+        {
+            file.open(path, std::ios::binary bitor std::ios::ate);
+            CORVUS_ASSERT(file.is_open(), "Failed to open texture {}!", path)
+            auto fileSize = static_cast<uint64_t>(file.tellg());
+            file.seekg(0);
+
+            Ktx2Header header{};
+            file.read(reinterpret_cast<char*>(&header), sizeof(header));
+            CORVUS_ASSERT(file and header.identifier == KTX2_IDENTIFIER, "{} is not a KTX2 file!", path)
+            CORVUS_ASSERT(header.supercompressionScheme == 0, "{} is supercompressed, which is not supported!", path)
+            CORVUS_ASSERT(header.pixelHeight > 0 and header.pixelDepth == 0 and header.layerCount <= 1 and
+                          header.faceCount == 1, "{} is not a single 2D texture!", path)
+
+            Ktx2Layout layout = {
+                .info = {
+                    .format = static_cast<VkFormat>(header.vkFormat),
+                    .extent = {header.pixelWidth, header.pixelHeight},
+                    // A level count of 0 asks the loader to generate mips, the texture then only gets the top level
+                    .levelCount = std::max(1u, header.levelCount),
+                },
+            };
+            CORVUS_ASSERT(getFormatBlock(layout.info.format).size != 0, "{} has the unsupported format {}!", path,
+                          header.vkFormat)
+            auto maxLevels = static_cast<uint32_t>(std::bit_width(std::max(header.pixelWidth, header.pixelHeight)));
+            CORVUS_ASSERT(layout.info.levelCount <= maxLevels, "{} has more mip levels than its extent allows!", path)
+
+            layout.levels.resize(layout.info.levelCount);
+            file.read(reinterpret_cast<char*>(layout.levels.data()),
+                      static_cast<std::streamsize>(layout.levels.size() * sizeof(Ktx2Level)));
+            CORVUS_ASSERT(file, "{} is truncated!", path)
+
+            for (uint32_t level = 0; level < layout.info.levelCount; level++)
+            {
+                auto size = getLevelSize(layout.info.format, getLevelExtent(layout.info.extent, level));
+                const auto& entry = layout.levels[level];
+                CORVUS_ASSERT(entry.byteLength >= size and entry.byteOffset + entry.byteLength <= fileSize,
+                              "Mip level {} of {} is out of bounds!", level, path)
+            }
+            return layout;
+        }
+    }
+
+    TextureImage loadKtx2(const std::string& path)
+    {
+        return loadKtx2(path, 0);
+    }
+
+    TextureImage loadKtx2(const std::string& path, uint32_t firstLevel, uint32_t levelCount)
+    {
+        std::ifstream file;
+        auto layout = openFile(path, file);
+        CORVUS_ASSERT(firstLevel < layout.levels.size(), "{} has no mip level {}!", path, firstLevel)
+        auto lastLevel = static_cast<uint32_t>(std::min<uint64_t>(layout.levels.size(),
+                                                                  static_cast<uint64_t>(firstLevel) + levelCount));
+
+        TextureImage image = {
+            .format = layout.info.format,
+            .extent = getLevelExtent(layout.info.extent, firstLevel),
+        };
+        for (uint32_t level = firstLevel; level < lastLevel; level++)
+        {
+            // Straight into the upload layout, the file stores the smallest level first
+            auto size = getLevelSize(image.format, getLevelExtent(layout.info.extent, level));
+            file.seekg(static_cast<std::streamoff>(layout.levels[level].byteOffset));
+            file.read(reinterpret_cast<char*>(image.addLevel(size)), static_cast<std::streamsize>(size));
+            CORVUS_ASSERT(file, "Failed to read mip level {} of {}!", level, path)
+        }
+        return image;
+    }
+
+    Ktx2Info readKtx2Info(const std::string& path)
+    {
+        std::ifstream file;
+        return openFile(path, file).info;
+    }
+
+    bool isKtx2File(const std::string& path)
+    {
+        return std::filesystem::path(path).extension() == ".ktx2";
+    }
+
+    void saveKtx2(const std::string& path, const TextureImage& image)
+    {
+        auto descriptor = createDataFormatDescriptor(image.format);
+        CORVUS_ASSERT(not descriptor.empty(), "KTX2 files can not be written for format {}!",
+                      static_cast<uint32_t>(image.format))
+
+        constexpr std::string_view writerKey = "KTXwriter";
+        constexpr std::string_view writer = "Corvus TextureCompressor";
+        auto keyValueLength = static_cast<uint32_t>(writerKey.size() + writer.size() + 2);
+
+        auto levelCount = static_cast<uint32_t>(image.levels.size());
+        uint32_t dfdOffset = sizeof(Ktx2Header) + levelCount * sizeof(Ktx2Level);
+        auto dfdLength = static_cast<uint32_t>(descriptor.size() * sizeof(uint32_t));
+        uint32_t kvdOffset = dfdOffset + dfdLength;
+        auto kvdLength = static_cast<uint32_t>(alignOffset(sizeof(uint32_t) + keyValueLength, 4));
+
+        Ktx2Header header = {
+            .identifier = KTX2_IDENTIFIER,
+            .vkFormat = static_cast<uint32_t>(image.format),
+            .typeSize = 1,
+            .pixelWidth = image.extent.width,
+            .pixelHeight = image.extent.height,
+            .pixelDepth = 0,
+            .layerCount = 0,
+            .faceCount = 1,
+            .levelCount = levelCount,
+            .supercompressionScheme = 0,
+            .dfdByteOffset = dfdOffset,
+            .dfdByteLength = dfdLength,
+            .kvdByteOffset = kvdOffset,
+            .kvdByteLength = kvdLength,
+            .sgdByteOffset = 0,
+            .sgdByteLength = 0,
+        };
+
+        // Levels go smallest first, each one aligned to the block size
+        std::vector<Ktx2Level> levels(levelCount);
+        VkDeviceSize offset = kvdOffset + kvdLength;
+        VkDeviceSize alignment = getFormatBlock(image.format).size;
+        for (uint32_t level = levelCount; level-- > 0;)
+        {
+            offset = alignOffset(offset, alignment);
+            levels[level] = {offset, image.levels[level].size, image.levels[level].size};
+            offset += image.levels[level].size;
+        }
+
+        std::vector<char> file(offset, 0);
+        std::memcpy(file.data(), &header, sizeof(header));
+        std::memcpy(file.data() + sizeof(header), levels.data(), levels.size() * sizeof(Ktx2Level));
+        std::memcpy(file.data() + dfdOffset, descriptor.data(), dfdLength);
+        std::memcpy(file.data() + kvdOffset, &keyValueLength, sizeof(keyValueLength));
+        std::memcpy(file.data() + kvdOffset + sizeof(uint32_t), writerKey.data(), writerKey.size());
+        std::memcpy(file.data() + kvdOffset + sizeof(uint32_t) + writerKey.size() + 1, writer.data(), writer.size());
+        for (uint32_t level = 0; level < levelCount; level++)
+        {
+            std::memcpy(file.data() + levels[level].byteOffset, image.data.data() + image.levels[level].offset,
+                        image.levels[level].size);
+        }
+
+        std::ofstream output(path, std::ios::binary);
+        output.write(file.data(), static_cast<std::streamsize>(file.size()));
+        CORVUS_ASSERT(output, "Failed to write {}!", path)
+    }
+} // Corvus
@@ -0,0 +1,32 @@
+#ifndef ENGINE_KTX2_H
+#define ENGINE_KTX2_H
+
+#include <cstdint>
+#include <string>
+
+#include "TextureFormat.h"
+
+namespace Corvus
+{
+    struct Ktx2Info
+    {
+        VkFormat format;
+        VkExtent2D extent;
+        uint32_t levelCount;
+    };
+
+    // KTX 2.0 container of a single 2D image with its mip chain. Only files without supercompression are read,
+    // their levels already hold GPU texel data and are uploaded without any CPU decoding.
+    [[nodiscard]] TextureImage loadKtx2(const std::string& path);
+    // Only reads levels from firstLevel on, the image's extent is that of its first level then
+    [[nodiscard]] TextureImage loadKtx2(const std::string& path, uint32_t firstLevel,
+                                        uint32_t levelCount = UINT32_MAX);
+    // Header only, without reading any texel data
+    [[nodiscard]] Ktx2Info readKtx2Info(const std::string& path);
+    [[nodiscard]] bool isKtx2File(const std::string& path);
+
+    // Writes the data format descriptor KTX 2.0 requires, which is only known for the BCn formats
+    void saveKtx2(const std::string& path, const TextureImage& image);
+} // Corvus
+
+#endif //ENGINE_KTX2_H
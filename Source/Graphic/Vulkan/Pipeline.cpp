@@ -2,17 +2,32 @@
 #include <fstream>
 #include <utility>
 #include "Utility/Log.h"
+#include "ImageUtils.h"
 #include "Vertex.h"
 
 namespace Corvus
 {
     Pipeline::Pipeline(
         std::shared_ptr<Device> device, const std::string& vertexShader,
-        const std::string& fragmentShader
+        const std::string& fragmentShader, DepthMode depthMode, VertexInputDescription vertexInput,
+        BlendMode blendMode
+    )
+        : Pipeline(std::move(device), readFile(vertexShader), readFile(fragmentShader), depthMode,
+                   std::move(vertexInput), blendMode)
+    {
+    }
+
+    Pipeline::Pipeline(
+        std::shared_ptr<Device> device, const std::vector<char>& vertexCode,
+        const std::vector<char>& fragmentCode, DepthMode depthMode, VertexInputDescription vertexInput,
+        BlendMode blendMode
     )
         : m_Device(std::move(device)),
-          m_VertexShader("Vertex", readFile(vertexShader), m_Device),
-          m_FragmentShader("Fragment", readFile(fragmentShader), m_Device)
+          m_VertexShader("Vertex", vertexCode, m_Device),
+          m_FragmentShader("Fragment", fragmentCode, m_Device),
+          m_DepthMode(depthMode),
+          m_VertexInput(std::move(vertexInput)),
+          m_BlendMode(blendMode)
     {
         createDescriptorSetLayout();
         createGraphicsPipeline();
@@ -20,10 +35,10 @@ namespace Corvus
 
     Pipeline::~Pipeline()
     {
+        const auto& vk = m_Device->getDispatch();
         auto device = m_Device->getDevice();
-        vkDestroyDescriptorSetLayout(device, m_DescriptorSetLayout, nullptr);
-        vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
-        vkDestroyPipeline(device, m_Pipeline, nullptr);
+        vk.vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+        vk.vkDestroyPipeline(device, m_Pipeline, nullptr);
     }
 
     std::vector<char> Pipeline::readFile(const std::string& filename)
@@ -53,14 +68,16 @@ namespace Corvus
             .pImmutableSamplers = nullptr
         };
 
-        VkDescriptorSetLayoutCreateInfo layoutInfo = {
-            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-            .bindingCount = 1,
-            .pBindings = &uboLayoutBinding
+        // Per-object data of GPU driven draws, looked up through the instance index
+        VkDescriptorSetLayoutBinding objectLayoutBinding = {
+            .binding = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+            .pImmutableSamplers = nullptr
         };
 
-        auto success = vkCreateDescriptorSetLayout(m_Device->getDevice(), &layoutInfo, nullptr, &m_DescriptorSetLayout);
-        CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create descriptor set layout!")
+        m_DescriptorSetLayout = m_Device->getDescriptorLayoutCache().getLayout({uboLayoutBinding, objectLayoutBinding});
     }
 
     void Pipeline::createGraphicsPipeline()
@@ -76,15 +93,12 @@ namespace Corvus
             .pDynamicStates = dynamicStates.data()
         };
 
-        auto bindingDescription = Vertex::getBindingDescription();
-        auto attributeDescriptions = Vertex::getAttributeDescriptions();
-
         VkPipelineVertexInputStateCreateInfo vertexInputInfo = {
             .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
-            .vertexBindingDescriptionCount = 1,
-            .pVertexBindingDescriptions = &bindingDescription,
-            .vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size()),
-            .pVertexAttributeDescriptions = attributeDescriptions.data()
+            .vertexBindingDescriptionCount = static_cast<uint32_t>(m_VertexInput.bindings.size()),
+            .pVertexBindingDescriptions = m_VertexInput.bindings.data(),
+            .vertexAttributeDescriptionCount = static_cast<uint32_t>(m_VertexInput.attributes.size()),
+            .pVertexAttributeDescriptions = m_VertexInput.attributes.data()
         };
 
         VkPipelineInputAssemblyStateCreateInfo inputAssembly = {
@@ -122,6 +136,18 @@ namespace Corvus
             .alphaToOneEnable = VK_FALSE
         };
 
+        // Reverse-Z: the near plane maps to 1 and the buffer is cleared to 0, so closer fragments compare greater
+        VkPipelineDepthStencilStateCreateInfo depthStencil = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+            .depthTestEnable = VK_TRUE,
+            .depthWriteEnable = m_DepthMode != DepthMode::ReadOnly,
+            .depthCompareOp = VK_COMPARE_OP_GREATER_OR_EQUAL,
+            .depthBoundsTestEnable = VK_FALSE,
+            .stencilTestEnable = VK_FALSE,
+            .minDepthBounds = 0.0f,
+            .maxDepthBounds = 1.0f,
+        };
+
         VkPipelineColorBlendAttachmentState colorBlendAttachment = {
             .blendEnable = VK_FALSE,
             .srcColorBlendFactor = VK_BLEND_FACTOR_ONE,
@@ -134,6 +160,23 @@ namespace Corvus
             .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT |
             VK_COLOR_COMPONENT_A_BIT
         };
+        if (m_DepthMode == DepthMode::DepthOnly)
+            colorBlendAttachment.colorWriteMask = 0;
+        if (m_BlendMode != BlendMode::Opaque)
+        {
+            // Alpha keeps the destination's alpha growing towards opaque, additive leaves it alone
+            colorBlendAttachment.blendEnable = VK_TRUE;
+            colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+            colorBlendAttachment.dstColorBlendFactor = m_BlendMode == BlendMode::Alpha
+                                                           ? VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA
+                                                           : VK_BLEND_FACTOR_ONE;
+            colorBlendAttachment.srcAlphaBlendFactor = m_BlendMode == BlendMode::Alpha
+                                                           ? VK_BLEND_FACTOR_ONE
+                                                           : VK_BLEND_FACTOR_ZERO;
+            colorBlendAttachment.dstAlphaBlendFactor = m_BlendMode == BlendMode::Alpha
+                                                           ? VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA
+                                                           : VK_BLEND_FACTOR_ONE;
+        }
 
         VkPipelineColorBlendStateCreateInfo colorBlending = {
             .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
@@ -144,15 +187,21 @@ namespace Corvus
             .blendConstants = {0.0f, 0.0f, 0.0f, 0.0f}
         };
 
+        // Set 0 holds the pipeline's own bindings, the bindless set follows at BindlessDescriptors::SET_INDEX
+        std::vector setLayouts = {m_DescriptorSetLayout};
+        if (auto* bindless = m_Device->getBindlessDescriptors())
+            setLayouts.push_back(bindless->getLayout());
+
         VkPipelineLayoutCreateInfo pipelineLayoutInfo = {
             .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-            .setLayoutCount = 1,
-            .pSetLayouts = &m_DescriptorSetLayout,
-            .pushConstantRangeCount = 0,
-            .pPushConstantRanges = nullptr
+            .setLayoutCount = static_cast<uint32_t>(setLayouts.size()),
+            .pSetLayouts = setLayouts.data(),
+            .pushConstantRangeCount = 1,
+            .pPushConstantRanges = &m_PushConstantRange
         };
 
-        auto success = vkCreatePipelineLayout(m_Device->getDevice(), &pipelineLayoutInfo, nullptr, &m_PipelineLayout);
+        const auto& vk = m_Device->getDispatch();
+        auto success = vk.vkCreatePipelineLayout(m_Device->getDevice(), &pipelineLayoutInfo, nullptr, &m_PipelineLayout);
         CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create pipeline layout!")
         CORVUS_LOG(info, "Pipeline layout created successfully!");
 
@@ -171,15 +220,30 @@ namespace Corvus
             }
         };
 
+        // With dynamic rendering the pipeline only needs the attachment formats instead of a render pass
+        const auto& swapChain = m_Device->getSwapChain();
+        VkFormat colorFormat = swapChain.getImageFormat();
+        VkFormat depthFormat = swapChain.getDepthFormat();
+        VkPipelineRenderingCreateInfo renderingInfo = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+            .colorAttachmentCount = 1,
+            .pColorAttachmentFormats = &colorFormat,
+            .depthAttachmentFormat = depthFormat,
+            .stencilAttachmentFormat = ImageUtils::hasStencilComponent(depthFormat) ? depthFormat : VK_FORMAT_UNDEFINED,
+        };
+        bool dynamicRendering = m_Device->getEnabledFeatures().dynamicRendering;
+
         VkGraphicsPipelineCreateInfo pipelineInfo = {
             .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
-            .stageCount = 2,
+            .pNext = dynamicRendering ? &renderingInfo : nullptr,
+            .stageCount = m_DepthMode == DepthMode::DepthOnly ? 1u : 2u, // Depth only skips the fragment stage
             .pStages = shaderStages,
             .pVertexInputState = &vertexInputInfo,
             .pInputAssemblyState = &inputAssembly,
             .pViewportState = &viewportState, // viewport and scissor are dynamic
             .pRasterizationState = &rasterizer,
             .pMultisampleState = &multisampling,
+            .pDepthStencilState = &depthStencil,
             .pColorBlendState = &colorBlending,
             .pDynamicState = &dynamicState,
             .layout = m_PipelineLayout,
@@ -189,7 +253,7 @@ namespace Corvus
             .basePipelineIndex = -1
         };
 
-        success = vkCreateGraphicsPipelines(m_Device->getDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr,
+        success = vk.vkCreateGraphicsPipelines(m_Device->getDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr,
                                             &m_Pipeline);
         CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create graphics pipeline!")
         CORVUS_LOG(info, "Graphics pipeline created successfully!");
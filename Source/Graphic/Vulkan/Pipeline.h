@@ -5,33 +5,70 @@
 #include <vector>
 
 #include "Device.h"
+#include "PushConstants.h"
 #include "Shader.h"
+#include "Vertex.h"
 
 #include "Utility/Corvus.h"
 
 
 namespace Corvus
 {
+    // All modes test with reverse-Z (greater is closer). A depth pre-pass renders opaque geometry with a DepthOnly
+    // pipeline first, the shading pipelines then run ReadOnly and only shade the visible fragment per pixel.
+    enum class DepthMode { ReadWrite, ReadOnly, DepthOnly };
+
+    // How fragments combine with the color attachment. Alpha blends non-premultiplied colors over what is there,
+    // additive only adds light and is independent of the drawing order.
+    enum class BlendMode { Opaque, Alpha, Additive };
+
     class Pipeline
     {
     public:
-        Pipeline(std::shared_ptr<Device> device, const std::string &vertexShader, const std::string &fragmentShader);
+        Pipeline(std::shared_ptr<Device> device, const std::string &vertexShader, const std::string &fragmentShader,
+                 DepthMode depthMode = DepthMode::ReadWrite,
+                 VertexInputDescription vertexInput = describeVertexInput<Vertex>(),
+                 BlendMode blendMode = BlendMode::Opaque);
+        Pipeline(std::shared_ptr<Device> device, const std::vector<char> &vertexCode,
+                 const std::vector<char> &fragmentCode, DepthMode depthMode = DepthMode::ReadWrite,
+                 VertexInputDescription vertexInput = describeVertexInput<Vertex>(),
+                 BlendMode blendMode = BlendMode::Opaque);
         ~Pipeline();
 
+        static std::vector<char> readFile(const std::string &filename);
+
         [[nodiscard]] VkPipeline getPipeline() const { return m_Pipeline; }
         [[nodiscard]] VkPipelineLayout getPipelineLayout() const { return m_PipelineLayout; }
+        [[nodiscard]] VkDescriptorSetLayout getDescriptorSetLayout() const { return m_DescriptorSetLayout; }
+        [[nodiscard]] const VkPushConstantRange& getPushConstantRange() const { return m_PushConstantRange; }
+        [[nodiscard]] DepthMode getDepthMode() const { return m_DepthMode; }
+        [[nodiscard]] BlendMode getBlendMode() const { return m_BlendMode; }
+
+        template<PushConstantData T>
+        void pushConstants(VkCommandBuffer commandBuffer, const T& data) const
+        {
+            CORVUS_ASSERT(sizeof(T) <= m_PushConstantRange.size, "Push constants exceed the pipeline's range!")
+            m_Device->getDispatch().vkCmdPushConstants(commandBuffer, m_PipelineLayout, m_PushConstantRange.stageFlags,
+                                                       0, sizeof(T), &data);
+        }
 
     private:
         std::shared_ptr<Device> m_Device;
         Shader m_VertexShader;
         Shader m_FragmentShader;
+        DepthMode m_DepthMode;
+        VertexInputDescription m_VertexInput;
+        BlendMode m_BlendMode;
 
         VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
         VkPipeline m_Pipeline = VK_NULL_HANDLE;
-        VkDescriptorSetLayout m_DescriptorSetLayout = VK_NULL_HANDLE;
-
+        VkDescriptorSetLayout m_DescriptorSetLayout = VK_NULL_HANDLE; // Owned by the device's layout cache
+        VkPushConstantRange m_PushConstantRange = {
+            .stageFlags = DRAW_PUSH_CONSTANT_STAGES,
+            .offset = 0,
+            .size = sizeof(DrawPushConstants)
+        };
 
-        static std::vector<char> readFile(const std::string &filename);
         void createDescriptorSetLayout();
         void createGraphicsPipeline();
     };
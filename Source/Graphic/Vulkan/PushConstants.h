@@ -0,0 +1,38 @@
+#ifndef ENGINE_PUSHCONSTANTS_H
+#define ENGINE_PUSHCONSTANTS_H
+
+#include <cstdint>
+#include <type_traits>
+
+#include <vulkan/vulkan_core.h>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace Corvus
+{
+    // Every device guarantees at least this many bytes of push constants (maxPushConstantsSize)
+    constexpr uint32_t MIN_PUSH_CONSTANT_SIZE = 128;
+
+    template<typename T>
+    concept PushConstantData = std::is_trivially_copyable_v<T> and sizeof(T) % 4 == 0 and
+                               sizeof(T) <= MIN_PUSH_CONSTANT_SIZE;
+
+    // Per-draw data pushed inline with the draw, matches Shaders/Include/PushConstants.glslh
+    struct DrawPushConstants
+    {
+        glm::mat4 model = glm::mat4(1.0f);
+        uint32_t objectIndex = 0;
+        uint32_t materialIndex = 0;
+    };
+    static_assert(sizeof(DrawPushConstants) == 72, "DrawPushConstants must match the shader block layout");
+
+    // Pushed as objectIndex for indirect draws, the vertex shader then reads the model matrix of the instance's
+    // object from the object buffer instead of the push constants
+    constexpr uint32_t INDIRECT_OBJECT_INDEX = UINT32_MAX;
+
+    constexpr VkShaderStageFlags DRAW_PUSH_CONSTANT_STAGES = VK_SHADER_STAGE_VERTEX_BIT bitor
+                                                             VK_SHADER_STAGE_FRAGMENT_BIT;
+} // Corvus
+
+#endif //ENGINE_PUSHCONSTANTS_H
@@ -0,0 +1,73 @@
+#include "Queue.h"
+
+namespace Corvus
+{
+    Queue::Queue(const DeviceDispatch &dispatch, VkQueue queue, uint32_t familyIndex, uint32_t queueIndex)
+        : m_Dispatch(dispatch), m_Queue(queue), m_FamilyIndex(familyIndex), m_QueueIndex(queueIndex)
+    {
+    }
+
+    VkResult Queue::submit(const VkSubmitInfo *submitInfos, uint32_t submitCount, VkFence fence)
+    {
+        std::lock_guard lock(m_QueueMutex);
+        return m_Dispatch.vkQueueSubmit(m_Queue, submitCount, submitInfos, fence);
+    }
+
+    VkResult Queue::present(const VkPresentInfoKHR &presentInfo)
+    {
+        std::lock_guard lock(m_QueueMutex);
+        return m_Dispatch.vkQueuePresentKHR(m_Queue, &presentInfo);
+    }
+
+    VkResult Queue::waitIdle()
+    {
+        std::lock_guard lock(m_QueueMutex);
+        return m_Dispatch.vkQueueWaitIdle(m_Queue);
+    }
+
+    void Queue::enqueue(const VkSubmitInfo &submitInfo)
+    {
+        PendingSubmit pending = {
+            .waitSemaphores = {submitInfo.pWaitSemaphores, submitInfo.pWaitSemaphores + submitInfo.waitSemaphoreCount},
+            .waitStages = {submitInfo.pWaitDstStageMask, submitInfo.pWaitDstStageMask + submitInfo.waitSemaphoreCount},
+            .commandBuffers = {submitInfo.pCommandBuffers, submitInfo.pCommandBuffers + submitInfo.commandBufferCount},
+            .signalSemaphores = {submitInfo.pSignalSemaphores,
+                                 submitInfo.pSignalSemaphores + submitInfo.signalSemaphoreCount},
+            .pNext = submitInfo.pNext
+        };
+
+        std::lock_guard lock(m_PendingMutex);
+        m_Pending.push_back(std::move(pending));
+    }
+
+    VkResult Queue::flush(VkFence fence)
+    {
+        std::vector<PendingSubmit> pending;
+        {
+            std::lock_guard lock(m_PendingMutex);
+            pending.swap(m_Pending);
+        }
+
+        if (pending.empty() and fence == VK_NULL_HANDLE)
+            return VK_SUCCESS;
+
+        std::vector<VkSubmitInfo> submitInfos;
+        submitInfos.reserve(pending.size());
+        for (const auto &entry: pending)
+        {
+            submitInfos.push_back({
+                .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+                .pNext = entry.pNext,
+                .waitSemaphoreCount = static_cast<uint32_t>(entry.waitSemaphores.size()),
+                .pWaitSemaphores = entry.waitSemaphores.data(),
+                .pWaitDstStageMask = entry.waitStages.data(),
+                .commandBufferCount = static_cast<uint32_t>(entry.commandBuffers.size()),
+                .pCommandBuffers = entry.commandBuffers.data(),
+                .signalSemaphoreCount = static_cast<uint32_t>(entry.signalSemaphores.size()),
+                .pSignalSemaphores = entry.signalSemaphores.data()
+            });
+        }
+
+        return submit(submitInfos.data(), static_cast<uint32_t>(submitInfos.size()), fence);
+    }
+} // Corvus
@@ -0,0 +1,66 @@
+#ifndef ENGINE_QUEUE_H
+#define ENGINE_QUEUE_H
+
+#include <vulkan/vulkan_core.h>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "Dispatch.h"
+
+namespace Corvus
+{
+    enum class QueueRole : uint32_t
+    {
+        Graphics,
+        Compute,
+        Transfer,
+        Present,
+        Count
+    };
+
+    // Thread-safe wrapper around one hardware queue. Vulkan requires external synchronization of
+    // every vkQueue* call, so all submissions from all producer threads go through m_QueueMutex.
+    class Queue
+    {
+    public:
+        Queue(const DeviceDispatch &dispatch, VkQueue queue, uint32_t familyIndex, uint32_t queueIndex);
+
+        VkResult submit(const VkSubmitInfo *submitInfos, uint32_t submitCount, VkFence fence);
+        VkResult submit(const VkSubmitInfo &submitInfo, VkFence fence) { return submit(&submitInfo, 1, fence); }
+        VkResult present(const VkPresentInfoKHR &presentInfo);
+        VkResult waitIdle();
+
+        // Batched submission: producers enqueue without touching the queue, flush hands every
+        // pending entry to the driver in a single vkQueueSubmit. The submit info is deep-copied,
+        // except for its pNext chain which has to stay alive until flush.
+        void enqueue(const VkSubmitInfo &submitInfo);
+        VkResult flush(VkFence fence = VK_NULL_HANDLE);
+
+        [[nodiscard]] VkQueue getHandle() const { return m_Queue; }
+        [[nodiscard]] uint32_t getFamilyIndex() const { return m_FamilyIndex; }
+        [[nodiscard]] uint32_t getQueueIndex() const { return m_QueueIndex; }
+
+    private:
+        struct PendingSubmit
+        {
+            std::vector<VkSemaphore> waitSemaphores;
+            std::vector<VkPipelineStageFlags> waitStages;
+            std::vector<VkCommandBuffer> commandBuffers;
+            std::vector<VkSemaphore> signalSemaphores;
+            const void *pNext = nullptr;
+        };
+
+        const DeviceDispatch &m_Dispatch;
+        VkQueue m_Queue = VK_NULL_HANDLE;
+        uint32_t m_FamilyIndex = 0;
+        uint32_t m_QueueIndex = 0;
+
+        std::mutex m_QueueMutex;
+        std::mutex m_PendingMutex;
+        std::vector<PendingSubmit> m_Pending;
+    };
+
+} // Corvus
+
+#endif //ENGINE_QUEUE_H
@@ -2,35 +2,55 @@
 #include <vector>
 #include "QueueFamilyIndices.h"
 
-QueueFamilyIndices QueueFamilyIndices::findQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface)
+QueueFamilyIndices QueueFamilyIndices::findQueueFamilies(const std::vector<VkQueueFamilyProperties> &queueFamilies,
+                                                         const std::vector<VkBool32> &presentSupport)
 {
     QueueFamilyIndices indices;
 
-    uint32_t queueFamilyCount = 0;
-    vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
-
-    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
-    vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
-
-    int i = 0;
-    for (const auto &queueFamily: queueFamilies)
+    for (uint32_t i = 0; i < queueFamilies.size(); i++)
     {
-        if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+        bool graphicsSupport = queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT;
+
+        // A family that can do both avoids concurrent sharing of the swapchain images
+        if (graphicsSupport and presentSupport[i])
         {
             indices.graphicsFamily = i;
+            indices.presentFamily = i;
+            break;
         }
-        VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
-
-        if (presentSupport)
+        if (graphicsSupport and not indices.graphicsFamily.has_value())
+        {
+            indices.graphicsFamily = i;
+        }
+        if (presentSupport[i] and not indices.presentFamily.has_value())
         {
             indices.presentFamily = i;
         }
-        if (indices.isComplete())
+    }
+
+    for (uint32_t i = 0; i < queueFamilies.size(); i++)
+    {
+        VkQueueFlags flags = queueFamilies[i].queueFlags;
+        bool graphicsSupport = flags & VK_QUEUE_GRAPHICS_BIT;
+        bool computeSupport = flags & VK_QUEUE_COMPUTE_BIT;
+
+        if (computeSupport and not graphicsSupport and not indices.computeFamily.has_value())
         {
-            break;
+            indices.computeFamily = i;
+        }
+        if ((flags & VK_QUEUE_TRANSFER_BIT) and not graphicsSupport and not computeSupport and
+            not indices.transferFamily.has_value())
+        {
+            indices.transferFamily = i;
         }
-        i++;
     }
+
+    // No dedicated family, share the graphics family (graphics implies transfer support)
+    if (not indices.computeFamily.has_value() and indices.graphicsFamily.has_value() and
+        (queueFamilies[*indices.graphicsFamily].queueFlags & VK_QUEUE_COMPUTE_BIT))
+        indices.computeFamily = indices.graphicsFamily;
+    if (not indices.transferFamily.has_value())
+        indices.transferFamily = indices.graphicsFamily;
+
     return indices;
 }
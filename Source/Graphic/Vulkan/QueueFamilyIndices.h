@@ -8,16 +8,21 @@
 
 #include <optional>
 #include <cstdint>
+#include <vector>
+#include <vulkan/vulkan_core.h>
 
 struct QueueFamilyIndices {
     std::optional<uint32_t> graphicsFamily;
     std::optional<uint32_t> presentFamily;
+    std::optional<uint32_t> computeFamily;  // Prefers a family without graphics (async compute)
+    std::optional<uint32_t> transferFamily; // Prefers a transfer-only family (DMA engine)
 
     [[nodiscard]] bool isComplete() const {
         return graphicsFamily.has_value() and presentFamily.has_value();
     }
 
-    static QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface);
+    static QueueFamilyIndices findQueueFamilies(const std::vector<VkQueueFamilyProperties> &queueFamilies,
+                                                const std::vector<VkBool32> &presentSupport);
 };
 
 #endif //ENGINE_QUEUEFAMILYINDICES_H
@@ -0,0 +1,72 @@
+#include "SamplerCache.h"
+
+#include <algorithm>
+
+#include "Utility/Corvus.h"
+#include "Utility/Hash.h"
+
+namespace Corvus
+{
+    size_t SamplerDescriptionHash::operator()(const SamplerDescription& description) const
+    {
+        size_t seed = 0;
+        hashCombine(seed, static_cast<uint32_t>(description.magFilter));
+        hashCombine(seed, static_cast<uint32_t>(description.minFilter));
+        hashCombine(seed, static_cast<uint32_t>(description.mipmapMode));
+        hashCombine(seed, static_cast<uint32_t>(description.addressMode));
+        hashCombine(seed, description.maxAnisotropy);
+        hashCombine(seed, description.minLod);
+        hashCombine(seed, description.maxLod);
+        hashCombine(seed, static_cast<uint32_t>(description.borderColor));
+        hashCombine(seed, static_cast<uint32_t>(description.compareOp));
+        return seed;
+    }
+
+    SamplerCache::SamplerCache(const DeviceDispatch& dispatch, VkDevice device, float maxAnisotropy)
+        : m_Dispatch(dispatch), m_Device(device), m_MaxAnisotropy(maxAnisotropy)
+    {
+    }
+
+    SamplerCache::~SamplerCache()
+    {
+        for (const auto& [description, sampler]: m_Samplers)
+            m_Dispatch.vkDestroySampler(m_Device, sampler, nullptr);
+    }
+
+    VkSampler SamplerCache::getSampler(const SamplerDescription& description)
+    {
+        // Clamped before the lookup, so requests differing only beyond what the device supports share a sampler
+        SamplerDescription key = description;
+        key.maxAnisotropy = std::clamp(key.maxAnisotropy, 1.0f, std::max(m_MaxAnisotropy, 1.0f));
+
+        std::lock_guard lock(m_Mutex);
+        if (auto it = m_Samplers.find(key); it != m_Samplers.end())
+            return it->second;
+
+        VkSamplerCreateInfo samplerInfo = {
+            .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+            .magFilter = key.magFilter,
+            .minFilter = key.minFilter,
+            .mipmapMode = key.mipmapMode,
+            .addressModeU = key.addressMode,
+            .addressModeV = key.addressMode,
+            .addressModeW = key.addressMode,
+            .mipLodBias = 0.0f,
+            .anisotropyEnable = key.maxAnisotropy > 1.0f,
+            .maxAnisotropy = key.maxAnisotropy,
+            .compareEnable = key.compareOp != VK_COMPARE_OP_NEVER,
+            .compareOp = key.compareOp,
+            .minLod = key.minLod,
+            .maxLod = key.maxLod,
+            .borderColor = key.borderColor,
+            .unnormalizedCoordinates = VK_FALSE,
+        };
+
+        VkSampler sampler;
+        auto success = m_Dispatch.vkCreateSampler(m_Device, &samplerInfo, nullptr, &sampler);
+        CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create sampler!")
+
+        m_Samplers.emplace(key, sampler);
+        return sampler;
+    }
+} // Corvus
@@ -0,0 +1,70 @@
+#ifndef ENGINE_SAMPLERCACHE_H
+#define ENGINE_SAMPLERCACHE_H
+
+#include <vulkan/vulkan_core.h>
+#include <mutex>
+#include <unordered_map>
+
+#include "Dispatch.h"
+
+namespace Corvus
+{
+    // Sampler state without the fields the engine never varies, the default is trilinear repeat
+    struct SamplerDescription
+    {
+        VkFilter magFilter = VK_FILTER_LINEAR;
+        VkFilter minFilter = VK_FILTER_LINEAR;
+        VkSamplerMipmapMode mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT; // Used for u, v and w
+        float maxAnisotropy = 16.0f; // 1 disables anisotropic filtering, clamped to the device limit
+        float minLod = 0.0f;
+        float maxLod = VK_LOD_CLAMP_NONE;
+        VkBorderColor borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
+        // Depth comparison for shadow lookups, VK_COMPARE_OP_NEVER leaves it disabled
+        VkCompareOp compareOp = VK_COMPARE_OP_NEVER;
+
+        bool operator==(const SamplerDescription& other) const = default;
+
+        // Unfiltered and clamped, for images read with texelFetch through a combined image sampler
+        static SamplerDescription nearestClamp()
+        {
+            return {
+                .magFilter = VK_FILTER_NEAREST,
+                .minFilter = VK_FILTER_NEAREST,
+                .mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+                .addressMode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+                .maxAnisotropy = 1.0f,
+            };
+        }
+    };
+
+    struct SamplerDescriptionHash
+    {
+        size_t operator()(const SamplerDescription& description) const;
+    };
+
+    // Deduplicates samplers, textures asking for the same state share one VkSampler. Devices only guarantee
+    // 4000 live samplers, so they should never be created per texture. Owned by the Device and thread safe.
+    class SamplerCache
+    {
+    public:
+        // maxAnisotropy is the device limit, 0 when the samplerAnisotropy feature is not enabled
+        SamplerCache(const DeviceDispatch& dispatch, VkDevice device, float maxAnisotropy);
+        ~SamplerCache();
+
+        SamplerCache(const SamplerCache&) = delete;
+        SamplerCache& operator=(const SamplerCache&) = delete;
+
+        [[nodiscard]] VkSampler getSampler(const SamplerDescription& description = {});
+
+    private:
+        const DeviceDispatch& m_Dispatch;
+        VkDevice m_Device;
+        float m_MaxAnisotropy;
+
+        std::mutex m_Mutex;
+        std::unordered_map<SamplerDescription, VkSampler, SamplerDescriptionHash> m_Samplers;
+    };
+} // Corvus
+
+#endif //ENGINE_SAMPLERCACHE_H
@@ -0,0 +1,30 @@
+#include "StorageBuffer.h"
+
+#include "BufferUtils.h"
+
+namespace Corvus
+{
+    StorageBuffer::StorageBuffer(std::shared_ptr<Device> device, VkDeviceSize size, Access access,
+                                 VkBufferUsageFlags additionalUsage)
+        : m_Device(std::move(device)),
+          m_Size(size)
+    {
+        VkMemoryPropertyFlags properties = access == Access::HostWrite
+                                               ? VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+                                               : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+        // Async compute may write any storage buffer the graphics queue reads
+        BufferUtils::createBuffer(*m_Device, size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | additionalUsage, properties,
+                                  m_Buffer, m_BufferMemory, m_Device->getSharedQueueFamilies());
+
+        if (access == Access::HostWrite)
+            m_Device->getDispatch().vkMapMemory(m_Device->getDevice(), m_BufferMemory, 0, size, 0, &m_MappedData);
+    }
+
+    StorageBuffer::~StorageBuffer()
+    {
+        const auto& vk = m_Device->getDispatch();
+        vk.vkDestroyBuffer(m_Device->getDevice(), m_Buffer, nullptr);
+        vk.vkFreeMemory(m_Device->getDevice(), m_BufferMemory, nullptr);
+    }
+} // Corvus
@@ -0,0 +1,38 @@
+#ifndef ENGINE_STORAGEBUFFER_H
+#define ENGINE_STORAGEBUFFER_H
+
+#include <memory>
+
+#include "Device.h"
+
+namespace Corvus
+{
+    // Shader storage buffer, either persistently mapped for data the CPU writes every frame or device local for
+    // data only the GPU produces and consumes
+    class StorageBuffer
+    {
+    public:
+        enum class Access { HostWrite, DeviceOnly };
+
+        StorageBuffer(std::shared_ptr<Device> device, VkDeviceSize size, Access access,
+                      VkBufferUsageFlags additionalUsage = 0);
+        ~StorageBuffer();
+
+        StorageBuffer(const StorageBuffer&) = delete;
+        StorageBuffer& operator=(const StorageBuffer&) = delete;
+
+        [[nodiscard]] VkBuffer getBuffer() const { return m_Buffer; }
+        [[nodiscard]] VkDeviceSize getSize() const { return m_Size; }
+        [[nodiscard]] void* getMappedData() const { return m_MappedData; } // Null for DeviceOnly buffers
+
+    private:
+        std::shared_ptr<Device> m_Device;
+        VkDeviceSize m_Size;
+
+        VkBuffer m_Buffer = VK_NULL_HANDLE;
+        VkDeviceMemory m_BufferMemory = VK_NULL_HANDLE;
+        void* m_MappedData = nullptr;
+    };
+} // Corvus
+
+#endif //ENGINE_STORAGEBUFFER_H
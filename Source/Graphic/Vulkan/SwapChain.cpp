@@ -2,6 +2,8 @@
 
 #include <algorithm>
 
+#include "Device.h"
+#include "ImageUtils.h"
 #include "QueueFamilyIndices.h"
 
 #include "Utility/Corvus.h"
@@ -10,9 +12,9 @@
 namespace Corvus
 {
 
-    SwapChain::SwapChain(VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, GLFWwindow *window)
+    SwapChain::SwapChain(const Device &device)
     {
-        create(device, physicalDevice, surface, window);
+        create(device);
     }
 
     VkSurfaceFormatKHR SwapChain::chooseSwapSurfaceFormat()
@@ -66,35 +68,41 @@ namespace Corvus
         }
     }
 
-    SwapChainSupportDetails SwapChain::querySwapChainSupport(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface)
+    SwapChainSupportDetails SwapChain::querySwapChainSupport(const InstanceDispatch &vk, VkPhysicalDevice physicalDevice,
+                                                             VkSurfaceKHR surface)
     {
         SwapChainSupportDetails details;
-        vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, surface, &details.capabilities);
+        vk.vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, surface, &details.capabilities);
 
         uint32_t formatCount;
-        vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, nullptr);
+        vk.vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, nullptr);
 
         if (formatCount != 0)
         {
             details.formats.resize(formatCount);
-            vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, details.formats.data());
+            vk.vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, details.formats.data());
         }
 
         return details;
     }
 
-    void SwapChain::destroy(VkDevice device) const
+    void SwapChain::destroy(const Device &device) const
     {
+        const auto &vk = device.getDispatch();
         for (auto framebuffer: framebuffers)
-            vkDestroyFramebuffer(device, framebuffer, nullptr);
+            vk.vkDestroyFramebuffer(device.getDevice(), framebuffer, nullptr);
 
         for (auto imageView: imageViews)
-            vkDestroyImageView(device, imageView, nullptr);
+            vk.vkDestroyImageView(device.getDevice(), imageView, nullptr);
 
-        vkDestroySwapchainKHR(device, handle, nullptr);
+        vk.vkDestroyImageView(device.getDevice(), depthImageView, nullptr);
+        vk.vkDestroyImage(device.getDevice(), depthImage, nullptr);
+        vk.vkFreeMemory(device.getDevice(), depthImageMemory, nullptr);
+
+        vk.vkDestroySwapchainKHR(device.getDevice(), handle, nullptr);
     }
 
-    void SwapChain::createImageViews(VkDevice device)
+    void SwapChain::createImageViews(const Device &device)
     {
         imageViews.resize(images.size());
 
@@ -120,38 +128,63 @@ namespace Corvus
                     }
             };
 
-            auto success = vkCreateImageView(device, &createInfo, nullptr, &imageViews[i]);
+            auto success = device.getDispatch().vkCreateImageView(device.getDevice(), &createInfo, nullptr,
+                                                                  &imageViews[i]);
             CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create image views!")
         }
     }
 
-    void SwapChain::createFramebuffers(VkDevice device, VkRenderPass renderPass)
+    void SwapChain::createDepthResources(const Device &device)
+    {
+        // Reverse-Z needs a float format, the precision of a 24-bit normalized buffer stays roughly linear in z
+        depthFormat = ImageUtils::findSupportedFormat(device, {
+                VK_FORMAT_D32_SFLOAT,
+                VK_FORMAT_D32_SFLOAT_S8_UINT,
+                VK_FORMAT_D24_UNORM_S8_UINT
+        }, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT bitor VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
+        CORVUS_ASSERT(depthFormat != VK_FORMAT_UNDEFINED, "Failed to find a supported depth format!")
+        if (depthFormat == VK_FORMAT_D24_UNORM_S8_UINT)
+            CORVUS_LOG(warn, "No float depth format available, reverse-Z precision is reduced");
+
+        // Sampled to build the depth pyramid for occlusion culling
+        ImageUtils::createImage(device, extent, depthFormat,
+                                VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT bitor VK_IMAGE_USAGE_SAMPLED_BIT,
+                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, depthImage, depthImageMemory);
+        depthImageView = ImageUtils::createImageView(device, depthImage, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT);
+    }
+
+    void SwapChain::createFramebuffers(const Device &device, VkRenderPass renderPass)
     {
         framebuffers.resize(imageViews.size());
 
         for (size_t i = 0; i < imageViews.size(); i++)
         {
-            VkImageView attachments[] = {imageViews[i]};
+            VkImageView attachments[] = {imageViews[i], depthImageView};
 
             VkFramebufferCreateInfo framebufferInfo = {
                     .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
                     .renderPass = renderPass,
-                    .attachmentCount = 1,
+                    .attachmentCount = 2,
                     .pAttachments = attachments,
                     .width = extent.width,
                     .height = extent.height,
                     .layers = 1
             };
 
-            auto success = vkCreateFramebuffer(device, &framebufferInfo, nullptr, &framebuffers[i]);
+            auto success = device.getDispatch().vkCreateFramebuffer(device.getDevice(), &framebufferInfo, nullptr,
+                                                                    &framebuffers[i]);
             CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create framebuffer!")
         }
     }
 
-    void SwapChain::create(VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, GLFWwindow *window)
+    void SwapChain::create(const Device &device)
     {
-        supportDetails = querySwapChainSupport(physicalDevice, surface);
-        extent = chooseSwapExtent(window);
+        const auto &vk = device.getDispatch();
+        const QueueFamilyIndices &indices = device.getCapabilities().queueFamilyIndices;
+
+        supportDetails = querySwapChainSupport(device.getInstanceDispatch(), device.getPhysicalDevice(),
+                                               device.getSurface());
+        extent = chooseSwapExtent(device.getWindowHandle());
         VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat();
         VkPresentModeKHR presentMode = chooseSwapPresentMode();
 
@@ -163,7 +196,7 @@ namespace Corvus
 
         VkSwapchainCreateInfoKHR createInfo = {
                 .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
-                .surface = surface,
+                .surface = device.getSurface(),
                 .minImageCount = imageCount,
                 .imageFormat = surfaceFormat.format,
                 .imageColorSpace = surfaceFormat.colorSpace,
@@ -176,7 +209,6 @@ namespace Corvus
                 .clipped = VK_TRUE,
         };
 
-        QueueFamilyIndices indices = QueueFamilyIndices::findQueueFamilies(physicalDevice, surface);
         uint32_t queueFamilyIndices[] = {indices.graphicsFamily.value(), indices.presentFamily.value()};
         if (indices.graphicsFamily != indices.presentFamily)
         {
@@ -190,27 +222,26 @@ namespace Corvus
             createInfo.pQueueFamilyIndices = nullptr; // Optional
         }
 
-        auto success = vkCreateSwapchainKHR(device, &createInfo, nullptr, &handle);
+        auto success = vk.vkCreateSwapchainKHR(device.getDevice(), &createInfo, nullptr, &handle);
         CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create swap chain!")
 
-        vkGetSwapchainImagesKHR(device, handle, &imageCount, nullptr);
+        vk.vkGetSwapchainImagesKHR(device.getDevice(), handle, &imageCount, nullptr);
         images.resize(imageCount);
-        vkGetSwapchainImagesKHR(device, handle, &imageCount, images.data());
+        vk.vkGetSwapchainImagesKHR(device.getDevice(), handle, &imageCount, images.data());
         imageFormat = surfaceFormat.format;
     }
 
-    void SwapChain::recreate(
-            VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, GLFWwindow *window,
-            VkRenderPass renderPass
-    )
+    void SwapChain::recreate(const Device &device, VkRenderPass renderPass)
     {
-        handleWindowMinimization(window);
-        vkDeviceWaitIdle(device);
+        handleWindowMinimization(device.getWindowHandle());
+        device.getDispatch().vkDeviceWaitIdle(device.getDevice());
         destroy(device);
 
-        create(device, physicalDevice, surface, window);
+        create(device);
         createImageViews(device);
-        createFramebuffers(device, renderPass);
+        createDepthResources(device);
+        if (renderPass != VK_NULL_HANDLE) // Dynamic rendering draws straight into the image views
+            createFramebuffers(device, renderPass);
     }
 
     void SwapChain::handleWindowMinimization(GLFWwindow *window)
@@ -9,10 +9,12 @@
 #include <vulkan/vulkan.h>
 #include <vector>
 #include "GLFW/glfw3.h"
+#include "QueueFamilyIndices.h"
+#include "Dispatch.h"
 
 namespace Corvus
 {
-
+    class Device;
 
     struct SwapChainSupportDetails
     {
@@ -28,16 +30,18 @@ namespace Corvus
 
         ~SwapChain() = default;
 
-        explicit SwapChain(VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, GLFWwindow *window);
+        explicit SwapChain(const Device &device);
 
-        void create(VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, GLFWwindow *window);
-        void destroy(VkDevice device) const;
+        void create(const Device &device);
+        void destroy(const Device &device) const;
 
-        void recreate(VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, GLFWwindow *window, VkRenderPass renderPass);
-        void createImageViews(VkDevice device);
-        void createFramebuffers(VkDevice device, VkRenderPass renderPass);
+        void recreate(const Device &device, VkRenderPass renderPass);
+        void createImageViews(const Device &device);
+        void createDepthResources(const Device &device);
+        void createFramebuffers(const Device &device, VkRenderPass renderPass);
 
-        static SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device, VkSurfaceKHR surface);
+        static SwapChainSupportDetails querySwapChainSupport(const InstanceDispatch &vk, VkPhysicalDevice device,
+                                                             VkSurfaceKHR surface);
 
         [[nodiscard]] VkSwapchainKHR getHandle() const { return handle; }
         [[nodiscard]] VkFormat getImageFormat() const { return imageFormat; }
@@ -46,6 +50,9 @@ namespace Corvus
         [[nodiscard]] std::vector<VkImageView> &getImageViews() { return imageViews; }
         [[nodiscard]] std::vector<VkFramebuffer> &getFramebuffers() { return framebuffers; }
         [[nodiscard]] const SwapChainSupportDetails &getSupportDetails() const { return supportDetails; }
+        [[nodiscard]] VkFormat getDepthFormat() const { return depthFormat; }
+        [[nodiscard]] VkImage getDepthImage() const { return depthImage; }
+        [[nodiscard]] VkImageView getDepthImageView() const { return depthImageView; }
 
     private:
         VkSwapchainKHR handle{};
@@ -56,6 +63,12 @@ namespace Corvus
         std::vector<VkFramebuffer> framebuffers{};
         SwapChainSupportDetails supportDetails{};
 
+        // Shared by all swapchain images, only one frame rasterizes at a time
+        VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+        VkImage depthImage = VK_NULL_HANDLE;
+        VkDeviceMemory depthImageMemory = VK_NULL_HANDLE;
+        VkImageView depthImageView = VK_NULL_HANDLE;
+
         VkSurfaceFormatKHR chooseSwapSurfaceFormat();
         VkPresentModeKHR chooseSwapPresentMode();
         VkExtent2D chooseSwapExtent(GLFWwindow *window) const;
@@ -0,0 +1,420 @@
+#include "Texture.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include "BufferUtils.h"
+#include "DescriptorAllocator.h"
+#include "ImageUtils.h"
+#include "Ktx2.h"
+#include "Utility/Corvus.h"
+#include "stb_image.h"
+
+namespace Corvus
+{
+    namespace
+    {
+        // The downsampler writes through an rgba8 storage view, sRGB images are aliased as UNORM for it
+        VkFormat getStorageFormat(VkFormat format)
+        {
+            switch (format)
+            {
+            case VK_FORMAT_R8G8B8A8_UNORM:
+            case VK_FORMAT_R8G8B8A8_SRGB:
+                return VK_FORMAT_R8G8B8A8_UNORM;
+            default:
+                return VK_FORMAT_UNDEFINED;
+            }
+        }
+    }
+
+    Texture::Texture(std::shared_ptr<Device> device, std::span<const std::byte> pixels, VkExtent2D extent,
+                     const TextureSettings& settings, const ComputePipeline* downsampler)
+        : m_Device(std::move(device)),
+          m_Extent(extent),
+          m_Format(settings.format)
+    {
+        CORVUS_ASSERT(extent.width > 0 and extent.height > 0, "Textures must not be empty!")
+        CORVUS_ASSERT(isFormatSupported(*m_Device, m_Format), "Texture format {} is not supported!",
+                      static_cast<uint32_t>(m_Format))
+        CORVUS_ASSERT(pixels.size() == getLevelSize(m_Format, extent), "Texture pixels do not match its {}x{} extent!",
+                      extent.width, extent.height)
+
+        auto mipGeneration = selectMipGeneration(settings, downsampler);
+        m_MipLevels = mipGeneration == MipGeneration::None ? 1 : getMipLevelCount(extent);
+
+        VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT bitor VK_IMAGE_USAGE_SAMPLED_BIT;
+        VkImageCreateFlags flags = 0;
+        if (mipGeneration == MipGeneration::Blit)
+            usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        if (mipGeneration == MipGeneration::Compute)
+        {
+            usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+            if (getStorageFormat(m_Format) != m_Format)
+            {
+                flags = VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT bitor VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
+                m_SampledViewUsage = VK_IMAGE_USAGE_TRANSFER_DST_BIT bitor VK_IMAGE_USAGE_SAMPLED_BIT;
+            }
+        }
+
+        createImage(usage, flags, settings.sampler);
+        upload(pixels, {{0, pixels.size()}}, mipGeneration, downsampler);
+    }
+
+    Texture::Texture(std::shared_ptr<Device> device, const TextureImage& image, const SamplerDescription& sampler)
+        : Texture(std::move(device), image.format, image.extent, static_cast<uint32_t>(image.levels.size()), sampler)
+    {
+        upload(image.data, image.levels, MipGeneration::None, nullptr);
+    }
+
+    Texture::Texture(std::shared_ptr<Device> device, VkFormat format, VkExtent2D extent, uint32_t mipLevels,
+                     const SamplerDescription& sampler)
+        : m_Device(std::move(device)),
+          m_Extent(extent),
+          m_Format(format),
+          m_MipLevels(mipLevels)
+    {
+        CORVUS_ASSERT(m_MipLevels > 0 and m_MipLevels <= getMipLevelCount(m_Extent),
+                      "Textures need between one level and a full mip chain!")
+        CORVUS_ASSERT(isFormatSupported(*m_Device, m_Format), "Texture format {} is not supported by the device!",
+                      static_cast<uint32_t>(m_Format))
+
+        createImage(VK_IMAGE_USAGE_TRANSFER_DST_BIT bitor VK_IMAGE_USAGE_SAMPLED_BIT, 0, sampler);
+    }
+
+    Texture::~Texture()
+    {
+        const auto& vk = m_Device->getDispatch();
+        vk.vkDestroyImageView(m_Device->getDevice(), m_ImageView, nullptr);
+        vk.vkDestroyImage(m_Device->getDevice(), m_Image, nullptr);
+        vk.vkFreeMemory(m_Device->getDevice(), m_ImageMemory, nullptr);
+    }
+
+    std::unique_ptr<Texture> Texture::load(std::shared_ptr<Device> device, const std::string& path,
+                                           const TextureSettings& settings, const ComputePipeline* downsampler)
+    {
+        if (isKtx2File(path))
+        {
+            auto image = loadKtx2(path);
+            auto texture = std::make_unique<Texture>(std::move(device), image, settings.sampler);
+            CORVUS_LOG(info, "Loaded texture {} ({}x{}, format {}, {} mip levels)", path, image.extent.width,
+                       image.extent.height, static_cast<uint32_t>(image.format), texture->getMipLevels());
+            return texture;
+        }
+
+        CORVUS_ASSERT(getFormatBlock(settings.format).size == 4 and getCompressionFamily(settings.format) ==
+                      CompressionFamily::None, "Textures loaded from {} need an 8 bit RGBA format!", path)
+
+        int width, height, channels;
+        std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> pixels = {
+            stbi_load(path.c_str(), &width, &height, &channels, 4), stbi_image_free
+        };
+        CORVUS_ASSERT(pixels != nullptr, "Failed to load texture {}: {}", path, stbi_failure_reason())
+
+        std::span data(reinterpret_cast<const std::byte*>(pixels.get()), static_cast<size_t>(width) * height * 4);
+        VkExtent2D extent = {static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
+        auto texture = std::make_unique<Texture>(std::move(device), data, extent, settings, downsampler);
+        CORVUS_LOG(info, "Loaded texture {} ({}x{}, {} mip levels)", path, width, height, texture->getMipLevels());
+        return texture;
+    }
+
+    uint32_t Texture::getMipLevelCount(VkExtent2D extent)
+    {
+        return static_cast<uint32_t>(std::bit_width(std::max(extent.width, extent.height)));
+    }
+
+    bool Texture::isFormatSupported(const Device& device, VkFormat format)
+    {
+        if (getFormatBlock(format).size == 0)
+            return false;
+
+        const auto& features = device.getEnabledFeatures();
+        switch (getCompressionFamily(format))
+        {
+        case CompressionFamily::BC:
+            if (not features.textureCompressionBC)
+                return false;
+            break;
+        case CompressionFamily::ETC2:
+            if (not features.textureCompressionETC2)
+                return false;
+            break;
+        case CompressionFamily::ASTC:
+            if (not features.textureCompressionASTC)
+                return false;
+            break;
+        case CompressionFamily::None:
+            break;
+        }
+        auto supported = ImageUtils::findSupportedFormat(device, {format}, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
+        return supported != VK_FORMAT_UNDEFINED;
+    }
+
+    bool Texture::requiresDownsampler(const Device& device, VkFormat format)
+    {
+        constexpr VkFormatFeatureFlags blitFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT bitor
+                                                      VK_FORMAT_FEATURE_BLIT_DST_BIT bitor
+                                                      VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+        return ImageUtils::findSupportedFormat(device, {format}, blitFeatures) == VK_FORMAT_UNDEFINED;
+    }
+
+    std::unique_ptr<ComputePipeline> Texture::createDownsampler(std::shared_ptr<Device> device,
+                                                                const std::string& shader)
+    {
+        return std::make_unique<ComputePipeline>(std::move(device), shader, std::vector{
+                                                     VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                                                     VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+                                                 }, sizeof(MipDownsampleConstants), "Mip Downsample");
+    }
+
+    Texture::MipGeneration Texture::selectMipGeneration(const TextureSettings& settings,
+                                                        const ComputePipeline* downsampler) const
+    {
+        // Compressed texels can only be filtered after decoding, their mips come precomputed
+        if (not settings.generateMips or getMipLevelCount(m_Extent) == 1 or
+            getCompressionFamily(m_Format) != CompressionFamily::None)
+        {
+            return MipGeneration::None;
+        }
+        if (not requiresDownsampler(*m_Device, m_Format))
+            return MipGeneration::Blit;
+
+        // Aliasing an sRGB image as UNORM needs the extended usage of Vulkan 1.1
+        VkFormat storageFormat = getStorageFormat(m_Format);
+        bool aliasable = storageFormat == m_Format or m_Device->getCapabilities().apiVersion >= VK_API_VERSION_1_1;
+        if (downsampler != nullptr and storageFormat != VK_FORMAT_UNDEFINED and aliasable)
+            return MipGeneration::Compute;
+
+        CORVUS_LOG(warn, "Mips of texture format {} can not be generated, it only gets its top level",
+                   static_cast<uint32_t>(m_Format));
+        return MipGeneration::None;
+    }
+
+    void Texture::createImage(VkImageUsageFlags usage, VkImageCreateFlags flags, const SamplerDescription& sampler)
+    {
+        // Compute dispatches may sample textures from the async compute queue
+        ImageUtils::createImage(*m_Device, m_Extent, m_Format, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_Image,
+                                m_ImageMemory, m_MipLevels, m_Device->getSharedQueueFamilies(), flags);
+        m_ImageView = createView(m_Format, 0, m_MipLevels, m_SampledViewUsage);
+        m_Sampler = m_Device->getSamplerCache().getSampler(sampler);
+    }
+
+    VkImageView Texture::createView(VkFormat format, uint32_t baseMipLevel, uint32_t levelCount,
+                                    VkImageUsageFlags usage) const
+    {
+        // Zero usage inherits the image's
+        VkImageViewUsageCreateInfo usageInfo = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO,
+            .usage = usage,
+        };
+
+        VkImageViewCreateInfo viewInfo = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .pNext = usage != 0 ? &usageInfo : nullptr,
+            .image = m_Image,
+            .viewType = VK_IMAGE_VIEW_TYPE_2D,
+            .format = format,
+            .subresourceRange = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = baseMipLevel,
+                .levelCount = levelCount,
+                .baseArrayLayer = 0,
+                .layerCount = 1
+            }
+        };
+
+        VkImageView view;
+        auto success = m_Device->getDispatch().vkCreateImageView(m_Device->getDevice(), &viewInfo, nullptr, &view);
+        CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create texture view!")
+        return view;
+    }
+
+    void Texture::upload(std::span<const std::byte> data, const std::vector<TextureLevel>& levels,
+                         MipGeneration mipGeneration, const ComputePipeline* downsampler)
+    {
+        const auto& vk = m_Device->getDispatch();
+        VkBuffer stagingBuffer;
+        VkDeviceMemory stagingBufferMemory;
+        BufferUtils::createBuffer(*m_Device, data.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT bitor VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                  stagingBuffer, stagingBufferMemory);
+
+        void* mapped;
+        vk.vkMapMemory(m_Device->getDevice(), stagingBufferMemory, 0, data.size(), 0, &mapped);
+        std::memcpy(mapped, data.data(), data.size());
+        vk.vkUnmapMemory(m_Device->getDevice(), stagingBufferMemory);
+
+        VkCommandBufferAllocateInfo allocInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = m_Device->getCommandPool(),
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 1,
+        };
+
+        VkCommandBuffer commandBuffer;
+        vk.vkAllocateCommandBuffers(m_Device->getDevice(), &allocInfo, &commandBuffer);
+
+        VkCommandBufferBeginInfo beginInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        };
+        vk.vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+        ImageUtils::transitionImageLayout(*m_Device, commandBuffer, m_Image, VK_IMAGE_LAYOUT_UNDEFINED,
+                                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        recordCopy(commandBuffer, stagingBuffer, levels);
+
+        // Sets and level views of the downsampler only live until the upload finished
+        std::unique_ptr<DescriptorAllocator> descriptorAllocator;
+        std::unique_ptr<DescriptorSetCache> descriptorSets;
+        std::vector<VkImageView> levelViews;
+        switch (mipGeneration)
+        {
+        case MipGeneration::None:
+            ImageUtils::transitionImageLayout(*m_Device, commandBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                              VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            break;
+        case MipGeneration::Blit:
+            blitMips(commandBuffer);
+            break;
+        case MipGeneration::Compute:
+            descriptorAllocator = std::make_unique<DescriptorAllocator>(m_Device, m_MipLevels);
+            descriptorSets = std::make_unique<DescriptorSetCache>(m_Device, *descriptorAllocator);
+            downsampleMips(commandBuffer, *downsampler, *descriptorSets, levelViews);
+            break;
+        }
+
+        vk.vkEndCommandBuffer(commandBuffer);
+
+        VkSubmitInfo submitInfo = {
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            .commandBufferCount = 1,
+            .pCommandBuffers = &commandBuffer,
+        };
+
+        auto& queue = m_Device->getQueue(QueueRole::Graphics);
+        queue.submit(submitInfo, VK_NULL_HANDLE);
+        queue.waitIdle();
+
+        vk.vkFreeCommandBuffers(m_Device->getDevice(), m_Device->getCommandPool(), 1, &commandBuffer);
+        for (auto view: levelViews)
+            vk.vkDestroyImageView(m_Device->getDevice(), view, nullptr);
+        vk.vkDestroyBuffer(m_Device->getDevice(), stagingBuffer, nullptr);
+        vk.vkFreeMemory(m_Device->getDevice(), stagingBufferMemory, nullptr);
+    }
+
+    void Texture::recordCopy(VkCommandBuffer commandBuffer, VkBuffer buffer,
+                             const std::vector<TextureLevel>& levels) const
+    {
+        CORVUS_ASSERT(levels.size() <= m_MipLevels, "Texture has {} mip levels, {} were copied!", m_MipLevels,
+                      levels.size())
+
+        std::vector<VkBufferImageCopy> regions;
+        regions.reserve(levels.size());
+        for (uint32_t level = 0; level < levels.size(); level++)
+        {
+            auto extent = getLevelExtent(m_Extent, level);
+            regions.push_back({
+                .bufferOffset = levels[level].offset,
+                .bufferRowLength = 0,
+                .bufferImageHeight = 0,
+                .imageSubresource = {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .mipLevel = level,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1,
+                },
+                .imageOffset = {0, 0, 0},
+                .imageExtent = {extent.width, extent.height, 1},
+            });
+        }
+        m_Device->getDispatch().vkCmdCopyBufferToImage(commandBuffer, buffer, m_Image,
+                                                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                       static_cast<uint32_t>(regions.size()), regions.data());
+    }
+
+    void Texture::blitMips(VkCommandBuffer commandBuffer) const
+    {
+        // Every level is filtered from the one above it, which moves to SHADER_READ_ONLY once it has been read
+        for (uint32_t level = 1; level < m_MipLevels; level++)
+        {
+            ImageUtils::transitionImageLayout(*m_Device, commandBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                              VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT,
+                                              level - 1, 1);
+
+            auto source = getLevelExtent(m_Extent, level - 1);
+            auto destination = getLevelExtent(m_Extent, level);
+            VkImageBlit blit = {
+                .srcSubresource = {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .mipLevel = level - 1,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1,
+                },
+                .srcOffsets = {
+                    {0, 0, 0}, {static_cast<int32_t>(source.width), static_cast<int32_t>(source.height), 1}
+                },
+                .dstSubresource = {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .mipLevel = level,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1,
+                },
+                .dstOffsets = {
+                    {0, 0, 0}, {static_cast<int32_t>(destination.width), static_cast<int32_t>(destination.height), 1}
+                },
+            };
+            m_Device->getDispatch().vkCmdBlitImage(commandBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                                   m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit,
+                                                   VK_FILTER_LINEAR);
+
+            ImageUtils::transitionImageLayout(*m_Device, commandBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                              VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT,
+                                              level - 1, 1);
+        }
+
+        ImageUtils::transitionImageLayout(*m_Device, commandBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT,
+                                          m_MipLevels - 1, 1);
+    }
+
+    void Texture::downsampleMips(VkCommandBuffer commandBuffer, const ComputePipeline& downsampler,
+                                 DescriptorSetCache& descriptorSets, std::vector<VkImageView>& levelViews) const
+    {
+        // Level i is read through a sampled view while level i + 1 is written through a storage view
+        VkFormat storageFormat = getStorageFormat(m_Format);
+        VkImageUsageFlags storageViewUsage = m_SampledViewUsage != 0 ? VK_IMAGE_USAGE_STORAGE_BIT : 0;
+        VkImageUsageFlags sampledViewUsage = m_SampledViewUsage != 0 ? VK_IMAGE_USAGE_SAMPLED_BIT : 0;
+        VkSampler sampler = m_Device->getSamplerCache().getSampler(SamplerDescription::nearestClamp());
+
+        ImageUtils::transitionImageLayout(*m_Device, commandBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, 0, 1);
+        ImageUtils::transitionImageLayout(*m_Device, commandBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                          VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_ASPECT_COLOR_BIT, 1);
+
+        // Texels are averaged in linear space, the UNORM alias of an sRGB image has to be encoded by the shader
+        MipDownsampleConstants constants = {.encodeSrgb = storageFormat != m_Format};
+        for (uint32_t level = 1; level < m_MipLevels; level++)
+        {
+            VkImageView source = levelViews.emplace_back(createView(m_Format, level - 1, 1, sampledViewUsage));
+            VkImageView destination = levelViews.emplace_back(createView(storageFormat, level, 1, storageViewUsage));
+
+            auto set = descriptorSets.get(downsampler.getDescriptorSetLayout(), {
+                DescriptorWrite::image(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, source, sampler),
+                DescriptorWrite::storageImage(1, destination),
+            });
+            downsampler.bind(commandBuffer, set);
+            downsampler.pushConstants(commandBuffer, constants);
+
+            auto extent = getLevelExtent(m_Extent, level);
+            downsampler.dispatch(commandBuffer, ComputePipeline::getGroupCount(extent.width, DOWNSAMPLE_GROUP_SIZE),
+                                 ComputePipeline::getGroupCount(extent.height, DOWNSAMPLE_GROUP_SIZE));
+
+            // Also makes the writes visible to the next level's reads
+            ImageUtils::transitionImageLayout(*m_Device, commandBuffer, m_Image, VK_IMAGE_LAYOUT_GENERAL,
+                                              VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT,
+                                              level, 1);
+        }
+    }
+} // Corvus
@@ -0,0 +1,116 @@
+#ifndef ENGINE_TEXTURE_H
+#define ENGINE_TEXTURE_H
+
+#include <memory>
+#include <span>
+#include <string>
+
+#include "ComputePipeline.h"
+#include "DescriptorSetCache.h"
+#include "Device.h"
+#include "PushConstants.h"
+#include "SamplerCache.h"
+#include "TextureFormat.h"
+
+namespace Corvus
+{
+    using TextureHandle = uint32_t;
+
+    struct TextureSettings
+    {
+        VkFormat format = VK_FORMAT_R8G8B8A8_SRGB; // Colour data, normal maps and masks want a UNORM format
+        bool generateMips = true;
+        SamplerDescription sampler;
+    };
+
+    // Must match the push constant block of Shaders/mipDownsample.glsl
+    struct MipDownsampleConstants
+    {
+        uint32_t encodeSrgb;
+    };
+    static_assert(PushConstantData<MipDownsampleConstants>);
+
+    // Sampled 2D image in device local, optimal tiling memory. The top level is uploaded through a staging buffer
+    // and the rest of the mip chain is filtered down on the GPU, with vkCmdBlitImage where the format supports
+    // linear blits and otherwise with the compute downsampler. Block compressed images come with their whole
+    // mip chain and are copied as they are. The sampler is shared through the SamplerCache.
+    class Texture
+    {
+    public:
+        static constexpr uint32_t DOWNSAMPLE_GROUP_SIZE = 8;
+
+        // Pixels are the tightly packed top level in the settings' format. The downsampler is only used for
+        // formats vkCmdBlitImage cannot filter, see requiresDownsampler.
+        Texture(std::shared_ptr<Device> device, std::span<const std::byte> pixels, VkExtent2D extent,
+                const TextureSettings& settings = {}, const ComputePipeline* downsampler = nullptr);
+        // Every level of the image is uploaded, none are generated
+        Texture(std::shared_ptr<Device> device, const TextureImage& image, const SamplerDescription& sampler = {});
+        // Leaves the levels undefined, they are filled by copies recorded with recordCopy
+        Texture(std::shared_ptr<Device> device, VkFormat format, VkExtent2D extent, uint32_t mipLevels,
+                const SamplerDescription& sampler = {});
+        ~Texture();
+
+        Texture(const Texture&) = delete;
+        Texture& operator=(const Texture&) = delete;
+
+        // KTX2 files keep their format and mip chain and only use the settings' sampler. Anything else is
+        // decoded with stb_image to 8 bit RGBA, the settings' format has to match that.
+        static std::unique_ptr<Texture> load(std::shared_ptr<Device> device, const std::string& path,
+                                             const TextureSettings& settings = {},
+                                             const ComputePipeline* downsampler = nullptr);
+
+        [[nodiscard]] VkImage getImage() const { return m_Image; }
+        [[nodiscard]] VkImageView getImageView() const { return m_ImageView; }
+        [[nodiscard]] VkSampler getSampler() const { return m_Sampler; }
+        [[nodiscard]] VkFormat getFormat() const { return m_Format; }
+        [[nodiscard]] VkExtent2D getExtent() const { return m_Extent; }
+        [[nodiscard]] uint32_t getMipLevels() const { return m_MipLevels; }
+        // Combined image sampler of the whole mip chain in SHADER_READ_ONLY_OPTIMAL
+        [[nodiscard]] DescriptorWrite getDescriptor(uint32_t binding) const
+        {
+            return DescriptorWrite::image(binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_ImageView, m_Sampler);
+        }
+
+        // Copies levels laid out like TextureImage::data from the buffer into the image, starting at its first
+        // level. Those levels have to be in TRANSFER_DST_OPTIMAL.
+        void recordCopy(VkCommandBuffer commandBuffer, VkBuffer buffer, const std::vector<TextureLevel>& levels) const;
+
+        [[nodiscard]] static uint32_t getMipLevelCount(VkExtent2D extent);
+        // Compressed formats also need their family's device feature
+        [[nodiscard]] static bool isFormatSupported(const Device& device, VkFormat format);
+        // Mips of the format can not be blitted, generating them needs a pipeline made with createDownsampler
+        [[nodiscard]] static bool requiresDownsampler(const Device& device, VkFormat format);
+        [[nodiscard]] static std::unique_ptr<ComputePipeline> createDownsampler(std::shared_ptr<Device> device,
+                                                                                const std::string& shader);
+
+    private:
+        enum class MipGeneration { None, Blit, Compute };
+
+        std::shared_ptr<Device> m_Device;
+        VkExtent2D m_Extent;
+        VkFormat m_Format;
+        uint32_t m_MipLevels = 1;
+
+        VkImage m_Image = VK_NULL_HANDLE;
+        VkDeviceMemory m_ImageMemory = VK_NULL_HANDLE;
+        VkImageView m_ImageView = VK_NULL_HANDLE;
+        VkSampler m_Sampler = VK_NULL_HANDLE; // Owned by the device's sampler cache
+        // Views of an sRGB image aliased as UNORM for the downsampler must not inherit its storage usage
+        VkImageUsageFlags m_SampledViewUsage = 0;
+
+    private:
+        [[nodiscard]] MipGeneration selectMipGeneration(const TextureSettings& settings,
+                                                        const ComputePipeline* downsampler) const;
+        void createImage(VkImageUsageFlags usage, VkImageCreateFlags flags, const SamplerDescription& sampler);
+        [[nodiscard]] VkImageView createView(VkFormat format, uint32_t baseMipLevel, uint32_t levelCount,
+                                             VkImageUsageFlags usage) const;
+
+        void upload(std::span<const std::byte> data, const std::vector<TextureLevel>& levels,
+                    MipGeneration mipGeneration, const ComputePipeline* downsampler);
+        void blitMips(VkCommandBuffer commandBuffer) const;
+        void downsampleMips(VkCommandBuffer commandBuffer, const ComputePipeline& downsampler,
+                            DescriptorSetCache& descriptorSets, std::vector<VkImageView>& levelViews) const;
+    };
+} // Corvus
+
+#endif //ENGINE_TEXTURE_H
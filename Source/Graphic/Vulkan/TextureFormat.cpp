@@ -0,0 +1,160 @@
+#include "TextureFormat.h"
+
+#include <algorithm>
+
+namespace Corvus
+{
+    FormatBlock getFormatBlock(VkFormat format)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_R8_UNORM:
+            return {1, 1, 1};
+        case VK_FORMAT_R8G8_UNORM:
+        case VK_FORMAT_R16_SFLOAT:
+            return {1, 1, 2};
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+        case VK_FORMAT_B8G8R8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+        case VK_FORMAT_R16G16_SFLOAT:
+        case VK_FORMAT_R32_SFLOAT:
+            return {1, 1, 4};
+        case VK_FORMAT_R16G16B16A16_SFLOAT:
+            return {1, 1, 8};
+        case VK_FORMAT_R32G32B32A32_SFLOAT:
+            return {1, 1, 16};
+
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+        case VK_FORMAT_BC4_SNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+        case VK_FORMAT_EAC_R11_UNORM_BLOCK:
+        case VK_FORMAT_EAC_R11_SNORM_BLOCK:
+            return {4, 4, 8};
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+        case VK_FORMAT_BC2_SRGB_BLOCK:
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC5_SNORM_BLOCK:
+        case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+        case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+        case VK_FORMAT_EAC_R11G11_UNORM_BLOCK:
+        case VK_FORMAT_EAC_R11G11_SNORM_BLOCK:
+            return {4, 4, 16};
+
+        // Every ASTC block is 16 bytes, only its footprint differs
+        case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
+            return {4, 4, 16};
+        case VK_FORMAT_ASTC_5x4_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_5x4_SRGB_BLOCK:
+            return {5, 4, 16};
+        case VK_FORMAT_ASTC_5x5_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_5x5_SRGB_BLOCK:
+            return {5, 5, 16};
+        case VK_FORMAT_ASTC_6x5_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_6x5_SRGB_BLOCK:
+            return {6, 5, 16};
+        case VK_FORMAT_ASTC_6x6_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_6x6_SRGB_BLOCK:
+            return {6, 6, 16};
+        case VK_FORMAT_ASTC_8x5_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_8x5_SRGB_BLOCK:
+            return {8, 5, 16};
+        case VK_FORMAT_ASTC_8x6_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_8x6_SRGB_BLOCK:
+            return {8, 6, 16};
+        case VK_FORMAT_ASTC_8x8_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_8x8_SRGB_BLOCK:
+            return {8, 8, 16};
+        case VK_FORMAT_ASTC_10x5_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_10x5_SRGB_BLOCK:
+            return {10, 5, 16};
+        case VK_FORMAT_ASTC_10x6_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_10x6_SRGB_BLOCK:
+            return {10, 6, 16};
+        case VK_FORMAT_ASTC_10x8_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_10x8_SRGB_BLOCK:
+            return {10, 8, 16};
+        case VK_FORMAT_ASTC_10x10_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_10x10_SRGB_BLOCK:
+            return {10, 10, 16};
+        case VK_FORMAT_ASTC_12x10_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_12x10_SRGB_BLOCK:
+            return {12, 10, 16};
+        case VK_FORMAT_ASTC_12x12_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_12x12_SRGB_BLOCK:
+            return {12, 12, 16};
+        default:
+            return {};
+        }
+    }
+
+    CompressionFamily getCompressionFamily(VkFormat format)
+    {
+        if (format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK and format <= VK_FORMAT_BC7_SRGB_BLOCK)
+            return CompressionFamily::BC;
+        if (format >= VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK and format <= VK_FORMAT_EAC_R11G11_SNORM_BLOCK)
+            return CompressionFamily::ETC2;
+        if (format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK and format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK)
+            return CompressionFamily::ASTC;
+        return CompressionFamily::None;
+    }
+
+    bool isSrgbFormat(VkFormat format)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_R8G8B8A8_SRGB:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC2_SRGB_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+            return true;
+        default:
+            // The ASTC enumerants alternate between UNORM and SRGB
+            return getCompressionFamily(format) == CompressionFamily::ASTC and
+                   (format - VK_FORMAT_ASTC_4x4_UNORM_BLOCK) % 2 == 1;
+        }
+    }
+
+    VkDeviceSize getLevelSize(VkFormat format, VkExtent2D extent)
+    {
+        auto block = getFormatBlock(format);
+        VkDeviceSize columns = (extent.width + block.width - 1) / block.width;
+        VkDeviceSize rows = (extent.height + block.height - 1) / block.height;
+        return columns * rows * block.size;
+    }
+
+    VkExtent2D getLevelExtent(VkExtent2D extent, uint32_t level)
+    {
+        return {std::max(1u, extent.width >> level), std::max(1u, extent.height >> level)};
+    }
+
+    std::byte* TextureImage::addLevel(VkDeviceSize size)
+    {
+        // 16 is a multiple of every block size and of the 4 bytes buffer to image copies need
+        constexpr VkDeviceSize alignment = 16;
+        VkDeviceSize offset = (data.size() + alignment - 1) / alignment * alignment;
+        data.resize(offset + size);
+        levels.push_back({offset, size});
+        return data.data() + offset;
+    }
+} // Corvus
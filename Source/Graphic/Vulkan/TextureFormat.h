@@ -0,0 +1,47 @@
+#ifndef ENGINE_TEXTUREFORMAT_H
+#define ENGINE_TEXTUREFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+namespace Corvus
+{
+    // Smallest addressable unit of a format, a single texel for uncompressed formats
+    struct FormatBlock
+    {
+        uint32_t width = 1;
+        uint32_t height = 1;
+        uint32_t size = 0; // Bytes, 0 for formats textures do not support
+    };
+
+    enum class CompressionFamily { None, BC, ETC2, ASTC };
+
+    [[nodiscard]] FormatBlock getFormatBlock(VkFormat format);
+    [[nodiscard]] CompressionFamily getCompressionFamily(VkFormat format);
+    [[nodiscard]] bool isSrgbFormat(VkFormat format);
+    // Bytes of one tightly packed mip level, partial blocks at the edges are stored whole
+    [[nodiscard]] VkDeviceSize getLevelSize(VkFormat format, VkExtent2D extent);
+    [[nodiscard]] VkExtent2D getLevelExtent(VkExtent2D extent, uint32_t level);
+
+    struct TextureLevel
+    {
+        VkDeviceSize offset; // Into TextureImage::data, a multiple of the format's block size
+        VkDeviceSize size;
+    };
+
+    // Texel data of a mip chain, level 0 first, laid out so it can be copied into an image as it is
+    struct TextureImage
+    {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkExtent2D extent = {0, 0};
+        std::vector<TextureLevel> levels;
+        std::vector<std::byte> data;
+
+        // Appends a level after the previous ones, aligned for the copy
+        std::byte* addLevel(VkDeviceSize size);
+    };
+} // Corvus
+
+#endif //ENGINE_TEXTUREFORMAT_H
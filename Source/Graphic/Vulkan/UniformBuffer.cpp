@@ -14,8 +14,7 @@ namespace Corvus {
         constexpr VkDeviceSize bufferSize = sizeof(UniformBufferObject);
 
         BufferUtils::createBuffer(
-            m_Device->getDevice(),
-            m_Device->getPhysicalDevice(),
+            *m_Device,
             bufferSize,
             VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
@@ -23,12 +22,14 @@ namespace Corvus {
             m_UniformBufferMemory
         );
 
-        vkMapMemory(m_Device->getDevice(), m_UniformBufferMemory, 0, bufferSize, 0, &m_MappedData);
+        m_Device->getDispatch().vkMapMemory(m_Device->getDevice(), m_UniformBufferMemory, 0, bufferSize, 0,
+                                            &m_MappedData);
     }
 
     UniformBuffer::~UniformBuffer()
     {
-        vkDestroyBuffer(m_Device->getDevice(), m_UniformBuffer, nullptr);
-        vkFreeMemory(m_Device->getDevice(), m_UniformBufferMemory, nullptr);
+        const auto& vk = m_Device->getDispatch();
+        vk.vkDestroyBuffer(m_Device->getDevice(), m_UniformBuffer, nullptr);
+        vk.vkFreeMemory(m_Device->getDevice(), m_UniformBufferMemory, nullptr);
     }
 } // Corvus
\ No newline at end of file
@@ -17,7 +17,6 @@ namespace Corvus
 {
     struct UniformBufferObject
     {
-        glm::mat4 model = {0.0f};
         glm::mat4 view = {0.0f};
         glm::mat4 projection = {0.0f};
     };
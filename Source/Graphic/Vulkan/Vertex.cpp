@@ -4,39 +4,79 @@
 
 #include "Vertex.h"
 
-#include <array>
+#include <span>
 
 namespace Corvus
 {
-    VkVertexInputBindingDescription Vertex::getBindingDescription()
+    namespace
     {
-        VkVertexInputBindingDescription bindingDescription{
-                .binding = 0,
-                .stride = sizeof(Vertex),
-                .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
-        };
+        template<VertexType T, typename Convert>
+        std::vector<std::byte> encode(const std::vector<Vertex>& vertices, Convert convert)
+        {
+            std::vector<T> encoded;
+            encoded.reserve(vertices.size());
+            for (const auto& vertex: vertices)
+                encoded.push_back(convert(vertex));
 
-        return bindingDescription;
+            auto bytes = std::as_bytes(std::span(encoded));
+            return {bytes.begin(), bytes.end()};
+        }
     }
 
-    std::array<VkVertexInputAttributeDescription, 2> Vertex::getAttributeDescriptions()
+    std::vector<std::byte> encodeVertices(const std::vector<Vertex>& vertices, VertexEncoding encoding)
     {
-        std::array<VkVertexInputAttributeDescription, 2> attributeDescriptions{};
-
-        attributeDescriptions[0] = {
-                .location = 0,
-                .binding = 0,
-                .format = VK_FORMAT_R32G32B32_SFLOAT,
-                .offset = offsetof(Vertex, position)
-        };
-
-        attributeDescriptions[1] = {
-                .location = 1,
-                .binding = 0,
-                .format = VK_FORMAT_R32G32B32_SFLOAT,
-                .offset = offsetof(Vertex, color)
-        };
-
-        return attributeDescriptions;
+        if (encoding == VertexEncoding::Full)
+        {
+            auto bytes = std::as_bytes(std::span(vertices));
+            return {bytes.begin(), bytes.end()};
+        }
+
+        return encode<PackedVertex>(vertices, [](const Vertex& vertex)
+        {
+            return PackedVertex{PackedHalf4(vertex.position), PackedUnorm8x4(vertex.color)};
+        });
+    }
+
+    std::vector<std::byte> encodePositions(const std::vector<Vertex>& vertices, VertexEncoding encoding)
+    {
+        if (encoding == VertexEncoding::Full)
+            return encode<VertexPosition>(vertices, [](const Vertex& vertex)
+            {
+                return VertexPosition{vertex.position};
+            });
+
+        return encode<PackedVertexPosition>(vertices, [](const Vertex& vertex)
+        {
+            return PackedVertexPosition{PackedHalf4(vertex.position)};
+        });
+    }
+
+    std::vector<std::byte> encodeAttributes(const std::vector<Vertex>& vertices, VertexEncoding encoding)
+    {
+        if (encoding == VertexEncoding::Full)
+            return encode<VertexAttributes>(vertices, [](const Vertex& vertex)
+            {
+                return VertexAttributes{vertex.color};
+            });
+
+        return encode<PackedVertexAttributes>(vertices, [](const Vertex& vertex)
+        {
+            return PackedVertexAttributes{PackedUnorm8x4(vertex.color)};
+        });
+    }
+
+    VertexInputDescription describeVertexInput(const VertexFormat& format)
+    {
+        bool packed = format.encoding == VertexEncoding::Packed;
+        if (format.splitPositions)
+            return packed ? describeVertexInput<PackedVertexPosition, PackedVertexAttributes>()
+                          : describeVertexInput<VertexPosition, VertexAttributes>();
+        return packed ? describeVertexInput<PackedVertex>() : describeVertexInput<Vertex>();
+    }
+
+    VertexInputDescription describePositionInput(VertexEncoding encoding)
+    {
+        return encoding == VertexEncoding::Packed ? describeVertexInput<PackedVertexPosition>()
+                                                  : describeVertexInput<VertexPosition>();
     }
-} // Corvus
\ No newline at end of file
+} // Corvus
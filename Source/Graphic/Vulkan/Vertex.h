@@ -5,9 +5,14 @@
 #ifndef ENGINE_VERTEX_H
 #define ENGINE_VERTEX_H
 
+#include <cstddef>
+#include <vector>
+
 #include <vulkan/vulkan_core.h>
 #include "glm/vec3.hpp"
 
+#include "VertexLayout.h"
+
 namespace Corvus
 {
 
@@ -15,11 +20,71 @@ namespace Corvus
     {
         glm::vec3 position;
         glm::vec3 color;
+    };
+
+    CORVUS_VERTEX_LAYOUT(Vertex,
+        CORVUS_VERTEX_ATTRIBUTE(Vertex, position),
+        CORVUS_VERTEX_ATTRIBUTE(Vertex, color)
+    );
+
+    // Vertex as uploaded with VertexEncoding::Packed, 12 instead of 24 bytes. Half precision keeps about three
+    // significant digits, enough for meshes modelled around their origin at the usual scales.
+    struct PackedVertex
+    {
+        PackedHalf4 position;
+        PackedUnorm8x4 color;
+    };
+
+    CORVUS_VERTEX_LAYOUT(PackedVertex,
+        CORVUS_VERTEX_ATTRIBUTE(PackedVertex, position),
+        CORVUS_VERTEX_ATTRIBUTE(PackedVertex, color)
+    );
+    static_assert(sizeof(PackedVertex) == 12, "PackedVertex must not contain padding");
+
+    // Streams of a split vertex, positions get a tightly packed buffer of their own so depth only passes fetch
+    // nothing else. Locations continue across the streams, so the shaders see the same inputs as with Vertex.
+    struct VertexPosition
+    {
+        glm::vec3 position;
+    };
+    CORVUS_VERTEX_LAYOUT(VertexPosition, CORVUS_VERTEX_ATTRIBUTE(VertexPosition, position));
+
+    struct VertexAttributes
+    {
+        glm::vec3 color;
+    };
+    CORVUS_VERTEX_LAYOUT(VertexAttributes, CORVUS_VERTEX_ATTRIBUTE(VertexAttributes, color));
 
-    public:
-        static VkVertexInputBindingDescription getBindingDescription();
-        static std::array<VkVertexInputAttributeDescription, 2> getAttributeDescriptions();
+    struct PackedVertexPosition
+    {
+        PackedHalf4 position;
+    };
+    CORVUS_VERTEX_LAYOUT(PackedVertexPosition, CORVUS_VERTEX_ATTRIBUTE(PackedVertexPosition, position));
+
+    struct PackedVertexAttributes
+    {
+        PackedUnorm8x4 color;
     };
+    CORVUS_VERTEX_LAYOUT(PackedVertexAttributes, CORVUS_VERTEX_ATTRIBUTE(PackedVertexAttributes, color));
+
+    enum class VertexEncoding { Full, Packed };
+
+    // How meshes store their vertices on the GPU, every combination feeds the same shader inputs
+    struct VertexFormat
+    {
+        VertexEncoding encoding = VertexEncoding::Full;
+        // Positions at binding 0 and the remaining attributes at binding 1 instead of one interleaved binding
+        bool splitPositions = false;
+    };
+
+    // Upload data in the given encoding, either interleaved or one of the two split streams
+    [[nodiscard]] std::vector<std::byte> encodeVertices(const std::vector<Vertex>& vertices, VertexEncoding encoding);
+    [[nodiscard]] std::vector<std::byte> encodePositions(const std::vector<Vertex>& vertices, VertexEncoding encoding);
+    [[nodiscard]] std::vector<std::byte> encodeAttributes(const std::vector<Vertex>& vertices, VertexEncoding encoding);
+
+    [[nodiscard]] VertexInputDescription describeVertexInput(const VertexFormat& format);
+    // Only the position stream, for depth only pipelines drawing split meshes
+    [[nodiscard]] VertexInputDescription describePositionInput(VertexEncoding encoding);
 
 } // Corvus
 
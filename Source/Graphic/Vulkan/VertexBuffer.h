@@ -5,7 +5,9 @@
 #ifndef ENGINE_VERTEXBUFFER_H
 #define ENGINE_VERTEXBUFFER_H
 
+#include <cstddef>
 #include <memory>
+#include <span>
 #include <vulkan/vulkan_core.h>
 
 #include "Device.h"
@@ -16,17 +18,21 @@ namespace Corvus
     class VertexBuffer
     {
     public:
-        VertexBuffer(const std::vector<Vertex> &vertices, std::shared_ptr<Device> device);
+        // Raw vertex data, the layout is whatever the pipeline drawing it declares
+        VertexBuffer(std::span<const std::byte> data, std::shared_ptr<Device> device);
+
+        template<VertexType T>
+        VertexBuffer(const std::vector<T>& vertices, std::shared_ptr<Device> device)
+            : VertexBuffer(std::as_bytes(std::span(vertices)), std::move(device)) {}
         ~VertexBuffer();
 
         [[nodiscard]] VkBuffer getVertexBuffer() const { return m_VertexBuffer; }
 
         [[nodiscard]] VkDeviceMemory getVertexBufferMemory() const { return m_VertexBufferMemory; }
-        void bind(VkCommandBuffer commandBuffer) const;
+        void bind(VkCommandBuffer commandBuffer, uint32_t binding = 0) const;
 
     private:
         std::shared_ptr<Device> m_Device;
-        std::vector<Vertex> m_Vertices;
 
         VkDeviceSize m_BufferSize;
 
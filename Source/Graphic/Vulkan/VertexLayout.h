@@ -0,0 +1,189 @@
+#ifndef ENGINE_VERTEXLAYOUT_H
+#define ENGINE_VERTEXLAYOUT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+namespace Corvus
+{
+    // Packed attribute types. Each one is stored in the format VertexFormatOf reports for it and decoded by the
+    // input assembler, only the octahedral normal needs decoding in the shader (Shaders/Include/VertexPacking.glslh).
+
+    // Half precision position, w is padding since three component 16 bit formats are rarely supported
+    struct PackedHalf4
+    {
+        uint16_t x = 0, y = 0, z = 0, w = 0;
+
+        PackedHalf4() = default;
+        explicit PackedHalf4(const glm::vec4& value)
+            : x(glm::packHalf1x16(value.x)), y(glm::packHalf1x16(value.y)),
+              z(glm::packHalf1x16(value.z)), w(glm::packHalf1x16(value.w)) {}
+        explicit PackedHalf4(const glm::vec3& value) : PackedHalf4(glm::vec4(value, 1.0f)) {}
+    };
+
+    struct PackedHalf2
+    {
+        uint32_t value = 0;
+
+        PackedHalf2() = default;
+        explicit PackedHalf2(const glm::vec2& v) : value(glm::packHalf2x16(v)) {}
+    };
+
+    // Texture coordinates in [0, 1], 1/65535 steps are finer than any texel up to 16k textures
+    struct PackedUnorm16x2
+    {
+        uint32_t value = 0;
+
+        PackedUnorm16x2() = default;
+        explicit PackedUnorm16x2(const glm::vec2& v) : value(glm::packUnorm2x16(glm::clamp(v, 0.0f, 1.0f))) {}
+    };
+
+    // Colors
+    struct PackedUnorm8x4
+    {
+        uint32_t value = 0;
+
+        PackedUnorm8x4() = default;
+        explicit PackedUnorm8x4(const glm::vec4& v) : value(glm::packUnorm4x8(v)) {}
+        explicit PackedUnorm8x4(const glm::vec3& v) : PackedUnorm8x4(glm::vec4(v, 1.0f)) {}
+    };
+
+    // Tangents and normals where 8 bits per axis suffice, w carries the bitangent sign of a tangent
+    struct PackedSnorm8x4
+    {
+        uint32_t value = 0;
+
+        PackedSnorm8x4() = default;
+        explicit PackedSnorm8x4(const glm::vec4& v) : value(glm::packSnorm4x8(v)) {}
+        explicit PackedSnorm8x4(const glm::vec3& v) : PackedSnorm8x4(glm::vec4(v, 0.0f)) {}
+    };
+
+    // Unit vector folded onto an octahedron and stored as two 16 bit snorms, more precise than snorm8x4 in the
+    // same four bytes
+    struct PackedOctahedral
+    {
+        uint32_t value = 0;
+
+        PackedOctahedral() = default;
+        explicit PackedOctahedral(const glm::vec3& normal)
+        {
+            float length = glm::abs(normal.x) + glm::abs(normal.y) + glm::abs(normal.z);
+            if (length == 0.0f)
+                return;
+
+            glm::vec3 n = normal / length;
+            glm::vec2 folded(n.x, n.y);
+            if (n.z < 0.0f)
+            {
+                glm::vec2 sign(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+                folded = (1.0f - glm::abs(glm::vec2(n.y, n.x))) * sign;
+            }
+            value = glm::packSnorm2x16(folded);
+        }
+    };
+
+    template<typename T>
+    struct VertexFormatOf; // Attribute types without a specialization do not compile
+
+    template<> struct VertexFormatOf<float> { static constexpr VkFormat format = VK_FORMAT_R32_SFLOAT; };
+    template<> struct VertexFormatOf<glm::vec2> { static constexpr VkFormat format = VK_FORMAT_R32G32_SFLOAT; };
+    template<> struct VertexFormatOf<glm::vec3> { static constexpr VkFormat format = VK_FORMAT_R32G32B32_SFLOAT; };
+    template<> struct VertexFormatOf<glm::vec4> { static constexpr VkFormat format = VK_FORMAT_R32G32B32A32_SFLOAT; };
+    template<> struct VertexFormatOf<uint32_t> { static constexpr VkFormat format = VK_FORMAT_R32_UINT; };
+    template<> struct VertexFormatOf<PackedHalf4> { static constexpr VkFormat format = VK_FORMAT_R16G16B16A16_SFLOAT; };
+    template<> struct VertexFormatOf<PackedHalf2> { static constexpr VkFormat format = VK_FORMAT_R16G16_SFLOAT; };
+    template<> struct VertexFormatOf<PackedUnorm16x2> { static constexpr VkFormat format = VK_FORMAT_R16G16_UNORM; };
+    template<> struct VertexFormatOf<PackedUnorm8x4> { static constexpr VkFormat format = VK_FORMAT_R8G8B8A8_UNORM; };
+    template<> struct VertexFormatOf<PackedSnorm8x4> { static constexpr VkFormat format = VK_FORMAT_R8G8B8A8_SNORM; };
+    template<> struct VertexFormatOf<PackedOctahedral> { static constexpr VkFormat format = VK_FORMAT_R16G16_SNORM; };
+
+    struct VertexAttribute
+    {
+        VkFormat format;
+        uint32_t offset;
+    };
+
+    // Specialized through CORVUS_VERTEX_LAYOUT, attributes are assigned shader locations in declaration order
+    template<typename T>
+    struct VertexLayout;
+
+    template<typename T>
+    concept VertexType = std::is_trivially_copyable_v<T> and requires { VertexLayout<T>::attributes; };
+
+    template<VertexType T>
+    constexpr VkVertexInputBindingDescription getVertexBindingDescription(uint32_t binding = 0)
+    {
+        return {
+            .binding = binding,
+            .stride = sizeof(T),
+            .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
+        };
+    }
+
+    template<VertexType T>
+    constexpr auto getVertexAttributeDescriptions(uint32_t binding = 0, uint32_t firstLocation = 0)
+    {
+        constexpr auto& attributes = VertexLayout<T>::attributes;
+        std::array<VkVertexInputAttributeDescription, attributes.size()> descriptions{};
+        for (uint32_t i = 0; i < attributes.size(); i++)
+            descriptions[i] = {
+                .location = firstLocation + i,
+                .binding = binding,
+                .format = attributes[i].format,
+                .offset = attributes[i].offset
+            };
+        return descriptions;
+    }
+
+    // Type erased form for code choosing the vertex type at runtime, such as the pipeline
+    struct VertexInputDescription
+    {
+        std::vector<VkVertexInputBindingDescription> bindings;
+        std::vector<VkVertexInputAttributeDescription> attributes;
+    };
+
+    // One binding per stream in order, locations continue across the streams
+    template<VertexType... Streams>
+    VertexInputDescription describeVertexInput()
+    {
+        VertexInputDescription description;
+        uint32_t location = 0;
+        ([&]
+        {
+            auto binding = static_cast<uint32_t>(description.bindings.size());
+            auto attributes = getVertexAttributeDescriptions<Streams>(binding, location);
+            description.bindings.push_back(getVertexBindingDescription<Streams>(binding));
+            description.attributes.insert(description.attributes.end(), attributes.begin(), attributes.end());
+            location += static_cast<uint32_t>(attributes.size());
+        }(), ...);
+        return description;
+    }
+} // Corvus
+
+// Declares a member as a vertex attribute, its format follows from the member's type
+#define CORVUS_VERTEX_ATTRIBUTE(Type, member) \
+    ::Corvus::VertexAttribute{ \
+        ::Corvus::VertexFormatOf<decltype(Type::member)>::format, \
+        static_cast<uint32_t>(offsetof(Type, member)) \
+    }
+
+// Declares the vertex layout of Type, has to be used inside namespace Corvus after Type is complete
+#define CORVUS_VERTEX_LAYOUT(Type, ...) \
+    template<> \
+    struct VertexLayout<Type> \
+    { \
+        static constexpr std::array attributes = {__VA_ARGS__}; \
+    }; \
+    static_assert(VertexLayout<Type>::attributes.size() <= 16, \
+                  #Type " has more attributes than every device supports (maxVertexInputAttributes)")
+
+#endif //ENGINE_VERTEXLAYOUT_H
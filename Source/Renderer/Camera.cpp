@@ -0,0 +1,30 @@
+#include "Camera.h"
+
+#include <cmath>
+
+#include <glm/ext/matrix_transform.hpp>
+
+namespace Corvus
+{
+    glm::mat4 Camera::getView() const
+    {
+        return glm::lookAt(position, target, up);
+    }
+
+    glm::mat4 Camera::getProjection(float aspectRatio) const
+    {
+        float focalLength = 1.0f / std::tan(fieldOfView * 0.5f);
+
+        glm::mat4 projection(0.0f);
+        projection[0][0] = focalLength / aspectRatio;
+        projection[1][1] = -focalLength; // Vulkan's clip space y points down
+        projection[2][3] = -1.0f;
+        projection[3][2] = nearPlane;
+        return projection;
+    }
+
+    float Camera::getViewDepth(const glm::vec3& point) const
+    {
+        return glm::dot(point - position, glm::normalize(target - position));
+    }
+} // Corvus
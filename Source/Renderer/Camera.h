@@ -0,0 +1,28 @@
+#ifndef ENGINE_CAMERA_H
+#define ENGINE_CAMERA_H
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace Corvus
+{
+    struct Camera
+    {
+        glm::vec3 position = glm::vec3(2.0f, 2.0f, 2.0f);
+        glm::vec3 target = glm::vec3(0.0f);
+        glm::vec3 up = glm::vec3(0.0f, 0.0f, 1.0f);
+        float fieldOfView = glm::radians(45.0f);
+        float nearPlane = 0.1f;
+
+        [[nodiscard]] glm::mat4 getView() const;
+
+        // Reverse-Z with an infinite far plane, depth is 1 at the near plane and approaches 0 at infinity.
+        // Together with a float depth buffer the precision stays nearly constant over the whole range.
+        [[nodiscard]] glm::mat4 getProjection(float aspectRatio) const;
+
+        // Distance along the view direction, used to order draws
+        [[nodiscard]] float getViewDepth(const glm::vec3& point) const;
+    };
+} // Corvus
+
+#endif //ENGINE_CAMERA_H
@@ -0,0 +1,299 @@
+#include "ComputePrimitives.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace Corvus
+{
+    namespace
+    {
+        uint32_t getRadixPassCount(uint32_t keyBits)
+        {
+            return (keyBits + ComputePrimitives::RADIX_BITS - 1) / ComputePrimitives::RADIX_BITS;
+        }
+
+        // Mask of the bits the radix passes for keyBits actually look at
+        template<typename Key>
+        Key getSortedBitMask(uint32_t keyBits)
+        {
+            uint32_t bits = getRadixPassCount(keyBits) * ComputePrimitives::RADIX_BITS;
+            return bits >= sizeof(Key) * 8 ? ~Key(0) : (Key(1) << bits) - 1;
+        }
+
+        template<typename Key>
+        void sortByMaskedKey(std::span<Key> keys, std::optional<std::span<uint32_t>> values, uint32_t keyBits)
+        {
+            CORVUS_ASSERT(not values or values->size() == keys.size(), "Sort keys and values differ in length!")
+            Key mask = getSortedBitMask<Key>(keyBits);
+
+            std::vector<uint32_t> order(keys.size());
+            std::iota(order.begin(), order.end(), 0u);
+            std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+            {
+                return (keys[a] & mask) < (keys[b] & mask);
+            });
+
+            std::vector<Key> sortedKeys(keys.size());
+            for (size_t i = 0; i < order.size(); i++)
+                sortedKeys[i] = keys[order[i]];
+            std::ranges::copy(sortedKeys, keys.begin());
+
+            if (not values)
+                return;
+            std::vector<uint32_t> sortedValues(values->size());
+            for (size_t i = 0; i < order.size(); i++)
+                sortedValues[i] = (*values)[order[i]];
+            std::ranges::copy(sortedValues, values->begin());
+        }
+    }
+
+    ComputePrimitives::ComputePrimitives(std::shared_ptr<Device> device, uint32_t capacity,
+                                         const ComputePrimitiveShaders& shaders)
+        : m_Device(std::move(device)),
+          m_Capacity(capacity),
+          m_ScanPipeline(m_Device, shaders.scan, std::vector<VkDescriptorType>(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+                         sizeof(ScanConstants), "Prefix Scan"),
+          m_CompactPipeline(m_Device, shaders.compactScatter,
+                            std::vector<VkDescriptorType>(5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+                            sizeof(CompactConstants), "Compact Scatter"),
+          m_RadixHistogramPipeline(m_Device, shaders.radixHistogram,
+                                   std::vector<VkDescriptorType>(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+                                   sizeof(RadixSortConstants), "Radix Histogram"),
+          m_RadixScatterPipeline(m_Device, shaders.radixScatter,
+                                 std::vector<VkDescriptorType>(5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+                                 sizeof(RadixSortConstants), "Radix Scatter"),
+          m_HistogramPipeline(m_Device, shaders.histogram,
+                              std::vector<VkDescriptorType>(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+                              sizeof(HistogramConstants), "Histogram")
+    {
+        CORVUS_ASSERT(capacity > 0, "Compute primitives need a capacity of at least one element!")
+
+        // The radix sort scans its digit table, which for few elements is longer than the elements themselves
+        uint32_t digitCount = RADIX_DIGITS * ComputePipeline::getGroupCount(capacity, RADIX_TILE_SIZE);
+        uint32_t scanTiles = ComputePipeline::getGroupCount(std::max(capacity, digitCount), SCAN_TILE_SIZE);
+        constexpr VkBufferUsageFlags transferUsage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT bitor
+                                                     VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        constexpr auto access = StorageBuffer::Access::DeviceOnly;
+
+        m_ScanCapacity = scanTiles * SCAN_TILE_SIZE;
+        m_TileStates = std::make_unique<StorageBuffer>(m_Device, (1 + scanTiles) * sizeof(uint32_t), access,
+                                                       transferUsage);
+        m_Offsets = std::make_unique<StorageBuffer>(m_Device, capacity * sizeof(uint32_t), access);
+        m_DigitCounts = std::make_unique<StorageBuffer>(m_Device, digitCount * sizeof(uint32_t), access);
+        m_DigitOffsets = std::make_unique<StorageBuffer>(m_Device, digitCount * sizeof(uint32_t), access);
+        m_ScratchKeys = std::make_unique<StorageBuffer>(m_Device, capacity * sizeof(uint64_t), access, transferUsage);
+        m_ScratchValues = std::make_unique<StorageBuffer>(m_Device, capacity * sizeof(uint32_t), access,
+                                                          transferUsage);
+    }
+
+    void ComputePrimitives::exclusiveScan(VkCommandBuffer commandBuffer, DescriptorSetCache& descriptorSets,
+                                          const StorageBuffer& input, const StorageBuffer& output, uint32_t count)
+    {
+        CORVUS_ASSERT(count <= m_ScanCapacity, "Scan of {} elements exceeds the capacity of {}!", count,
+                      m_ScanCapacity)
+        if (count == 0)
+            return;
+
+        // Tiles find their predecessors' sums through the states, so they have to start out unpublished
+        computeToTransferBarrier(commandBuffer);
+        m_Device->getDispatch().vkCmdFillBuffer(commandBuffer, m_TileStates->getBuffer(), 0, VK_WHOLE_SIZE, 0);
+        transferToComputeBarrier(commandBuffer);
+
+        auto set = descriptorSets.get(m_ScanPipeline.getDescriptorSetLayout(), {
+            DescriptorWrite::storageBuffer(0, input.getBuffer()),
+            DescriptorWrite::storageBuffer(1, output.getBuffer()),
+            DescriptorWrite::storageBuffer(2, m_TileStates->getBuffer()),
+        });
+
+        m_ScanPipeline.bind(commandBuffer, set);
+        m_ScanPipeline.pushConstants(commandBuffer, ScanConstants{.count = count});
+        m_ScanPipeline.dispatch(commandBuffer, ComputePipeline::getGroupCount(count, SCAN_TILE_SIZE));
+    }
+
+    void ComputePrimitives::compact(VkCommandBuffer commandBuffer, DescriptorSetCache& descriptorSets,
+                                    const StorageBuffer& values, const StorageBuffer& flags,
+                                    const StorageBuffer& output, const StorageBuffer& countBuffer, uint32_t count)
+    {
+        CORVUS_ASSERT(count <= m_Capacity, "Compaction of {} elements exceeds the capacity of {}!", count,
+                      m_Capacity)
+        if (count == 0)
+        {
+            // Nothing would write the count otherwise
+            m_Device->getDispatch().vkCmdFillBuffer(commandBuffer, countBuffer.getBuffer(), 0, sizeof(uint32_t), 0);
+            return;
+        }
+
+        exclusiveScan(commandBuffer, descriptorSets, flags, *m_Offsets, count);
+        computeBarrier(commandBuffer);
+
+        auto set = descriptorSets.get(m_CompactPipeline.getDescriptorSetLayout(), {
+            DescriptorWrite::storageBuffer(0, values.getBuffer()),
+            DescriptorWrite::storageBuffer(1, flags.getBuffer()),
+            DescriptorWrite::storageBuffer(2, m_Offsets->getBuffer()),
+            DescriptorWrite::storageBuffer(3, output.getBuffer()),
+            DescriptorWrite::storageBuffer(4, countBuffer.getBuffer()),
+        });
+
+        m_CompactPipeline.bind(commandBuffer, set);
+        m_CompactPipeline.pushConstants(commandBuffer, CompactConstants{.count = count});
+        m_CompactPipeline.dispatch(commandBuffer, ComputePipeline::getGroupCount(count, 256));
+    }
+
+    void ComputePrimitives::sortKeyValues(VkCommandBuffer commandBuffer, DescriptorSetCache& descriptorSets,
+                                          const StorageBuffer& keys, const StorageBuffer* values, uint32_t count,
+                                          KeyWidth keyWidth, uint32_t keyBits)
+    {
+        CORVUS_ASSERT(count <= m_Capacity, "Sort of {} elements exceeds the capacity of {}!", count, m_Capacity)
+        auto keyWords = static_cast<uint32_t>(keyWidth);
+        if (keyBits == 0)
+            keyBits = keyWords * 32;
+        CORVUS_ASSERT(keyBits <= keyWords * 32, "Cannot sort {} bits of {} bit keys!", keyBits, keyWords * 32)
+        if (count <= 1)
+            return;
+
+        uint32_t tileCount = ComputePipeline::getGroupCount(count, RADIX_TILE_SIZE);
+        uint32_t digitCount = RADIX_DIGITS * tileCount;
+        uint32_t passCount = getRadixPassCount(keyBits);
+
+        // Without values the scatter still needs something bound, it never touches it
+        VkBuffer valueBuffers[2] = {values ? values->getBuffer() : m_ScratchValues->getBuffer(),
+                                    m_ScratchValues->getBuffer()};
+        VkBuffer keyBuffers[2] = {keys.getBuffer(), m_ScratchKeys->getBuffer()};
+
+        for (uint32_t pass = 0; pass < passCount; pass++)
+        {
+            uint32_t source = pass % 2;
+            uint32_t destination = 1 - source;
+            RadixSortConstants constants = {
+                .count = count,
+                .tileCount = tileCount,
+                .keyWords = keyWords,
+                .shift = pass * RADIX_BITS,
+                .hasValues = values ? 1u : 0u,
+            };
+
+            auto histogramSet = descriptorSets.get(m_RadixHistogramPipeline.getDescriptorSetLayout(), {
+                DescriptorWrite::storageBuffer(0, keyBuffers[source]),
+                DescriptorWrite::storageBuffer(1, m_DigitCounts->getBuffer()),
+            });
+            m_RadixHistogramPipeline.bind(commandBuffer, histogramSet);
+            m_RadixHistogramPipeline.pushConstants(commandBuffer, constants);
+            m_RadixHistogramPipeline.dispatch(commandBuffer, tileCount);
+            computeBarrier(commandBuffer);
+
+            exclusiveScan(commandBuffer, descriptorSets, *m_DigitCounts, *m_DigitOffsets, digitCount);
+            computeBarrier(commandBuffer);
+
+            auto scatterSet = descriptorSets.get(m_RadixScatterPipeline.getDescriptorSetLayout(), {
+                DescriptorWrite::storageBuffer(0, keyBuffers[source]),
+                DescriptorWrite::storageBuffer(1, valueBuffers[source]),
+                DescriptorWrite::storageBuffer(2, m_DigitOffsets->getBuffer()),
+                DescriptorWrite::storageBuffer(3, keyBuffers[destination]),
+                DescriptorWrite::storageBuffer(4, valueBuffers[destination]),
+            });
+            m_RadixScatterPipeline.bind(commandBuffer, scatterSet);
+            m_RadixScatterPipeline.pushConstants(commandBuffer, constants);
+            m_RadixScatterPipeline.dispatch(commandBuffer, tileCount);
+            computeBarrier(commandBuffer);
+        }
+
+        if (passCount % 2 == 0)
+            return;
+
+        // An odd number of passes leaves the result in scratch
+        const auto& vk = m_Device->getDispatch();
+        computeToTransferBarrier(commandBuffer);
+        VkBufferCopy keyCopy = {.srcOffset = 0, .dstOffset = 0, .size = count * keyWords * sizeof(uint32_t)};
+        vk.vkCmdCopyBuffer(commandBuffer, m_ScratchKeys->getBuffer(), keys.getBuffer(), 1, &keyCopy);
+        if (values)
+        {
+            VkBufferCopy valueCopy = {.srcOffset = 0, .dstOffset = 0, .size = count * sizeof(uint32_t)};
+            vk.vkCmdCopyBuffer(commandBuffer, m_ScratchValues->getBuffer(), values->getBuffer(), 1, &valueCopy);
+        }
+    }
+
+    void ComputePrimitives::histogram(VkCommandBuffer commandBuffer, DescriptorSetCache& descriptorSets,
+                                      const StorageBuffer& values, const StorageBuffer& bins, uint32_t count,
+                                      uint32_t binCount, uint32_t shift)
+    {
+        CORVUS_ASSERT(binCount > 0 and binCount * sizeof(uint32_t) <= bins.getSize(),
+                      "Histogram bins have to be between 1 and the bin buffer's size!")
+        CORVUS_ASSERT(shift < 32, "Histogram shift of {} is out of range!", shift)
+
+        computeToTransferBarrier(commandBuffer);
+        m_Device->getDispatch().vkCmdFillBuffer(commandBuffer, bins.getBuffer(), 0, binCount * sizeof(uint32_t), 0);
+        transferToComputeBarrier(commandBuffer);
+
+        auto set = descriptorSets.get(m_HistogramPipeline.getDescriptorSetLayout(), {
+            DescriptorWrite::storageBuffer(0, values.getBuffer()),
+            DescriptorWrite::storageBuffer(1, bins.getBuffer()),
+        });
+
+        HistogramConstants constants = {
+            .count = count,
+            .binCount = binCount,
+            .shift = shift,
+        };
+        m_HistogramPipeline.bind(commandBuffer, set);
+        m_HistogramPipeline.pushConstants(commandBuffer, constants);
+        m_HistogramPipeline.dispatch(commandBuffer, ComputePipeline::getGroupCount(count, HISTOGRAM_ITEMS_PER_GROUP));
+    }
+
+    void ComputePrimitives::computeBarrier(VkCommandBuffer commandBuffer) const
+    {
+        memoryBarrier(*m_Device, commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT bitor VK_ACCESS_SHADER_WRITE_BIT);
+    }
+
+    void ComputePrimitives::transferToComputeBarrier(VkCommandBuffer commandBuffer) const
+    {
+        memoryBarrier(*m_Device, commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT bitor VK_ACCESS_SHADER_WRITE_BIT);
+    }
+
+    void ComputePrimitives::computeToTransferBarrier(VkCommandBuffer commandBuffer) const
+    {
+        memoryBarrier(*m_Device, commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                      VK_ACCESS_SHADER_READ_BIT bitor VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_ACCESS_TRANSFER_READ_BIT bitor VK_ACCESS_TRANSFER_WRITE_BIT);
+    }
+
+    std::vector<uint32_t> referenceExclusiveScan(std::span<const uint32_t> input)
+    {
+        std::vector<uint32_t> output(input.size());
+        std::exclusive_scan(input.begin(), input.end(), output.begin(), 0u);
+        return output;
+    }
+
+    std::vector<uint32_t> referenceCompact(std::span<const uint32_t> values, std::span<const uint32_t> flags)
+    {
+        CORVUS_ASSERT(values.size() == flags.size(), "Compaction values and flags differ in length!")
+        std::vector<uint32_t> output;
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            if (flags[i] != 0)
+                output.push_back(values[i]);
+        }
+        return output;
+    }
+
+    void referenceSortKeyValues(std::span<uint32_t> keys, std::optional<std::span<uint32_t>> values,
+                                uint32_t keyBits)
+    {
+        sortByMaskedKey(keys, values, keyBits);
+    }
+
+    void referenceSortKeyValues(std::span<uint64_t> keys, std::optional<std::span<uint32_t>> values,
+                                uint32_t keyBits)
+    {
+        sortByMaskedKey(keys, values, keyBits);
+    }
+
+    std::vector<uint32_t> referenceHistogram(std::span<const uint32_t> values, uint32_t binCount, uint32_t shift)
+    {
+        std::vector<uint32_t> bins(binCount, 0);
+        for (uint32_t value: values)
+            bins[std::min(value >> shift, binCount - 1)]++;
+        return bins;
+    }
+} // Corvus
@@ -0,0 +1,145 @@
+#ifndef ENGINE_COMPUTEPRIMITIVES_H
+#define ENGINE_COMPUTEPRIMITIVES_H
+
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Graphic/Vulkan/ComputePipeline.h"
+#include "Graphic/Vulkan/DescriptorSetCache.h"
+#include "Graphic/Vulkan/Device.h"
+#include "Graphic/Vulkan/PushConstants.h"
+#include "Graphic/Vulkan/StorageBuffer.h"
+
+namespace Corvus
+{
+    // Must match the push constant block of Shaders/prefixScan.glsl
+    struct ScanConstants
+    {
+        uint32_t count;
+    };
+    static_assert(PushConstantData<ScanConstants>);
+
+    // Must match the push constant block of Shaders/compactScatter.glsl
+    struct CompactConstants
+    {
+        uint32_t count;
+    };
+    static_assert(PushConstantData<CompactConstants>);
+
+    // Must match Shaders/Include/RadixSort.glslh
+    struct RadixSortConstants
+    {
+        uint32_t count;
+        uint32_t tileCount;
+        uint32_t keyWords;
+        uint32_t shift;
+        uint32_t hasValues;
+    };
+    static_assert(PushConstantData<RadixSortConstants>);
+
+    // Must match the push constant block of Shaders/histogram.glsl
+    struct HistogramConstants
+    {
+        uint32_t count;
+        uint32_t binCount;
+        uint32_t shift;
+    };
+    static_assert(PushConstantData<HistogramConstants>);
+
+    struct ComputePrimitiveShaders
+    {
+        std::string scan = "Shaders/prefixScan.glsl.spv";
+        std::string compactScatter = "Shaders/compactScatter.glsl.spv";
+        std::string radixHistogram = "Shaders/radixHistogram.glsl.spv";
+        std::string radixScatter = "Shaders/radixScatter.glsl.spv";
+        std::string histogram = "Shaders/histogram.glsl.spv";
+    };
+
+    // Parallel building blocks for GPU driven passes, all of them work on uint32 elements in storage buffers.
+    // Every call records into the given command buffer and only uses compute and transfer stages, so it is valid
+    // on the async compute queue. Inputs have to be visible to compute shaders when recorded, and results are
+    // shader or transfer writes the caller makes visible to whatever consumes them. The scratch memory is shared
+    // between calls, so calls on different command buffers must not overlap on the GPU.
+    class ComputePrimitives
+    {
+    public:
+        static constexpr uint32_t SCAN_TILE_SIZE = 1024;
+        static constexpr uint32_t RADIX_TILE_SIZE = 256;
+        static constexpr uint32_t RADIX_BITS = 4;
+        static constexpr uint32_t RADIX_DIGITS = 1u << RADIX_BITS;
+        static constexpr uint32_t HISTOGRAM_ITEMS_PER_GROUP = 256 * 8;
+
+        enum class KeyWidth : uint32_t { Bits32 = 1, Bits64 = 2 }; // 64 bit keys are stored as low and high word
+
+        // capacity is the largest element count any call will be given
+        ComputePrimitives(std::shared_ptr<Device> device, uint32_t capacity,
+                          const ComputePrimitiveShaders& shaders = {});
+
+        ComputePrimitives(const ComputePrimitives&) = delete;
+        ComputePrimitives& operator=(const ComputePrimitives&) = delete;
+
+        // output[i] is the sum of input[0..i). Sums have to stay below 2^30, the scan packs a tile's state flag
+        // into the top bits of its running sum.
+        void exclusiveScan(VkCommandBuffer commandBuffer, DescriptorSetCache& descriptorSets,
+                           const StorageBuffer& input, const StorageBuffer& output, uint32_t count);
+
+        // Writes the values whose flag is 1 to the front of output in their original order and the number written
+        // to the first uint32 of countBuffer, flags have to be 0 or 1
+        void compact(VkCommandBuffer commandBuffer, DescriptorSetCache& descriptorSets, const StorageBuffer& values,
+                     const StorageBuffer& flags, const StorageBuffer& output, const StorageBuffer& countBuffer,
+                     uint32_t count);
+
+        // Stable ascending sort of the keys in place, with the optional values moved alongside. Only the lowest
+        // keyBits bits are sorted, 0 sorts the whole key. Buffers need TRANSFER_SRC and TRANSFER_DST usage when
+        // the number of passes (keyBits / 4 rounded up) is odd, the result is then copied back from scratch.
+        void sortKeyValues(VkCommandBuffer commandBuffer, DescriptorSetCache& descriptorSets,
+                           const StorageBuffer& keys, const StorageBuffer* values, uint32_t count,
+                           KeyWidth keyWidth = KeyWidth::Bits32, uint32_t keyBits = 0);
+
+        // Counts the values per bin, a value lands in bin value >> shift or in the last bin if that is out of
+        // range. The bins buffer is cleared first and needs TRANSFER_DST usage.
+        void histogram(VkCommandBuffer commandBuffer, DescriptorSetCache& descriptorSets, const StorageBuffer& values,
+                       const StorageBuffer& bins, uint32_t count, uint32_t binCount, uint32_t shift = 0);
+
+        [[nodiscard]] uint32_t getCapacity() const { return m_Capacity; }
+
+    private:
+        std::shared_ptr<Device> m_Device;
+        uint32_t m_Capacity;
+        uint32_t m_ScanCapacity; // Also covers the radix sort's digit table
+
+        ComputePipeline m_ScanPipeline;
+        ComputePipeline m_CompactPipeline;
+        ComputePipeline m_RadixHistogramPipeline;
+        ComputePipeline m_RadixScatterPipeline;
+        ComputePipeline m_HistogramPipeline;
+
+        std::unique_ptr<StorageBuffer> m_TileStates; // Look-back state of the scan, cleared before every scan
+        std::unique_ptr<StorageBuffer> m_Offsets; // Scanned flags of compact
+        std::unique_ptr<StorageBuffer> m_DigitCounts; // Digit major counts per radix tile
+        std::unique_ptr<StorageBuffer> m_DigitOffsets;
+        std::unique_ptr<StorageBuffer> m_ScratchKeys; // Ping-pong targets of the radix passes
+        std::unique_ptr<StorageBuffer> m_ScratchValues;
+
+    private:
+        void computeBarrier(VkCommandBuffer commandBuffer) const;
+        void transferToComputeBarrier(VkCommandBuffer commandBuffer) const;
+        void computeToTransferBarrier(VkCommandBuffer commandBuffer) const;
+    };
+
+    // CPU references with the exact results of the GPU versions, for validating them and for small inputs
+    [[nodiscard]] std::vector<uint32_t> referenceExclusiveScan(std::span<const uint32_t> input);
+    [[nodiscard]] std::vector<uint32_t> referenceCompact(std::span<const uint32_t> values,
+                                                         std::span<const uint32_t> flags);
+    void referenceSortKeyValues(std::span<uint32_t> keys, std::optional<std::span<uint32_t>> values = std::nullopt,
+                                uint32_t keyBits = 32);
+    void referenceSortKeyValues(std::span<uint64_t> keys, std::optional<std::span<uint32_t>> values = std::nullopt,
+                                uint32_t keyBits = 64);
+    [[nodiscard]] std::vector<uint32_t> referenceHistogram(std::span<const uint32_t> values, uint32_t binCount,
+                                                           uint32_t shift = 0);
+} // Corvus
+
+#endif //ENGINE_COMPUTEPRIMITIVES_H
@@ -0,0 +1,31 @@
+#ifndef ENGINE_GPUOBJECT_H
+#define ENGINE_GPUOBJECT_H
+
+#include <cstdint>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+namespace Corvus
+{
+    // Per-object data of GPU driven draws, matches Shaders/Include/Objects.glslh. Indirect draws use the object's
+    // slot as firstInstance so the vertex shader finds it through gl_InstanceIndex.
+    struct GpuObject
+    {
+        glm::mat4 model = glm::mat4(1.0f);
+        glm::vec4 boundingSphere = glm::vec4(0.0f); // World space center and radius
+        uint32_t objectIndex = 0;
+        uint32_t indexCount = 0;
+        uint32_t firstIndex = 0;
+        int32_t vertexOffset = 0;
+
+        // Only used by meshlet culling
+        uint32_t firstMeshlet = 0; // Into the culler's meshlet buffer, already offset to the selected level
+        uint32_t meshletCount = 0;
+        uint32_t batch = 0; // Indirect batch the meshlet draws are compacted into
+        uint32_t firstDraw = 0; // Own command range when the draws are not compacted
+    };
+    static_assert(sizeof(GpuObject) == 112, "GpuObject must match the shader struct layout");
+} // Corvus
+
+#endif //ENGINE_GPUOBJECT_H
@@ -0,0 +1,47 @@
+#include "Mesh.h"
+
+namespace Corvus
+{
+    Mesh::Mesh(std::shared_ptr<Device> device, const std::vector<Vertex>& vertices,
+               const std::vector<uint32_t>& indices, const VertexFormat& format)
+        : Mesh(std::move(device), vertices, LodChain{indices, {{0, static_cast<uint32_t>(indices.size()), 0.0f}}},
+               format)
+    {
+    }
+
+    Mesh::Mesh(std::shared_ptr<Device> device, const std::vector<Vertex>& vertices, const LodChain& lodChain,
+               const VertexFormat& format)
+        : m_VertexBuffer(format.splitPositions ? encodePositions(vertices, format.encoding)
+                                               : encodeVertices(vertices, format.encoding), device),
+          m_IndexBuffer(lodChain.indices, device),
+          m_Lods(lodChain.lods),
+          m_Meshlets(lodChain.meshlets)
+    {
+        CORVUS_ASSERT(not m_Lods.empty(), "A mesh needs at least one level of detail!")
+        if (format.splitPositions)
+            m_AttributeBuffer = std::make_unique<VertexBuffer>(encodeAttributes(vertices, format.encoding), device);
+        for (const auto& vertex: vertices)
+            m_Bounds.expand(vertex.position);
+    }
+
+    void Mesh::bind(VkCommandBuffer commandBuffer) const
+    {
+        m_VertexBuffer.bind(commandBuffer, 0);
+        if (m_AttributeBuffer)
+            m_AttributeBuffer->bind(commandBuffer, 1);
+        m_IndexBuffer.bind(commandBuffer);
+    }
+
+    uint32_t Mesh::selectLod(float pixelsPerUnit, float maxErrorPixels, float hysteresis, uint32_t current) const
+    {
+        // Errors grow with every level, so the first one that is too coarse ends the search
+        uint32_t level = 0;
+        while (level + 1 < m_Lods.size() and m_Lods[level + 1].error * pixelsPerUnit <= maxErrorPixels)
+            level++;
+
+        float coarserThreshold = maxErrorPixels * (1.0f - hysteresis);
+        while (level > current and m_Lods[level].error * pixelsPerUnit > coarserThreshold)
+            level--;
+        return level;
+    }
+} // Corvus
@@ -0,0 +1,84 @@
+#ifndef ENGINE_MESH_H
+#define ENGINE_MESH_H
+
+#include <memory>
+#include <vector>
+
+#include "Culling/Bounds.h"
+#include "Graphic/Vulkan/Device.h"
+#include "Graphic/Vulkan/IndexBuffer.h"
+#include "Graphic/Vulkan/Vertex.h"
+#include "Graphic/Vulkan/VertexBuffer.h"
+
+namespace Corvus
+{
+    using MeshHandle = uint32_t;
+
+    // Range of the mesh's index buffer drawing one level of detail. Error is the largest distance in model units
+    // the level's surface may deviate from the full detail mesh.
+    struct MeshLod
+    {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        float error = 0.0f;
+        uint32_t firstMeshlet = 0; // Into LodChain::meshlets, the level's meshlets cover exactly its index range
+        uint32_t meshletCount = 0;
+    };
+
+    // Small cluster of consecutive triangles culled as a unit on the GPU. Bounds are in model space, the cone
+    // holds the triangles' front facing normals, a cutoff of 1 means the cluster can never be back facing.
+    struct Meshlet
+    {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        glm::vec3 center = glm::vec3(0.0f);
+        float radius = 0.0f;
+        glm::vec3 coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+        float coneCutoff = 1.0f;
+    };
+
+    // Index lists of all levels back to back, level 0 is the full detail mesh. Every level references the same
+    // vertices, so one vertex and one index buffer hold the whole chain. Meshlets are optional, see
+    // MeshletBuilder.h.
+    struct LodChain
+    {
+        std::vector<uint32_t> indices;
+        std::vector<MeshLod> lods;
+        std::vector<Meshlet> meshlets;
+    };
+
+    // GPU resident geometry, drawn as one indexed draw of the selected level of detail
+    class Mesh
+    {
+    public:
+        Mesh(std::shared_ptr<Device> device, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+             const VertexFormat& format = {});
+        Mesh(std::shared_ptr<Device> device, const std::vector<Vertex>& vertices, const LodChain& lodChain,
+             const VertexFormat& format = {});
+
+        // Binds every vertex stream, pipelines only fetch from the bindings they declare
+        void bind(VkCommandBuffer commandBuffer) const;
+
+        // Coarsest level whose error covers at most maxErrorPixels on screen, pixelsPerUnit being the screen size
+        // of one model unit at the object. Only moves to a coarser level than current once the error is below
+        // maxErrorPixels * (1 - hysteresis), so objects near a threshold do not flicker between levels.
+        [[nodiscard]] uint32_t selectLod(float pixelsPerUnit, float maxErrorPixels, float hysteresis,
+                                         uint32_t current) const;
+
+        [[nodiscard]] uint32_t getIndexCount() const { return m_Lods[0].indexCount; }
+        [[nodiscard]] const MeshLod& getLod(uint32_t level) const { return m_Lods[level]; }
+        [[nodiscard]] uint32_t getLodCount() const { return static_cast<uint32_t>(m_Lods.size()); }
+        [[nodiscard]] const AABB& getBounds() const { return m_Bounds; } // In model space
+        [[nodiscard]] const std::vector<Meshlet>& getMeshlets() const { return m_Meshlets; }
+
+    private:
+        VertexBuffer m_VertexBuffer; // Interleaved vertices, or only the positions when split
+        std::unique_ptr<VertexBuffer> m_AttributeBuffer;
+        IndexBuffer m_IndexBuffer;
+        std::vector<MeshLod> m_Lods;
+        std::vector<Meshlet> m_Meshlets;
+        AABB m_Bounds;
+    };
+} // Corvus
+
+#endif //ENGINE_MESH_H
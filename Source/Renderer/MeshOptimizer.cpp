@@ -0,0 +1,369 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include "Utility/Hash.h"
+
+namespace Corvus
+{
+    namespace
+    {
+        constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+        // Cache the vertex cache optimizer models, larger than real hardware caches on purpose since the scoring
+        // only needs the recency order to be right
+        constexpr uint32_t SCORING_CACHE_SIZE = 32;
+
+        // Cache the overdraw optimizer measures its clusters with, close to what current GPUs reuse in practice
+        constexpr uint32_t SIMULATED_CACHE_SIZE = 16;
+
+        using VertexBits = std::array<uint32_t, sizeof(Vertex) / sizeof(uint32_t)>;
+
+        struct VertexBitsHash
+        {
+            size_t operator()(const VertexBits& bits) const
+            {
+                size_t seed = 0;
+                for (uint32_t word: bits)
+                    hashCombine(seed, word);
+                return seed;
+            }
+        };
+
+        // Forsyth's score, recently used vertices and vertices with few triangles left rank highest. The three
+        // vertices of the last triangle get a fixed score so the next triangle does not simply reuse its edge.
+        float getVertexScore(int32_t cachePosition, uint32_t remainingTriangles)
+        {
+            if (remainingTriangles == 0)
+                return -1.0f;
+
+            float score = 0.0f;
+            if (cachePosition >= 0)
+            {
+                if (cachePosition < 3)
+                    score = 0.75f;
+                else
+                {
+                    float scale = 1.0f / static_cast<float>(SCORING_CACHE_SIZE - 3);
+                    score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scale, 1.5f);
+                }
+            }
+            return score + 2.0f / std::sqrt(static_cast<float>(remainingTriangles));
+        }
+
+        // FIFO post-transform cache where a vertex counts as cached while fewer than size misses happened since
+        // it was loaded. Resetting only moves the clock forward.
+        class CacheSimulator
+        {
+        public:
+            CacheSimulator(size_t vertexCount, uint32_t size)
+                : m_Timestamps(vertexCount, 0), m_Size(size), m_Time(size + 1) {}
+
+            // Returns the number of vertices the triangle had to transform
+            uint32_t addTriangle(const uint32_t* triangle)
+            {
+                uint32_t misses = 0;
+                for (uint32_t corner = 0; corner < 3; corner++)
+                {
+                    uint32_t vertex = triangle[corner];
+                    if (m_Time - m_Timestamps[vertex] > m_Size)
+                    {
+                        m_Timestamps[vertex] = m_Time++;
+                        misses++;
+                    }
+                }
+                return misses;
+            }
+
+            void reset() { m_Time += m_Size + 1; }
+
+        private:
+            std::vector<uint32_t> m_Timestamps;
+            uint32_t m_Size;
+            uint32_t m_Time;
+        };
+    }
+
+    void deduplicateVertices(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+    {
+        // Bitwise so no two vertices are merged that shade differently, and NaNs still compare equal to themselves
+        std::unordered_map<VertexBits, uint32_t, VertexBitsHash> unique;
+        unique.reserve(vertices.size());
+
+        std::vector<uint32_t> remap(vertices.size());
+        std::vector<Vertex> deduplicated;
+        deduplicated.reserve(vertices.size());
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            auto [it, inserted] = unique.try_emplace(std::bit_cast<VertexBits>(vertices[i]),
+                                                     static_cast<uint32_t>(deduplicated.size()));
+            if (inserted)
+                deduplicated.push_back(vertices[i]);
+            remap[i] = it->second;
+        }
+
+        for (auto& index: indices)
+            index = remap[index];
+        vertices = std::move(deduplicated);
+    }
+
+    void optimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount)
+    {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount < 2)
+            return;
+
+        // Triangles using each vertex, emitted ones are swapped to the end of the vertex's range
+        std::vector<uint32_t> remaining(vertexCount, 0);
+        for (uint32_t index: indices)
+            remaining[index]++;
+
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+        std::inclusive_scan(remaining.begin(), remaining.end(), adjacencyOffsets.begin() + 1);
+        std::vector<uint32_t> adjacency(indices.size());
+        {
+            std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (size_t i = 0; i < indices.size(); i++)
+                adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        std::vector<int32_t> cachePositions(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount, 0.0f);
+        for (size_t vertex = 0; vertex < vertexCount; vertex++)
+            vertexScores[vertex] = getVertexScore(-1, remaining[vertex]);
+
+        std::vector<float> triangleScores(triangleCount);
+        for (size_t triangle = 0; triangle < triangleCount; triangle++)
+            triangleScores[triangle] = vertexScores[indices[triangle * 3 + 0]] +
+                                       vertexScores[indices[triangle * 3 + 1]] +
+                                       vertexScores[indices[triangle * 3 + 2]];
+
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+
+        // One slot per vertex of the triangle being added on top of the modelled size
+        std::vector<uint32_t> cache;
+        std::vector<uint32_t> nextCache;
+        cache.reserve(SCORING_CACHE_SIZE + 3);
+        nextCache.reserve(SCORING_CACHE_SIZE + 3);
+
+        auto best = static_cast<uint32_t>(std::max_element(triangleScores.begin(), triangleScores.end()) -
+                                          triangleScores.begin());
+        size_t scanCursor = 0;
+
+        for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+        {
+            // Nothing in the cache touches an open triangle anymore, restart from the first one left
+            if (best == INVALID_INDEX)
+            {
+                while (emitted[scanCursor])
+                    scanCursor++;
+                best = static_cast<uint32_t>(scanCursor);
+            }
+
+            const uint32_t* triangle = &indices[best * 3];
+            result.insert(result.end(), triangle, triangle + 3);
+            emitted[best] = true;
+
+            for (uint32_t corner = 0; corner < 3; corner++)
+            {
+                uint32_t vertex = triangle[corner];
+                uint32_t begin = adjacencyOffsets[vertex];
+                uint32_t end = begin + remaining[vertex];
+                auto it = std::find(adjacency.begin() + begin, adjacency.begin() + end, best);
+                std::iter_swap(it, adjacency.begin() + end - 1);
+                remaining[vertex]--;
+            }
+
+            // Most recently used first, the triangle's vertices move to the front
+            nextCache.assign(triangle, triangle + 3);
+            for (uint32_t vertex: cache)
+                if (vertex != triangle[0] and vertex != triangle[1] and vertex != triangle[2])
+                    nextCache.push_back(vertex);
+
+            for (size_t i = 0; i < nextCache.size(); i++)
+                cachePositions[nextCache[i]] = i < SCORING_CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+
+            // Rescore everything whose cache position changed, the best candidate is picked among their triangles
+            best = INVALID_INDEX;
+            float bestScore = -std::numeric_limits<float>::max();
+            for (uint32_t vertex: nextCache)
+            {
+                float newScore = getVertexScore(cachePositions[vertex], remaining[vertex]);
+                float delta = newScore - vertexScores[vertex];
+                vertexScores[vertex] = newScore;
+
+                uint32_t begin = adjacencyOffsets[vertex];
+                for (uint32_t i = begin; i < begin + remaining[vertex]; i++)
+                {
+                    uint32_t candidate = adjacency[i];
+                    triangleScores[candidate] += delta;
+                    if (triangleScores[candidate] > bestScore)
+                    {
+                        bestScore = triangleScores[candidate];
+                        best = candidate;
+                    }
+                }
+            }
+
+            if (nextCache.size() > SCORING_CACHE_SIZE)
+                nextCache.resize(SCORING_CACHE_SIZE);
+            std::swap(cache, nextCache);
+        }
+
+        std::copy(result.begin(), result.end(), indices.begin());
+    }
+
+    void optimizeOverdraw(std::span<uint32_t> indices, const std::vector<Vertex>& vertices, float threshold)
+    {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount < 2)
+            return;
+
+        // Hard boundaries, triangles missing the cache on all three vertices start a cluster of their own
+        // anyway, so reordering there costs nothing
+        std::vector<uint32_t> hardStarts;
+        CacheSimulator cache(vertices.size(), SIMULATED_CACHE_SIZE);
+        for (size_t triangle = 0; triangle < triangleCount; triangle++)
+            if (cache.addTriangle(&indices[triangle * 3]) == 3)
+                hardStarts.push_back(static_cast<uint32_t>(triangle));
+        hardStarts.push_back(static_cast<uint32_t>(triangleCount));
+
+        // Soft boundaries, a cluster is cut off as soon as it is no worse than threshold times the hard cluster
+        std::vector<uint32_t> clusterStarts;
+        for (size_t hard = 0; hard + 1 < hardStarts.size(); hard++)
+        {
+            uint32_t start = hardStarts[hard];
+            uint32_t end = hardStarts[hard + 1];
+
+            cache.reset();
+            uint32_t misses = 0;
+            for (uint32_t triangle = start; triangle < end; triangle++)
+                misses += cache.addTriangle(&indices[triangle * 3]);
+            float limit = threshold * static_cast<float>(misses) / static_cast<float>(end - start);
+
+            cache.reset();
+            clusterStarts.push_back(start);
+            uint32_t clusterStart = start;
+            misses = 0;
+            for (uint32_t triangle = start; triangle < end; triangle++)
+            {
+                misses += cache.addTriangle(&indices[triangle * 3]);
+                if (triangle + 1 < end and
+                    static_cast<float>(misses) <= limit * static_cast<float>(triangle + 1 - clusterStart))
+                {
+                    clusterStart = triangle + 1;
+                    clusterStarts.push_back(clusterStart);
+                    misses = 0;
+                    cache.reset();
+                }
+            }
+        }
+        clusterStarts.push_back(static_cast<uint32_t>(triangleCount));
+        size_t clusterCount = clusterStarts.size() - 1;
+        if (clusterCount < 2)
+            return;
+
+        // Area weighted centroid and normal of every cluster
+        std::vector<glm::vec3> centroids(clusterCount, glm::vec3(0.0f));
+        std::vector<glm::vec3> normals(clusterCount, glm::vec3(0.0f));
+        std::vector<float> areas(clusterCount, 0.0f);
+        glm::vec3 meshCentroid(0.0f);
+        float meshArea = 0.0f;
+        for (size_t cluster = 0; cluster < clusterCount; cluster++)
+        {
+            for (uint32_t triangle = clusterStarts[cluster]; triangle < clusterStarts[cluster + 1]; triangle++)
+            {
+                const glm::vec3& a = vertices[indices[triangle * 3 + 0]].position;
+                const glm::vec3& b = vertices[indices[triangle * 3 + 1]].position;
+                const glm::vec3& c = vertices[indices[triangle * 3 + 2]].position;
+
+                glm::vec3 normal = glm::cross(b - a, c - a); // Length is twice the area
+                float area = glm::length(normal);
+                centroids[cluster] += (a + b + c) * (area / 3.0f);
+                normals[cluster] += normal;
+                areas[cluster] += area;
+            }
+            meshCentroid += centroids[cluster];
+            meshArea += areas[cluster];
+        }
+        if (meshArea > 0.0f)
+            meshCentroid /= meshArea;
+
+        // Clusters facing away from the centre sit on the outside and are likely to cover the rest
+        std::vector<float> keys(clusterCount, 0.0f);
+        for (size_t cluster = 0; cluster < clusterCount; cluster++)
+        {
+            if (areas[cluster] <= 0.0f)
+                continue;
+            glm::vec3 centroid = centroids[cluster] / areas[cluster];
+            float normalLength = glm::length(normals[cluster]);
+            if (normalLength > 0.0f)
+                keys[cluster] = glm::dot(centroid - meshCentroid, normals[cluster] / normalLength);
+        }
+
+        std::vector<uint32_t> order(clusterCount);
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [&keys](uint32_t a, uint32_t b) { return keys[a] > keys[b]; });
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        for (uint32_t cluster: order)
+            result.insert(result.end(), indices.begin() + clusterStarts[cluster] * 3,
+                          indices.begin() + clusterStarts[cluster + 1] * 3);
+        std::copy(result.begin(), result.end(), indices.begin());
+    }
+
+    void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+    {
+        std::vector<uint32_t> remap(vertices.size(), INVALID_INDEX);
+        std::vector<Vertex> reordered;
+        reordered.reserve(vertices.size());
+        for (auto& index: indices)
+        {
+            if (remap[index] == INVALID_INDEX)
+            {
+                remap[index] = static_cast<uint32_t>(reordered.size());
+                reordered.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+        vertices = std::move(reordered);
+    }
+
+    float getAverageCacheMissRatio(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize)
+    {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0)
+            return 0.0f;
+
+        CacheSimulator cache(vertexCount, cacheSize);
+        uint32_t misses = 0;
+        for (size_t triangle = 0; triangle < triangleCount; triangle++)
+            misses += cache.addTriangle(&indices[triangle * 3]);
+        return static_cast<float>(misses) / static_cast<float>(triangleCount);
+    }
+
+    void optimizeMesh(std::vector<Vertex>& vertices, LodChain& lodChain)
+    {
+        for (const auto& lod: lodChain.lods)
+        {
+            std::span<uint32_t> range(lodChain.indices.data() + lod.firstIndex, lod.indexCount);
+            optimizeVertexCache(range, vertices.size());
+            optimizeOverdraw(range, vertices);
+        }
+
+        // Level 0 comes first and references every vertex, so its triangle order decides the vertex layout
+        optimizeVertexFetch(vertices, lodChain.indices);
+    }
+} // Corvus
@@ -0,0 +1,36 @@
+#ifndef ENGINE_MESHOPTIMIZER_H
+#define ENGINE_MESHOPTIMIZER_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Graphic/Vulkan/Vertex.h"
+#include "Mesh.h"
+
+namespace Corvus
+{
+    // Merges bitwise identical vertices and points the indices at the survivors
+    void deduplicateVertices(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+    // Reorders triangles so recently transformed vertices get reused while still in the post-transform cache
+    // (Forsyth's linear-speed optimizer)
+    void optimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount);
+
+    // Splits a cache optimized triangle list into clusters and draws outward facing clusters first, so the
+    // front of the mesh tends to hide the back. A cluster may miss the cache up to threshold times as often as
+    // the unsplit list did, which bounds what the overdraw gain costs in vertex reuse.
+    void optimizeOverdraw(std::span<uint32_t> indices, const std::vector<Vertex>& vertices, float threshold = 1.05f);
+
+    // Renumbers vertices in order of first use so the vertex fetch walks memory forward, unused ones are dropped
+    void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+    // Transformed vertices per triangle for a FIFO cache of the given size, 0.5 is ideal and 3 the worst case
+    [[nodiscard]] float getAverageCacheMissRatio(std::span<const uint32_t> indices, size_t vertexCount,
+                                                 uint32_t cacheSize = 16);
+
+    // Runs the cache and overdraw passes on every level of the chain, then the fetch pass over all of them
+    void optimizeMesh(std::vector<Vertex>& vertices, LodChain& lodChain);
+} // Corvus
+
+#endif //ENGINE_MESHOPTIMIZER_H
@@ -0,0 +1,401 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <queue>
+#include <unordered_map>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include "Utility/Hash.h"
+
+namespace Corvus
+{
+    namespace
+    {
+        // Weight of the planes perpendicular to open borders, high enough that borders only move along themselves
+        constexpr double BORDER_WEIGHT = 10.0;
+
+        // Collapses bending a neighbouring triangle by more than about 78 degrees are rejected
+        constexpr double MIN_NORMAL_COSINE = 0.2;
+
+        // Sum of squared distances to a set of planes, stored as the upper triangle of the symmetric 4x4 matrix
+        struct Quadric
+        {
+            double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+            double a11 = 0, a12 = 0, a13 = 0;
+            double a22 = 0, a23 = 0;
+            double a33 = 0;
+
+            static Quadric fromPlane(const glm::dvec3& normal, double distance, double weight)
+            {
+                return {
+                    weight * normal.x * normal.x, weight * normal.x * normal.y, weight * normal.x * normal.z,
+                    weight * normal.x * distance,
+                    weight * normal.y * normal.y, weight * normal.y * normal.z, weight * normal.y * distance,
+                    weight * normal.z * normal.z, weight * normal.z * distance,
+                    weight * distance * distance
+                };
+            }
+
+            Quadric& operator+=(const Quadric& other)
+            {
+                a00 += other.a00, a01 += other.a01, a02 += other.a02, a03 += other.a03;
+                a11 += other.a11, a12 += other.a12, a13 += other.a13;
+                a22 += other.a22, a23 += other.a23;
+                a33 += other.a33;
+                return *this;
+            }
+
+            [[nodiscard]] double evaluate(const glm::dvec3& p) const
+            {
+                double error = a00 * p.x * p.x + 2.0 * a01 * p.x * p.y + 2.0 * a02 * p.x * p.z + 2.0 * a03 * p.x +
+                               a11 * p.y * p.y + 2.0 * a12 * p.y * p.z + 2.0 * a13 * p.y +
+                               a22 * p.z * p.z + 2.0 * a23 * p.z +
+                               a33;
+                return std::max(error, 0.0);
+            }
+        };
+
+        struct Collapse
+        {
+            double error;
+            uint32_t from;
+            uint32_t to;
+            uint32_t fromVersion;
+            uint32_t toVersion;
+
+            bool operator>(const Collapse& other) const { return error > other.error; }
+        };
+
+        struct PositionHash
+        {
+            size_t operator()(const glm::vec3& position) const
+            {
+                size_t seed = 0;
+                hashCombine(seed, position.x);
+                hashCombine(seed, position.y);
+                hashCombine(seed, position.z);
+                return seed;
+            }
+        };
+
+        uint64_t edgeKey(uint32_t a, uint32_t b)
+        {
+            return static_cast<uint64_t>(std::min(a, b)) << 32 | std::max(a, b);
+        }
+
+        // Mesh connectivity over welded vertices, a vertex is identified by the first vertex at its position
+        class CollapseMesh
+        {
+        public:
+            CollapseMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+                : m_Positions(vertices.size()),
+                  m_Remap(vertices.size()),
+                  m_Quadrics(vertices.size()),
+                  m_VertexTriangles(vertices.size()),
+                  m_Versions(vertices.size(), 0),
+                  m_Removed(vertices.size(), false)
+            {
+                std::unordered_map<glm::vec3, uint32_t, PositionHash> firstAtPosition;
+                for (uint32_t i = 0; i < vertices.size(); i++)
+                {
+                    m_Positions[i] = vertices[i].position;
+                    m_Remap[i] = firstAtPosition.try_emplace(vertices[i].position, i).first->second;
+                }
+
+                m_Corners.resize(indices.size() / 3);
+                m_TriangleRemoved.resize(m_Corners.size(), false);
+                for (uint32_t t = 0; t < m_Corners.size(); t++)
+                {
+                    m_Corners[t] = {indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]};
+                    uint32_t a = vertex(t, 0), b = vertex(t, 1), c = vertex(t, 2);
+                    if (a == b or b == c or c == a)
+                    {
+                        m_TriangleRemoved[t] = true;
+                        continue;
+                    }
+
+                    m_AliveTriangles++;
+                    for (uint32_t v: {a, b, c})
+                        m_VertexTriangles[v].push_back(t);
+
+                    glm::dvec3 normal = getNormal(m_Positions[a], m_Positions[b], m_Positions[c]);
+                    if (normal == glm::dvec3(0.0))
+                        continue;
+
+                    auto quadric = Quadric::fromPlane(normal, -glm::dot(normal, m_Positions[a]), 1.0);
+                    for (uint32_t v: {a, b, c})
+                        m_Quadrics[v] += quadric;
+                }
+            }
+
+            void addBorderQuadrics(std::vector<std::pair<uint32_t, uint32_t>>& edges)
+            {
+                std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>> edgeUses; // Count, first triangle
+                for (uint32_t t = 0; t < m_Corners.size(); t++)
+                {
+                    if (m_TriangleRemoved[t])
+                        continue;
+
+                    for (int k = 0; k < 3; k++)
+                    {
+                        uint32_t a = vertex(t, k), b = vertex(t, (k + 1) % 3);
+                        auto [entry, inserted] = edgeUses.try_emplace(edgeKey(a, b), 0, t);
+                        entry->second.first++;
+                        if (inserted)
+                            edges.emplace_back(a, b);
+                    }
+                }
+
+                for (auto [a, b]: edges)
+                {
+                    auto [uses, triangle] = edgeUses[edgeKey(a, b)];
+                    if (uses != 1)
+                        continue;
+
+                    glm::dvec3 normal = getNormal(m_Positions[vertex(triangle, 0)], m_Positions[vertex(triangle, 1)],
+                                                  m_Positions[vertex(triangle, 2)]);
+                    glm::dvec3 borderNormal = glm::cross(m_Positions[b] - m_Positions[a], normal);
+                    double length = glm::length(borderNormal);
+                    if (length == 0.0)
+                        continue;
+
+                    // Scaled by the edge length so long borders are held as firmly as the faces next to them
+                    borderNormal /= length;
+                    auto quadric = Quadric::fromPlane(borderNormal, -glm::dot(borderNormal, m_Positions[a]),
+                                                      BORDER_WEIGHT * length);
+                    m_Quadrics[a] += quadric;
+                    m_Quadrics[b] += quadric;
+                }
+            }
+
+            [[nodiscard]] Collapse makeCollapse(uint32_t a, uint32_t b) const
+            {
+                Quadric combined = m_Quadrics[a];
+                combined += m_Quadrics[b];
+
+                double intoB = combined.evaluate(m_Positions[b]);
+                double intoA = combined.evaluate(m_Positions[a]);
+                return intoB <= intoA
+                           ? Collapse{intoB, a, b, m_Versions[a], m_Versions[b]}
+                           : Collapse{intoA, b, a, m_Versions[b], m_Versions[a]};
+            }
+
+            [[nodiscard]] bool isCurrent(const Collapse& collapse) const
+            {
+                return not m_Removed[collapse.from] and not m_Removed[collapse.to] and
+                       m_Versions[collapse.from] == collapse.fromVersion and
+                       m_Versions[collapse.to] == collapse.toVersion;
+            }
+
+            [[nodiscard]] bool canCollapse(uint32_t from, uint32_t to) const
+            {
+                // Link condition: only the vertices opposite the edge may be adjacent to both ends, anything else
+                // would pinch the surface into a non-manifold edge
+                auto fromNeighbours = getNeighbours(from);
+                auto toNeighbours = getNeighbours(to);
+                std::vector<uint32_t> shared;
+                std::ranges::set_intersection(fromNeighbours, toNeighbours, std::back_inserter(shared));
+
+                uint32_t edgeTriangles = 0;
+                for (uint32_t t: m_VertexTriangles[from])
+                {
+                    if (m_TriangleRemoved[t])
+                        continue;
+
+                    if (contains(t, to))
+                    {
+                        edgeTriangles++;
+                        continue;
+                    }
+
+                    std::array<glm::dvec3, 3> before, after;
+                    for (int k = 0; k < 3; k++)
+                    {
+                        before[k] = m_Positions[vertex(t, k)];
+                        after[k] = vertex(t, k) == from ? m_Positions[to] : before[k];
+                    }
+
+                    glm::dvec3 normalBefore = getNormal(before[0], before[1], before[2]);
+                    glm::dvec3 normalAfter = getNormal(after[0], after[1], after[2]);
+                    if (glm::dot(normalBefore, normalAfter) < MIN_NORMAL_COSINE)
+                        return false;
+                }
+                return shared.size() == edgeTriangles;
+            }
+
+            void collapse(const Collapse& collapse, std::vector<uint32_t>& neighbours)
+            {
+                for (uint32_t t: m_VertexTriangles[collapse.from])
+                {
+                    if (m_TriangleRemoved[t])
+                        continue;
+
+                    if (contains(t, collapse.to))
+                    {
+                        m_TriangleRemoved[t] = true;
+                        m_AliveTriangles--;
+                        continue;
+                    }
+
+                    // The welded vertex itself takes over the corner, its attributes win over the collapsed one's
+                    for (auto& corner: m_Corners[t])
+                    {
+                        if (m_Remap[corner] == collapse.from)
+                            corner = collapse.to;
+                    }
+                    m_VertexTriangles[collapse.to].push_back(t);
+                }
+
+                m_VertexTriangles[collapse.from].clear();
+                m_Removed[collapse.from] = true;
+                m_Quadrics[collapse.to] += m_Quadrics[collapse.from];
+                m_Versions[collapse.to]++;
+
+                neighbours = getNeighbours(collapse.to);
+            }
+
+            [[nodiscard]] std::vector<uint32_t> getIndices() const
+            {
+                std::vector<uint32_t> indices;
+                indices.reserve(m_AliveTriangles * 3);
+                for (uint32_t t = 0; t < m_Corners.size(); t++)
+                {
+                    if (not m_TriangleRemoved[t])
+                        indices.insert(indices.end(), m_Corners[t].begin(), m_Corners[t].end());
+                }
+                return indices;
+            }
+
+            [[nodiscard]] size_t getIndexCount() const { return m_AliveTriangles * 3; }
+
+        private:
+            std::vector<glm::dvec3> m_Positions;
+            std::vector<uint32_t> m_Remap;
+            std::vector<Quadric> m_Quadrics;
+            std::vector<std::vector<uint32_t>> m_VertexTriangles;
+            std::vector<uint32_t> m_Versions;
+            std::vector<bool> m_Removed;
+
+            std::vector<std::array<uint32_t, 3>> m_Corners; // Original vertex indices
+            std::vector<bool> m_TriangleRemoved;
+            size_t m_AliveTriangles = 0;
+
+            [[nodiscard]] uint32_t vertex(uint32_t triangle, int corner) const
+            {
+                return m_Remap[m_Corners[triangle][corner]];
+            }
+
+            [[nodiscard]] bool contains(uint32_t triangle, uint32_t v) const
+            {
+                return vertex(triangle, 0) == v or vertex(triangle, 1) == v or vertex(triangle, 2) == v;
+            }
+
+            [[nodiscard]] std::vector<uint32_t> getNeighbours(uint32_t v) const
+            {
+                std::vector<uint32_t> neighbours;
+                for (uint32_t t: m_VertexTriangles[v])
+                {
+                    if (m_TriangleRemoved[t])
+                        continue;
+
+                    for (int k = 0; k < 3; k++)
+                    {
+                        if (vertex(t, k) != v)
+                            neighbours.push_back(vertex(t, k));
+                    }
+                }
+                std::ranges::sort(neighbours);
+                neighbours.erase(std::ranges::unique(neighbours).begin(), neighbours.end());
+                return neighbours;
+            }
+
+            static glm::dvec3 getNormal(const glm::dvec3& a, const glm::dvec3& b, const glm::dvec3& c)
+            {
+                glm::dvec3 normal = glm::cross(b - a, c - a);
+                double length = glm::length(normal);
+                return length > 0.0 ? normal / length : glm::dvec3(0.0);
+            }
+        };
+    }
+
+    std::vector<uint32_t> simplifyMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                                       size_t targetIndexCount, float maxError, float& resultError)
+    {
+        resultError = 0.0f;
+        if (indices.size() <= targetIndexCount)
+            return indices;
+
+        CollapseMesh mesh(vertices, indices);
+        std::vector<std::pair<uint32_t, uint32_t>> edges;
+        mesh.addBorderQuadrics(edges);
+
+        // Cheapest collapse first. Entries go stale when either end changes, they are then skipped and the
+        // collapse re-queued with the current quadrics.
+        std::priority_queue<Collapse, std::vector<Collapse>, std::greater<>> queue;
+        for (auto [a, b]: edges)
+            queue.push(mesh.makeCollapse(a, b));
+
+        double maxQuadricError = static_cast<double>(maxError) * maxError;
+        double reachedError = 0.0;
+        std::vector<uint32_t> neighbours;
+        while (mesh.getIndexCount() > targetIndexCount and not queue.empty())
+        {
+            Collapse collapse = queue.top();
+            queue.pop();
+            if (collapse.error > maxQuadricError)
+                break;
+            if (not mesh.isCurrent(collapse) or not mesh.canCollapse(collapse.from, collapse.to))
+                continue;
+
+            mesh.collapse(collapse, neighbours);
+            reachedError = std::max(reachedError, collapse.error);
+            for (uint32_t neighbour: neighbours)
+                queue.push(mesh.makeCollapse(collapse.to, neighbour));
+        }
+
+        resultError = static_cast<float>(std::sqrt(reachedError));
+        return mesh.getIndices();
+    }
+
+    LodChain buildLodChain(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                           const LodSettings& settings)
+    {
+        LodChain chain = {indices, {{0, static_cast<uint32_t>(indices.size()), 0.0f}}};
+
+        AABB bounds;
+        for (const auto& vertex: vertices)
+            bounds.expand(vertex.position);
+        float maxError = settings.maxError * glm::length(bounds.max - bounds.min);
+
+        std::vector<uint32_t> current = indices;
+        float error = 0.0f;
+        for (uint32_t level = 1; level < settings.maxLevels; level++)
+        {
+            auto targetIndexCount = static_cast<size_t>(static_cast<float>(current.size() / 3) * settings.reduction) * 3;
+            if (targetIndexCount == 0 or error >= maxError)
+                break;
+
+            // Each level starts from the previous one, so their errors add up
+            float levelError;
+            auto simplified = simplifyMesh(vertices, current, targetIndexCount, maxError - error, levelError);
+
+            // A level barely smaller than the last one is not worth its index range
+            if (simplified.empty() or simplified.size() > current.size() * 9 / 10)
+                break;
+
+            error += levelError;
+            chain.lods.push_back({
+                static_cast<uint32_t>(chain.indices.size()),
+                static_cast<uint32_t>(simplified.size()),
+                error
+            });
+            chain.indices.insert(chain.indices.end(), simplified.begin(), simplified.end());
+            current = std::move(simplified);
+        }
+        return chain;
+    }
+} // Corvus
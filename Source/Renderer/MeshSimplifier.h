@@ -0,0 +1,34 @@
+#ifndef ENGINE_MESHSIMPLIFIER_H
+#define ENGINE_MESHSIMPLIFIER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Graphic/Vulkan/Vertex.h"
+#include "Mesh.h"
+
+namespace Corvus
+{
+    struct LodSettings
+    {
+        uint32_t maxLevels = 4;     // Including the full detail level, 1 disables simplification
+        float reduction = 0.5f;     // Triangle count of each level relative to the previous one
+        float maxError = 0.05f;     // Largest deviation any level may reach, relative to the mesh's bounding diagonal
+    };
+
+    // Quadric error edge collapse (Garland and Heckbert). Edges collapse onto one of their endpoints, so the result
+    // indexes into the same vertices and no attributes have to be interpolated. Vertices sharing a position are
+    // treated as one, open borders are held in place by additional quadrics and collapses that would flip a
+    // triangle or pinch the surface are rejected. Stops at targetIndexCount or once the next collapse would move
+    // the surface further than maxError, resultError receives the largest error reached.
+    [[nodiscard]] std::vector<uint32_t> simplifyMesh(const std::vector<Vertex>& vertices,
+                                                     const std::vector<uint32_t>& indices, size_t targetIndexCount,
+                                                     float maxError, float& resultError);
+
+    // Builds levels by repeatedly simplifying the previous one until the settings or the error budget are exhausted.
+    // Cheap enough to run at load time, the chain can also be built offline and handed to Renderer::createMesh.
+    [[nodiscard]] LodChain buildLodChain(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                                         const LodSettings& settings = {});
+} // Corvus
+
+#endif //ENGINE_MESHSIMPLIFIER_H
@@ -0,0 +1,138 @@
+#include "MeshletBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Corvus
+{
+    namespace
+    {
+        // Cones wider than this are not worth testing, hardly any view direction would see the whole cluster's back
+        constexpr float MIN_CONE_SPREAD = 0.1f;
+
+        void computeBounds(const std::vector<Vertex>& vertices, std::span<const uint32_t> indices, Meshlet& meshlet)
+        {
+            AABB box;
+            for (uint32_t index: indices)
+                box.expand(vertices[index].position);
+
+            meshlet.center = box.getCenter();
+            float radiusSquared = 0.0f;
+            for (uint32_t index: indices)
+            {
+                glm::vec3 offset = vertices[index].position - meshlet.center;
+                radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+            }
+            meshlet.radius = std::sqrt(radiusSquared);
+
+            // The pipelines treat clockwise triangles as front facing (VK_FRONT_FACE_CLOCKWISE with the flipped
+            // projection), so the front normal is the reversed right-handed one
+            std::vector<glm::vec3> normals;
+            normals.reserve(indices.size() / 3);
+            glm::vec3 axis(0.0f);
+            for (size_t i = 0; i + 2 < indices.size(); i += 3)
+            {
+                const glm::vec3& a = vertices[indices[i + 0]].position;
+                const glm::vec3& b = vertices[indices[i + 1]].position;
+                const glm::vec3& c = vertices[indices[i + 2]].position;
+                glm::vec3 normal = glm::cross(c - a, b - a);
+                float length = glm::length(normal);
+                if (length <= std::numeric_limits<float>::min())
+                    continue; // Degenerate triangles are never rasterized
+
+                normals.push_back(normal / length);
+                axis += normals.back();
+            }
+
+            meshlet.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+            meshlet.coneCutoff = 1.0f;
+            float axisLength = glm::length(axis);
+            if (normals.empty() or axisLength <= std::numeric_limits<float>::min())
+                return;
+
+            axis /= axisLength;
+            float minimumDot = 1.0f;
+            for (const auto& normal: normals)
+                minimumDot = std::min(minimumDot, glm::dot(normal, axis));
+            if (minimumDot < MIN_CONE_SPREAD)
+                return;
+
+            // Sine of the widest angle between a normal and the axis. The cluster is back facing for every camera
+            // with dot(center - camera, axis) >= cutoff * |center - camera| + radius.
+            meshlet.coneAxis = axis;
+            meshlet.coneCutoff = std::sqrt(1.0f - minimumDot * minimumDot);
+        }
+    }
+
+    std::vector<Meshlet> buildMeshlets(const std::vector<Vertex>& vertices, std::span<const uint32_t> indices,
+                                       uint32_t firstIndex, uint32_t maxVertices, uint32_t maxTriangles)
+    {
+        std::vector<Meshlet> meshlets;
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0)
+            return meshlets;
+
+        // Marks which vertices the open meshlet already uses, stamps avoid clearing the array for every meshlet
+        std::vector<uint32_t> stamps(vertices.size(), 0);
+        uint32_t stamp = 1;
+        uint32_t vertexCount = 0;
+        size_t start = 0;
+
+        auto close = [&](size_t end)
+        {
+            Meshlet meshlet = {
+                .firstIndex = firstIndex + static_cast<uint32_t>(start * 3),
+                .indexCount = static_cast<uint32_t>((end - start) * 3),
+            };
+            computeBounds(vertices, indices.subspan(start * 3, (end - start) * 3), meshlet);
+            meshlets.push_back(meshlet);
+
+            start = end;
+            stamp++;
+            vertexCount = 0;
+        };
+
+        for (size_t triangle = 0; triangle < triangleCount; triangle++)
+        {
+            const uint32_t* corners = &indices[triangle * 3];
+            uint32_t newVertices = 0;
+            for (uint32_t corner = 0; corner < 3; corner++)
+            {
+                bool repeated = (corner > 0 and corners[corner] == corners[0]) or
+                                (corner > 1 and corners[corner] == corners[1]);
+                if (stamps[corners[corner]] != stamp and not repeated)
+                    newVertices++;
+            }
+
+            if (vertexCount + newVertices > maxVertices or triangle - start >= maxTriangles)
+                close(triangle);
+
+            for (uint32_t corner = 0; corner < 3; corner++)
+            {
+                if (stamps[corners[corner]] != stamp)
+                {
+                    stamps[corners[corner]] = stamp;
+                    vertexCount++;
+                }
+            }
+        }
+        close(triangleCount);
+        return meshlets;
+    }
+
+    void buildMeshlets(const std::vector<Vertex>& vertices, LodChain& lodChain, uint32_t maxVertices,
+                       uint32_t maxTriangles)
+    {
+        lodChain.meshlets.clear();
+        for (auto& lod: lodChain.lods)
+        {
+            std::span<const uint32_t> range(lodChain.indices.data() + lod.firstIndex, lod.indexCount);
+            auto meshlets = buildMeshlets(vertices, range, lod.firstIndex, maxVertices, maxTriangles);
+
+            lod.firstMeshlet = static_cast<uint32_t>(lodChain.meshlets.size());
+            lod.meshletCount = static_cast<uint32_t>(meshlets.size());
+            lodChain.meshlets.insert(lodChain.meshlets.end(), meshlets.begin(), meshlets.end());
+        }
+    }
+} // Corvus
@@ -0,0 +1,33 @@
+#ifndef ENGINE_MESHLETBUILDER_H
+#define ENGINE_MESHLETBUILDER_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Graphic/Vulkan/Vertex.h"
+#include "Mesh.h"
+
+namespace Corvus
+{
+    // Limits that keep a meshlet's vertices in the post-transform cache of current GPUs, 124 triangles leave room
+    // for the vertex and primitive counts when the same data feeds mesh shaders later
+    constexpr uint32_t MAX_MESHLET_VERTICES = 64;
+    constexpr uint32_t MAX_MESHLET_TRIANGLES = 124;
+
+    // Cuts indices into runs of consecutive triangles that stay within the limits, so every meshlet is a plain
+    // range of the index buffer and can be drawn with an ordinary indexed draw. The triangles should already be
+    // in cache optimized order (optimizeMesh), which keeps each run spatially compact. firstIndex is the offset of
+    // indices within the mesh's index buffer.
+    [[nodiscard]] std::vector<Meshlet> buildMeshlets(const std::vector<Vertex>& vertices,
+                                                     std::span<const uint32_t> indices, uint32_t firstIndex = 0,
+                                                     uint32_t maxVertices = MAX_MESHLET_VERTICES,
+                                                     uint32_t maxTriangles = MAX_MESHLET_TRIANGLES);
+
+    // Replaces the chain's meshlets with new ones for every level. Has to run after anything reordering the
+    // indices, the meshlets reference index ranges.
+    void buildMeshlets(const std::vector<Vertex>& vertices, LodChain& lodChain,
+                       uint32_t maxVertices = MAX_MESHLET_VERTICES, uint32_t maxTriangles = MAX_MESHLET_TRIANGLES);
+} // Corvus
+
+#endif //ENGINE_MESHLETBUILDER_H
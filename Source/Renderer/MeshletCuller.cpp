@@ -0,0 +1,156 @@
+#include "MeshletCuller.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Graphic/Vulkan/BufferUtils.h"
+
+namespace Corvus
+{
+    MeshletCuller::MeshletCuller(std::shared_ptr<Device> device, const std::vector<char>& cullCode,
+                                 const std::vector<GpuMeshlet>& meshlets, uint32_t maxDraws, uint32_t maxBatches,
+                                 uint32_t framesInFlight)
+        : m_Device(std::move(device)),
+          m_MaxDraws(maxDraws),
+          m_MaxBatches(maxBatches),
+          m_Compact(m_Device->getEnabledFeatures().drawIndirectCount),
+          m_CullPipeline(m_Device, cullCode,
+                         std::vector<VkDescriptorType>(5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+                         sizeof(MeshletCullConstants), "Meshlet Cull")
+    {
+        uploadMeshlets(meshlets);
+        m_CommandBuffer = std::make_unique<StorageBuffer>(m_Device, maxDraws * sizeof(VkDrawIndexedIndirectCommand),
+                                                          StorageBuffer::Access::DeviceOnly,
+                                                          VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+
+        // Tasks never outnumber the draws, every task holds at least one meshlet
+        m_Frames.resize(framesInFlight);
+        for (auto& frame: m_Frames)
+        {
+            frame.tasks = std::make_unique<StorageBuffer>(m_Device, maxDraws * sizeof(MeshletTask),
+                                                          StorageBuffer::Access::HostWrite);
+            frame.batches = std::make_unique<StorageBuffer>(m_Device, maxBatches * sizeof(MeshletDrawBatch),
+                                                            StorageBuffer::Access::HostWrite,
+                                                            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+        }
+
+        CORVUS_LOG(info, "Meshlet culling enabled for {} meshlets, up to {} draws per frame{}", meshlets.size(),
+                   maxDraws, m_Compact ? "" : " (not compacted, drawIndirectCount is unavailable)");
+    }
+
+    void MeshletCuller::appendMeshlets(const std::vector<Meshlet>& meshlets, std::vector<GpuMeshlet>& gpuMeshlets)
+    {
+        for (const auto& meshlet: meshlets)
+        {
+            gpuMeshlets.push_back({
+                .boundingSphere = glm::vec4(meshlet.center, meshlet.radius),
+                .cone = glm::vec4(meshlet.coneAxis, meshlet.coneCutoff),
+                .firstIndex = meshlet.firstIndex,
+                .indexCount = meshlet.indexCount,
+                .padding = {0, 0},
+            });
+        }
+    }
+
+    void MeshletCuller::cull(VkCommandBuffer commandBuffer, DescriptorSetCache& descriptorSets, uint32_t frame,
+                             const StorageBuffer& objects, const std::vector<MeshletTask>& tasks,
+                             const std::vector<MeshletDrawBatch>& batches, const glm::mat4& view,
+                             const glm::mat4& projection)
+    {
+        CORVUS_ASSERT(tasks.size() <= m_MaxDraws, "More than {} meshlet tasks submitted!", m_MaxDraws)
+        CORVUS_ASSERT(batches.size() <= m_MaxBatches, "More than {} meshlet batches submitted!", m_MaxBatches)
+        const auto& resources = m_Frames[frame];
+
+        std::memcpy(resources.tasks->getMappedData(), tasks.data(), tasks.size() * sizeof(MeshletTask));
+        std::memcpy(resources.batches->getMappedData(), batches.data(), batches.size() * sizeof(MeshletDrawBatch));
+
+        // The command buffer is shared by all frames in flight, wait for the last frame's draws to be done with it
+        memoryBarrier(*m_Device, commandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                      VK_ACCESS_INDIRECT_COMMAND_READ_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                      VK_ACCESS_SHADER_WRITE_BIT);
+
+        auto set = descriptorSets.get(m_CullPipeline.getDescriptorSetLayout(), {
+            DescriptorWrite::buffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, objects.getBuffer()),
+            DescriptorWrite::buffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_MeshletBuffer->getBuffer()),
+            DescriptorWrite::buffer(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, resources.tasks->getBuffer()),
+            DescriptorWrite::buffer(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, resources.batches->getBuffer()),
+            DescriptorWrite::buffer(4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_CommandBuffer->getBuffer()),
+        });
+
+        // A point is inside the x planes while P00 * |x| <= z (z pointing forward), normalized that is the plane
+        // (-P00, 1) / sqrt(1 + P00^2). The same holds for y with |P11|, which is negative for Vulkan's flipped y.
+        float scaleX = projection[0][0];
+        float scaleY = glm::abs(projection[1][1]);
+        float lengthX = glm::sqrt(1.0f + scaleX * scaleX);
+        float lengthY = glm::sqrt(1.0f + scaleY * scaleY);
+
+        MeshletCullConstants constants = {
+            .view = view,
+            .frustum = glm::vec4(scaleX / lengthX, 1.0f / lengthX, scaleY / lengthY, 1.0f / lengthY),
+            .nearPlane = projection[3][2], // Reverse-Z infinite projection
+            .taskCount = static_cast<uint32_t>(tasks.size()),
+            .compact = m_Compact ? 1u : 0u,
+            .padding = 0,
+        };
+
+        m_CullPipeline.bind(commandBuffer, set);
+        m_CullPipeline.pushConstants(commandBuffer, constants);
+        m_CullPipeline.dispatch(commandBuffer, static_cast<uint32_t>(tasks.size()));
+
+        memoryBarrier(*m_Device, commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+    }
+
+    void MeshletCuller::drawIndirect(VkCommandBuffer commandBuffer, uint32_t frame, uint32_t batch,
+                                     uint32_t firstDraw, uint32_t maxDrawCount) const
+    {
+        const auto& vk = m_Device->getDispatch();
+        auto buffer = m_CommandBuffer->getBuffer();
+        constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+
+        if (m_Compact)
+        {
+            vk.vkCmdDrawIndexedIndirectCount(commandBuffer, buffer, firstDraw * stride,
+                                             m_Frames[frame].batches->getBuffer(), batch * sizeof(MeshletDrawBatch),
+                                             maxDrawCount, stride);
+            return;
+        }
+
+        // Culled meshlets stay in the buffer with an instance count of 0, the GPU skips them
+        if (m_Device->getEnabledFeatures().multiDrawIndirect)
+        {
+            vk.vkCmdDrawIndexedIndirect(commandBuffer, buffer, firstDraw * stride, maxDrawCount, stride);
+            return;
+        }
+
+        for (uint32_t i = firstDraw; i < firstDraw + maxDrawCount; i++)
+            vk.vkCmdDrawIndexedIndirect(commandBuffer, buffer, i * stride, 1, stride);
+    }
+
+    void MeshletCuller::uploadMeshlets(const std::vector<GpuMeshlet>& meshlets)
+    {
+        // Static for the culler's lifetime, so it goes into device local memory through a staging buffer
+        VkDeviceSize size = std::max<size_t>(meshlets.size(), 1) * sizeof(GpuMeshlet);
+        m_MeshletBuffer = std::make_unique<StorageBuffer>(m_Device, size, StorageBuffer::Access::DeviceOnly,
+                                                          VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+        if (meshlets.empty())
+            return;
+
+        const auto& vk = m_Device->getDispatch();
+        VkBuffer stagingBuffer;
+        VkDeviceMemory stagingBufferMemory;
+        BufferUtils::createBuffer(*m_Device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT bitor VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                  stagingBuffer, stagingBufferMemory);
+
+        void* data;
+        vk.vkMapMemory(m_Device->getDevice(), stagingBufferMemory, 0, size, 0, &data);
+        std::memcpy(data, meshlets.data(), meshlets.size() * sizeof(GpuMeshlet));
+        vk.vkUnmapMemory(m_Device->getDevice(), stagingBufferMemory);
+
+        BufferUtils::copyBuffer(*m_Device, stagingBuffer, m_MeshletBuffer->getBuffer(), size);
+
+        vk.vkDestroyBuffer(m_Device->getDevice(), stagingBuffer, nullptr);
+        vk.vkFreeMemory(m_Device->getDevice(), stagingBufferMemory, nullptr);
+    }
+} // Corvus
@@ -0,0 +1,107 @@
+#ifndef ENGINE_MESHLETCULLER_H
+#define ENGINE_MESHLETCULLER_H
+
+#include <memory>
+#include <vector>
+
+#include "Graphic/Vulkan/ComputePipeline.h"
+#include "Graphic/Vulkan/DescriptorSetCache.h"
+#include "Graphic/Vulkan/Device.h"
+#include "Graphic/Vulkan/PushConstants.h"
+#include "Graphic/Vulkan/StorageBuffer.h"
+#include "Mesh.h"
+
+namespace Corvus
+{
+    // Meshlet as the cull shader reads it, matches Shaders/meshletCull.glsl
+    struct GpuMeshlet
+    {
+        glm::vec4 boundingSphere; // Model space center and radius
+        glm::vec4 cone; // Front facing axis and cutoff
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        uint32_t padding[2];
+    };
+    static_assert(sizeof(GpuMeshlet) == 48, "GpuMeshlet must match the shader struct layout");
+
+    // Up to one workgroup of meshlets of one object, the culler dispatches one workgroup per task
+    struct MeshletTask
+    {
+        uint32_t object; // Slot in the GpuObject buffer
+        uint32_t firstMeshlet; // Relative to the object's meshlet range
+    };
+
+    // Indirect draws of one batch, drawCount is filled in by the cull shader when draws are compacted
+    struct MeshletDrawBatch
+    {
+        uint32_t drawCount = 0;
+        uint32_t firstDraw = 0;
+    };
+
+    // Must match the push constant block of Shaders/meshletCull.glsl
+    struct MeshletCullConstants
+    {
+        glm::mat4 view;
+        glm::vec4 frustum; // Normalized side planes in view space, x/z for left and right, y/z for top and bottom
+        float nearPlane;
+        uint32_t taskCount;
+        uint32_t compact;
+        uint32_t padding;
+    };
+    static_assert(PushConstantData<MeshletCullConstants>);
+
+    // Culls the meshlets of every GpuObject against the frustum and their normal cones on compute and writes one
+    // indexed indirect draw per visible meshlet. Meshlets are ranges of their mesh's index buffer, so no mesh
+    // shaders are involved. With drawIndirectCount the surviving draws of a batch are compacted and the GPU reads
+    // their count, otherwise every meshlet keeps its slot and culled ones get an instance count of 0.
+    class MeshletCuller
+    {
+    public:
+        static constexpr uint32_t GROUP_SIZE = 64;
+
+        MeshletCuller(std::shared_ptr<Device> device, const std::vector<char>& cullCode,
+                      const std::vector<GpuMeshlet>& meshlets, uint32_t maxDraws, uint32_t maxBatches,
+                      uint32_t framesInFlight);
+
+        MeshletCuller(const MeshletCuller&) = delete;
+        MeshletCuller& operator=(const MeshletCuller&) = delete;
+
+        // Model space meshlets of a mesh in the layout the shader reads
+        static void appendMeshlets(const std::vector<Meshlet>& meshlets, std::vector<GpuMeshlet>& gpuMeshlets);
+
+        // Copies the frame's tasks and batches and records the cull, ends with a barrier making the draws visible
+        // to drawIndirect. The batches' firstDraw ranges have to fit into maxDraws.
+        void cull(VkCommandBuffer commandBuffer, DescriptorSetCache& descriptorSets, uint32_t frame,
+                  const StorageBuffer& objects, const std::vector<MeshletTask>& tasks,
+                  const std::vector<MeshletDrawBatch>& batches, const glm::mat4& view, const glm::mat4& projection);
+
+        // Draws what survived of a batch, maxDrawCount is the number of meshlets the batch was culled with
+        void drawIndirect(VkCommandBuffer commandBuffer, uint32_t frame, uint32_t batch, uint32_t firstDraw,
+                          uint32_t maxDrawCount) const;
+
+        [[nodiscard]] bool isCompacting() const { return m_Compact; }
+
+    private:
+        struct FrameResources
+        {
+            std::unique_ptr<StorageBuffer> tasks;
+            std::unique_ptr<StorageBuffer> batches;
+        };
+
+        std::shared_ptr<Device> m_Device;
+        uint32_t m_MaxDraws;
+        uint32_t m_MaxBatches;
+        bool m_Compact;
+
+        ComputePipeline m_CullPipeline;
+
+        std::unique_ptr<StorageBuffer> m_MeshletBuffer;
+        std::unique_ptr<StorageBuffer> m_CommandBuffer; // Shared by all frames in flight
+        std::vector<FrameResources> m_Frames;
+
+    private:
+        void uploadMeshlets(const std::vector<GpuMeshlet>& meshlets);
+    };
+} // Corvus
+
+#endif //ENGINE_MESHLETCULLER_H
@@ -0,0 +1,231 @@
+#include "OcclusionCuller.h"
+
+#include <bit>
+
+#include "Graphic/Vulkan/ImageUtils.h"
+
+namespace Corvus
+{
+    namespace
+    {
+        constexpr uint32_t PYRAMID_GROUP_SIZE = 8;
+        constexpr uint32_t CULL_GROUP_SIZE = 64;
+    }
+
+    OcclusionCuller::OcclusionCuller(std::shared_ptr<Device> device, const std::vector<char>& pyramidCode,
+                                     const std::vector<char>& cullCode, uint32_t capacity)
+        : m_Device(std::move(device)),
+          m_Capacity(capacity),
+          m_PyramidPipeline(m_Device, pyramidCode,
+                            {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE}, 0,
+                            "Depth Pyramid"),
+          m_CullPipeline(m_Device, cullCode,
+                         {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                          VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER},
+                         sizeof(OcclusionCullConstants), "Occlusion Cull")
+    {
+        m_Sampler = m_Device->getSamplerCache().getSampler(SamplerDescription::nearestClamp());
+
+        for (auto& commands: m_CommandBuffers)
+        {
+            commands = std::make_unique<StorageBuffer>(m_Device, capacity * sizeof(VkDrawIndexedIndirectCommand),
+                                                       StorageBuffer::Access::DeviceOnly,
+                                                       VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+        }
+        m_VisibilityBuffer = std::make_unique<StorageBuffer>(m_Device, capacity * sizeof(uint32_t),
+                                                             StorageBuffer::Access::DeviceOnly,
+                                                             VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+
+        CORVUS_LOG(info, "Occlusion culling enabled for up to {} objects", capacity);
+    }
+
+    OcclusionCuller::~OcclusionCuller()
+    {
+        destroyPyramid();
+    }
+
+    void OcclusionCuller::cull(VkCommandBuffer commandBuffer, DescriptorSetCache& descriptorSets,
+                               const StorageBuffer& objects, uint32_t objectCount, const glm::mat4& view,
+                               const glm::mat4& projection, Phase phase)
+    {
+        CORVUS_ASSERT(objectCount <= m_Capacity, "Occlusion culler capacity of {} objects exceeded!", m_Capacity)
+        const auto& vk = m_Device->getDispatch();
+        preparePyramid(commandBuffer);
+
+        if (not m_VisibilityCleared)
+        {
+            // Nothing has been seen yet, the first phase draws nothing and the second one tests everything
+            vk.vkCmdFillBuffer(commandBuffer, m_VisibilityBuffer->getBuffer(), 0, VK_WHOLE_SIZE, 0);
+            memoryBarrier(*m_Device, commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                          VK_ACCESS_SHADER_READ_BIT bitor VK_ACCESS_SHADER_WRITE_BIT);
+            m_VisibilityCleared = true;
+        }
+
+        // The buffers are shared by all frames in flight, wait for the last frame's draws and cull to be done with them
+        memoryBarrier(*m_Device, commandBuffer,
+                      VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT bitor VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                      VK_ACCESS_INDIRECT_COMMAND_READ_BIT bitor VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT bitor VK_ACCESS_SHADER_WRITE_BIT);
+
+        auto set = descriptorSets.get(m_CullPipeline.getDescriptorSetLayout(), {
+            DescriptorWrite::buffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, objects.getBuffer()),
+            DescriptorWrite::buffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                    m_CommandBuffers[static_cast<uint32_t>(phase)]->getBuffer()),
+            DescriptorWrite::buffer(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_VisibilityBuffer->getBuffer()),
+            DescriptorWrite::image(3, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_PyramidView, m_Sampler,
+                                   VK_IMAGE_LAYOUT_GENERAL),
+        });
+
+        // The projection is reverse-Z infinite, [3][2] holds the near plane
+        OcclusionCullConstants constants = {
+            .view = view,
+            .projection = glm::vec4(projection[0][0], projection[1][1], projection[3][2], 0.0f),
+            .pyramidSize = glm::vec2(m_PyramidExtent.width, m_PyramidExtent.height),
+            .objectCount = objectCount,
+            .phase = static_cast<uint32_t>(phase),
+        };
+
+        m_CullPipeline.bind(commandBuffer, set);
+        m_CullPipeline.pushConstants(commandBuffer, constants);
+        m_CullPipeline.dispatch(commandBuffer, ComputePipeline::getGroupCount(objectCount, CULL_GROUP_SIZE));
+
+        memoryBarrier(*m_Device, commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+    }
+
+    void OcclusionCuller::buildDepthPyramid(VkCommandBuffer commandBuffer, DescriptorSetCache& descriptorSets,
+                                            VkImageView depthView)
+    {
+        preparePyramid(commandBuffer);
+
+        // The first phase's cull may still be sampling the pyramid
+        ImageUtils::transitionImageLayout(*m_Device, commandBuffer, m_PyramidImage, VK_IMAGE_LAYOUT_GENERAL,
+                                          VK_IMAGE_LAYOUT_GENERAL);
+
+        for (uint32_t level = 0; level < m_PyramidLevelViews.size(); level++)
+        {
+            auto source = level == 0
+                              ? DescriptorWrite::image(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, depthView,
+                                                       m_Sampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+                              : DescriptorWrite::image(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                                                       m_PyramidLevelViews[level - 1], m_Sampler,
+                                                       VK_IMAGE_LAYOUT_GENERAL);
+
+            auto set = descriptorSets.get(m_PyramidPipeline.getDescriptorSetLayout(), {
+                source,
+                DescriptorWrite::image(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, m_PyramidLevelViews[level],
+                                       VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL),
+            });
+            m_PyramidPipeline.bind(commandBuffer, set);
+
+            uint32_t width = std::max(1u, m_PyramidExtent.width >> level);
+            uint32_t height = std::max(1u, m_PyramidExtent.height >> level);
+            m_PyramidPipeline.dispatch(commandBuffer, ComputePipeline::getGroupCount(width, PYRAMID_GROUP_SIZE),
+                                       ComputePipeline::getGroupCount(height, PYRAMID_GROUP_SIZE));
+
+            // The next level reads this one
+            ImageUtils::transitionImageLayout(*m_Device, commandBuffer, m_PyramidImage, VK_IMAGE_LAYOUT_GENERAL,
+                                              VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_ASPECT_COLOR_BIT, level, 1);
+        }
+    }
+
+    void OcclusionCuller::drawIndirect(VkCommandBuffer commandBuffer, Phase phase, uint32_t first,
+                                       uint32_t count) const
+    {
+        const auto& vk = m_Device->getDispatch();
+        auto buffer = m_CommandBuffers[static_cast<uint32_t>(phase)]->getBuffer();
+        constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+
+        // Culled objects stay in the buffer with an instance count of 0, the GPU skips them
+        if (m_Device->getEnabledFeatures().multiDrawIndirect)
+        {
+            vk.vkCmdDrawIndexedIndirect(commandBuffer, buffer, first * stride, count, stride);
+            return;
+        }
+
+        for (uint32_t i = first; i < first + count; i++)
+            vk.vkCmdDrawIndexedIndirect(commandBuffer, buffer, i * stride, 1, stride);
+    }
+
+    void OcclusionCuller::preparePyramid(VkCommandBuffer commandBuffer)
+    {
+        // Level 0 is the largest power of two that fits, so every level halves exactly and a texel of any level
+        // covers a whole number of texels of the level below
+        auto extent = m_Device->getSwapChain().getExtent();
+        VkExtent2D pyramidExtent = {std::bit_floor(extent.width), std::bit_floor(extent.height)};
+
+        if (pyramidExtent.width != m_PyramidExtent.width or pyramidExtent.height != m_PyramidExtent.height)
+        {
+            // Only happens after the swapchain was recreated, which already waited for the device to go idle
+            if (m_PyramidImage != VK_NULL_HANDLE)
+                m_Device->getDispatch().vkDeviceWaitIdle(m_Device->getDevice());
+
+            destroyPyramid();
+            createPyramid(pyramidExtent);
+        }
+
+        if (not m_PyramidInitialized)
+        {
+            ImageUtils::transitionImageLayout(*m_Device, commandBuffer, m_PyramidImage, VK_IMAGE_LAYOUT_UNDEFINED,
+                                              VK_IMAGE_LAYOUT_GENERAL);
+            m_PyramidInitialized = true;
+        }
+    }
+
+    void OcclusionCuller::createPyramid(VkExtent2D extent)
+    {
+        m_PyramidExtent = extent;
+        auto levelCount = static_cast<uint32_t>(std::bit_width(std::max(extent.width, extent.height)));
+
+        ImageUtils::createImage(*m_Device, extent, VK_FORMAT_R32_SFLOAT,
+                                VK_IMAGE_USAGE_STORAGE_BIT bitor VK_IMAGE_USAGE_SAMPLED_BIT,
+                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_PyramidImage, m_PyramidMemory, levelCount);
+        m_PyramidView = ImageUtils::createImageView(*m_Device, m_PyramidImage, VK_FORMAT_R32_SFLOAT,
+                                                    VK_IMAGE_ASPECT_COLOR_BIT, levelCount);
+
+        m_PyramidLevelViews.resize(levelCount);
+        for (uint32_t level = 0; level < levelCount; level++)
+        {
+            VkImageViewCreateInfo viewInfo = {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+                .image = m_PyramidImage,
+                .viewType = VK_IMAGE_VIEW_TYPE_2D,
+                .format = VK_FORMAT_R32_SFLOAT,
+                .subresourceRange = {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .baseMipLevel = level,
+                    .levelCount = 1,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1
+                }
+            };
+
+            auto success = m_Device->getDispatch().vkCreateImageView(m_Device->getDevice(), &viewInfo, nullptr,
+                                                                     &m_PyramidLevelViews[level]);
+            CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create depth pyramid level view!")
+        }
+
+        m_PyramidInitialized = false;
+        CORVUS_LOG(info, "Depth pyramid created at {}x{} with {} levels", extent.width, extent.height, levelCount);
+    }
+
+    void OcclusionCuller::destroyPyramid()
+    {
+        if (m_PyramidImage == VK_NULL_HANDLE)
+            return;
+
+        const auto& vk = m_Device->getDispatch();
+        for (auto view: m_PyramidLevelViews)
+            vk.vkDestroyImageView(m_Device->getDevice(), view, nullptr);
+        m_PyramidLevelViews.clear();
+
+        vk.vkDestroyImageView(m_Device->getDevice(), m_PyramidView, nullptr);
+        vk.vkDestroyImage(m_Device->getDevice(), m_PyramidImage, nullptr);
+        vk.vkFreeMemory(m_Device->getDevice(), m_PyramidMemory, nullptr);
+        m_PyramidView = VK_NULL_HANDLE;
+        m_PyramidImage = VK_NULL_HANDLE;
+        m_PyramidMemory = VK_NULL_HANDLE;
+        m_PyramidExtent = {0, 0};
+    }
+} // Corvus
@@ -0,0 +1,85 @@
+#ifndef ENGINE_OCCLUSIONCULLER_H
+#define ENGINE_OCCLUSIONCULLER_H
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "Graphic/Vulkan/ComputePipeline.h"
+#include "Graphic/Vulkan/DescriptorSetCache.h"
+#include "Graphic/Vulkan/Device.h"
+#include "Graphic/Vulkan/PushConstants.h"
+#include "Graphic/Vulkan/StorageBuffer.h"
+
+namespace Corvus
+{
+    // Must match the push constant block of Shaders/occlusionCull.glsl
+    struct OcclusionCullConstants
+    {
+        glm::mat4 view;
+        glm::vec4 projection; // P00, P11, near plane
+        glm::vec2 pyramidSize;
+        uint32_t objectCount;
+        uint32_t phase;
+    };
+    static_assert(PushConstantData<OcclusionCullConstants>);
+
+    // Two-phase occlusion culling against a hierarchical depth buffer. The first phase draws whatever was visible
+    // last frame, its depth is reduced into a min pyramid, and the second phase tests every object against that
+    // pyramid and draws only the ones that were hidden last frame but are visible now. Visibility persists per
+    // objectIndex, objects are fed in through a GpuObject buffer and come back as indirect draws in the same order.
+    class OcclusionCuller
+    {
+    public:
+        enum class Phase : uint32_t { Previous = 0, Revealed = 1 };
+
+        OcclusionCuller(std::shared_ptr<Device> device, const std::vector<char>& pyramidCode,
+                        const std::vector<char>& cullCode, uint32_t capacity);
+        ~OcclusionCuller();
+
+        OcclusionCuller(const OcclusionCuller&) = delete;
+        OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+        // Writes one indirect command per object into the phase's command buffer, objectIndex must stay below the
+        // capacity. Ends with a barrier making the commands visible to drawIndirect.
+        void cull(VkCommandBuffer commandBuffer, DescriptorSetCache& descriptorSets, const StorageBuffer& objects,
+                  uint32_t objectCount, const glm::mat4& view, const glm::mat4& projection, Phase phase);
+
+        // Reduces the depth attachment into the pyramid, the depth image has to be in SHADER_READ_ONLY_OPTIMAL
+        void buildDepthPyramid(VkCommandBuffer commandBuffer, DescriptorSetCache& descriptorSets,
+                               VkImageView depthView);
+
+        // Draws the objects in [first, first + count), which must share the pipeline and mesh bound by the caller
+        void drawIndirect(VkCommandBuffer commandBuffer, Phase phase, uint32_t first, uint32_t count) const;
+
+        [[nodiscard]] uint32_t getCapacity() const { return m_Capacity; }
+        [[nodiscard]] VkExtent2D getPyramidExtent() const { return m_PyramidExtent; }
+
+    private:
+        std::shared_ptr<Device> m_Device;
+        uint32_t m_Capacity;
+
+        ComputePipeline m_PyramidPipeline;
+        ComputePipeline m_CullPipeline;
+        VkSampler m_Sampler = VK_NULL_HANDLE; // Owned by the device's sampler cache
+
+        VkImage m_PyramidImage = VK_NULL_HANDLE;
+        VkDeviceMemory m_PyramidMemory = VK_NULL_HANDLE;
+        VkImageView m_PyramidView = VK_NULL_HANDLE; // All levels, sampled by the cull shader
+        std::vector<VkImageView> m_PyramidLevelViews; // One per level, written by the reduction
+        VkExtent2D m_PyramidExtent = {0, 0};
+        bool m_PyramidInitialized = false;
+
+        std::array<std::unique_ptr<StorageBuffer>, 2> m_CommandBuffers; // One per phase
+        std::unique_ptr<StorageBuffer> m_VisibilityBuffer;
+        bool m_VisibilityCleared = false;
+
+    private:
+
+        void preparePyramid(VkCommandBuffer commandBuffer);
+        void createPyramid(VkExtent2D extent);
+        void destroyPyramid();
+    };
+} // Corvus
+
+#endif //ENGINE_OCCLUSIONCULLER_H
@@ -0,0 +1,336 @@
+#include "ParticleSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+#include "Graphic/Vulkan/BufferUtils.h"
+#include "Graphic/Vulkan/UniformBuffer.h"
+
+namespace Corvus
+{
+    namespace
+    {
+        constexpr uint32_t COUNTER_MODE_BEGIN = 0;
+        constexpr uint32_t COUNTER_MODE_END = 1;
+        constexpr uint32_t SORT_KEY_BITS = 16; // Half float distances, see Shaders/particleSimulate.glsl
+        constexpr float MAX_TIME_STEP = 0.1f; // Longer frames slow the simulation down instead of tunneling
+
+        // Fills a device local buffer once through a staging buffer
+        void uploadBuffer(const Device& device, const StorageBuffer& buffer, const void* data, VkDeviceSize size)
+        {
+            const auto& vk = device.getDispatch();
+            VkBuffer stagingBuffer;
+            VkDeviceMemory stagingBufferMemory;
+            BufferUtils::createBuffer(device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT bitor VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                      stagingBuffer, stagingBufferMemory);
+
+            void* mapped;
+            vk.vkMapMemory(device.getDevice(), stagingBufferMemory, 0, size, 0, &mapped);
+            std::memcpy(mapped, data, size);
+            vk.vkUnmapMemory(device.getDevice(), stagingBufferMemory);
+
+            BufferUtils::copyBuffer(device, stagingBuffer, buffer.getBuffer(), size);
+
+            vk.vkDestroyBuffer(device.getDevice(), stagingBuffer, nullptr);
+            vk.vkFreeMemory(device.getDevice(), stagingBufferMemory, nullptr);
+        }
+    }
+
+    ParticleSystem::ParticleSystem(std::shared_ptr<Device> device, const ParticleSettings& settings,
+                                   uint32_t framesInFlight)
+        : m_Device(std::move(device)),
+          m_Settings(settings),
+          m_CounterPipeline(m_Device, settings.countersShader, {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},
+                            sizeof(ParticleCounterConstants), "Particle Counters"),
+          m_EmitPipeline(m_Device, settings.emitShader,
+                         std::vector<VkDescriptorType>(5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+                         sizeof(ParticleEmitConstants), "Particle Emit"),
+          m_SimulatePipeline(m_Device, settings.simulateShader, {
+                                 VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                 VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                 VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                 VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER
+                             }, sizeof(ParticleSimulateConstants), "Particle Simulate"),
+          m_GatherPipeline(m_Device, settings.gatherShader,
+                           std::vector<VkDescriptorType>(4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+                           sizeof(ParticleGatherConstants), "Particle Gather"),
+          // Billboards are generated from the vertex index, there is no vertex input
+          m_DrawPipeline(m_Device, settings.vertexShader, settings.fragmentShader, DepthMode::ReadOnly, {},
+                         settings.blendMode)
+    {
+        CORVUS_ASSERT(settings.maxParticles > 0 and settings.maxEmitters > 0,
+                      "Particles need room for at least one particle and emitter!")
+        constexpr auto access = StorageBuffer::Access::DeviceOnly;
+        uint32_t maxParticles = settings.maxParticles;
+
+        m_Counters = std::make_unique<StorageBuffer>(m_Device, sizeof(ParticleCounters), access,
+                                                     VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT bitor
+                                                     VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+        m_Particles = std::make_unique<StorageBuffer>(m_Device, maxParticles * sizeof(GpuParticle), access);
+        m_DeadList = std::make_unique<StorageBuffer>(m_Device, maxParticles * sizeof(uint32_t), access,
+                                                     VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+        for (auto& aliveList: m_AliveLists)
+            aliveList = std::make_unique<StorageBuffer>(m_Device, maxParticles * sizeof(uint32_t), access);
+        m_DrawData = std::make_unique<StorageBuffer>(m_Device, maxParticles * sizeof(glm::vec4) * 2, access);
+
+        if (settings.sort)
+        {
+            m_SortKeys = std::make_unique<StorageBuffer>(m_Device, maxParticles * sizeof(uint32_t), access,
+                                                         VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+            m_Sorter = std::make_unique<ComputePrimitives>(m_Device, maxParticles, settings.sortShaders);
+        }
+
+        m_EmitterBuffers.resize(framesInFlight);
+        for (auto& emitters: m_EmitterBuffers)
+        {
+            emitters = std::make_unique<StorageBuffer>(m_Device, settings.maxEmitters * sizeof(GpuParticleEmitter),
+                                                       StorageBuffer::Access::HostWrite);
+        }
+
+        m_DepthSampler = m_Device->getSamplerCache().getSampler(SamplerDescription::nearestClamp());
+        uploadInitialState();
+        CORVUS_LOG(info, "GPU particles enabled for {} particles{}", maxParticles,
+                   settings.sort ? ", sorted back to front" : "");
+    }
+
+    ParticleEmitterHandle ParticleSystem::addEmitter(const ParticleEmitter& emitter)
+    {
+        ParticleEmitterHandle handle;
+        if (not m_FreeEmitters.empty())
+        {
+            handle = m_FreeEmitters.back();
+            m_FreeEmitters.pop_back();
+        }
+        else
+        {
+            CORVUS_ASSERT(m_Emitters.size() < m_Settings.maxEmitters, "More than {} particle emitters added!",
+                          m_Settings.maxEmitters)
+            handle = static_cast<ParticleEmitterHandle>(m_Emitters.size());
+            m_Emitters.emplace_back();
+        }
+
+        m_Emitters[handle] = {.emitter = emitter, .pendingSpawns = 0.0f, .burst = 0, .active = true};
+        return handle;
+    }
+
+    void ParticleSystem::removeEmitter(ParticleEmitterHandle handle)
+    {
+        // Its particles live out their lifetime, only spawning stops
+        CORVUS_ASSERT(handle < m_Emitters.size() and m_Emitters[handle].active, "Unknown particle emitter {}!",
+                      handle)
+        m_Emitters[handle].active = false;
+        m_FreeEmitters.push_back(handle);
+    }
+
+    void ParticleSystem::emit(ParticleEmitterHandle handle, uint32_t count)
+    {
+        CORVUS_ASSERT(handle < m_Emitters.size() and m_Emitters[handle].active, "Unknown particle emitter {}!",
+                      handle)
+        m_Emitters[handle].burst += count;
+    }
+
+    void ParticleSystem::simulate(VkCommandBuffer commandBuffer, DescriptorSetCache& descriptorSets, uint32_t frame,
+                                  VkImageView depthView, VkExtent2D extent, const glm::mat4& view,
+                                  const glm::mat4& projection)
+    {
+        const auto& vk = m_Device->getDispatch();
+        auto now = std::chrono::steady_clock::now();
+        float deltaTime = m_Simulated ? std::chrono::duration<float>(now - m_LastSimulation).count() : 0.0f;
+        deltaTime = std::min(deltaTime, MAX_TIME_STEP);
+        m_LastSimulation = now;
+        m_Simulated = true;
+
+        uint32_t requestedSpawns = writeEmitters(frame, deltaTime);
+        uint32_t current = m_Parity;
+        uint32_t next = 1 - m_Parity;
+        auto counters = m_Counters->getBuffer();
+        auto computeBarrier = [&]
+        {
+            memoryBarrier(*m_Device, commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT bitor VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                          VK_ACCESS_SHADER_READ_BIT bitor VK_ACCESS_SHADER_WRITE_BIT bitor
+                          VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+        };
+
+        // Last frame's draw has to be done with the draw data and its command before they are rewritten
+        memoryBarrier(*m_Device, commandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT bitor
+                      VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, 0, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT bitor
+                      VK_PIPELINE_STAGE_TRANSFER_BIT, 0);
+        if (m_Sorter)
+        {
+            // Keys of unused slots stay at the maximum and sort behind every live particle
+            vk.vkCmdFillBuffer(commandBuffer, m_SortKeys->getBuffer(), 0, VK_WHOLE_SIZE, UINT32_MAX);
+            memoryBarrier(*m_Device, commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT);
+        }
+
+        auto counterSet = descriptorSets.get(m_CounterPipeline.getDescriptorSetLayout(), {
+            DescriptorWrite::storageBuffer(0, counters),
+        });
+        m_CounterPipeline.bind(commandBuffer, counterSet);
+        m_CounterPipeline.pushConstants(commandBuffer, ParticleCounterConstants{
+            .mode = COUNTER_MODE_BEGIN,
+            .requestedSpawns = requestedSpawns,
+            .parity = current,
+        });
+        m_CounterPipeline.dispatch(commandBuffer, 1);
+        computeBarrier();
+
+        if (requestedSpawns > 0)
+        {
+            auto emitSet = descriptorSets.get(m_EmitPipeline.getDescriptorSetLayout(), {
+                DescriptorWrite::storageBuffer(0, counters),
+                DescriptorWrite::storageBuffer(1, m_EmitterBuffers[frame]->getBuffer()),
+                DescriptorWrite::storageBuffer(2, m_Particles->getBuffer()),
+                DescriptorWrite::storageBuffer(3, m_DeadList->getBuffer()),
+                DescriptorWrite::storageBuffer(4, m_AliveLists[current]->getBuffer()),
+            });
+            m_EmitPipeline.bind(commandBuffer, emitSet);
+            m_EmitPipeline.pushConstants(commandBuffer, ParticleEmitConstants{
+                .emitterCount = static_cast<uint32_t>(m_GpuEmitters.size()),
+                .parity = current,
+            });
+            m_EmitPipeline.dispatch(commandBuffer, ComputePipeline::getGroupCount(requestedSpawns, EMIT_GROUP_SIZE));
+            computeBarrier();
+        }
+
+        // Without sorting the keys are never written, any storage buffer satisfies the binding
+        auto simulateSet = descriptorSets.get(m_SimulatePipeline.getDescriptorSetLayout(), {
+            DescriptorWrite::storageBuffer(0, counters),
+            DescriptorWrite::storageBuffer(1, m_Particles->getBuffer()),
+            DescriptorWrite::storageBuffer(2, m_DeadList->getBuffer()),
+            DescriptorWrite::storageBuffer(3, m_AliveLists[current]->getBuffer()),
+            DescriptorWrite::storageBuffer(4, m_AliveLists[next]->getBuffer()),
+            DescriptorWrite::storageBuffer(5, m_Sorter ? m_SortKeys->getBuffer() : m_DrawData->getBuffer()),
+            DescriptorWrite::image(6, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, depthView, m_DepthSampler),
+        });
+        ParticleSimulateConstants constants = {
+            .view = view,
+            .projection = glm::vec4(projection[0][0], projection[1][1], projection[3][2], 0.0f), // Reverse-Z
+            .gravityDrag = glm::vec4(m_Settings.gravity, m_Settings.drag),
+            .viewportSize = glm::vec2(extent.width, extent.height),
+            .deltaTime = deltaTime,
+            .collisionThickness = m_Settings.collisionThickness,
+            .restitution = m_Settings.restitution,
+            .parity = current,
+            .collide = m_Settings.depthCollision ? 1u : 0u,
+            .sort = m_Sorter ? 1u : 0u,
+        };
+        m_SimulatePipeline.bind(commandBuffer, simulateSet);
+        m_SimulatePipeline.pushConstants(commandBuffer, constants);
+        m_SimulatePipeline.dispatchIndirect(commandBuffer, counters, offsetof(ParticleCounters, simulateGroups));
+        computeBarrier();
+
+        m_CounterPipeline.bind(commandBuffer, counterSet);
+        m_CounterPipeline.pushConstants(commandBuffer, ParticleCounterConstants{
+            .mode = COUNTER_MODE_END,
+            .requestedSpawns = 0,
+            .parity = current,
+        });
+        m_CounterPipeline.dispatch(commandBuffer, 1);
+
+        // The live count is only known on the GPU, so the whole pool is sorted with dead slots at the end
+        if (m_Sorter)
+        {
+            m_Sorter->sortKeyValues(commandBuffer, descriptorSets, *m_SortKeys, m_AliveLists[next].get(),
+                                    m_Settings.maxParticles, ComputePrimitives::KeyWidth::Bits32, SORT_KEY_BITS);
+        }
+        computeBarrier();
+
+        // Survivors never outnumber what the simulation covered, so its group count fits the gather as well
+        auto gatherSet = descriptorSets.get(m_GatherPipeline.getDescriptorSetLayout(), {
+            DescriptorWrite::storageBuffer(0, counters),
+            DescriptorWrite::storageBuffer(1, m_Particles->getBuffer()),
+            DescriptorWrite::storageBuffer(2, m_AliveLists[next]->getBuffer()),
+            DescriptorWrite::storageBuffer(3, m_DrawData->getBuffer()),
+        });
+        m_GatherPipeline.bind(commandBuffer, gatherSet);
+        m_GatherPipeline.pushConstants(commandBuffer, ParticleGatherConstants{.parity = current});
+        m_GatherPipeline.dispatchIndirect(commandBuffer, counters, offsetof(ParticleCounters, simulateGroups));
+
+        memoryBarrier(*m_Device, commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT bitor VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                      VK_ACCESS_INDIRECT_COMMAND_READ_BIT bitor VK_ACCESS_SHADER_READ_BIT);
+        m_Parity = next;
+    }
+
+    void ParticleSystem::draw(VkCommandBuffer commandBuffer, DescriptorSetCache& descriptorSets,
+                              VkBuffer uniformBuffer) const
+    {
+        const auto& vk = m_Device->getDispatch();
+        auto set = descriptorSets.get(m_DrawPipeline.getDescriptorSetLayout(), {
+            DescriptorWrite::buffer(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, uniformBuffer, 0,
+                                    sizeof(UniformBufferObject)),
+            DescriptorWrite::storageBuffer(1, m_DrawData->getBuffer()),
+        });
+
+        vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_DrawPipeline.getPipeline());
+        vk.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_DrawPipeline.getPipelineLayout(),
+                                   0, 1, &set, 0, nullptr);
+        vk.vkCmdDrawIndirect(commandBuffer, m_Counters->getBuffer(), offsetof(ParticleCounters, drawCommand), 1,
+                             sizeof(VkDrawIndirectCommand));
+    }
+
+    void ParticleSystem::uploadInitialState()
+    {
+        // Every particle starts out dead
+        std::vector<uint32_t> deadList(m_Settings.maxParticles);
+        std::iota(deadList.begin(), deadList.end(), 0u);
+        uploadBuffer(*m_Device, *m_DeadList, deadList.data(), deadList.size() * sizeof(uint32_t));
+
+        ParticleCounters counters = {
+            .deadCount = m_Settings.maxParticles,
+            .aliveCounts = {0, 0},
+            .spawnCount = 0,
+            .simulateGroups = {.x = 0, .y = 1, .z = 1},
+            .padding = 0,
+            .drawCommand = {.vertexCount = 6, .instanceCount = 0, .firstVertex = 0, .firstInstance = 0},
+        };
+        uploadBuffer(*m_Device, *m_Counters, &counters, sizeof(counters));
+    }
+
+    uint32_t ParticleSystem::writeEmitters(uint32_t frame, float deltaTime)
+    {
+        m_GpuEmitters.clear();
+        m_Seed++;
+        uint32_t spawns = 0;
+        for (uint32_t handle = 0; handle < m_Emitters.size(); handle++)
+        {
+            auto& slot = m_Emitters[handle];
+            if (not slot.active)
+                continue;
+
+            const auto& emitter = slot.emitter;
+            slot.pendingSpawns += emitter.rate * deltaTime;
+            float whole = std::floor(slot.pendingSpawns);
+            slot.pendingSpawns -= whole;
+
+            // More than the pool holds could never spawn anyway, the begin step drops what does not fit
+            uint32_t count = std::min(static_cast<uint32_t>(whole) + slot.burst, m_Settings.maxParticles - spawns);
+            slot.burst = 0;
+            if (count == 0)
+                continue;
+
+            m_GpuEmitters.push_back({
+                .positionRadius = glm::vec4(emitter.position, emitter.radius),
+                .velocitySpread = glm::vec4(emitter.velocity, emitter.velocitySpread),
+                .startColor = emitter.startColor,
+                .endColor = emitter.endColor,
+                .lifetime = glm::vec2(emitter.minLifetime, emitter.maxLifetime),
+                .size = glm::vec2(emitter.startSize, emitter.endSize),
+                .firstSpawn = spawns,
+                .spawnCount = count,
+                .seed = (m_Seed * 0x9E3779B9u) ^ (handle * 0x85EBCA6Bu),
+                .padding = 0,
+            });
+            spawns += count;
+        }
+
+        std::memcpy(m_EmitterBuffers[frame]->getMappedData(), m_GpuEmitters.data(),
+                    m_GpuEmitters.size() * sizeof(GpuParticleEmitter));
+        return spawns;
+    }
+} // Corvus
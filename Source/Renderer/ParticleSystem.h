@@ -0,0 +1,213 @@
+#ifndef ENGINE_PARTICLESYSTEM_H
+#define ENGINE_PARTICLESYSTEM_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Graphic/Vulkan/ComputePipeline.h"
+#include "Graphic/Vulkan/DescriptorSetCache.h"
+#include "Graphic/Vulkan/Device.h"
+#include "Graphic/Vulkan/Pipeline.h"
+#include "Graphic/Vulkan/PushConstants.h"
+#include "Graphic/Vulkan/StorageBuffer.h"
+#include "ComputePrimitives.h"
+
+namespace Corvus
+{
+    using ParticleEmitterHandle = uint32_t;
+
+    struct ParticleSettings
+    {
+        uint32_t maxParticles = 1 << 20;
+        uint32_t maxEmitters = 256;
+        glm::vec3 gravity = glm::vec3(0.0f, -9.81f, 0.0f);
+        float drag = 0.1f; // Fraction of the velocity lost per second
+        // Particles bounce off the depth buffer, restitution is the fraction of the velocity kept
+        bool depthCollision = true;
+        float collisionThickness = 0.5f;
+        float restitution = 0.5f;
+        // Draw back to front for correct alpha blending. Sorts the whole pool every frame, additive effects
+        // look the same unsorted and can skip it.
+        bool sort = true;
+        BlendMode blendMode = BlendMode::Alpha;
+
+        std::string countersShader = "Shaders/particleCounters.glsl.spv";
+        std::string emitShader = "Shaders/particleEmit.glsl.spv";
+        std::string simulateShader = "Shaders/particleSimulate.glsl.spv";
+        std::string gatherShader = "Shaders/particleGather.glsl.spv";
+        std::string vertexShader = "Shaders/particleVertexShader.glsl.spv";
+        std::string fragmentShader = "Shaders/particleFragmentShader.glsl.spv";
+        ComputePrimitiveShaders sortShaders;
+    };
+
+    // Spawns particles continuously at rate per second, plus whatever emit() asks for on top
+    struct ParticleEmitter
+    {
+        glm::vec3 position = glm::vec3(0.0f);
+        float radius = 0.0f; // Particles spawn anywhere inside the sphere
+        glm::vec3 velocity = glm::vec3(0.0f, 1.0f, 0.0f);
+        float velocitySpread = 0.5f; // Largest random deviation per axis
+        glm::vec4 startColor = glm::vec4(1.0f);
+        glm::vec4 endColor = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f);
+        float minLifetime = 1.0f;
+        float maxLifetime = 2.0f;
+        float startSize = 0.1f;
+        float endSize = 0.1f;
+        float rate = 100.0f;
+    };
+
+    // Must match Shaders/Include/Particles.glslh
+    struct GpuParticle
+    {
+        glm::vec3 position;
+        float age;
+        glm::vec3 velocity;
+        float lifetime;
+        uint32_t startColor;
+        uint32_t endColor;
+        float startSize;
+        float endSize;
+    };
+    static_assert(sizeof(GpuParticle) == 48, "GpuParticle must match the shader struct layout");
+
+    struct GpuParticleEmitter
+    {
+        glm::vec4 positionRadius;
+        glm::vec4 velocitySpread;
+        glm::vec4 startColor;
+        glm::vec4 endColor;
+        glm::vec2 lifetime;
+        glm::vec2 size;
+        uint32_t firstSpawn;
+        uint32_t spawnCount;
+        uint32_t seed;
+        uint32_t padding;
+    };
+    static_assert(sizeof(GpuParticleEmitter) == 96, "GpuParticleEmitter must match the shader struct layout");
+
+    struct ParticleCounters
+    {
+        uint32_t deadCount;
+        uint32_t aliveCounts[2];
+        uint32_t spawnCount;
+        VkDispatchIndirectCommand simulateGroups;
+        uint32_t padding;
+        VkDrawIndirectCommand drawCommand;
+    };
+    static_assert(offsetof(ParticleCounters, drawCommand) == 32, "ParticleCounters must match the shader layout");
+
+    // Must match the push constant blocks of the particle shaders
+    struct ParticleCounterConstants
+    {
+        uint32_t mode;
+        uint32_t requestedSpawns;
+        uint32_t parity;
+    };
+    static_assert(PushConstantData<ParticleCounterConstants>);
+
+    struct ParticleEmitConstants
+    {
+        uint32_t emitterCount;
+        uint32_t parity;
+    };
+    static_assert(PushConstantData<ParticleEmitConstants>);
+
+    struct ParticleSimulateConstants
+    {
+        glm::mat4 view;
+        glm::vec4 projection; // P00, P11, near plane
+        glm::vec4 gravityDrag;
+        glm::vec2 viewportSize;
+        float deltaTime;
+        float collisionThickness;
+        float restitution;
+        uint32_t parity;
+        uint32_t collide;
+        uint32_t sort;
+    };
+    static_assert(PushConstantData<ParticleSimulateConstants>);
+
+    struct ParticleGatherConstants
+    {
+        uint32_t parity;
+    };
+    static_assert(PushConstantData<ParticleGatherConstants>);
+
+    // Particles live entirely on the GPU. A fixed pool is handed out through a dead list, emitters spawn into it
+    // on compute, the simulation recycles expired particles and keeps the survivors in ping-ponged alive lists,
+    // and a single indirect draw reads its instance count from the GPU. Per frame the CPU only writes emitters.
+    class ParticleSystem
+    {
+    public:
+        static constexpr uint32_t EMIT_GROUP_SIZE = 64;
+        static constexpr uint32_t SIMULATE_GROUP_SIZE = 256;
+
+        ParticleSystem(std::shared_ptr<Device> device, const ParticleSettings& settings, uint32_t framesInFlight);
+
+        ParticleSystem(const ParticleSystem&) = delete;
+        ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+        [[nodiscard]] ParticleEmitterHandle addEmitter(const ParticleEmitter& emitter);
+        void removeEmitter(ParticleEmitterHandle handle);
+        // Parameters may be changed at any time, they are picked up by the next simulate()
+        [[nodiscard]] ParticleEmitter& getEmitter(ParticleEmitterHandle handle) { return m_Emitters[handle].emitter; }
+        // One-off burst on top of the emitter's rate
+        void emit(ParticleEmitterHandle handle, uint32_t count);
+
+        // Spawns, simulates and prepares this frame's draw. The depth image has to be in
+        // SHADER_READ_ONLY_OPTIMAL and hold this frame's opaque depth, it is only read with depth collision.
+        void simulate(VkCommandBuffer commandBuffer, DescriptorSetCache& descriptorSets, uint32_t frame,
+                      VkImageView depthView, VkExtent2D extent, const glm::mat4& view, const glm::mat4& projection);
+
+        // Must be recorded inside rendering on the graphics queue after simulate()
+        void draw(VkCommandBuffer commandBuffer, DescriptorSetCache& descriptorSets, VkBuffer uniformBuffer) const;
+
+        [[nodiscard]] const ParticleSettings& getSettings() const { return m_Settings; }
+
+    private:
+        struct EmitterSlot
+        {
+            ParticleEmitter emitter;
+            float pendingSpawns = 0.0f; // Fraction of a particle carried over to the next frame
+            uint32_t burst = 0;
+            bool active = false;
+        };
+
+        std::shared_ptr<Device> m_Device;
+        ParticleSettings m_Settings;
+
+        ComputePipeline m_CounterPipeline;
+        ComputePipeline m_EmitPipeline;
+        ComputePipeline m_SimulatePipeline;
+        ComputePipeline m_GatherPipeline;
+        Pipeline m_DrawPipeline;
+        std::unique_ptr<ComputePrimitives> m_Sorter; // Only when sorting
+        VkSampler m_DepthSampler = VK_NULL_HANDLE; // Owned by the device's sampler cache
+
+        std::unique_ptr<StorageBuffer> m_Counters;
+        std::unique_ptr<StorageBuffer> m_Particles;
+        std::unique_ptr<StorageBuffer> m_DeadList;
+        std::array<std::unique_ptr<StorageBuffer>, 2> m_AliveLists;
+        std::unique_ptr<StorageBuffer> m_SortKeys;
+        std::unique_ptr<StorageBuffer> m_DrawData;
+        std::vector<std::unique_ptr<StorageBuffer>> m_EmitterBuffers; // One per frame in flight
+
+        std::vector<EmitterSlot> m_Emitters;
+        std::vector<ParticleEmitterHandle> m_FreeEmitters;
+        std::vector<GpuParticleEmitter> m_GpuEmitters;
+        uint32_t m_Parity = 0; // Alive list read by the next simulation
+        uint32_t m_Seed = 0;
+        std::chrono::steady_clock::time_point m_LastSimulation;
+        bool m_Simulated = false;
+
+    private:
+        void uploadInitialState();
+        uint32_t writeEmitters(uint32_t frame, float deltaTime);
+    };
+} // Corvus
+
+#endif //ENGINE_PARTICLESYSTEM_H
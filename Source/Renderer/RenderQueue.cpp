@@ -0,0 +1,57 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "Utility/RadixSort.h"
+
+namespace Corvus
+{
+    namespace
+    {
+        // Positive floats keep their order when compared as integers, the upper half is precise enough for sorting
+        uint64_t quantizeDepth(float depth)
+        {
+            return std::bit_cast<uint32_t>(std::max(depth, 0.0f)) >> 16;
+        }
+    }
+
+    void RenderQueue::submit(const DrawPacket& packet)
+    {
+        m_Packets.push_back(packet);
+        m_Keys.push_back(makeSortKey(packet));
+    }
+
+    void RenderQueue::sort(ThreadPool& threadPool)
+    {
+        // The submitted keys stay in packet order, so sorting again after more submits starts from scratch
+        m_Order.resize(m_Packets.size());
+        for (uint32_t i = 0; i < m_Order.size(); i++)
+            m_Order[i] = i;
+
+        m_SortedKeys.assign(m_Keys.begin(), m_Keys.end());
+        radixSort(m_SortedKeys, m_Order, threadPool);
+    }
+
+    void RenderQueue::clear()
+    {
+        m_Packets.clear();
+        m_Keys.clear();
+        m_SortedKeys.clear();
+        m_Order.clear();
+    }
+
+    uint64_t RenderQueue::makeSortKey(const DrawPacket& packet)
+    {
+        uint64_t pass = static_cast<uint64_t>(packet.pass) & 0xF;
+        uint64_t pipeline = packet.pipeline & 0xFFF;
+        uint64_t material = packet.material & 0xFFFF;
+        uint64_t mesh = packet.mesh & 0xFFFF;
+        uint64_t depth = quantizeDepth(packet.depth);
+
+        if (packet.pass == RenderPassType::Transparent)
+            return pass << 60 | (0xFFFF - depth) << 44 | pipeline << 32 | material << 16 | mesh;
+
+        return pass << 60 | pipeline << 48 | material << 32 | depth << 16 | mesh;
+    }
+} // Corvus
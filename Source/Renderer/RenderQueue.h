@@ -0,0 +1,80 @@
+#ifndef ENGINE_RENDERQUEUE_H
+#define ENGINE_RENDERQUEUE_H
+
+#include <cstdint>
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include "Mesh.h"
+#include "Utility/ThreadPool.h"
+
+namespace Corvus
+{
+    using PipelineHandle = uint32_t;
+
+    // Executed in this order, the pass occupies the top bits of the sort key
+    enum class RenderPassType : uint8_t { Opaque, Transparent };
+
+    // One object to draw, submitted by the game side every frame
+    struct DrawPacket
+    {
+        MeshHandle mesh = 0;
+        PipelineHandle pipeline = 0;
+        uint32_t material = 0;
+        RenderPassType pass = RenderPassType::Opaque;
+        float depth = 0.0f; // Distance to the camera, only used for ordering
+
+        glm::mat4 model = glm::mat4(1.0f);
+        uint32_t objectIndex = 0;
+        uint32_t lod = 0; // Level of detail of the mesh, picked by Renderer::selectLod
+    };
+
+    // Collects draw packets and orders them by a 64-bit key so consecutive draws share as much state as possible.
+    // Key layout, most significant first:
+    //   Opaque:      pass(4) | pipeline(12) | material(16) | depth(16) | mesh(16)
+    //   Transparent: pass(4) | inverted depth(16) | pipeline(12) | material(16) | mesh(16)
+    // Transparent draws have to be blended back to front, so depth takes precedence over state there.
+    class RenderQueue
+    {
+    public:
+        void submit(const DrawPacket& packet);
+        void sort(ThreadPool& threadPool = ThreadPool::getInstance());
+        void clear();
+
+        [[nodiscard]] static uint64_t makeSortKey(const DrawPacket& packet);
+
+        [[nodiscard]] size_t getSize() const { return m_Packets.size(); }
+        [[nodiscard]] bool isEmpty() const { return m_Packets.empty(); }
+
+        // Visits the packets in key order, only valid after sort()
+        template<typename Function>
+        void forEachSorted(Function&& function) const
+        {
+            for (uint32_t index: m_Order)
+                function(m_Packets[index]);
+        }
+
+        // Visits the packets of one pass in key order, the pass bits lead the key so they are contiguous
+        template<typename Function>
+        void forEachSorted(RenderPassType pass, Function&& function) const
+        {
+            for (uint32_t index: m_Order)
+            {
+                if (m_Packets[index].pass == pass)
+                    function(m_Packets[index]);
+                else if (m_Packets[index].pass > pass)
+                    break;
+            }
+        }
+
+    private:
+        std::vector<DrawPacket> m_Packets;
+        std::vector<uint64_t> m_Keys; // Per packet
+        std::vector<uint64_t> m_SortedKeys; // Scratch of sort(), in m_Order
+        std::vector<uint32_t> m_Order;
+    };
+} // Corvus
+
+#endif //ENGINE_RENDERQUEUE_H
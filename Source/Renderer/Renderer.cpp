@@ -7,51 +7,251 @@
 #include <utility>
 #include <vulkan/vk_enum_string_helper.h>
 
+#include "Graphic/Vulkan/ImageUtils.h"
+#include "Graphic/Vulkan/Ktx2.h"
+
 
 namespace Corvus
 {
     Renderer::Renderer(RendererSpecification specification)
         : m_Specification(std::move(specification))
     {
-        m_Device = std::make_shared<Device>(m_Specification.window);
-        m_Pipeline = std::make_shared<Pipeline>(m_Device, m_Specification.vertexShader, m_Specification.fragmentShader);
-        m_VertexBuffer = std::make_unique<VertexBuffer>(m_Specification.vertices, m_Device);
-        m_IndexBuffer = std::make_unique<IndexBuffer>(m_Specification.indices, m_Device);
+    }
 
-        for (size_t uboIndex = 0; uboIndex < MAX_FRAMES_IN_FLIGHT; uboIndex++)
+    Renderer::~Renderer()
+    {
+        for (size_t i = 0; i < m_InFlightFences.size(); ++i)
         {
-            m_UniformBuffers.emplace_back(m_Device);
+            const auto& vk = m_Device->getDispatch();
+            vk.vkDestroySemaphore(m_Device->getDevice(), m_ImageAvailableSemaphores[i], nullptr);
+            vk.vkDestroySemaphore(m_Device->getDevice(), m_RenderFinishedSemaphores[i], nullptr);
+            vk.vkDestroyFence(m_Device->getDevice(), m_InFlightFences[i], nullptr);
         }
+        for (auto semaphore: m_ComputeFinishedSemaphores)
+            m_Device->getDispatch().vkDestroySemaphore(m_Device->getDevice(), semaphore, nullptr);
+    }
 
-        createCommandBuffers();
-        recordCommandBuffers(m_CommandBuffers[m_CurrentFrame], 0);
-        createSyncObjects();
+    void Renderer::createDevice()
+    {
+        m_Device = std::make_shared<Device>(m_Specification.window, m_Specification.deviceSelection,
+                                            m_Specification.deviceFeatures);
+
+        // Pipelines are created after the device, so these have to be settled before the pipeline phase
+        if (m_Specification.occlusionCulling and not m_Device->getEnabledFeatures().dynamicRendering)
+        {
+            CORVUS_LOG(warn, "Occlusion culling needs dynamic rendering, it is disabled");
+            m_Specification.occlusionCulling = false;
+        }
+        if (m_Specification.occlusionCulling and m_Specification.depthPrePass)
+        {
+            CORVUS_LOG(info, "Depth pre-pass disabled, the first occlusion culling phase already lays down depth");
+            m_Specification.depthPrePass = false;
+        }
+        if (m_Specification.meshletCulling and m_Specification.occlusionCulling)
+        {
+            CORVUS_LOG(warn, "Meshlet culling is not combined with occlusion culling, it is disabled");
+            m_Specification.meshletCulling = false;
+        }
+        if (m_Specification.particles and not m_Device->getEnabledFeatures().dynamicRendering)
+        {
+            CORVUS_LOG(warn, "GPU particles need dynamic rendering, they are disabled");
+            m_Specification.particles = false;
+        }
+
+        if (m_Specification.textureStreaming)
+            m_TextureStreamer = std::make_unique<TextureStreamer>(m_Device, m_Specification.textureStreamingSettings,
+                                                                  MAX_FRAMES_IN_FLIGHT);
     }
 
-    Renderer::~Renderer()
+    PipelineHandle Renderer::createPipeline(const std::vector<char>& vertexCode, const std::vector<char>& fragmentCode)
+    {
+        CORVUS_ASSERT(m_Pipelines.size() < 0x1000, "Pipeline handles are limited to 12 bits by the sort key!")
+        const auto& vertexFormat = m_Specification.vertexFormat;
+        auto vertexInput = describeVertexInput(vertexFormat);
+        if (m_Specification.depthPrePass)
+        {
+            // Split meshes let the pre-pass consume the position stream alone, which needs a shader without the
+            // other inputs. Depth only pipelines have no fragment stage, so nothing downstream misses them.
+            if (vertexFormat.splitPositions)
+            {
+                if (m_DepthVertexCode.empty())
+                    m_DepthVertexCode = Pipeline::readFile(m_Specification.depthVertexShader);
+                m_DepthPipelines.push_back(std::make_shared<Pipeline>(m_Device, m_DepthVertexCode, fragmentCode,
+                                                                      DepthMode::DepthOnly,
+                                                                      describePositionInput(vertexFormat.encoding)));
+            }
+            else
+            {
+                m_DepthPipelines.push_back(std::make_shared<Pipeline>(m_Device, vertexCode, fragmentCode,
+                                                                      DepthMode::DepthOnly, vertexInput));
+            }
+            m_Pipelines.push_back(std::make_shared<Pipeline>(m_Device, vertexCode, fragmentCode, DepthMode::ReadOnly,
+                                                             vertexInput));
+        }
+        else
+        {
+            m_Pipelines.push_back(std::make_shared<Pipeline>(m_Device, vertexCode, fragmentCode, DepthMode::ReadWrite,
+                                                             vertexInput));
+        }
+        return static_cast<PipelineHandle>(m_Pipelines.size() - 1);
+    }
+
+    MeshHandle Renderer::createMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+    {
+        if (not m_Specification.optimizeMeshes)
+            return createMesh(vertices, buildLodChain(vertices, indices, m_Specification.lodSettings));
+
+        // Welding first gives the simplifier a connected surface, the reordering has to see the final levels
+        auto optimizedVertices = vertices;
+        auto optimizedIndices = indices;
+        deduplicateVertices(optimizedVertices, optimizedIndices);
+        auto lodChain = buildLodChain(optimizedVertices, optimizedIndices, m_Specification.lodSettings);
+        optimizeMesh(optimizedVertices, lodChain);
+        return createMesh(optimizedVertices, lodChain);
+    }
+
+    MeshHandle Renderer::createMesh(const std::vector<Vertex>& vertices, const LodChain& lodChain)
+    {
+        CORVUS_ASSERT(m_Meshes.size() < 0x10000, "Mesh handles are limited to 16 bits by the sort key!")
+        CORVUS_ASSERT(not m_MeshletCuller, "Meshes have to be created before the frame resources with meshlet culling!")
+        if (m_Specification.meshletCulling and lodChain.meshlets.empty())
+        {
+            auto clusteredChain = lodChain;
+            buildMeshlets(vertices, clusteredChain);
+            m_Meshes.push_back(std::make_unique<Mesh>(m_Device, vertices, clusteredChain,
+                                                      m_Specification.vertexFormat));
+            return static_cast<MeshHandle>(m_Meshes.size() - 1);
+        }
+
+        m_Meshes.push_back(std::make_unique<Mesh>(m_Device, vertices, lodChain, m_Specification.vertexFormat));
+        return static_cast<MeshHandle>(m_Meshes.size() - 1);
+    }
+
+    ComputePipelineHandle Renderer::createComputePipeline(const std::vector<char>& code,
+                                                          const std::vector<VkDescriptorType>& bindings,
+                                                          uint32_t pushConstantSize)
+    {
+        m_ComputePipelines.push_back(std::make_unique<ComputePipeline>(m_Device, code, bindings, pushConstantSize));
+        return static_cast<ComputePipelineHandle>(m_ComputePipelines.size() - 1);
+    }
+
+    TextureHandle Renderer::createTexture(const std::string& path, const TextureSettings& settings)
+    {
+        // KTX2 files bring their own mip chain
+        const ComputePipeline* downsampler = isKtx2File(path) ? nullptr : getMipDownsampler(settings);
+        m_Textures.push_back(Texture::load(m_Device, path, settings, downsampler));
+        return static_cast<TextureHandle>(m_Textures.size() - 1);
+    }
+
+    TextureHandle Renderer::createTexture(std::span<const std::byte> pixels, VkExtent2D extent,
+                                          const TextureSettings& settings)
+    {
+        m_Textures.push_back(std::make_unique<Texture>(m_Device, pixels, extent, settings,
+                                                       getMipDownsampler(settings)));
+        return static_cast<TextureHandle>(m_Textures.size() - 1);
+    }
+
+    uint32_t Renderer::selectLod(MeshHandle mesh, const glm::mat4& model, uint32_t currentLod) const
+    {
+        const auto& selected = *m_Meshes[mesh];
+        if (selected.getLodCount() == 1)
+            return 0;
+
+        float pixelsPerUnit = getPixelsPerUnit(selected.getBounds().getCenter(), model);
+        return selected.selectLod(pixelsPerUnit, m_Specification.lodErrorPixels, m_Specification.lodHysteresis,
+                                  glm::min(currentLod, selected.getLodCount() - 1));
+    }
+
+    void Renderer::requestTexture(StreamedTextureHandle texture, MeshHandle mesh, const glm::mat4& model,
+                                  float uvScale)
+    {
+        CORVUS_ASSERT(m_TextureStreamer, "Textures can only be requested with texture streaming enabled!")
+        const auto& bounds = m_Meshes[mesh]->getBounds();
+        glm::vec3 extent = bounds.getExtent();
+        float size = 2.0f * glm::max(extent.x, glm::max(extent.y, extent.z));
+        m_TextureStreamer->requestSize(texture, size * getPixelsPerUnit(bounds.getCenter(), model) * uvScale);
+    }
+
+    float Renderer::getPixelsPerUnit(const glm::vec3& point, const glm::mat4& model) const
+    {
+        // Model units stretch by at most the largest axis scale in the world
+        float scale = glm::max(glm::length(glm::vec3(model[0])),
+                               glm::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+        glm::vec3 center = glm::vec3(model * glm::vec4(point, 1.0f));
+        float distance = glm::max(glm::length(center - m_Camera.position), m_Camera.nearPlane);
+
+        // [1][1] is the projection's focal length, it maps a unit at distance 1 to half the viewport height
+        float focalLength = glm::abs(m_Camera.getProjection(getAspectRatio())[1][1]);
+        float viewportHeight = static_cast<float>(m_Device->getSwapChain().getExtent().height);
+        return scale * focalLength * 0.5f * viewportHeight / distance;
+    }
+
+    void Renderer::createFrameResources()
     {
-        for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+        m_UniformBuffers.reserve(MAX_FRAMES_IN_FLIGHT); // UniformBuffer owns its handles, it must not be relocated
+        for (size_t uboIndex = 0; uboIndex < MAX_FRAMES_IN_FLIGHT; uboIndex++)
+        {
+            m_UniformBuffers.emplace_back(m_Device);
+            m_ObjectBuffers.push_back(std::make_unique<StorageBuffer>(
+                m_Device, m_Specification.maxGpuObjects * sizeof(GpuObject), StorageBuffer::Access::HostWrite));
+        }
+
+        if (m_Specification.occlusionCulling)
+        {
+            m_OcclusionCuller = std::make_unique<OcclusionCuller>(
+                m_Device, Pipeline::readFile(m_Specification.depthPyramidShader),
+                Pipeline::readFile(m_Specification.occlusionCullShader), m_Specification.maxGpuObjects);
+        }
+
+        if (m_Specification.meshletCulling)
         {
-            vkDestroySemaphore(m_Device->getDevice(), m_ImageAvailableSemaphores[i], nullptr);
-            vkDestroySemaphore(m_Device->getDevice(), m_RenderFinishedSemaphores[i], nullptr);
-            vkDestroyFence(m_Device->getDevice(), m_InFlightFences[i], nullptr);
+            // Meshlets of all meshes go into one buffer, GpuObjects address them through the mesh's offset
+            std::vector<GpuMeshlet> meshlets;
+            for (const auto& mesh: m_Meshes)
+            {
+                m_MeshletOffsets.push_back(static_cast<uint32_t>(meshlets.size()));
+                MeshletCuller::appendMeshlets(mesh->getMeshlets(), meshlets);
+            }
+            m_MeshletCuller = std::make_unique<MeshletCuller>(
+                m_Device, Pipeline::readFile(m_Specification.meshletCullShader), meshlets,
+                m_Specification.maxMeshletDraws, m_Specification.maxGpuObjects, MAX_FRAMES_IN_FLIGHT);
         }
+
+        if (m_Specification.particles)
+        {
+            m_ParticleSystem = std::make_unique<ParticleSystem>(m_Device, m_Specification.particleSettings,
+                                                                MAX_FRAMES_IN_FLIGHT);
+        }
+
+        createDescriptors();
+        createCommandBuffers();
+        createSyncObjects();
     }
 
     void Renderer::draw()
     {
         auto device = m_Device->getDevice();
-        auto swapChain = m_Device->getSwapChain();
+        auto& swapChain = m_Device->getSwapChain();
 
         synchronize(device);
+        resetFrameDescriptors();
+        if (m_TextureStreamer)
+            m_TextureStreamer->update();
         auto imageIndex = acquireNextImage(device, swapChain);
 
-        vkResetCommandBuffer(m_CommandBuffers[m_CurrentFrame], 0);
+        m_Statistics = {};
+        // Goes out first so the compute queue can start while the graphics work is still being recorded
+        bool computeSubmitted = submitAsyncCompute();
+
+        m_RenderQueue.sort();
+        m_Device->getDispatch().vkResetCommandBuffer(m_CommandBuffers[m_CurrentFrame], 0);
         recordCommandBuffers(m_CommandBuffers[m_CurrentFrame], imageIndex);
+        m_RenderQueue.clear();
+        m_ComputeDispatches.clear();
 
         updateUniformBuffer(m_CurrentFrame);
 
-        submitGraphicsQueue();
+        submitGraphicsQueue(computeSubmitted);
         presentImage(swapChain.getHandle(), imageIndex);
 
         updateCurrentFrame();
@@ -59,7 +259,7 @@ namespace Corvus
 
     void Renderer::waitIdle() const
     {
-        vkDeviceWaitIdle(m_Device->getDevice());
+        m_Device->getDispatch().vkDeviceWaitIdle(m_Device->getDevice());
     }
 
     void Renderer::createCommandBuffers()
@@ -73,8 +273,18 @@ namespace Corvus
             .commandBufferCount = static_cast<uint32_t>(m_CommandBuffers.size()),
         };
 
-        auto success = vkAllocateCommandBuffers(m_Device->getDevice(), &allocInfo, m_CommandBuffers.data());
+        auto success = m_Device->getDispatch().vkAllocateCommandBuffers(m_Device->getDevice(), &allocInfo,
+                                                                        m_CommandBuffers.data());
         CORVUS_ASSERT(success == VK_SUCCESS, "Failed to allocate command buffers!")
+
+        if (m_Device->getEnabledFeatures().asyncCompute)
+        {
+            m_ComputeCommandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+            allocInfo.commandPool = m_Device->getComputeCommandPool();
+            success = m_Device->getDispatch().vkAllocateCommandBuffers(m_Device->getDevice(), &allocInfo,
+                                                                       m_ComputeCommandBuffers.data());
+            CORVUS_ASSERT(success == VK_SUCCESS, "Failed to allocate compute command buffers!")
+        }
         CORVUS_LOG(info, "Command buffers allocated successfully!");
     }
 
@@ -94,21 +304,52 @@ namespace Corvus
             .flags = VK_FENCE_CREATE_SIGNALED_BIT // Start with signaled state, so we don't wait on first draw
         };
 
+        const auto& vk = m_Device->getDispatch();
         for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
         {
-            VkResult success = vkCreateSemaphore(m_Device->getDevice(), &semaphoreInfo, nullptr,
-                                                 &m_ImageAvailableSemaphores[i]);
+            VkResult success = vk.vkCreateSemaphore(m_Device->getDevice(), &semaphoreInfo, nullptr,
+                                                    &m_ImageAvailableSemaphores[i]);
             CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create image available semaphore!")
 
-            success = vkCreateSemaphore(m_Device->getDevice(), &semaphoreInfo, nullptr, &m_RenderFinishedSemaphores[i]);
+            success = vk.vkCreateSemaphore(m_Device->getDevice(), &semaphoreInfo, nullptr,
+                                           &m_RenderFinishedSemaphores[i]);
             CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create render finished semaphore!")
 
-            success = vkCreateFence(m_Device->getDevice(), &fenceInfo, nullptr, &m_InFlightFences[i]);
+            success = vk.vkCreateFence(m_Device->getDevice(), &fenceInfo, nullptr, &m_InFlightFences[i]);
             CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create in flight fence!")
         }
+
+        // The graphics submission waits on the frame's compute, so the in flight fence covers both
+        if (m_Device->getEnabledFeatures().asyncCompute)
+        {
+            m_ComputeFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
+            for (auto& semaphore: m_ComputeFinishedSemaphores)
+            {
+                auto success = vk.vkCreateSemaphore(m_Device->getDevice(), &semaphoreInfo, nullptr, &semaphore);
+                CORVUS_ASSERT(success == VK_SUCCESS, "Failed to create compute finished semaphore!")
+            }
+        }
         CORVUS_LOG(info, "Sync objects created successfully!");
     }
 
+    void Renderer::createDescriptors()
+    {
+        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+        {
+            m_DescriptorAllocators.push_back(std::make_unique<DescriptorAllocator>(m_Device));
+            m_DescriptorSetCaches.push_back(std::make_unique<DescriptorSetCache>(m_Device, *m_DescriptorAllocators[i]));
+        }
+    }
+
+    void Renderer::resetFrameDescriptors()
+    {
+        m_DescriptorSetCaches[m_CurrentFrame]->clear();
+        m_DescriptorAllocators[m_CurrentFrame]->reset();
+
+        if (auto* bindless = m_Device->getBindlessDescriptors())
+            bindless->beginFrame(MAX_FRAMES_IN_FLIGHT);
+    }
+
     void Renderer::updateCurrentFrame()
     {
         m_CurrentFrame = (m_CurrentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
@@ -116,42 +357,426 @@ namespace Corvus
 
     void Renderer::updateUniformBuffer(uint32_t imageIndex)
     {
-        static auto startTime = std::chrono::high_resolution_clock::now();
+        UniformBufferObject ubo{
+            .view = m_Camera.getView(),
+            .projection = m_Camera.getProjection(getAspectRatio()),
+        };
+
+        memcpy(m_UniformBuffers[imageIndex].getMappedData(), &ubo, sizeof(ubo));
+    }
 
-        auto swapChainExtent = m_Device->getSwapChain().getExtent();
+    float Renderer::getAspectRatio() const
+    {
+        auto extent = m_Device->getSwapChain().getExtent();
+        return static_cast<float>(extent.width) / static_cast<float>(extent.height);
+    }
 
-        auto currentTime = std::chrono::high_resolution_clock::now();
-        float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
+    glm::mat4 Renderer::getViewProjection() const
+    {
+        return m_Camera.getProjection(getAspectRatio()) * m_Camera.getView();
+    }
 
-        UniformBufferObject ubo{
-            .model = rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f)),
-            .view = lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)),
-            .projection = glm::perspective(glm::radians(45.0f), swapChainExtent.width / (float) swapChainExtent.height, 0.1f, 10.0f),
+    Renderer::ComputeDispatch& Renderer::queueDispatch(ComputePipelineHandle pipeline,
+                                                       std::vector<DescriptorWrite> bindings, glm::uvec3 groupCount)
+    {
+        CORVUS_ASSERT(pipeline < m_ComputePipelines.size(), "Unknown compute pipeline {}!", pipeline)
+        return m_ComputeDispatches.emplace_back(ComputeDispatch{
+            .pipeline = pipeline,
+            .bindings = std::move(bindings),
+            .constants = {},
+            .constantSize = 0,
+            .groupCount = groupCount,
+        });
+    }
+
+    const ComputePipeline* Renderer::getMipDownsampler(const TextureSettings& settings)
+    {
+        if (not settings.generateMips or not Texture::requiresDownsampler(*m_Device, settings.format))
+            return nullptr;
+
+        if (not m_MipDownsampler)
+            m_MipDownsampler = Texture::createDownsampler(m_Device, m_Specification.mipDownsampleShader);
+        return m_MipDownsampler.get();
+    }
+
+    void Renderer::recordComputeDispatches(VkCommandBuffer commandBuffer)
+    {
+        if (m_ComputeDispatches.empty())
+            return;
+
+        // Writes of the previous frame's dispatches and reads of its draws have to be done
+        constexpr VkPipelineStageFlags computeStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        bool async = m_Device->getEnabledFeatures().asyncCompute;
+        VkPipelineStageFlags consumerStages = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT bitor
+                                              VK_PIPELINE_STAGE_VERTEX_INPUT_BIT bitor
+                                              VK_PIPELINE_STAGE_VERTEX_SHADER_BIT bitor
+                                              VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT bitor computeStage;
+        memoryBarrier(*m_Device, commandBuffer, async ? computeStage : consumerStages, VK_ACCESS_SHADER_WRITE_BIT,
+                      computeStage, VK_ACCESS_SHADER_READ_BIT bitor VK_ACCESS_SHADER_WRITE_BIT);
+
+        auto& descriptorSets = *m_DescriptorSetCaches[m_CurrentFrame];
+        for (size_t i = 0; i < m_ComputeDispatches.size(); i++)
+        {
+            const auto& queued = m_ComputeDispatches[i];
+            const auto& pipeline = *m_ComputePipelines[queued.pipeline];
+            if (i > 0)
+            {
+                memoryBarrier(*m_Device, commandBuffer, computeStage, VK_ACCESS_SHADER_WRITE_BIT, computeStage,
+                              VK_ACCESS_SHADER_READ_BIT bitor VK_ACCESS_SHADER_WRITE_BIT);
+            }
+
+            pipeline.bind(commandBuffer, descriptorSets.get(pipeline.getDescriptorSetLayout(), queued.bindings));
+            if (queued.constantSize > 0)
+                pipeline.pushConstants(commandBuffer, queued.constants.data(), queued.constantSize);
+            pipeline.dispatch(commandBuffer, queued.groupCount.x, queued.groupCount.y, queued.groupCount.z);
+            m_Statistics.dispatches++;
+        }
+
+        // On the compute queue the semaphore the graphics submission waits on makes the writes visible
+        if (not async)
+        {
+            memoryBarrier(*m_Device, commandBuffer, computeStage, VK_ACCESS_SHADER_WRITE_BIT, consumerStages,
+                          VK_ACCESS_INDIRECT_COMMAND_READ_BIT bitor VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT bitor
+                          VK_ACCESS_INDEX_READ_BIT bitor VK_ACCESS_UNIFORM_READ_BIT bitor VK_ACCESS_SHADER_READ_BIT);
+        }
+    }
+
+    bool Renderer::submitAsyncCompute()
+    {
+        if (not m_Device->getEnabledFeatures().asyncCompute or m_ComputeDispatches.empty())
+            return false;
+
+        const auto& vk = m_Device->getDispatch();
+        auto commandBuffer = m_ComputeCommandBuffers[m_CurrentFrame];
+        vk.vkResetCommandBuffer(commandBuffer, 0);
+
+        VkCommandBufferBeginInfo beginInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
         };
+        auto success = vk.vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        CORVUS_ASSERT(success == VK_SUCCESS, "Failed to begin recording compute command buffer!")
+        recordComputeDispatches(commandBuffer);
+        success = vk.vkEndCommandBuffer(commandBuffer);
+        CORVUS_ASSERT(success == VK_SUCCESS, "Failed to end recording compute command buffer!")
 
-        ubo.projection[1][1] *= -1; // Flip y coordinate (glm uses OpenGL, Vulkan uses DirectX coordinate system)
-        memcpy(m_UniformBuffers[imageIndex].getMappedData(), &ubo, sizeof(ubo));
+        const VkSubmitInfo submitInfo = {
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            .commandBufferCount = 1,
+            .pCommandBuffers = &commandBuffer,
+            .signalSemaphoreCount = 1,
+            .pSignalSemaphores = &m_ComputeFinishedSemaphores[m_CurrentFrame],
+        };
+        success = m_Device->getQueue(QueueRole::Compute).submit(submitInfo, VK_NULL_HANDLE);
+        CORVUS_ASSERT(success == VK_SUCCESS, "Failed to submit compute command buffer!")
+        return true;
     }
 
-    void Renderer::recordCommandBuffers(const VkCommandBuffer commandBuffer, const uint32_t imageIndex) const
+    void Renderer::recordCommandBuffers(const VkCommandBuffer commandBuffer, const uint32_t imageIndex)
     {
-        auto swapChain = m_Device->getSwapChain();
+        auto& swapChain = m_Device->getSwapChain();
         auto extent = swapChain.getExtent();
         auto framebuffer = swapChain.getFramebuffers();
 
+        auto image = swapChain.getImages()[imageIndex];
+
         beginCommandBuffer();
-        beginRenderPass(commandBuffer, framebuffer[imageIndex], extent);
-        bindPipeline(commandBuffer, m_Pipeline->getPipeline());
+        if (m_TextureStreamer)
+            m_TextureStreamer->recordUploads(commandBuffer);
+        if (not m_Device->getEnabledFeatures().asyncCompute)
+            recordComputeDispatches(commandBuffer);
+
+        if (m_OcclusionCuller)
+        {
+            recordOcclusionCulledPasses(commandBuffer, image, swapChain.getImageViews()[imageIndex], extent);
+            if (m_ParticleSystem)
+                recordParticles(commandBuffer, image, swapChain.getImageViews()[imageIndex], extent);
+            cleanupFrame(commandBuffer, image);
+            return;
+        }
+
+        // Compute has to finish writing the draws before the rendering they feed begins
+        if (m_MeshletCuller)
+            cullMeshlets(commandBuffer);
+
+        // Particles collide with the depth of everything drawn before them, so it has to be stored
+        if (m_Device->getEnabledFeatures().dynamicRendering)
+        {
+            beginRendering(commandBuffer, image, swapChain.getImageViews()[imageIndex], extent,
+                           VK_ATTACHMENT_LOAD_OP_CLEAR,
+                           m_ParticleSystem ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE);
+        }
+        else
+            beginRenderPass(commandBuffer, framebuffer[imageIndex], extent);
+
+        // Viewport and scissor are dynamic in every pipeline, so they survive the pipeline binds below
+        setViewport(commandBuffer, extent);
+        setScissor(commandBuffer, extent);
+
+        if (m_Specification.depthPrePass)
+            recordDepthPrePass(commandBuffer);
+        recordDrawPackets(commandBuffer);
+        if (m_ParticleSystem)
+            recordParticles(commandBuffer, image, swapChain.getImageViews()[imageIndex], extent);
+
+        cleanupFrame(commandBuffer, image);
+    }
+
+    void Renderer::recordDepthPrePass(VkCommandBuffer commandBuffer)
+    {
+        // Transparent draws blend with what is behind them and must not occlude it, only opaque ones write depth
+        if (m_MeshletCuller)
+        {
+            recordMeshletBatches(commandBuffer, m_DepthPipelines);
+            return;
+        }
+
+        BindState state;
+        m_RenderQueue.forEachSorted(RenderPassType::Opaque, [&](const DrawPacket& packet)
+        {
+            recordDrawPacket(commandBuffer, *m_DepthPipelines[packet.pipeline], packet, state);
+        });
+    }
+
+    void Renderer::recordDrawPackets(VkCommandBuffer commandBuffer)
+    {
+        BindState state;
+        if (m_MeshletCuller)
+        {
+            // Opaque draws come from the culled meshlets, transparent ones keep their sorted direct draws
+            recordMeshletBatches(commandBuffer, m_Pipelines);
+            m_RenderQueue.forEachSorted(RenderPassType::Transparent, [&](const DrawPacket& packet)
+            {
+                recordDrawPacket(commandBuffer, *m_Pipelines[packet.pipeline], packet, state);
+            });
+            return;
+        }
+
+        m_RenderQueue.forEachSorted([&](const DrawPacket& packet)
+        {
+            recordDrawPacket(commandBuffer, *m_Pipelines[packet.pipeline], packet, state);
+        });
+    }
+
+    void Renderer::recordDrawPacket(VkCommandBuffer commandBuffer, const Pipeline& pipeline, const DrawPacket& packet,
+                                    BindState& state)
+    {
+        bindDrawState(commandBuffer, pipeline, packet.mesh, state);
+
+        DrawPushConstants drawConstants = {
+            .model = packet.model,
+            .objectIndex = packet.objectIndex,
+            .materialIndex = packet.material,
+        };
+        pushConstants(commandBuffer, pipeline, drawConstants);
 
+        const auto& lod = m_Meshes[packet.mesh]->getLod(packet.lod);
+        m_Device->getDispatch().vkCmdDrawIndexed(commandBuffer, lod.indexCount, 1, lod.firstIndex, 0, 0);
+        m_Statistics.draws++;
+    }
+
+    void Renderer::recordOcclusionCulledPasses(VkCommandBuffer commandBuffer, VkImage image, VkImageView imageView,
+                                               VkExtent2D extent)
+    {
+        const auto& vk = m_Device->getDispatch();
+        auto& swapChain = m_Device->getSwapChain();
+        auto& descriptorSets = *m_DescriptorSetCaches[m_CurrentFrame];
+        const auto& objects = *m_ObjectBuffers[m_CurrentFrame];
+
+        auto view = m_Camera.getView();
+        auto projection = m_Camera.getProjection(getAspectRatio());
+        uint32_t objectCount = writeGpuObjects();
+
+        // Redraw what was visible last frame, its depth is what everything else gets tested against
+        m_OcclusionCuller->cull(commandBuffer, descriptorSets, objects, objectCount, view, projection,
+                                OcclusionCuller::Phase::Previous);
+        beginRendering(commandBuffer, image, imageView, extent, VK_ATTACHMENT_LOAD_OP_CLEAR,
+                       VK_ATTACHMENT_STORE_OP_STORE);
         setViewport(commandBuffer, extent);
         setScissor(commandBuffer, extent);
+        recordIndirectBatches(commandBuffer, OcclusionCuller::Phase::Previous);
+        vk.vkCmdEndRendering(commandBuffer);
+
+        ImageUtils::transitionImageLayout(*m_Device, commandBuffer, swapChain.getDepthImage(),
+                                          VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, getDepthAspect());
+        m_OcclusionCuller->buildDepthPyramid(commandBuffer, descriptorSets, swapChain.getDepthImageView());
+
+        // Test everything against the pyramid and draw the objects that just came into view on top
+        m_OcclusionCuller->cull(commandBuffer, descriptorSets, objects, objectCount, view, projection,
+                                OcclusionCuller::Phase::Revealed);
+        ImageUtils::transitionImageLayout(*m_Device, commandBuffer, swapChain.getDepthImage(),
+                                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                          VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, getDepthAspect());
+        ImageUtils::transitionImageLayout(*m_Device, commandBuffer, image, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                                          VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        beginRendering(commandBuffer, image, imageView, extent, VK_ATTACHMENT_LOAD_OP_LOAD,
+                       m_ParticleSystem ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE);
+        recordIndirectBatches(commandBuffer, OcclusionCuller::Phase::Revealed);
+
+        // Transparent draws do not occlude anything and stay on the CPU path, they only pass the frustum test
+        BindState state;
+        m_RenderQueue.forEachSorted(RenderPassType::Transparent, [&](const DrawPacket& packet)
+        {
+            recordDrawPacket(commandBuffer, *m_Pipelines[packet.pipeline], packet, state);
+        });
+    }
 
-        m_VertexBuffer->bind(commandBuffer);
-        m_IndexBuffer->bind(commandBuffer);
+    void Renderer::recordIndirectBatches(VkCommandBuffer commandBuffer, OcclusionCuller::Phase phase)
+    {
+        BindState state;
+        for (const auto& batch: m_IndirectBatches)
+        {
+            const auto& pipeline = *m_Pipelines[batch.pipeline];
+            bindDrawState(commandBuffer, pipeline, batch.mesh, state);
 
-        vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(m_Specification.indices.size()), 1, 0, 0, 0);
+            DrawPushConstants drawConstants = {
+                .objectIndex = INDIRECT_OBJECT_INDEX,
+                .materialIndex = batch.material,
+            };
+            pushConstants(commandBuffer, pipeline, drawConstants);
 
-        cleanupFrame(commandBuffer);
+            m_OcclusionCuller->drawIndirect(commandBuffer, phase, batch.first, batch.count);
+            m_Statistics.draws += batch.count; // Issued, how many survive is only known on the GPU
+        }
+    }
+
+    void Renderer::cullMeshlets(VkCommandBuffer commandBuffer)
+    {
+        writeGpuObjects();
+        m_MeshletCuller->cull(commandBuffer, *m_DescriptorSetCaches[m_CurrentFrame], m_CurrentFrame,
+                              *m_ObjectBuffers[m_CurrentFrame], m_MeshletTasks, m_MeshletBatches,
+                              m_Camera.getView(), m_Camera.getProjection(getAspectRatio()));
+    }
+
+    void Renderer::recordMeshletBatches(VkCommandBuffer commandBuffer,
+                                        const std::vector<std::shared_ptr<Pipeline>>& pipelines)
+    {
+        BindState state;
+        for (uint32_t i = 0; i < m_IndirectBatches.size(); i++)
+        {
+            const auto& batch = m_IndirectBatches[i];
+            const auto& pipeline = *pipelines[batch.pipeline];
+            bindDrawState(commandBuffer, pipeline, batch.mesh, state);
+
+            DrawPushConstants drawConstants = {
+                .objectIndex = INDIRECT_OBJECT_INDEX,
+                .materialIndex = batch.material,
+            };
+            pushConstants(commandBuffer, pipeline, drawConstants);
+
+            m_MeshletCuller->drawIndirect(commandBuffer, m_CurrentFrame, i, batch.firstDraw, batch.drawCount);
+            m_Statistics.draws += batch.drawCount; // Issued, how many survive is only known on the GPU
+        }
+    }
+
+    void Renderer::recordParticles(VkCommandBuffer commandBuffer, VkImage image, VkImageView imageView,
+                                   VkExtent2D extent)
+    {
+        // The simulation reads the finished scene depth, rendering resumes afterwards to draw the particles on top
+        auto& swapChain = m_Device->getSwapChain();
+        m_Device->getDispatch().vkCmdEndRendering(commandBuffer);
+        ImageUtils::transitionImageLayout(*m_Device, commandBuffer, swapChain.getDepthImage(),
+                                          VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, getDepthAspect());
+        m_ParticleSystem->simulate(commandBuffer, *m_DescriptorSetCaches[m_CurrentFrame], m_CurrentFrame,
+                                   swapChain.getDepthImageView(), extent, m_Camera.getView(),
+                                   m_Camera.getProjection(getAspectRatio()));
+        ImageUtils::transitionImageLayout(*m_Device, commandBuffer, swapChain.getDepthImage(),
+                                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                          VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, getDepthAspect());
+        ImageUtils::transitionImageLayout(*m_Device, commandBuffer, image, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                                          VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+
+        beginRendering(commandBuffer, image, imageView, extent, VK_ATTACHMENT_LOAD_OP_LOAD);
+        setViewport(commandBuffer, extent);
+        setScissor(commandBuffer, extent);
+        m_ParticleSystem->draw(commandBuffer, *m_DescriptorSetCaches[m_CurrentFrame],
+                               m_UniformBuffers[m_CurrentFrame].getBuffer());
+        m_Statistics.draws++;
+    }
+
+    uint32_t Renderer::writeGpuObjects()
+    {
+        auto* objects = static_cast<GpuObject*>(m_ObjectBuffers[m_CurrentFrame]->getMappedData());
+        uint32_t count = 0;
+
+        // The queue is sorted by state, so objects sharing pipeline, material and mesh end up next to each other
+        m_IndirectBatches.clear();
+        m_MeshletTasks.clear();
+        m_MeshletBatches.clear();
+        uint32_t meshletDraws = 0;
+        m_RenderQueue.forEachSorted(RenderPassType::Opaque, [&](const DrawPacket& packet)
+        {
+            CORVUS_ASSERT(count < m_Specification.maxGpuObjects, "More than {} opaque draws submitted!",
+                          m_Specification.maxGpuObjects)
+            CORVUS_ASSERT(packet.objectIndex < m_Specification.maxGpuObjects,
+                          "Object index {} exceeds the GPU visibility buffer!", packet.objectIndex)
+
+            const auto& mesh = *m_Meshes[packet.mesh];
+            const auto& lod = mesh.getLod(packet.lod);
+            auto sphere = BoundingSphere::fromAABB(mesh.getBounds()).transform(packet.model);
+            objects[count] = {
+                .model = packet.model,
+                .boundingSphere = glm::vec4(sphere.center, sphere.radius),
+                .objectIndex = packet.objectIndex,
+                .indexCount = lod.indexCount,
+                .firstIndex = lod.firstIndex,
+            };
+
+            if (m_IndirectBatches.empty() or m_IndirectBatches.back().pipeline != packet.pipeline or
+                m_IndirectBatches.back().mesh != packet.mesh or m_IndirectBatches.back().material != packet.material)
+            {
+                m_IndirectBatches.push_back({packet.pipeline, packet.mesh, packet.material, count, 0, meshletDraws, 0});
+                m_MeshletBatches.push_back({.drawCount = 0, .firstDraw = meshletDraws});
+            }
+            auto& batch = m_IndirectBatches.back();
+            batch.count++;
+
+            if (m_MeshletCuller)
+            {
+                CORVUS_ASSERT(meshletDraws + lod.meshletCount <= m_Specification.maxMeshletDraws,
+                              "More than {} meshlet draws submitted!", m_Specification.maxMeshletDraws)
+                auto& object = objects[count];
+                object.firstMeshlet = m_MeshletOffsets[packet.mesh] + lod.firstMeshlet;
+                object.meshletCount = lod.meshletCount;
+                object.batch = static_cast<uint32_t>(m_IndirectBatches.size() - 1);
+                object.firstDraw = batch.firstDraw + batch.drawCount;
+
+                for (uint32_t first = 0; first < lod.meshletCount; first += MeshletCuller::GROUP_SIZE)
+                    m_MeshletTasks.push_back({.object = count, .firstMeshlet = first});
+                batch.drawCount += lod.meshletCount;
+                meshletDraws += lod.meshletCount;
+            }
+            count++;
+        });
+        return count;
+    }
+
+    void Renderer::bindDrawState(VkCommandBuffer commandBuffer, const Pipeline& pipeline, MeshHandle mesh,
+                                 BindState& state)
+    {
+        if (pipeline.getPipeline() != state.pipeline)
+        {
+            bindPipeline(commandBuffer, pipeline.getPipeline());
+            state.pipeline = pipeline.getPipeline();
+            m_Statistics.pipelineBinds++;
+
+            // Bound sets stay valid across pipelines with a compatible layout
+            if (pipeline.getPipelineLayout() != state.layout)
+            {
+                bindDescriptorSets(commandBuffer, pipeline);
+                state.layout = pipeline.getPipelineLayout();
+                m_Statistics.descriptorBinds++;
+            }
+        }
+
+        if (mesh != state.mesh)
+        {
+            m_Meshes[mesh]->bind(commandBuffer);
+            state.mesh = mesh;
+            m_Statistics.meshBinds++;
+        }
     }
 
     void Renderer::beginCommandBuffer() const
@@ -162,13 +787,16 @@ namespace Corvus
             .pInheritanceInfo = nullptr
         };
 
-        auto success = vkBeginCommandBuffer(m_CommandBuffers[m_CurrentFrame], &beginInfo);
+        auto success = m_Device->getDispatch().vkBeginCommandBuffer(m_CommandBuffers[m_CurrentFrame], &beginInfo);
         CORVUS_ASSERT(success == VK_SUCCESS, "Failed to begin recording command buffer!")
     }
 
     void Renderer::beginRenderPass(VkCommandBuffer commandBuffer, VkFramebuffer& framebuffer, VkExtent2D extent) const
     {
-        VkClearValue clearColor = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
+        std::array<VkClearValue, 2> clearValues = {};
+        clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+        clearValues[1].depthStencil = {0.0f, 0}; // Reverse-Z, 0 is the far plane
+
         VkRenderPassBeginInfo renderPassInfo = {
             .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
             .renderPass = m_Device->getRenderPass(),
@@ -177,18 +805,107 @@ namespace Corvus
                 .offset = {0, 0},
                 .extent = extent
             },
-            .clearValueCount = 1,
-            .pClearValues = &clearColor,
+            .clearValueCount = static_cast<uint32_t>(clearValues.size()),
+            .pClearValues = clearValues.data(),
         };
-        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        m_Device->getDispatch().vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
     }
 
-    void Renderer::bindPipeline(VkCommandBuffer commandBuffer, VkPipeline pipeline)
+    void Renderer::beginRendering(VkCommandBuffer commandBuffer, VkImage image, VkImageView imageView,
+                                  VkExtent2D extent, VkAttachmentLoadOp loadOp, VkAttachmentStoreOp depthStoreOp) const
     {
-        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        // Without a render pass the layout transitions are ours. A clear discards last frame's content, a load
+        // continues rendering and expects the caller to have both attachments back in their attachment layouts.
+        auto& swapChain = m_Device->getSwapChain();
+        VkImageAspectFlags depthAspect = getDepthAspect();
+        if (loadOp == VK_ATTACHMENT_LOAD_OP_CLEAR)
+        {
+            ImageUtils::transitionImageLayout(*m_Device, commandBuffer, image, VK_IMAGE_LAYOUT_UNDEFINED,
+                                              VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            // The depth image is shared by the frames in flight, its layout change has to wait for the previous
+            // frame's depth writes like the render pass path's subpass dependency does
+            ImageUtils::transitionImageLayoutAfter(*m_Device, commandBuffer, swapChain.getDepthImage(),
+                                                   VK_IMAGE_LAYOUT_UNDEFINED,
+                                                   VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                                                   VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT bitor
+                                                   VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                                                   VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, depthAspect);
+        }
+
+        VkRenderingAttachmentInfo colorAttachment = {
+            .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+            .imageView = imageView,
+            .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            .loadOp = loadOp,
+            .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+            .clearValue = {{{0.0f, 0.0f, 0.0f, 1.0f}}},
+        };
+
+        VkRenderingAttachmentInfo depthAttachment = {
+            .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+            .imageView = swapChain.getDepthImageView(),
+            .imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            .loadOp = loadOp,
+            .storeOp = depthStoreOp,
+            .clearValue = {.depthStencil = {0.0f, 0}}, // Reverse-Z, 0 is the far plane
+        };
+
+        VkRenderingInfo renderingInfo = {
+            .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+            .renderArea = {
+                .offset = {0, 0},
+                .extent = extent
+            },
+            .layerCount = 1,
+            .colorAttachmentCount = 1,
+            .pColorAttachments = &colorAttachment,
+            .pDepthAttachment = &depthAttachment,
+            .pStencilAttachment = depthAspect bitand VK_IMAGE_ASPECT_STENCIL_BIT ? &depthAttachment : nullptr,
+        };
+        m_Device->getDispatch().vkCmdBeginRendering(commandBuffer, &renderingInfo);
     }
 
-    void Renderer::setViewport(VkCommandBuffer commandBuffer, VkExtent2D extent)
+    void Renderer::endRendering(VkCommandBuffer commandBuffer, VkImage image) const
+    {
+        m_Device->getDispatch().vkCmdEndRendering(commandBuffer);
+        ImageUtils::transitionImageLayout(*m_Device, commandBuffer, image, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                                          VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    }
+
+    VkImageAspectFlags Renderer::getDepthAspect() const
+    {
+        VkImageAspectFlags depthAspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+        if (ImageUtils::hasStencilComponent(m_Device->getSwapChain().getDepthFormat()))
+            depthAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+        return depthAspect;
+    }
+
+    void Renderer::bindPipeline(VkCommandBuffer commandBuffer, VkPipeline pipeline) const
+    {
+        m_Device->getDispatch().vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    }
+
+    void Renderer::bindDescriptorSets(VkCommandBuffer commandBuffer, const Pipeline& pipeline) const
+    {
+        std::vector descriptorSets = {
+            m_DescriptorSetCaches[m_CurrentFrame]->get(pipeline.getDescriptorSetLayout(), {
+                DescriptorWrite::buffer(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                                        m_UniformBuffers[m_CurrentFrame].getBuffer(), 0, sizeof(UniformBufferObject)),
+                DescriptorWrite::buffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_ObjectBuffers[m_CurrentFrame]->getBuffer())
+            })
+        };
+
+        // Bound once per command buffer, every draw reaches its resources through handles
+        if (const auto* bindless = m_Device->getBindlessDescriptors())
+            descriptorSets.push_back(bindless->getSet());
+
+        m_Device->getDispatch().vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                        pipeline.getPipelineLayout(), 0,
+                                                        static_cast<uint32_t>(descriptorSets.size()),
+                                                        descriptorSets.data(), 0, nullptr);
+    }
+
+    void Renderer::setViewport(VkCommandBuffer commandBuffer, VkExtent2D extent) const
     {
         VkViewport viewport = {
             .x = 0.0f,
@@ -198,44 +915,48 @@ namespace Corvus
             .minDepth = 0.0f,
             .maxDepth = 1.0f
         };
-        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+        m_Device->getDispatch().vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
     }
 
-    void Renderer::setScissor(VkCommandBuffer commandBuffer, VkExtent2D extent)
+    void Renderer::setScissor(VkCommandBuffer commandBuffer, VkExtent2D extent) const
     {
         VkRect2D scissor = {
             .offset = {0, 0},
             .extent = extent
         };
 
-        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+        m_Device->getDispatch().vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
     }
 
-    void Renderer::cleanupFrame(VkCommandBuffer commandBuffer)
+    void Renderer::cleanupFrame(VkCommandBuffer commandBuffer, VkImage image) const
     {
-        vkCmdEndRenderPass(commandBuffer);
-        auto success = vkEndCommandBuffer(commandBuffer);
+        const auto& vk = m_Device->getDispatch();
+        if (m_Device->getEnabledFeatures().dynamicRendering)
+            endRendering(commandBuffer, image);
+        else
+            vk.vkCmdEndRenderPass(commandBuffer);
+
+        auto success = vk.vkEndCommandBuffer(commandBuffer);
         CORVUS_ASSERT(success == VK_SUCCESS, "Failed to end recording command buffer!")
     }
 
     void Renderer::synchronize(VkDevice device) const
     {
-        vkWaitForFences(device, 1, &m_InFlightFences[m_CurrentFrame], VK_TRUE, UINT64_MAX);
-        vkResetFences(device, 1, &m_InFlightFences[m_CurrentFrame]);
+        const auto& vk = m_Device->getDispatch();
+        vk.vkWaitForFences(device, 1, &m_InFlightFences[m_CurrentFrame], VK_TRUE, UINT64_MAX);
+        vk.vkResetFences(device, 1, &m_InFlightFences[m_CurrentFrame]);
     }
 
     uint32_t Renderer::acquireNextImage(VkDevice device, SwapChain& swapChain) const
     {
         uint32_t imageIndex;
-        auto success = vkAcquireNextImageKHR(device, swapChain.getHandle(), UINT64_MAX,
-                                             m_ImageAvailableSemaphores[m_CurrentFrame],
-                                             VK_NULL_HANDLE, &imageIndex);
+        auto success = m_Device->getDispatch().vkAcquireNextImageKHR(device, swapChain.getHandle(), UINT64_MAX,
+                                                                     m_ImageAvailableSemaphores[m_CurrentFrame],
+                                                                     VK_NULL_HANDLE, &imageIndex);
 
         if (success == VK_ERROR_OUT_OF_DATE_KHR)
         {
-            swapChain.recreate(device, m_Device->getPhysicalDevice(), m_Device->getSurface(),
-                               m_Specification.window->getHandle(),
-                               m_Device->getRenderPass());
+            m_Device->recreateSwapChain();
             return imageIndex;
         }
 
@@ -247,15 +968,23 @@ namespace Corvus
     {
     }
 
-    void Renderer::submitGraphicsQueue()
+    void Renderer::submitGraphicsQueue(bool waitForCompute)
     {
-        const VkSemaphore waitSemaphores[] = {m_ImageAvailableSemaphores[m_CurrentFrame]};
+        const VkSemaphore waitSemaphores[] = {
+            m_ImageAvailableSemaphores[m_CurrentFrame],
+            waitForCompute ? m_ComputeFinishedSemaphores[m_CurrentFrame] : VK_NULL_HANDLE
+        };
         const VkSemaphore signalSemaphores[] = {m_RenderFinishedSemaphores[m_CurrentFrame]};
-        constexpr VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+        constexpr VkPipelineStageFlags waitStages[] = {
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT bitor VK_PIPELINE_STAGE_VERTEX_INPUT_BIT bitor
+            VK_PIPELINE_STAGE_VERTEX_SHADER_BIT bitor VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT bitor
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+        };
 
         const VkSubmitInfo submitInfo = {
             .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-            .waitSemaphoreCount = 1,
+            .waitSemaphoreCount = waitForCompute ? 2u : 1u,
             .pWaitSemaphores = waitSemaphores,
             .pWaitDstStageMask = waitStages,
             .commandBufferCount = 1,
@@ -264,7 +993,7 @@ namespace Corvus
             .pSignalSemaphores = signalSemaphores
         };
 
-        auto success = vkQueueSubmit(m_Device->getQueue("graphics"), 1, &submitInfo, m_InFlightFences[m_CurrentFrame]);
+        auto success = m_Device->getQueue(QueueRole::Graphics).submit(submitInfo, m_InFlightFences[m_CurrentFrame]);
         CORVUS_ASSERT(success == VK_SUCCESS, "Failed to submit draw command buffer!")
     }
 
@@ -280,13 +1009,11 @@ namespace Corvus
             .pResults = nullptr
         };
 
-        auto success = vkQueuePresentKHR(m_Device->getQueue("present"), &presentInfo);
+        auto success = m_Device->getQueue(QueueRole::Present).present(presentInfo);
         if (success == VK_ERROR_OUT_OF_DATE_KHR or success == VK_SUBOPTIMAL_KHR or m_Specification.window->wasResized())
         {
             m_Specification.window->resetResized();
-            m_Device->getSwapChain().recreate(m_Device->getDevice(), m_Device->getPhysicalDevice(),
-                                              m_Device->getSurface(),
-                                              m_Specification.window->getHandle(), m_Device->getRenderPass());
+            m_Device->recreateSwapChain();
         }
         else
         {
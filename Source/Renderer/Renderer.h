@@ -5,19 +5,40 @@
 
 #include "Core/Window.h"
 
+#include "Graphic/Vulkan/ComputePipeline.h"
 #include "Graphic/Vulkan/Device.h"
 #include "Graphic/Vulkan/Pipeline.h"
 #include "Graphic/Vulkan/Vertex.h"
 #include "Graphic/Vulkan/VertexBuffer.h"
 
+#include <array>
+#include <cstring>
 #include <memory>
 #include <filesystem>
 
 #include "Graphic/Vulkan/IndexBuffer.h"
 #include "Graphic/Vulkan/UniformBuffer.h"
+#include "Graphic/Vulkan/DescriptorAllocator.h"
+#include "Graphic/Vulkan/DescriptorSetCache.h"
+#include "Graphic/Vulkan/StorageBuffer.h"
+#include "Graphic/Vulkan/Texture.h"
+
+#include "Camera.h"
+#include "GpuObject.h"
+#include "Mesh.h"
+#include "MeshletBuilder.h"
+#include "MeshletCuller.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "OcclusionCuller.h"
+#include "ParticleSystem.h"
+#include "RenderQueue.h"
+#include "TextureStreamer.h"
 
 namespace Corvus
 {
+    using ComputePipelineHandle = uint32_t;
+
     struct RendererSpecification
     {
         enum class API { Vulkan, OpenGL };
@@ -37,57 +58,264 @@ namespace Corvus
         std::vector<uint32_t> indices = {
             0, 1, 2, 2, 3, 0
         };
+
+        DeviceSelection deviceSelection = DeviceSelection::fromEnvironment();
+        DeviceFeatures deviceFeatures;
+
+        // Lay down depth for opaque draws first so the shading pass runs each pixel's fragment shader only once
+        bool depthPrePass = false;
+
+        // Cull opaque draws on the GPU against last frame's visible set and a depth pyramid, needs dynamic
+        // rendering and replaces the depth pre-pass
+        bool occlusionCulling = false;
+        std::string depthPyramidShader = "Shaders/depthPyramid.glsl.spv";
+        std::string occlusionCullShader = "Shaders/occlusionCull.glsl.spv";
+
+        // Opaque draws per frame that can be handed to the GPU, objectIndex has to stay below it as well
+        uint32_t maxGpuObjects = 16384;
+
+        // Split every mesh into meshlets and cull them against the frustum and their normal cones on the GPU,
+        // opaque draws then become one indirect draw per surviving meshlet. Not combined with occlusion culling.
+        bool meshletCulling = false;
+        std::string meshletCullShader = "Shaders/meshletCull.glsl.spv";
+        uint32_t maxMeshletDraws = 1 << 18;
+
+        // Levels generated for every mesh created from plain index lists
+        LodSettings lodSettings;
+        // A level is used while its simplification error stays below this many pixels on screen
+        float lodErrorPixels = 1.0f;
+        float lodHysteresis = 0.25f;
+        // Welds duplicate vertices and reorders triangles and vertices for the GPU's caches before upload
+        bool optimizeMeshes = true;
+        // Packed encoding halves vertex memory and fetch bandwidth, at half precision positions and 8 bit colors.
+        // Split positions let depth only pipelines fetch positions alone, they then use depthVertexShader.
+        VertexFormat vertexFormat;
+        std::string depthVertexShader = "Shaders/depthVertexShader.glsl.spv";
+
+        // GPU simulated particles, emitters are added through getParticleSystem(). The simulation collides with
+        // the frame's depth, so rendering is split around it and it needs dynamic rendering.
+        bool particles = false;
+        ParticleSettings particleSettings;
+
+        // Builds texture mips for formats that can not be blitted, only loaded once such a texture is created
+        std::string mipDownsampleShader = "Shaders/mipDownsample.glsl.spv";
+
+        // KTX2 textures added through getTextureStreamer() keep only the mip levels resident that requestTexture
+        // asked for in the last frames, within the settings' memory budget
+        bool textureStreaming = false;
+        TextureStreamingSettings textureStreamingSettings;
     };
 
+    // Counted while recording the last frame, a bind is only issued when the sorted queue changes state
+    struct RenderStatistics
+    {
+        uint32_t draws = 0;
+        uint32_t pipelineBinds = 0;
+        uint32_t descriptorBinds = 0;
+        uint32_t meshBinds = 0;
+        uint32_t dispatches = 0;
+    };
+
+    // Construction is split into boot phases so the Engine's BootGraph can overlap them:
+    // createDevice -> (createPipeline | createMesh) -> createFrameResources
     class Renderer
     {
     public:
         explicit Renderer(RendererSpecification specification);
         ~Renderer();
+
+        void createDevice();
+        void createFrameResources();
+
+        // Pipelines and meshes are owned by the renderer and referenced by handle from draw packets.
+        // Creating them is not synchronized, only one thread may create each kind and never during draw().
+        PipelineHandle createPipeline(const std::vector<char>& vertexCode, const std::vector<char>& fragmentCode);
+        MeshHandle createMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
+        MeshHandle createMesh(const std::vector<Vertex>& vertices, const LodChain& lodChain);
+        // Binding i of the pipeline's set has the i-th descriptor type. May also be created after the frame
+        // resources, under the same rules.
+        ComputePipelineHandle createComputePipeline(const std::vector<char>& code,
+                                                    const std::vector<VkDescriptorType>& bindings,
+                                                    uint32_t pushConstantSize = 0);
+        // Uploaded with their whole mip chain before returning, KTX2 files keep their block compressed format.
+        // Same rules as meshes, but may also be created after the frame resources.
+        TextureHandle createTexture(const std::string& path, const TextureSettings& settings = {});
+        TextureHandle createTexture(std::span<const std::byte> pixels, VkExtent2D extent,
+                                    const TextureSettings& settings = {});
+
+        // Queues a dispatch for the next draw(). Dispatches run before any rendering in the order they were
+        // queued, each one sees the writes of those before it and every draw sees all of them. With the
+        // asyncCompute device feature they are submitted to the compute queue and overlap with the previous
+        // frame's rendering, whatever they write should then be per frame in flight.
+        template<PushConstantData T>
+        void dispatch(ComputePipelineHandle pipeline, std::vector<DescriptorWrite> bindings, const T& constants,
+                      glm::uvec3 groupCount)
+        {
+            ComputeDispatch& queued = queueDispatch(pipeline, std::move(bindings), groupCount);
+            std::memcpy(queued.constants.data(), &constants, sizeof(T));
+            queued.constantSize = sizeof(T);
+        }
+        void dispatch(ComputePipelineHandle pipeline, std::vector<DescriptorWrite> bindings, glm::uvec3 groupCount)
+        {
+            queueDispatch(pipeline, std::move(bindings), groupCount);
+        }
+
+        // Level of detail for the mesh drawn with the model matrix this frame, given the level it had last frame
+        [[nodiscard]] uint32_t selectLod(MeshHandle mesh, const glm::mat4& model, uint32_t currentLod) const;
+        // Streams in the detail the texture shows on the mesh drawn with the model matrix this frame. uvScale is
+        // how often the texture repeats across the mesh's largest extent.
+        void requestTexture(StreamedTextureHandle texture, MeshHandle mesh, const glm::mat4& model,
+                            float uvScale = 1.0f);
+
+        // Sorts everything submitted to the render queue since the last frame, records it and clears the queue
         void draw();
         void waitIdle() const;
 
         [[nodiscard]] std::shared_ptr<Device> getDevice() const { return m_Device; }
-        [[nodiscard]] std::shared_ptr<Pipeline> getPipeline() const { return m_Pipeline; }
+        [[nodiscard]] std::shared_ptr<Pipeline> getPipeline(PipelineHandle handle = 0) const { return m_Pipelines[handle]; }
+        [[nodiscard]] const Mesh& getMesh(MeshHandle handle) const { return *m_Meshes[handle]; }
+        [[nodiscard]] const ComputePipeline& getComputePipeline(ComputePipelineHandle handle) const
+        {
+            return *m_ComputePipelines[handle];
+        }
+        [[nodiscard]] const Texture& getTexture(TextureHandle handle) const { return *m_Textures[handle]; }
+        [[nodiscard]] uint32_t getCurrentFrame() const { return m_CurrentFrame; } // Selects per frame resources
+        [[nodiscard]] uint32_t getFramesInFlight() const { return MAX_FRAMES_IN_FLIGHT; }
+        [[nodiscard]] RenderQueue& getRenderQueue() { return m_RenderQueue; }
+        [[nodiscard]] Camera& getCamera() { return m_Camera; }
+        [[nodiscard]] float getAspectRatio() const;
+        [[nodiscard]] glm::mat4 getViewProjection() const;
+        [[nodiscard]] const RenderStatistics& getStatistics() const { return m_Statistics; }
+        [[nodiscard]] ParticleSystem* getParticleSystem() { return m_ParticleSystem.get(); } // Null when disabled
+        [[nodiscard]] TextureStreamer* getTextureStreamer() { return m_TextureStreamer.get(); } // Null when disabled
+
+        // Per-draw data goes inline into the command buffer, no UBO write or descriptor update needed
+        template<PushConstantData T>
+        void pushConstants(VkCommandBuffer commandBuffer, const Pipeline& pipeline, const T& data) const
+        {
+            pipeline.pushConstants(commandBuffer, data);
+        }
 
     private:
         RendererSpecification m_Specification;
         std::shared_ptr<Device> m_Device;
-        std::shared_ptr<Pipeline> m_Pipeline;
+        std::vector<std::shared_ptr<Pipeline>> m_Pipelines;
+        std::vector<std::shared_ptr<Pipeline>> m_DepthPipelines; // Per pipeline, only with a depth pre-pass
+        std::vector<char> m_DepthVertexCode; // Loaded with the first depth pipeline drawing split meshes
+        std::vector<std::unique_ptr<Mesh>> m_Meshes;
+        std::vector<std::unique_ptr<ComputePipeline>> m_ComputePipelines;
+        std::vector<std::unique_ptr<Texture>> m_Textures;
+        std::unique_ptr<ComputePipeline> m_MipDownsampler; // Created with the first texture that needs it
+        std::unique_ptr<TextureStreamer> m_TextureStreamer;
+
+        struct ComputeDispatch
+        {
+            ComputePipelineHandle pipeline;
+            std::vector<DescriptorWrite> bindings;
+            std::array<std::byte, MIN_PUSH_CONSTANT_SIZE> constants;
+            uint32_t constantSize = 0;
+            glm::uvec3 groupCount;
+        };
+        std::vector<ComputeDispatch> m_ComputeDispatches;
+
+        RenderQueue m_RenderQueue;
+        Camera m_Camera;
+        RenderStatistics m_Statistics;
 
         std::vector<VkCommandBuffer> m_CommandBuffers;
         std::vector<VkSemaphore> m_ImageAvailableSemaphores;
         std::vector<VkSemaphore> m_RenderFinishedSemaphores;
         std::vector<VkFence> m_InFlightFences;
+        std::vector<VkCommandBuffer> m_ComputeCommandBuffers; // Only with async compute
+        std::vector<VkSemaphore> m_ComputeFinishedSemaphores;
 
         const uint32_t MAX_FRAMES_IN_FLIGHT = 2;
         uint32_t m_CurrentFrame = 0;
 
-        std::unique_ptr<VertexBuffer> m_VertexBuffer;
-        std::unique_ptr<IndexBuffer> m_IndexBuffer;
         std::vector<UniformBuffer> m_UniformBuffers;
+        std::vector<std::unique_ptr<StorageBuffer>> m_ObjectBuffers; // GpuObjects, one buffer per frame in flight
+        std::unique_ptr<OcclusionCuller> m_OcclusionCuller;
+        std::unique_ptr<MeshletCuller> m_MeshletCuller;
+        std::vector<uint32_t> m_MeshletOffsets; // Per mesh, first meshlet in the culler's buffer
+        std::unique_ptr<ParticleSystem> m_ParticleSystem;
+
+        // One allocator and set cache per frame in flight, both reset once that frame's fence has been waited on
+        std::vector<std::unique_ptr<DescriptorAllocator>> m_DescriptorAllocators;
+        std::vector<std::unique_ptr<DescriptorSetCache>> m_DescriptorSetCaches;
+
+        // What the command buffer currently has bound while recording packets
+        struct BindState
+        {
+            VkPipeline pipeline = VK_NULL_HANDLE;
+            VkPipelineLayout layout = VK_NULL_HANDLE;
+            MeshHandle mesh = UINT32_MAX;
+        };
+
+        // Run of consecutive GpuObjects sharing their state, drawn with a single indirect call
+        struct IndirectBatch
+        {
+            PipelineHandle pipeline;
+            MeshHandle mesh;
+            uint32_t material;
+            uint32_t first;
+            uint32_t count;
+            uint32_t firstDraw = 0; // Meshlet draws, all meshlets of all the batch's objects
+            uint32_t drawCount = 0;
+        };
+        std::vector<IndirectBatch> m_IndirectBatches;
+        std::vector<MeshletTask> m_MeshletTasks;
+        std::vector<MeshletDrawBatch> m_MeshletBatches;
 
     private:
         void createCommandBuffers();
         void createSyncObjects();
+        void createDescriptors();
+        void resetFrameDescriptors();
         void updateCurrentFrame();
 
         void updateUniformBuffer(uint32_t uint32);
+        // Screen pixels one model space unit around the point covers
+        [[nodiscard]] float getPixelsPerUnit(const glm::vec3& point, const glm::mat4& model) const;
+
+        ComputeDispatch& queueDispatch(ComputePipelineHandle pipeline, std::vector<DescriptorWrite> bindings,
+                                       glm::uvec3 groupCount);
+        void recordComputeDispatches(VkCommandBuffer commandBuffer);
+        [[nodiscard]] const ComputePipeline* getMipDownsampler(const TextureSettings& settings);
+        bool submitAsyncCompute();
 
         // Record pipeline
-        void recordCommandBuffers(VkCommandBuffer commandBuffer, uint32_t imageIndex) const;
+        void recordCommandBuffers(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+        void recordDepthPrePass(VkCommandBuffer commandBuffer);
+        void recordDrawPackets(VkCommandBuffer commandBuffer);
+        void recordDrawPacket(VkCommandBuffer commandBuffer, const Pipeline& pipeline, const DrawPacket& packet,
+                              BindState& state);
+        void recordOcclusionCulledPasses(VkCommandBuffer commandBuffer, VkImage image, VkImageView imageView,
+                                         VkExtent2D extent);
+        void recordIndirectBatches(VkCommandBuffer commandBuffer, OcclusionCuller::Phase phase);
+        void cullMeshlets(VkCommandBuffer commandBuffer);
+        void recordMeshletBatches(VkCommandBuffer commandBuffer,
+                                  const std::vector<std::shared_ptr<Pipeline>>& pipelines);
+        void recordParticles(VkCommandBuffer commandBuffer, VkImage image, VkImageView imageView, VkExtent2D extent);
+        uint32_t writeGpuObjects();
+        void bindDrawState(VkCommandBuffer commandBuffer, const Pipeline& pipeline, MeshHandle mesh, BindState& state);
         void beginCommandBuffer() const;
         void beginRenderPass(VkCommandBuffer commandBuffer, VkFramebuffer& framebuffer, VkExtent2D extent) const;
-        static void bindPipeline(VkCommandBuffer commandBuffer, VkPipeline pipeline);
-        static void setViewport(VkCommandBuffer commandBuffer, VkExtent2D extent);
-        static void setScissor(VkCommandBuffer commandBuffer, VkExtent2D extent);
-        static void cleanupFrame(VkCommandBuffer commandBuffer);
+        void beginRendering(VkCommandBuffer commandBuffer, VkImage image, VkImageView imageView, VkExtent2D extent,
+                            VkAttachmentLoadOp loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                            VkAttachmentStoreOp depthStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE) const;
+        void endRendering(VkCommandBuffer commandBuffer, VkImage image) const;
+        [[nodiscard]] VkImageAspectFlags getDepthAspect() const;
+        void bindPipeline(VkCommandBuffer commandBuffer, VkPipeline pipeline) const;
+        void bindDescriptorSets(VkCommandBuffer commandBuffer, const Pipeline& pipeline) const;
+        void setViewport(VkCommandBuffer commandBuffer, VkExtent2D extent) const;
+        void setScissor(VkCommandBuffer commandBuffer, VkExtent2D extent) const;
+        void cleanupFrame(VkCommandBuffer commandBuffer, VkImage image) const;
 
         // Draw pipeline
         void synchronize(VkDevice device) const;
         uint32_t acquireNextImage(VkDevice device, SwapChain& swapChain) const;
         void prepareCommandBuffer(uint32_t imageIndex);
-        void submitGraphicsQueue();
+        void submitGraphicsQueue(bool waitForCompute);
         void presentImage(VkSwapchainKHR swapChain, uint32_t imageIndex);
     };
 }
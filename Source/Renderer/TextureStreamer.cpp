@@ -0,0 +1,309 @@
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#include "Graphic/Vulkan/BufferUtils.h"
+#include "Graphic/Vulkan/ImageUtils.h"
+#include "Graphic/Vulkan/Ktx2.h"
+
+namespace Corvus
+{
+    namespace
+    {
+        void destroyStagingBuffer(const Device& device, VkBuffer buffer, VkDeviceMemory memory)
+        {
+            device.getDispatch().vkDestroyBuffer(device.getDevice(), buffer, nullptr);
+            device.getDispatch().vkFreeMemory(device.getDevice(), memory, nullptr);
+        }
+    }
+
+    TextureStreamer::TextureStreamer(std::shared_ptr<Device> device, const TextureStreamingSettings& settings,
+                                     uint32_t framesInFlight)
+        : m_Device(std::move(device)),
+          m_Settings(settings),
+          m_FramesInFlight(framesInFlight),
+          m_LoadThreads(std::max(1u, settings.loadThreads))
+    {
+    }
+
+    TextureStreamer::~TextureStreamer()
+    {
+        // The load threads may still be allocating, their results are released with everything else
+        for (auto& pending: m_PendingLoads)
+            m_CompletedLoads.push_back(pending.get());
+        for (const auto& load: m_CompletedLoads)
+            destroyStagingBuffer(*m_Device, load.stagingBuffer, load.stagingBufferMemory);
+        for (const auto& retired: m_Retired)
+            destroyStagingBuffer(*m_Device, retired.stagingBuffer, retired.stagingBufferMemory);
+    }
+
+    StreamedTextureHandle TextureStreamer::addTexture(const std::string& path, const SamplerDescription& sampler)
+    {
+        CORVUS_ASSERT(isKtx2File(path), "Only KTX2 files can be streamed, {} needs to be converted first!", path)
+        auto info = readKtx2Info(path);
+        CORVUS_ASSERT(Texture::isFormatSupported(*m_Device, info.format), "Texture format {} of {} is not supported!",
+                      static_cast<uint32_t>(info.format), path)
+
+        uint32_t tailLevel = 0;
+        while (tailLevel + 1 < info.levelCount)
+        {
+            auto extent = getLevelExtent(info.extent, tailLevel);
+            if (std::max(extent.width, extent.height) <= m_Settings.residentTailSize)
+                break;
+            tailLevel++;
+        }
+
+        StreamedTexture texture = {
+            .path = path,
+            .sampler = sampler,
+            .format = info.format,
+            .extent = info.extent,
+            .levelCount = info.levelCount,
+            .tailLevel = tailLevel,
+            .texture = std::make_unique<Texture>(m_Device, loadKtx2(path, tailLevel), sampler),
+            .residentLevel = tailLevel,
+            .requestedLevel = info.levelCount,
+        };
+        m_ResidentBytes += getResidentSize(texture, tailLevel);
+        m_Statistics.residentBytes = m_ResidentBytes;
+
+        CORVUS_LOG(info, "Streaming texture {} ({}x{}, {} mip levels, resident from level {})", path,
+                   info.extent.width, info.extent.height, info.levelCount, tailLevel);
+        m_Textures.push_back(std::move(texture));
+        return static_cast<StreamedTextureHandle>(m_Textures.size() - 1);
+    }
+
+    void TextureStreamer::requestSize(StreamedTextureHandle handle, float screenTexels)
+    {
+        auto& texture = m_Textures[handle];
+
+        // The level whose width matches the texels on screen, rounded towards more detail
+        float level = std::log2(static_cast<float>(texture.extent.width) / std::max(screenTexels, 1.0f)) +
+                      m_Settings.mipBias;
+        auto requested = static_cast<uint32_t>(std::clamp(std::floor(level), 0.0f,
+                                                          static_cast<float>(texture.tailLevel)));
+        texture.requestedLevel = std::min(texture.requestedLevel, requested);
+    }
+
+    void TextureStreamer::update()
+    {
+        m_FrameNumber++;
+        for (auto& texture: m_Textures)
+        {
+            if (texture.requestedLevel < texture.levelCount)
+                texture.lastRequestFrame = m_FrameNumber;
+        }
+
+        destroyRetired();
+        collectLoads();
+        evictIdle();
+        scheduleLoads();
+
+        for (auto& texture: m_Textures)
+            texture.requestedLevel = texture.levelCount;
+        m_Statistics.residentBytes = m_ResidentBytes;
+        m_Statistics.pendingLoads = static_cast<uint32_t>(m_PendingLoads.size());
+    }
+
+    void TextureStreamer::recordUploads(VkCommandBuffer commandBuffer)
+    {
+        for (auto& load: m_CompletedLoads)
+        {
+            VkImage image = load.texture->getImage();
+            ImageUtils::transitionImageLayout(*m_Device, commandBuffer, image, VK_IMAGE_LAYOUT_UNDEFINED,
+                                              VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+            load.texture->recordCopy(commandBuffer, load.stagingBuffer, load.levels);
+            ImageUtils::transitionImageLayout(*m_Device, commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                              VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+            // Descriptors of this frame may still point at the old image
+            auto& texture = m_Textures[load.handle];
+            m_Retired.push_back({m_FrameNumber, std::move(texture.texture), load.stagingBuffer,
+                                 load.stagingBufferMemory});
+            texture.texture = std::move(load.texture);
+            texture.residentLevel = load.level;
+            texture.loading = false;
+        }
+        m_CompletedLoads.clear();
+    }
+
+    VkDeviceSize TextureStreamer::getResidentSize(const StreamedTexture& texture, uint32_t level) const
+    {
+        VkDeviceSize size = 0;
+        for (; level < texture.levelCount; level++)
+            size += getLevelSize(texture.format, getLevelExtent(texture.extent, level));
+        return size;
+    }
+
+    uint32_t TextureStreamer::getNeededLevel(const StreamedTexture& texture) const
+    {
+        return texture.lastRequestFrame == m_FrameNumber ? texture.requestedLevel : texture.tailLevel;
+    }
+
+    void TextureStreamer::destroyRetired()
+    {
+        // The fence of the frame that retired them has been waited on once framesInFlight frames have started
+        while (not m_Retired.empty() and m_Retired.front().frame + m_FramesInFlight <= m_FrameNumber)
+        {
+            destroyStagingBuffer(*m_Device, m_Retired.front().stagingBuffer, m_Retired.front().stagingBufferMemory);
+            m_Retired.pop_front();
+        }
+    }
+
+    void TextureStreamer::collectLoads()
+    {
+        std::erase_if(m_PendingLoads, [this](std::future<Load>& pending) {
+            if (pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                return false;
+            m_CompletedLoads.push_back(pending.get());
+            return true;
+        });
+    }
+
+    void TextureStreamer::evictIdle()
+    {
+        // Dropping back to the tail is a load too, whatever does not fit is evicted in a later update
+        for (StreamedTextureHandle handle = 0; handle < m_Textures.size(); handle++)
+        {
+            if (m_PendingLoads.size() >= m_Settings.maxPendingLoads)
+                break;
+
+            const auto& texture = m_Textures[handle];
+            if (not texture.loading and texture.residentLevel < texture.tailLevel and
+                m_FrameNumber - texture.lastRequestFrame > m_Settings.idleFrames)
+            {
+                startLoad(handle, texture.tailLevel);
+                m_Statistics.evictions++;
+            }
+        }
+    }
+
+    void TextureStreamer::scheduleLoads()
+    {
+        std::vector<StreamedTextureHandle> candidates;
+        for (StreamedTextureHandle handle = 0; handle < m_Textures.size(); handle++)
+        {
+            const auto& texture = m_Textures[handle];
+            if (not texture.loading and texture.requestedLevel < texture.residentLevel)
+                candidates.push_back(handle);
+        }
+
+        // Whatever misses the most detail goes first
+        auto getMissingLevels = [this](StreamedTextureHandle handle) {
+            return m_Textures[handle].residentLevel - m_Textures[handle].requestedLevel;
+        };
+        std::ranges::stable_sort(candidates, [&](StreamedTextureHandle a, StreamedTextureHandle b) {
+            return getMissingLevels(a) > getMissingLevels(b);
+        });
+
+        for (auto handle: candidates)
+        {
+            if (m_PendingLoads.size() >= m_Settings.maxPendingLoads)
+                break;
+
+            // Settles for less detail when not even evicting everything else makes room
+            const auto& texture = m_Textures[handle];
+            VkDeviceSize residentSize = getResidentSize(texture, texture.residentLevel);
+            uint32_t level = texture.requestedLevel;
+            for (; level < texture.residentLevel; level++)
+            {
+                VkDeviceSize required = m_ResidentBytes + getResidentSize(texture, level) - residentSize;
+                if (required <= m_Settings.budget or evict(required - m_Settings.budget, handle))
+                    break;
+            }
+
+            if (level < texture.residentLevel)
+            {
+                startLoad(handle, level);
+                m_Statistics.loads++;
+            }
+        }
+    }
+
+    bool TextureStreamer::evict(VkDeviceSize bytes, StreamedTextureHandle requester)
+    {
+        struct Candidate
+        {
+            StreamedTextureHandle handle;
+            uint32_t level;
+            VkDeviceSize freed;
+        };
+
+        // Textures holding more than this frame needs, either because nothing asked for them or for less detail
+        std::vector<Candidate> candidates;
+        for (StreamedTextureHandle handle = 0; handle < m_Textures.size(); handle++)
+        {
+            const auto& texture = m_Textures[handle];
+            uint32_t level = getNeededLevel(texture);
+            if (handle == requester or texture.loading or level <= texture.residentLevel)
+                continue;
+
+            VkDeviceSize freed = getResidentSize(texture, texture.residentLevel) - getResidentSize(texture, level);
+            candidates.push_back({handle, level, freed});
+        }
+
+        std::ranges::sort(candidates, [this](const Candidate& a, const Candidate& b) {
+            const auto& first = m_Textures[a.handle];
+            const auto& second = m_Textures[b.handle];
+            if (first.lastRequestFrame != second.lastRequestFrame)
+                return first.lastRequestFrame < second.lastRequestFrame;
+            return a.freed > b.freed;
+        });
+
+        size_t evictionCount = 0;
+        VkDeviceSize freed = 0;
+        for (; evictionCount < candidates.size() and freed < bytes; evictionCount++)
+            freed += candidates[evictionCount].freed;
+        if (freed < bytes)
+            return false;
+
+        // Every eviction is a load of its own, and the requester's load needs a slot after them. scheduleLoads
+        // only asks while a slot is free.
+        if (m_PendingLoads.size() + evictionCount + 1 > m_Settings.maxPendingLoads)
+            return false;
+
+        for (size_t i = 0; i < evictionCount; i++)
+        {
+            startLoad(candidates[i].handle, candidates[i].level);
+            m_Statistics.evictions++;
+        }
+        return true;
+    }
+
+    void TextureStreamer::startLoad(StreamedTextureHandle handle, uint32_t level)
+    {
+        auto& texture = m_Textures[handle];
+        m_ResidentBytes = m_ResidentBytes + getResidentSize(texture, level) -
+                          getResidentSize(texture, texture.residentLevel);
+        texture.loading = true;
+
+        // Levels that stay resident are read again rather than copied from the old image, which is then never
+        // touched while frames in flight sample it. They add at most a third to the new levels.
+        m_PendingLoads.push_back(m_LoadThreads.submit(
+            [device = m_Device, handle, level, path = texture.path, sampler = texture.sampler]
+            {
+                auto image = loadKtx2(path, level);
+                Load load = {
+                    .handle = handle,
+                    .level = level,
+                    .texture = std::make_unique<Texture>(device, image.format, image.extent,
+                                                         static_cast<uint32_t>(image.levels.size()), sampler),
+                    .levels = image.levels,
+                };
+
+                BufferUtils::createBuffer(*device, image.data.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT bitor
+                                          VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                          load.stagingBuffer, load.stagingBufferMemory);
+                void* mapped;
+                const auto& vk = device->getDispatch();
+                vk.vkMapMemory(device->getDevice(), load.stagingBufferMemory, 0, image.data.size(), 0, &mapped);
+                std::memcpy(mapped, image.data.data(), image.data.size());
+                vk.vkUnmapMemory(device->getDevice(), load.stagingBufferMemory);
+                return load;
+            }));
+    }
+} // Corvus
@@ -0,0 +1,153 @@
+#ifndef ENGINE_TEXTURESTREAMER_H
+#define ENGINE_TEXTURESTREAMER_H
+
+#include <deque>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Graphic/Vulkan/Device.h"
+#include "Graphic/Vulkan/Texture.h"
+#include "Utility/ThreadPool.h"
+
+namespace Corvus
+{
+    using StreamedTextureHandle = uint32_t;
+
+    struct TextureStreamingSettings
+    {
+        // Device memory all streamed levels may occupy together, mip tails included
+        VkDeviceSize budget = VkDeviceSize{256} << 20;
+        // Levels up to this size are loaded with the texture and stay resident
+        uint32_t residentTailSize = 64;
+        // Residency changes being read and allocated at once, evictions included. They run on threads of their own,
+        // so reading from disk never holds up the frame's work on the shared ThreadPool.
+        uint32_t maxPendingLoads = 4;
+        uint32_t loadThreads = 2;
+        // Textures no frame asked for in this many frames drop back to their tail, even within the budget
+        uint32_t idleFrames = 300;
+        // Positive values stream in less detail than the screen size asks for
+        float mipBias = 0.0f;
+    };
+
+    struct TextureStreamingStatistics
+    {
+        VkDeviceSize residentBytes = 0;
+        uint32_t pendingLoads = 0;
+        uint32_t loads = 0; // Since the streamer was created
+        uint32_t evictions = 0;
+    };
+
+    // Keeps the mip levels of KTX2 textures resident that the frames ask for. Every texture starts with its small
+    // mip tail, requestSize raises that from the frame's screen space feedback and whatever does not fit into the
+    // budget is taken from the least recently requested textures first.
+    // A residency change builds a new image holding the new first level and everything below it. A load thread
+    // reads those levels and allocates the image and its staging buffer, the copy is then recorded at the start
+    // of the next frame. The old image keeps being sampled untouched until the frames in flight are done with it,
+    // so descriptors change with the residency and have to be fetched every frame.
+    class TextureStreamer
+    {
+    public:
+        TextureStreamer(std::shared_ptr<Device> device, const TextureStreamingSettings& settings,
+                        uint32_t framesInFlight);
+        ~TextureStreamer();
+
+        TextureStreamer(const TextureStreamer&) = delete;
+        TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+        // Only the mip tail is loaded before returning. Not synchronized, the same rules as for textures apply.
+        StreamedTextureHandle addTexture(const std::string& path, const SamplerDescription& sampler = {});
+
+        // Feedback of the frame being built, the texels the texture spans on screen across its width. The finest
+        // level any request of the frame asks for is streamed in.
+        void requestSize(StreamedTextureHandle handle, float screenTexels);
+
+        // Once per frame after its fence has been waited on. Destroys what the finished frames used, picks up
+        // completed loads and turns the frame's requests into new loads and evictions.
+        void update();
+        // Copies the loads update picked up, before anything of the frame samples them
+        void recordUploads(VkCommandBuffer commandBuffer);
+
+        [[nodiscard]] const Texture& getTexture(StreamedTextureHandle handle) const
+        {
+            return *m_Textures[handle].texture;
+        }
+        [[nodiscard]] DescriptorWrite getDescriptor(StreamedTextureHandle handle, uint32_t binding) const
+        {
+            return m_Textures[handle].texture->getDescriptor(binding);
+        }
+        // Finest resident level of the full chain, 0 is full resolution
+        [[nodiscard]] uint32_t getResidentLevel(StreamedTextureHandle handle) const
+        {
+            return m_Textures[handle].residentLevel;
+        }
+        [[nodiscard]] const TextureStreamingStatistics& getStatistics() const { return m_Statistics; }
+
+    private:
+        struct StreamedTexture
+        {
+            std::string path;
+            SamplerDescription sampler;
+            VkFormat format;
+            VkExtent2D extent;
+            uint32_t levelCount;
+            uint32_t tailLevel; // First level of the tail that is always resident
+
+            std::unique_ptr<Texture> texture; // Holds the levels from residentLevel on
+            uint32_t residentLevel;
+            uint32_t requestedLevel; // Finest level asked for since the last update, levelCount if none
+            uint64_t lastRequestFrame = 0;
+            bool loading = false;
+        };
+
+        // Built on a load thread, swapped in by recordUploads
+        struct Load
+        {
+            StreamedTextureHandle handle;
+            uint32_t level;
+            std::unique_ptr<Texture> texture;
+            std::vector<TextureLevel> levels; // In the staging buffer
+            VkBuffer stagingBuffer = VK_NULL_HANDLE;
+            VkDeviceMemory stagingBufferMemory = VK_NULL_HANDLE;
+        };
+
+        // Kept until the frames in flight that may still use it are done
+        struct Retired
+        {
+            uint64_t frame;
+            std::unique_ptr<Texture> texture;
+            VkBuffer stagingBuffer = VK_NULL_HANDLE;
+            VkDeviceMemory stagingBufferMemory = VK_NULL_HANDLE;
+        };
+
+        std::shared_ptr<Device> m_Device;
+        TextureStreamingSettings m_Settings;
+        uint32_t m_FramesInFlight;
+        uint64_t m_FrameNumber = 0;
+
+        std::vector<StreamedTexture> m_Textures;
+        std::vector<std::future<Load>> m_PendingLoads;
+        std::vector<Load> m_CompletedLoads; // Recorded into the current frame
+        std::deque<Retired> m_Retired;
+        VkDeviceSize m_ResidentBytes = 0; // Of what every texture's latest load will hold
+        TextureStreamingStatistics m_Statistics;
+        ThreadPool m_LoadThreads;
+
+    private:
+        [[nodiscard]] VkDeviceSize getResidentSize(const StreamedTexture& texture, uint32_t level) const;
+        // Level the texture should hold this frame when memory is short, coarser than what it holds if unused
+        [[nodiscard]] uint32_t getNeededLevel(const StreamedTexture& texture) const;
+
+        void destroyRetired();
+        void collectLoads();
+        void evictIdle();
+        void scheduleLoads();
+        // Frees at least the requested bytes from least recently requested textures, except the given one. Fails
+        // without evicting anything if that is not possible within the pending load limit.
+        bool evict(VkDeviceSize bytes, StreamedTextureHandle requester);
+        void startLoad(StreamedTextureHandle handle, uint32_t level);
+    };
+} // Corvus
+
+#endif //ENGINE_TEXTURESTREAMER_H
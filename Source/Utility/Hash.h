@@ -0,0 +1,17 @@
+#ifndef ENGINE_HASH_H
+#define ENGINE_HASH_H
+
+#include <cstddef>
+#include <functional>
+
+namespace Corvus
+{
+    // boost::hash_combine, used to build hashes for cache keys out of their members
+    template<typename T>
+    void hashCombine(size_t& seed, const T& value)
+    {
+        seed ^= std::hash<T>{}(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+    }
+} // Corvus
+
+#endif //ENGINE_HASH_H
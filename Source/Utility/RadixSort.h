@@ -0,0 +1,107 @@
+#ifndef ENGINE_RADIXSORT_H
+#define ENGINE_RADIXSORT_H
+
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <vector>
+
+#include "Utility/ThreadPool.h"
+
+namespace Corvus
+{
+    // Stable LSD radix sort of keys carrying a 32-bit payload, 8 bits per pass. Each pass builds per-chunk
+    // histograms and scatters the chunks in parallel, passes in which every key has the same digit are skipped.
+    template<std::unsigned_integral Key>
+    void radixSort(std::vector<Key>& keys, std::vector<uint32_t>& values,
+                   ThreadPool& threadPool = ThreadPool::getInstance())
+    {
+        constexpr size_t RADIX = 256;
+        constexpr size_t PASSES = sizeof(Key);
+        constexpr size_t MIN_CHUNK = 4096;
+        using Histogram = std::array<uint32_t, RADIX>;
+
+        const size_t count = keys.size();
+        if (count < 2)
+            return;
+
+        const size_t chunkCount = std::min<size_t>(threadPool.getThreadCount() + 1, (count + MIN_CHUNK - 1) / MIN_CHUNK);
+        const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+        auto forEachChunk = [&](auto&& function)
+        {
+            threadPool.parallelFor(chunkCount, 1, [&](size_t firstChunk, size_t lastChunk)
+            {
+                for (size_t chunk = firstChunk; chunk < lastChunk; chunk++)
+                    function(chunk, chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize));
+            });
+        };
+
+        // Global digit counts of every pass, a pass is a no-op when one digit holds all keys
+        std::vector<std::array<Histogram, PASSES>> chunkTotals(chunkCount);
+        forEachChunk([&](size_t chunk, size_t begin, size_t end)
+        {
+            auto& totals = chunkTotals[chunk];
+            for (auto& histogram: totals)
+                histogram.fill(0);
+            for (size_t i = begin; i < end; i++)
+            {
+                for (size_t pass = 0; pass < PASSES; pass++)
+                    totals[pass][(keys[i] >> (pass * 8)) & 0xFF]++;
+            }
+        });
+
+        std::vector<Key> keyScratch(count);
+        std::vector<uint32_t> valueScratch(count);
+        std::vector<Histogram> offsets(chunkCount);
+
+        for (size_t pass = 0; pass < PASSES; pass++)
+        {
+            const size_t shift = pass * 8;
+            bool trivial = false;
+            for (size_t digit = 0; digit < RADIX and not trivial; digit++)
+            {
+                size_t total = 0;
+                for (const auto& totals: chunkTotals)
+                    total += totals[pass][digit];
+                trivial = total == count;
+            }
+            if (trivial)
+                continue;
+
+            forEachChunk([&](size_t chunk, size_t begin, size_t end)
+            {
+                offsets[chunk].fill(0);
+                for (size_t i = begin; i < end; i++)
+                    offsets[chunk][(keys[i] >> shift) & 0xFF]++;
+            });
+
+            // Exclusive prefix over (digit, chunk) keeps equal digits in chunk order, which makes the sort stable
+            uint32_t running = 0;
+            for (size_t digit = 0; digit < RADIX; digit++)
+            {
+                for (size_t chunk = 0; chunk < chunkCount; chunk++)
+                {
+                    uint32_t digitCount = offsets[chunk][digit];
+                    offsets[chunk][digit] = running;
+                    running += digitCount;
+                }
+            }
+
+            forEachChunk([&](size_t chunk, size_t begin, size_t end)
+            {
+                auto& offset = offsets[chunk];
+                for (size_t i = begin; i < end; i++)
+                {
+                    uint32_t destination = offset[(keys[i] >> shift) & 0xFF]++;
+                    keyScratch[destination] = keys[i];
+                    valueScratch[destination] = values[i];
+                }
+            });
+
+            keys.swap(keyScratch);
+            values.swap(valueScratch);
+        }
+    }
+} // Corvus
+
+#endif //ENGINE_RADIXSORT_H
@@ -0,0 +1,71 @@
+#ifndef ENGINE_SIMD_H
+#define ENGINE_SIMD_H
+
+// Kernels for wider instruction sets are compiled next to the baseline code and selected at runtime, so the
+// binary keeps running on CPUs without them. GCC and Clang need the target attribute to emit those instructions,
+// MSVC accepts the intrinsics anywhere.
+#if defined(__x86_64__) or defined(_M_X64)
+    #define CORVUS_SIMD_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) and not defined(__clang__)
+        #include <intrin.h>
+        #define CORVUS_TARGET_AVX2
+    #else
+        #define CORVUS_TARGET_AVX2 __attribute__((target("avx2,fma")))
+    #endif
+#else
+    #define CORVUS_SIMD_X86 0
+    #define CORVUS_TARGET_AVX2
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <string_view>
+
+namespace Corvus
+{
+    enum class SimdLevel { Scalar, SSE2, AVX2 };
+
+    [[nodiscard]] inline SimdLevel detectSimdLevel()
+    {
+#if CORVUS_SIMD_X86
+    #if defined(_MSC_VER) and not defined(__clang__)
+        int info[4];
+        __cpuidex(info, 7, 0);
+        bool avx2 = info[1] bitand (1 << 5);
+        __cpuid(info, 1);
+        bool fma = info[2] bitand (1 << 12);
+        bool osxsave = info[2] bitand (1 << 27);
+        // The OS has to save the upper ymm halves on context switches
+        bool ymmEnabled = osxsave and (_xgetbv(0) bitand 0x6) == 0x6;
+        return avx2 and fma and ymmEnabled ? SimdLevel::AVX2 : SimdLevel::SSE2;
+    #else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma") ? SimdLevel::AVX2 : SimdLevel::SSE2;
+    #endif
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+
+    // Detected once, CORVUS_SIMD=scalar|sse2|avx2 caps it for debugging and comparisons
+    [[nodiscard]] inline SimdLevel getSimdLevel()
+    {
+        static const SimdLevel level = []
+        {
+            SimdLevel detected = detectSimdLevel();
+            const char* value = std::getenv("CORVUS_SIMD");
+            if (value == nullptr)
+                return detected;
+
+            std::string_view requested = value;
+            SimdLevel cap = requested == "scalar" ? SimdLevel::Scalar
+                          : requested == "sse2" ? SimdLevel::SSE2
+                          : SimdLevel::AVX2;
+            return std::min(detected, cap);
+        }();
+        return level;
+    }
+} // Corvus
+
+#endif //ENGINE_SIMD_H
@@ -0,0 +1,117 @@
+#ifndef ENGINE_THREADPOOL_H
+#define ENGINE_THREADPOOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "Utility/Corvus.h"
+
+namespace Corvus
+{
+    class ThreadPool
+    {
+    public:
+        // hardware_concurrency may report 0, the pool then still gets one worker
+        explicit ThreadPool(uint32_t threadCount = std::max(2u, std::thread::hardware_concurrency()) - 1)
+        {
+            for (uint32_t i = 0; i < threadCount; i++)
+            {
+                m_Workers.emplace_back([this](const std::stop_token& stopToken) { workerLoop(stopToken); });
+            }
+        }
+
+        ~ThreadPool()
+        {
+            for (auto& worker: m_Workers)
+                worker.request_stop();
+            m_Condition.notify_all();
+            m_Workers.clear(); // Join before the queue and its lock are destroyed
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        static ThreadPool& getInstance()
+        {
+            static ThreadPool instance;
+            return instance;
+        }
+
+        template<typename Function>
+        auto submit(Function&& function) -> std::future<std::invoke_result_t<Function>>
+        {
+            using Result = std::invoke_result_t<Function>;
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+            auto future = task->get_future();
+            {
+                std::lock_guard lock(m_Mutex);
+                m_Tasks.emplace([task] { (*task)(); });
+            }
+            m_Condition.notify_one();
+            return future;
+        }
+
+        // Splits [0, count) into chunks of at least minChunk elements and runs them on the workers.
+        // The calling thread processes the first chunk itself and blocks until all chunks are done. Must not be
+        // called from one of this pool's workers, which could all end up waiting on chunks queued behind them.
+        template<typename Function>
+        void parallelFor(size_t count, size_t minChunk, Function&& function)
+        {
+            CORVUS_ASSERT(s_CurrentPool != this, "parallelFor called from a worker of the same thread pool!")
+            if (count == 0)
+                return;
+
+            size_t chunkCount = std::min<size_t>(getThreadCount() + 1, (count + minChunk - 1) / minChunk);
+            size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+
+            std::vector<std::future<void>> futures;
+            futures.reserve(chunkCount);
+            for (size_t begin = chunkSize; begin < count; begin += chunkSize)
+            {
+                size_t end = std::min(count, begin + chunkSize);
+                futures.push_back(submit([&function, begin, end] { function(begin, end); }));
+            }
+
+            function(size_t{0}, std::min(count, chunkSize));
+            for (auto& future: futures)
+                future.get();
+        }
+
+        [[nodiscard]] uint32_t getThreadCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+    private:
+        std::vector<std::jthread> m_Workers;
+        std::queue<std::function<void()>> m_Tasks;
+        std::mutex m_Mutex;
+        std::condition_variable_any m_Condition;
+
+        static inline thread_local const ThreadPool* s_CurrentPool = nullptr; // Pool the calling thread works for
+
+        void workerLoop(const std::stop_token& stopToken)
+        {
+            s_CurrentPool = this;
+            while (true)
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock lock(m_Mutex);
+                    m_Condition.wait(lock, stopToken, [this] { return not m_Tasks.empty(); });
+                    if (m_Tasks.empty())
+                        return; // Stop requested and nothing left to run
+
+                    task = std::move(m_Tasks.front());
+                    m_Tasks.pop();
+                }
+                task();
+            }
+        }
+    };
+} // Corvus
+
+#endif //ENGINE_THREADPOOL_H
@@ -0,0 +1,265 @@
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "Graphic/Vulkan/DescriptorAllocator.h"
+#include "Graphic/Vulkan/DescriptorSetCache.h"
+#include "Graphic/Vulkan/Device.h"
+#include "Graphic/Vulkan/StorageBuffer.h"
+#include "Renderer/ComputePrimitives.h"
+#include "Utility/Corvus.h"
+
+using namespace Corvus;
+
+namespace
+{
+    // Multiple scan tiles and a partial last tile for every kernel
+    constexpr uint32_t CAPACITY = 20000;
+    constexpr std::array<uint32_t, 6> COUNTS = {0, 1, 255, ComputePrimitives::SCAN_TILE_SIZE, 5000, CAPACITY};
+
+    struct TestContext
+    {
+        std::shared_ptr<Device> device;
+        DescriptorAllocator allocator;
+        DescriptorSetCache descriptorSets;
+        ComputePrimitives primitives;
+        std::mt19937_64 random{42};
+
+        explicit TestContext(std::shared_ptr<Device> testDevice)
+            : device(std::move(testDevice)),
+              allocator(device),
+              descriptorSets(device, allocator),
+              primitives(device, CAPACITY)
+        {
+        }
+    };
+
+    // Records the work into a one time command buffer on the graphics queue and waits for the results to be
+    // readable on the host
+    template<typename Record>
+    void run(TestContext& context, Record&& record)
+    {
+        const auto& device = *context.device;
+        const auto& vk = device.getDispatch();
+        VkCommandBufferAllocateInfo allocInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = device.getCommandPool(),
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 1,
+        };
+        VkCommandBuffer commandBuffer;
+        vk.vkAllocateCommandBuffers(device.getDevice(), &allocInfo, &commandBuffer);
+
+        VkCommandBufferBeginInfo beginInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        };
+        vk.vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        record(commandBuffer);
+        memoryBarrier(device, commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT bitor VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_ACCESS_SHADER_WRITE_BIT bitor VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                      VK_ACCESS_HOST_READ_BIT);
+        vk.vkEndCommandBuffer(commandBuffer);
+
+        VkSubmitInfo submitInfo = {
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            .commandBufferCount = 1,
+            .pCommandBuffers = &commandBuffer,
+        };
+        auto& queue = device.getQueue(QueueRole::Graphics);
+        queue.submit(submitInfo, VK_NULL_HANDLE);
+        queue.waitIdle();
+
+        vk.vkFreeCommandBuffers(device.getDevice(), device.getCommandPool(), 1, &commandBuffer);
+        context.descriptorSets.clear();
+        context.allocator.reset();
+    }
+
+    // Host visible, so the test can fill and read it directly. Empty inputs still get a buffer to bind.
+    template<typename T>
+    std::unique_ptr<StorageBuffer> createBuffer(const TestContext& context, const std::vector<T>& data,
+                                                size_t elementCount)
+    {
+        auto buffer = std::make_unique<StorageBuffer>(context.device, std::max<size_t>(elementCount, 1) * sizeof(T),
+                                                      StorageBuffer::Access::HostWrite,
+                                                      VK_BUFFER_USAGE_TRANSFER_SRC_BIT bitor
+                                                      VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+        std::memcpy(buffer->getMappedData(), data.data(), data.size() * sizeof(T));
+        return buffer;
+    }
+
+    template<typename T>
+    std::unique_ptr<StorageBuffer> createBuffer(const TestContext& context, const std::vector<T>& data)
+    {
+        return createBuffer(context, data, data.size());
+    }
+
+    template<typename T>
+    std::vector<T> read(const StorageBuffer& buffer, size_t count)
+    {
+        std::vector<T> data(count);
+        std::memcpy(data.data(), buffer.getMappedData(), count * sizeof(T));
+        return data;
+    }
+
+    template<typename T>
+    bool expectEqual(std::string_view name, uint32_t count, const std::vector<T>& actual,
+                     const std::vector<T>& expected)
+    {
+        if (actual.size() != expected.size())
+        {
+            CORVUS_LOG(error, "{} of {} elements: {} results instead of {}", name, count, actual.size(),
+                       expected.size());
+            return false;
+        }
+        for (size_t i = 0; i < actual.size(); i++)
+        {
+            if (actual[i] != expected[i])
+            {
+                CORVUS_LOG(error, "{} of {} elements: element {} is {} instead of {}", name, count, i, actual[i],
+                           expected[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename T>
+    std::vector<T> generate(TestContext& context, uint32_t count, T maximum)
+    {
+        std::uniform_int_distribution<T> distribution(0, maximum);
+        std::vector<T> data(count);
+        for (auto& value: data)
+            value = distribution(context.random);
+        return data;
+    }
+
+    bool testExclusiveScan(TestContext& context, uint32_t count)
+    {
+        auto input = generate<uint32_t>(context, count, 255);
+        auto inputBuffer = createBuffer(context, input);
+        auto outputBuffer = createBuffer(context, std::vector<uint32_t>{}, count);
+
+        run(context, [&](VkCommandBuffer commandBuffer) {
+            context.primitives.exclusiveScan(commandBuffer, context.descriptorSets, *inputBuffer, *outputBuffer,
+                                             count);
+        });
+        return expectEqual("exclusiveScan", count, read<uint32_t>(*outputBuffer, count),
+                           referenceExclusiveScan(input));
+    }
+
+    bool testCompact(TestContext& context, uint32_t count)
+    {
+        auto values = generate<uint32_t>(context, count, UINT32_MAX);
+        auto flags = generate<uint32_t>(context, count, 1);
+        auto valueBuffer = createBuffer(context, values);
+        auto flagBuffer = createBuffer(context, flags);
+        auto outputBuffer = createBuffer(context, std::vector<uint32_t>{}, count);
+        auto countBuffer = createBuffer(context, std::vector<uint32_t>{UINT32_MAX}); // Has to be overwritten
+
+        run(context, [&](VkCommandBuffer commandBuffer) {
+            context.primitives.compact(commandBuffer, context.descriptorSets, *valueBuffer, *flagBuffer,
+                                       *outputBuffer, *countBuffer, count);
+        });
+        uint32_t written = read<uint32_t>(*countBuffer, 1)[0];
+        if (written > count)
+        {
+            CORVUS_LOG(error, "compact of {} elements: wrote {} elements", count, written);
+            return false;
+        }
+        return expectEqual("compact", count, read<uint32_t>(*outputBuffer, written), referenceCompact(values, flags));
+    }
+
+    template<typename Key>
+    bool testSortKeyValues(TestContext& context, uint32_t count, uint32_t keyBits, bool withValues)
+    {
+        constexpr auto keyWidth = sizeof(Key) == sizeof(uint64_t) ? ComputePrimitives::KeyWidth::Bits64
+                                                                    : ComputePrimitives::KeyWidth::Bits32;
+        auto keys = generate<Key>(context, count, std::numeric_limits<Key>::max());
+        std::vector<uint32_t> values(count);
+        std::iota(values.begin(), values.end(), 0u);
+        auto keyBuffer = createBuffer(context, keys);
+        auto valueBuffer = createBuffer(context, values);
+
+        run(context, [&](VkCommandBuffer commandBuffer) {
+            context.primitives.sortKeyValues(commandBuffer, context.descriptorSets, *keyBuffer,
+                                             withValues ? valueBuffer.get() : nullptr, count, keyWidth, keyBits);
+        });
+
+        auto expectedValues = values;
+        if (withValues)
+            referenceSortKeyValues(std::span(keys), std::span(expectedValues), keyBits);
+        else
+            referenceSortKeyValues(std::span(keys), std::nullopt, keyBits);
+
+        bool passed = expectEqual(withValues ? "sortKeyValues keys" : "sortKeys", count, read<Key>(*keyBuffer, count),
+                                  keys);
+        if (withValues)
+            passed = expectEqual("sortKeyValues values", count, read<uint32_t>(*valueBuffer, count),
+                                 expectedValues) and passed;
+        return passed;
+    }
+
+    bool testHistogram(TestContext& context, uint32_t count)
+    {
+        // Values reach past the last bin, which collects everything out of range
+        constexpr uint32_t BIN_COUNT = 16;
+        constexpr uint32_t SHIFT = 6;
+        auto values = generate<uint32_t>(context, count, 4095);
+        auto valueBuffer = createBuffer(context, values);
+        auto binBuffer = createBuffer(context, std::vector<uint32_t>(BIN_COUNT, UINT32_MAX)); // Has to be cleared
+
+        run(context, [&](VkCommandBuffer commandBuffer) {
+            context.primitives.histogram(commandBuffer, context.descriptorSets, *valueBuffer, *binBuffer, count,
+                                         BIN_COUNT, SHIFT);
+        });
+        return expectEqual("histogram", count, read<uint32_t>(*binBuffer, BIN_COUNT),
+                           referenceHistogram(values, BIN_COUNT, SHIFT));
+    }
+}
+
+// Checks the GPU compute primitives against their CPU references on a headless device. CORVUS_DEVICE selects the
+// implementation, e.g. a software one such as lavapipe where no GPU is available.
+int main()
+{
+    TestContext context(std::make_shared<Device>(nullptr, DeviceSelection::fromEnvironment()));
+
+    uint32_t checks = 0;
+    uint32_t failures = 0;
+    auto check = [&](bool passed) {
+        checks++;
+        failures += passed ? 0 : 1;
+    };
+
+    for (uint32_t count: COUNTS)
+    {
+        check(testExclusiveScan(context, count));
+        check(testCompact(context, count));
+        check(testHistogram(context, count));
+
+        // Full keys sort in an even number of passes, 12 and 36 bits in an odd one that copies back from scratch
+        for (bool withValues: {false, true})
+        {
+            check(testSortKeyValues<uint32_t>(context, count, 32, withValues));
+            check(testSortKeyValues<uint32_t>(context, count, 12, withValues));
+            check(testSortKeyValues<uint64_t>(context, count, 64, withValues));
+            check(testSortKeyValues<uint64_t>(context, count, 36, withValues));
+        }
+    }
+
+    context.device->getDispatch().vkDeviceWaitIdle(context.device->getDevice());
+    if (failures > 0)
+    {
+        CORVUS_LOG(error, "{} of {} compute primitive checks failed", failures, checks);
+        return EXIT_FAILURE;
+    }
+    CORVUS_LOG(info, "All {} compute primitive checks passed", checks);
+    return EXIT_SUCCESS;
+}
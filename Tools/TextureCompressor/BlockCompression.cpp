@@ -0,0 +1,475 @@
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <span>
+
+namespace Corvus
+{
+    namespace
+    {
+        template<size_t Channels>
+        using Color = std::array<float, Channels>;
+
+        template<size_t Channels>
+        struct Endpoints
+        {
+            Color<Channels> first;
+            Color<Channels> second;
+        };
+
+        constexpr std::array<float, 4> BC1_WEIGHTS = {0.0f, 1.0f / 3.0f, 2.0f / 3.0f, 1.0f};
+        constexpr std::array<float, 3> BC1_PUNCH_THROUGH_WEIGHTS = {0.0f, 0.5f, 1.0f};
+        constexpr std::array<uint32_t, 16> BC7_WEIGHTS = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+        template<size_t Channels>
+        float distanceSquared(const Color<Channels>& a, const Color<Channels>& b)
+        {
+            float distance = 0.0f;
+            for (size_t channel = 0; channel < Channels; channel++)
+                distance += (a[channel] - b[channel]) * (a[channel] - b[channel]);
+            return distance;
+        }
+
+        template<size_t Channels>
+        Color<Channels> interpolate(const Endpoints<Channels>& endpoints, float weight)
+        {
+            Color<Channels> color;
+            for (size_t channel = 0; channel < Channels; channel++)
+            {
+                float first = endpoints.first[channel];
+                color[channel] = first + (endpoints.second[channel] - first) * weight;
+            }
+            return color;
+        }
+
+        // Extremes of the colours projected onto their principal axis, which a few power iterations of the
+        // covariance matrix find well enough for 16 texels
+        template<size_t Channels>
+        Endpoints<Channels> fitPrincipalAxis(std::span<const Color<Channels>> colors)
+        {
+            Color<Channels> mean{};
+            for (const auto& color: colors)
+            {
+                for (size_t channel = 0; channel < Channels; channel++)
+                    mean[channel] += color[channel] / static_cast<float>(colors.size());
+            }
+
+            std::array<Color<Channels>, Channels> covariance{};
+            for (const auto& color: colors)
+            {
+                for (size_t row = 0; row < Channels; row++)
+                {
+                    for (size_t column = 0; column < Channels; column++)
+                        covariance[row][column] += (color[row] - mean[row]) * (color[column] - mean[column]);
+                }
+            }
+
+            Color<Channels> axis;
+            axis.fill(1.0f);
+            for (uint32_t iteration = 0; iteration < 8; iteration++)
+            {
+                Color<Channels> next{};
+                float length = 0.0f;
+                for (size_t row = 0; row < Channels; row++)
+                {
+                    for (size_t column = 0; column < Channels; column++)
+                        next[row] += covariance[row][column] * axis[column];
+                    length += next[row] * next[row];
+                }
+
+                // Every colour is the same
+                if (length < 1e-8f)
+                    return {mean, mean};
+                for (size_t channel = 0; channel < Channels; channel++)
+                    axis[channel] = next[channel] / std::sqrt(length);
+            }
+
+            float low = std::numeric_limits<float>::max();
+            float high = std::numeric_limits<float>::lowest();
+            for (const auto& color: colors)
+            {
+                float projection = 0.0f;
+                for (size_t channel = 0; channel < Channels; channel++)
+                    projection += (color[channel] - mean[channel]) * axis[channel];
+                low = std::min(low, projection);
+                high = std::max(high, projection);
+            }
+
+            Endpoints<Channels> endpoints;
+            for (size_t channel = 0; channel < Channels; channel++)
+            {
+                endpoints.first[channel] = std::clamp(mean[channel] + axis[channel] * low, 0.0f, 255.0f);
+                endpoints.second[channel] = std::clamp(mean[channel] + axis[channel] * high, 0.0f, 255.0f);
+            }
+            return endpoints;
+        }
+
+        // Assigns every colour to its closest weight and solves for the endpoints with the least squared error
+        // under that assignment
+        template<size_t Channels>
+        Endpoints<Channels> refineEndpoints(std::span<const Color<Channels>> colors,
+                                            const Endpoints<Channels>& endpoints, std::span<const float> weights)
+        {
+            float firstFirst = 0.0f;
+            float firstSecond = 0.0f;
+            float secondSecond = 0.0f;
+            Color<Channels> firstColor{};
+            Color<Channels> secondColor{};
+            for (const auto& color: colors)
+            {
+                float bestWeight = 0.0f;
+                float bestDistance = std::numeric_limits<float>::max();
+                for (auto weight: weights)
+                {
+                    float distance = distanceSquared(color, interpolate(endpoints, weight));
+                    if (distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        bestWeight = weight;
+                    }
+                }
+
+                float first = 1.0f - bestWeight;
+                firstFirst += first * first;
+                firstSecond += first * bestWeight;
+                secondSecond += bestWeight * bestWeight;
+                for (size_t channel = 0; channel < Channels; channel++)
+                {
+                    firstColor[channel] += first * color[channel];
+                    secondColor[channel] += bestWeight * color[channel];
+                }
+            }
+
+            // All colours picked the same weight, the system has no unique solution
+            float determinant = firstFirst * secondSecond - firstSecond * firstSecond;
+            if (std::abs(determinant) < 1e-6f)
+                return endpoints;
+
+            Endpoints<Channels> refined;
+            for (size_t channel = 0; channel < Channels; channel++)
+            {
+                float first = (secondSecond * firstColor[channel] - firstSecond * secondColor[channel]) / determinant;
+                float second = (firstFirst * secondColor[channel] - firstSecond * firstColor[channel]) / determinant;
+                refined.first[channel] = std::clamp(first, 0.0f, 255.0f);
+                refined.second[channel] = std::clamp(second, 0.0f, 255.0f);
+            }
+            return refined;
+        }
+
+        template<size_t Channels>
+        Endpoints<Channels> fitEndpoints(std::span<const Color<Channels>> colors, std::span<const float> weights)
+        {
+            auto endpoints = fitPrincipalAxis(colors);
+            for (uint32_t iteration = 0; iteration < 2; iteration++)
+                endpoints = refineEndpoints(colors, endpoints, weights);
+            return endpoints;
+        }
+
+        template<size_t Channels>
+        uint32_t findClosest(const Color<Channels>& color, std::span<const Color<Channels>> palette)
+        {
+            uint32_t closest = 0;
+            float closestDistance = std::numeric_limits<float>::max();
+            for (uint32_t index = 0; index < palette.size(); index++)
+            {
+                float distance = distanceSquared(color, palette[index]);
+                if (distance < closestDistance)
+                {
+                    closestDistance = distance;
+                    closest = index;
+                }
+            }
+            return closest;
+        }
+
+        uint16_t packColor565(const Color<3>& color)
+        {
+            auto quantize = [](float value, float maximum) {
+                return static_cast<uint16_t>(std::lround(value / 255.0f * maximum));
+            };
+            return static_cast<uint16_t>(quantize(color[0], 31.0f) << 11 bitor quantize(color[1], 63.0f) << 5 bitor
+                                         quantize(color[2], 31.0f));
+        }
+
+        Color<3> unpackColor565(uint16_t color)
+        {
+            uint32_t red = color >> 11 bitand 0x1F;
+            uint32_t green = color >> 5 bitand 0x3F;
+            uint32_t blue = color bitand 0x1F;
+            return {static_cast<float>(red << 3 bitor red >> 2), static_cast<float>(green << 2 bitor green >> 4),
+                    static_cast<float>(blue << 3 bitor blue >> 2)};
+        }
+
+        void encodeColorBlock(const BlockTexels& texels, bool punchThroughAlpha, std::byte* output)
+        {
+            std::array<Color<3>, 16> colors;
+            std::array<bool, 16> transparent = {};
+            size_t colorCount = 0;
+            for (size_t texel = 0; texel < texels.size(); texel++)
+            {
+                transparent[texel] = punchThroughAlpha and texels[texel][3] < 128;
+                if (not transparent[texel])
+                {
+                    colors[colorCount++] = {static_cast<float>(texels[texel][0]), static_cast<float>(texels[texel][1]),
+                                            static_cast<float>(texels[texel][2])};
+                }
+            }
+
+            // c0 > c1 selects four colours, otherwise the fourth index is transparent black
+            bool threeColors = colorCount < texels.size();
+            uint16_t first = 0;
+            uint16_t second = 0;
+            if (colorCount > 0)
+            {
+                std::span<const float> weights = threeColors ? std::span<const float>(BC1_PUNCH_THROUGH_WEIGHTS)
+                                                             : std::span<const float>(BC1_WEIGHTS);
+                auto endpoints = fitEndpoints<3>(std::span(colors.data(), colorCount), weights);
+                first = packColor565(endpoints.first);
+                second = packColor565(endpoints.second);
+                if (threeColors == (first > second))
+                    std::swap(first, second);
+            }
+
+            // Equal endpoints decode in three colour mode, which only differs in the index 3 no colour picks
+            std::array<Color<3>, 4> palette;
+            palette[0] = unpackColor565(first);
+            palette[1] = unpackColor565(second);
+            for (size_t channel = 0; channel < 3; channel++)
+            {
+                if (threeColors)
+                {
+                    palette[2][channel] = (palette[0][channel] + palette[1][channel]) / 2.0f;
+                }
+                else
+                {
+                    palette[2][channel] = (2.0f * palette[0][channel] + palette[1][channel]) / 3.0f;
+                    palette[3][channel] = (palette[0][channel] + 2.0f * palette[1][channel]) / 3.0f;
+                }
+            }
+
+            uint32_t indices = 0;
+            for (size_t texel = 0, color = 0; texel < texels.size(); texel++)
+            {
+                uint32_t index = 3;
+                if (not transparent[texel])
+                    index = findClosest<3>(colors[color++], std::span(palette.data(), threeColors ? 3 : 4));
+                indices |= index << (2 * texel);
+            }
+
+            std::memcpy(output, &first, sizeof(first));
+            std::memcpy(output + 2, &second, sizeof(second));
+            std::memcpy(output + 4, &indices, sizeof(indices));
+        }
+
+        std::array<uint8_t, 8> createChannelPalette(uint8_t first, uint8_t second)
+        {
+            std::array<uint8_t, 8> palette = {first, second};
+            if (first > second)
+            {
+                for (uint32_t index = 2; index < 8; index++)
+                    palette[index] = static_cast<uint8_t>(((8 - index) * first + (index - 1) * second + 3) / 7);
+            }
+            else
+            {
+                for (uint32_t index = 2; index < 6; index++)
+                    palette[index] = static_cast<uint8_t>(((6 - index) * first + (index - 1) * second + 2) / 5);
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+            return palette;
+        }
+
+        // BC4 block of one channel, the eight value mode spans the extremes while the six value mode keeps exact
+        // 0 and 255 and only spans the values between them. Whichever has less error is written.
+        void encodeChannelBlock(const std::array<uint8_t, 16>& values, std::byte* output)
+        {
+            uint8_t low = 255;
+            uint8_t high = 0;
+            uint8_t innerLow = 255;
+            uint8_t innerHigh = 0;
+            for (auto value: values)
+            {
+                low = std::min(low, value);
+                high = std::max(high, value);
+                if (value != 0 and value != 255)
+                {
+                    innerLow = std::min(innerLow, value);
+                    innerHigh = std::max(innerHigh, value);
+                }
+            }
+            if (innerLow > innerHigh)
+                innerLow = innerHigh = 0;
+
+            uint64_t bestBlock = 0;
+            uint32_t bestError = std::numeric_limits<uint32_t>::max();
+            for (auto [first, second]: {std::pair(high, low), std::pair(innerLow, innerHigh)})
+            {
+                auto palette = createChannelPalette(first, second);
+                uint64_t block = first bitor static_cast<uint64_t>(second) << 8;
+                uint32_t error = 0;
+                for (size_t texel = 0; texel < values.size(); texel++)
+                {
+                    uint32_t closest = 0;
+                    uint32_t closestError = std::numeric_limits<uint32_t>::max();
+                    for (uint32_t index = 0; index < palette.size(); index++)
+                    {
+                        auto difference = static_cast<int32_t>(values[texel]) - palette[index];
+                        auto indexError = static_cast<uint32_t>(difference * difference);
+                        if (indexError < closestError)
+                        {
+                            closestError = indexError;
+                            closest = index;
+                        }
+                    }
+                    block |= static_cast<uint64_t>(closest) << (16 + 3 * texel);
+                    error += closestError;
+                }
+
+                if (error < bestError)
+                {
+                    bestError = error;
+                    bestBlock = block;
+                }
+            }
+            std::memcpy(output, &bestBlock, sizeof(bestBlock));
+        }
+
+        std::array<uint8_t, 16> extractChannel(const BlockTexels& texels, size_t channel)
+        {
+            std::array<uint8_t, 16> values;
+            for (size_t texel = 0; texel < texels.size(); texel++)
+                values[texel] = texels[texel][channel];
+            return values;
+        }
+
+        // Packs fields least significant bit first, the way BC7 blocks are laid out
+        class BitWriter
+        {
+        public:
+            explicit BitWriter(std::byte* output) : m_Output(output) { std::memset(m_Output, 0, 16); }
+
+            void write(uint32_t value, uint32_t bitCount)
+            {
+                for (uint32_t bit = 0; bit < bitCount; bit++, m_Position++)
+                {
+                    if (value >> bit bitand 1)
+                        m_Output[m_Position / 8] |= std::byte{1} << (m_Position % 8);
+                }
+            }
+
+        private:
+            std::byte* m_Output;
+            uint32_t m_Position = 0;
+        };
+
+        // 7 bit channels plus a p-bit shared by the endpoint's channels, picked by the smaller error
+        struct Bc7Endpoint
+        {
+            std::array<uint32_t, 4> channels;
+            uint32_t pBit;
+
+            [[nodiscard]] uint32_t getValue(size_t channel) const { return channels[channel] << 1 bitor pBit; }
+        };
+
+        Bc7Endpoint quantizeBc7Endpoint(const Color<4>& color)
+        {
+            Bc7Endpoint best = {};
+            float bestError = std::numeric_limits<float>::max();
+            for (uint32_t pBit = 0; pBit < 2; pBit++)
+            {
+                Bc7Endpoint endpoint = {.pBit = pBit};
+                float error = 0.0f;
+                for (size_t channel = 0; channel < 4; channel++)
+                {
+                    auto quantized = std::lround((color[channel] - static_cast<float>(pBit)) / 2.0f);
+                    endpoint.channels[channel] = static_cast<uint32_t>(std::clamp(quantized, 0l, 127l));
+                    float difference = static_cast<float>(endpoint.getValue(channel)) - color[channel];
+                    error += difference * difference;
+                }
+
+                if (error < bestError)
+                {
+                    bestError = error;
+                    best = endpoint;
+                }
+            }
+            return best;
+        }
+    }
+
+    void encodeBC1(const BlockTexels& texels, bool punchThroughAlpha, std::byte* output)
+    {
+        encodeColorBlock(texels, punchThroughAlpha, output);
+    }
+
+    void encodeBC3(const BlockTexels& texels, std::byte* output)
+    {
+        encodeChannelBlock(extractChannel(texels, 3), output);
+        encodeColorBlock(texels, false, output + 8);
+    }
+
+    void encodeBC4(const BlockTexels& texels, std::byte* output)
+    {
+        encodeChannelBlock(extractChannel(texels, 0), output);
+    }
+
+    void encodeBC5(const BlockTexels& texels, std::byte* output)
+    {
+        encodeChannelBlock(extractChannel(texels, 0), output);
+        encodeChannelBlock(extractChannel(texels, 1), output + 8);
+    }
+
+    void encodeBC7(const BlockTexels& texels, std::byte* output)
+    {
+        std::array<Color<4>, 16> colors;
+        for (size_t texel = 0; texel < texels.size(); texel++)
+        {
+            for (size_t channel = 0; channel < 4; channel++)
+                colors[texel][channel] = static_cast<float>(texels[texel][channel]);
+        }
+
+        std::array<float, 16> weights;
+        for (size_t index = 0; index < weights.size(); index++)
+            weights[index] = static_cast<float>(BC7_WEIGHTS[index]) / 64.0f;
+        auto fitted = fitEndpoints<4>(colors, weights);
+        std::array endpoints = {quantizeBc7Endpoint(fitted.first), quantizeBc7Endpoint(fitted.second)};
+
+        std::array<Color<4>, 16> palette;
+        for (size_t index = 0; index < palette.size(); index++)
+        {
+            for (size_t channel = 0; channel < 4; channel++)
+            {
+                uint32_t value = ((64 - BC7_WEIGHTS[index]) * endpoints[0].getValue(channel) +
+                                  BC7_WEIGHTS[index] * endpoints[1].getValue(channel) + 32) >> 6;
+                palette[index][channel] = static_cast<float>(value);
+            }
+        }
+
+        std::array<uint32_t, 16> indices;
+        for (size_t texel = 0; texel < texels.size(); texel++)
+            indices[texel] = findClosest<4>(colors[texel], palette);
+
+        // The first index is stored without its most significant bit, which therefore has to be 0
+        if (indices[0] >= 8)
+        {
+            std::swap(endpoints[0], endpoints[1]);
+            for (auto& index: indices)
+                index = 15 - index;
+        }
+
+        BitWriter writer(output);
+        writer.write(1 << 6, 7); // Mode 6
+        for (size_t channel = 0; channel < 4; channel++)
+        {
+            writer.write(endpoints[0].channels[channel], 7);
+            writer.write(endpoints[1].channels[channel], 7);
+        }
+        writer.write(endpoints[0].pBit, 1);
+        writer.write(endpoints[1].pBit, 1);
+        for (size_t texel = 0; texel < indices.size(); texel++)
+            writer.write(indices[texel], texel == 0 ? 3 : 4);
+    }
+} // Corvus
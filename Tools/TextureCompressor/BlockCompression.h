@@ -0,0 +1,28 @@
+#ifndef ENGINE_BLOCKCOMPRESSION_H
+#define ENGINE_BLOCKCOMPRESSION_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Corvus
+{
+    // 4x4 texels of 8 bit RGBA in row order, texels outside the image repeat the edge
+    using BlockTexels = std::array<std::array<uint8_t, 4>, 16>;
+
+    // Endpoints are fitted along the principal axis of the block's colours and refined with a least squares
+    // solve before they are quantized. Every encoder writes one whole block.
+
+    // Texels with alpha below 128 become transparent through the three colour mode of BC1 if punch through alpha
+    // is enabled, BC3 colour blocks must not use it.
+    void encodeBC1(const BlockTexels& texels, bool punchThroughAlpha, std::byte* output);
+    void encodeBC3(const BlockTexels& texels, std::byte* output);
+    // Red channel only
+    void encodeBC4(const BlockTexels& texels, std::byte* output);
+    // Red and green channel, e.g. tangent space normals
+    void encodeBC5(const BlockTexels& texels, std::byte* output);
+    // Mode 6 only, a single RGBA subset with 4 bit indices
+    void encodeBC7(const BlockTexels& texels, std::byte* output);
+} // Corvus
+
+#endif //ENGINE_BLOCKCOMPRESSION_H
@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "stb_image.h"
+
+#include "BlockCompression.h"
+#include "Graphic/Vulkan/Ktx2.h"
+#include "Utility/Corvus.h"
+#include "Utility/ThreadPool.h"
+
+using namespace Corvus;
+
+namespace
+{
+    enum class BlockFormat { BC1, BC3, BC4, BC5, BC7 };
+
+    struct Options
+    {
+        std::string input;
+        std::string output;
+        BlockFormat format = BlockFormat::BC7;
+        bool srgb = true;
+        bool mips = true;
+    };
+
+    // Linear floats, so mips of sRGB sources are filtered in linear space
+    struct Level
+    {
+        VkExtent2D extent;
+        std::vector<std::array<float, 4>> texels;
+    };
+
+    constexpr std::string_view USAGE =
+        "Usage: TextureCompressor <input> <output.ktx2> [--format bc1|bc3|bc4|bc5|bc7] [--linear] [--no-mips]";
+
+    bool parseOptions(int argc, char** argv, Options& options)
+    {
+        std::vector<std::string_view> positional;
+        for (int i = 1; i < argc; i++)
+        {
+            std::string_view argument = argv[i];
+            if (argument == "--linear")
+            {
+                options.srgb = false;
+            }
+            else if (argument == "--no-mips")
+            {
+                options.mips = false;
+            }
+            else if (argument == "--format" and i + 1 < argc)
+            {
+                std::string_view format = argv[++i];
+                if (format == "bc1")
+                    options.format = BlockFormat::BC1;
+                else if (format == "bc3")
+                    options.format = BlockFormat::BC3;
+                else if (format == "bc4")
+                    options.format = BlockFormat::BC4;
+                else if (format == "bc5")
+                    options.format = BlockFormat::BC5;
+                else if (format == "bc7")
+                    options.format = BlockFormat::BC7;
+                else
+                    return false;
+            }
+            else if (argument.starts_with("--"))
+            {
+                return false;
+            }
+            else
+            {
+                positional.push_back(argument);
+            }
+        }
+
+        if (positional.size() != 2)
+            return false;
+        options.input = positional[0];
+        options.output = positional[1];
+        // BC4 and BC5 only exist as UNORM, they hold data rather than colour
+        if (options.format == BlockFormat::BC4 or options.format == BlockFormat::BC5)
+            options.srgb = false;
+        return true;
+    }
+
+    VkFormat getVkFormat(BlockFormat format, bool srgb, bool punchThroughAlpha)
+    {
+        switch (format)
+        {
+        case BlockFormat::BC1:
+            if (punchThroughAlpha)
+                return srgb ? VK_FORMAT_BC1_RGBA_SRGB_BLOCK : VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+            return srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+        case BlockFormat::BC3:
+            return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+        case BlockFormat::BC4:
+            return VK_FORMAT_BC4_UNORM_BLOCK;
+        case BlockFormat::BC5:
+            return VK_FORMAT_BC5_UNORM_BLOCK;
+        case BlockFormat::BC7:
+            return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+        }
+        return VK_FORMAT_UNDEFINED;
+    }
+
+    float srgbToLinear(float value)
+    {
+        return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    float linearToSrgb(float value)
+    {
+        return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    }
+
+    Level decodeSource(const uint8_t* pixels, VkExtent2D extent, bool srgb)
+    {
+        Level level = {extent, std::vector<std::array<float, 4>>(static_cast<size_t>(extent.width) * extent.height)};
+        for (size_t texel = 0; texel < level.texels.size(); texel++)
+        {
+            for (size_t channel = 0; channel < 4; channel++)
+            {
+                float value = static_cast<float>(pixels[texel * 4 + channel]) / 255.0f;
+                level.texels[texel][channel] = srgb and channel < 3 ? srgbToLinear(value) : value;
+            }
+        }
+        return level;
+    }
+
+    // Box filter over the texels each one covers, odd extents fold their last row or column into the edge
+    Level downsample(const Level& source)
+    {
+        Level level = {getLevelExtent(source.extent, 1), {}};
+        level.texels.resize(static_cast<size_t>(level.extent.width) * level.extent.height);
+        ThreadPool::getInstance().parallelFor(level.extent.height, 16, [&](size_t begin, size_t end) {
+            for (auto y = static_cast<uint32_t>(begin); y < end; y++)
+            {
+                uint32_t lastY = y + 1 == level.extent.height ? source.extent.height - 1 : 2 * y + 1;
+                for (uint32_t x = 0; x < level.extent.width; x++)
+                {
+                    uint32_t lastX = x + 1 == level.extent.width ? source.extent.width - 1 : 2 * x + 1;
+                    std::array<float, 4> sum = {};
+                    for (uint32_t sourceY = 2 * y; sourceY <= lastY; sourceY++)
+                    {
+                        for (uint32_t sourceX = 2 * x; sourceX <= lastX; sourceX++)
+                        {
+                            const auto& texel = source.texels[static_cast<size_t>(sourceY) * source.extent.width +
+                                                              sourceX];
+                            for (size_t channel = 0; channel < 4; channel++)
+                                sum[channel] += texel[channel];
+                        }
+                    }
+
+                    auto count = static_cast<float>((lastY - 2 * y + 1) * (lastX - 2 * x + 1));
+                    for (size_t channel = 0; channel < 4; channel++)
+                        sum[channel] /= count;
+                    level.texels[static_cast<size_t>(y) * level.extent.width + x] = sum;
+                }
+            }
+        });
+        return level;
+    }
+
+    BlockTexels gatherBlock(const Level& level, uint32_t blockX, uint32_t blockY, bool srgb)
+    {
+        BlockTexels block;
+        for (uint32_t y = 0; y < 4; y++)
+        {
+            for (uint32_t x = 0; x < 4; x++)
+            {
+                uint32_t sourceX = std::min(blockX * 4 + x, level.extent.width - 1);
+                uint32_t sourceY = std::min(blockY * 4 + y, level.extent.height - 1);
+                const auto& texel = level.texels[static_cast<size_t>(sourceY) * level.extent.width + sourceX];
+                for (size_t channel = 0; channel < 4; channel++)
+                {
+                    float value = srgb and channel < 3 ? linearToSrgb(texel[channel]) : texel[channel];
+                    block[y * 4 + x][channel] = static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) *
+                                                                                 255.0f));
+                }
+            }
+        }
+        return block;
+    }
+
+    void encodeLevel(const Level& level, const Options& options, bool punchThroughAlpha, TextureImage& image)
+    {
+        uint32_t columns = (level.extent.width + 3) / 4;
+        uint32_t rows = (level.extent.height + 3) / 4;
+        uint32_t blockSize = getFormatBlock(image.format).size;
+        std::byte* output = image.addLevel(static_cast<VkDeviceSize>(columns) * rows * blockSize);
+
+        ThreadPool::getInstance().parallelFor(static_cast<size_t>(columns) * rows, 64, [&](size_t begin, size_t end) {
+            for (size_t block = begin; block < end; block++)
+            {
+                auto texels = gatherBlock(level, static_cast<uint32_t>(block % columns),
+                                          static_cast<uint32_t>(block / columns), options.srgb);
+                std::byte* blockOutput = output + block * blockSize;
+                switch (options.format)
+                {
+                case BlockFormat::BC1:
+                    encodeBC1(texels, punchThroughAlpha, blockOutput);
+                    break;
+                case BlockFormat::BC3:
+                    encodeBC3(texels, blockOutput);
+                    break;
+                case BlockFormat::BC4:
+                    encodeBC4(texels, blockOutput);
+                    break;
+                case BlockFormat::BC5:
+                    encodeBC5(texels, blockOutput);
+                    break;
+                case BlockFormat::BC7:
+                    encodeBC7(texels, blockOutput);
+                    break;
+                }
+            }
+        });
+    }
+}
+
+// Offline converter of PNG/JPG sources to block compressed KTX2 files with a full mip chain
+int main(int argc, char** argv)
+{
+    Options options;
+    if (not parseOptions(argc, argv, options))
+    {
+        CORVUS_LOG(error, USAGE);
+        return EXIT_FAILURE;
+    }
+
+    int width;
+    int height;
+    int channels;
+    std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> pixels = {
+        stbi_load(options.input.c_str(), &width, &height, &channels, STBI_rgb_alpha), stbi_image_free
+    };
+    if (pixels == nullptr)
+    {
+        CORVUS_LOG(error, "Failed to load {}: {}", options.input, stbi_failure_reason());
+        return EXIT_FAILURE;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    VkExtent2D extent = {static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
+    auto level = decodeSource(pixels.get(), extent, options.srgb);
+
+    // BC1 only spends its transparent index when the source has cut out texels
+    bool punchThroughAlpha = false;
+    if (options.format == BlockFormat::BC1)
+    {
+        for (size_t texel = 0; texel < level.texels.size() and not punchThroughAlpha; texel++)
+            punchThroughAlpha = pixels.get()[texel * 4 + 3] < 128;
+    }
+
+    TextureImage image = {
+        .format = getVkFormat(options.format, options.srgb, punchThroughAlpha),
+        .extent = extent,
+    };
+    uint32_t levelCount = options.mips ? static_cast<uint32_t>(std::bit_width(std::max(extent.width, extent.height)))
+                                       : 1;
+    for (uint32_t i = 0; i < levelCount; i++)
+    {
+        if (i > 0)
+            level = downsample(level);
+        encodeLevel(level, options, punchThroughAlpha, image);
+    }
+
+    saveKtx2(options.output, image);
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    CORVUS_LOG(info, "Compressed {} ({}x{}, {} mip levels) to {} in {} ms", options.input, width, height, levelCount,
+               options.output, duration.count());
+    return EXIT_SUCCESS;
+}